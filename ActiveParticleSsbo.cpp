@@ -0,0 +1,191 @@
+#include "ActiveParticleSsbo.h"
+
+#include <cstddef>
+#include "glload/include/glload/gl_4_4.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Calls the base class to give members initial values (zeros).
+
+    Allocates every section at its largest size.  Each section starts on a multiple of
+    GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT so that it can be bound with
+    glBindBufferRange(...), and each of the three storage blocks gets its own binding point.
+
+    The commands start out as "nothing is active", with the parts of the draw command that the
+    shader never writes already filled in.
+Parameters:
+    maxParticles    The size of the index list.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+ActiveParticleSsbo::ActiveParticleSsbo(unsigned int maxParticles) :
+    SsboBase(),  // generate buffers
+    _maxParticles(maxParticles),
+    _blockSumsBindingPointIndex(0),
+    _commandsBindingPointIndex(0)
+{
+    // ignore _numVertices because this SSBO does not draw by itself (see DrawIndirect(...))
+
+    GLint offsetAlignment = 0;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+    if (offsetAlignment < 1)
+    {
+        offsetAlignment = 1;
+    }
+
+    _sectionSizeBytes[SECTION_INDICES] = sizeof(unsigned int) * maxParticles;
+    _sectionSizeBytes[SECTION_BLOCK_SUMS] = sizeof(unsigned int) * NumWorkGroups(maxParticles);
+    _sectionSizeBytes[SECTION_COMMANDS] = sizeof(ActiveParticleCommands);
+
+    GLuint bufferSizeBytes = 0;
+    for (unsigned int sectionIndex = 0; sectionIndex < SECTION_COUNT; sectionIndex++)
+    {
+        _sectionOffsetBytes[sectionIndex] = bufferSizeBytes;
+        GLuint sectionEnd = bufferSizeBytes + _sectionSizeBytes[sectionIndex];
+        bufferSizeBytes = ((sectionEnd + offsetAlignment - 1) / offsetAlignment) * offsetAlignment;
+    }
+
+    _blockSumsBindingPointIndex = NewStorageBlockBindingPointIndex();
+    _commandsBindingPointIndex = NewStorageBlockBindingPointIndex();
+
+    ActiveParticleCommands initialCommands;
+    initialCommands._numWorkGroupsX = 0;
+    initialCommands._numWorkGroupsY = 1;
+    initialCommands._numWorkGroupsZ = 1;
+    initialCommands._numActiveParticles = 0;
+    initialCommands._drawCount = 0;
+    initialCommands._drawInstanceCount = 1;
+    initialCommands._drawFirstIndex = _sectionOffsetBytes[SECTION_INDICES] / sizeof(unsigned int);
+    initialCommands._drawBaseVertex = 0;
+    initialCommands._drawBaseInstance = 0;
+
+    // Note: Only the shaders write it, hence "copy".
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSizeBytes, 0, GL_DYNAMIC_COPY);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, _sectionOffsetBytes[SECTION_COMMANDS],
+        sizeof(initialCommands), &initialCommands);
+
+    _bufferSizeBytes = bufferSizeBytes;
+
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, _ssboBindingPointIndex, _bufferId,
+        _sectionOffsetBytes[SECTION_INDICES], _sectionSizeBytes[SECTION_INDICES]);
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, _blockSumsBindingPointIndex, _bufferId,
+        _sectionOffsetBytes[SECTION_BLOCK_SUMS], _sectionSizeBytes[SECTION_BLOCK_SUMS]);
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, _commandsBindingPointIndex, _bufferId,
+        _sectionOffsetBytes[SECTION_COMMANDS], _sectionSizeBytes[SECTION_COMMANDS]);
+
+    // cleanup
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Connects each of the shader's storage blocks to its binding point.  Blocks that the shader
+    doesn't have (the compiler may remove unused ones) are skipped.  The sections were bound to
+    the binding points in the constructor.
+
+    Note: It is ok to call this function for multiple compute shaders so that the same SSBO
+    can be used in each shader.  No member variables are altered in this function.
+Parameters:
+    computeProgramId    Self-explanatory
+    bufferNameInShader  The prefix of the storage block names.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ActiveParticleSsbo::ConfigureCompute(unsigned int computeProgramId,
+    const std::string &bufferNameInShader)
+{
+    const char *blockSuffixes[] =
+    {
+        "Indices", "BlockSums", "Commands"
+    };
+    unsigned int bindingPointIndexes[] =
+    {
+        _ssboBindingPointIndex,
+        _blockSumsBindingPointIndex,
+        _commandsBindingPointIndex
+    };
+
+    for (unsigned int blockIndex = 0; blockIndex < SECTION_COUNT; blockIndex++)
+    {
+        std::string blockName = bufferNameInShader + blockSuffixes[blockIndex];
+        GLuint storageBlockIndex = glGetProgramResourceIndex(computeProgramId, GL_SHADER_STORAGE_BLOCK, blockName.c_str());
+        if (storageBlockIndex != GL_INVALID_INDEX)
+        {
+            glShaderStorageBlockBinding(computeProgramId, storageBlockIndex, bindingPointIndexes[blockIndex]);
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    This SSBO has no vertices of its own.  The particles are drawn from the ParticleSsbo's VAO
+    with this buffer as the element array (see DrawIndirect(...)).
+Parameters:
+    irrelevant
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ActiveParticleSsbo::ConfigureRender(unsigned int, unsigned int)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Dispatches the currently used compute program with one invocation for every active
+    particle (rounded up to a whole work group), as counted by the last compaction.  The
+    count never comes back to the CPU.
+
+    Note: The compaction must have been followed by a GL_COMMAND_BARRIER_BIT barrier (see
+    ComputeControllerActiveParticleCompaction::CompactActiveParticles()).
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ActiveParticleSsbo::DispatchIndirect() const
+{
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, _bufferId);
+    glDispatchComputeIndirect(_sectionOffsetBytes[SECTION_COMMANDS] +
+        offsetof(ActiveParticleCommands, _numWorkGroupsX));
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Draws one vertex for every active particle from the currently bound VAO, which must be
+    the ParticleSsbo's.  The index list is the element array, so the vertices are the same
+    ones that glDrawArrays(...) would have drawn, minus the inactive particles.
+
+    Note: Binding an element array changes the bound VAO, so it is unbound again afterwards
+    to leave the particle VAO the way that glDrawArrays(...) expects it.
+Parameters:
+    drawStyle   GL_POINTS, probably.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ActiveParticleSsbo::DrawIndirect(unsigned int drawStyle) const
+{
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _bufferId);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _bufferId);
+
+    GLintptr commandOffset = _sectionOffsetBytes[SECTION_COMMANDS] +
+        offsetof(ActiveParticleCommands, _drawCount);
+    glDrawElementsIndirect(drawStyle, GL_UNSIGNED_INT, (void *)commandOffset);
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    How many work groups the compaction uses, which is also how many block sums there are.
+Parameters:
+    maxParticles    Self-explanatory
+Returns:
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int ActiveParticleSsbo::NumWorkGroups(unsigned int maxParticles)
+{
+    return (maxParticles + 255) / 256;
+}
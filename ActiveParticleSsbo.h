@@ -0,0 +1,77 @@
+#pragma once
+
+#include "SsboBase.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    What ParticleCompactActive.comp leaves for the shaders that run after it and for the
+    particle draw.  The first three members are a DispatchIndirectCommand and the last five
+    are a DrawElementsIndirectCommand, so the same buffer can be handed to both
+    glDispatchComputeIndirect(...) and glDrawElementsIndirect(...).  Must match the
+    ActiveParticleCommands structure in the shaders.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+struct ActiveParticleCommands
+{
+    // one work group for every 256 active particles
+    unsigned int _numWorkGroupsX;
+    unsigned int _numWorkGroupsY;
+    unsigned int _numWorkGroupsZ;
+
+    // the length of the active index list
+    unsigned int _numActiveParticles;
+
+    // one point per active particle; the rest are set once on the CPU
+    unsigned int _drawCount;
+    unsigned int _drawInstanceCount;
+    unsigned int _drawFirstIndex;
+    int _drawBaseVertex;
+    unsigned int _drawBaseInstance;
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets up the Shader Storage Block Object for the dense list of active particles (see
+    ComputeControllerActiveParticleCompaction).  It holds the indices of the active particles
+    in index order, the compaction's work group block sums, and an ActiveParticleCommands.
+    Each is a section of the same buffer, like QuadTreeBuildSsbo's sections.
+
+    The storage blocks are bufferNameInShader + "Indices", "BlockSums", and "Commands".
+
+    The index section doubles as the particle draw's element array, so the particles can be
+    drawn with DrawIndirect(...) instead of glDrawArrays(...) over every particle.
+
+    Nothing here is ever read by the CPU.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class ActiveParticleSsbo : public SsboBase
+{
+public:
+    ActiveParticleSsbo(unsigned int maxParticles);
+    virtual ~ActiveParticleSsbo() override = default; // empty override of base destructor
+
+    void ConfigureCompute(unsigned int computeProgramId, const std::string &bufferNameInShader) override;
+    void ConfigureRender(unsigned int renderProgramId, unsigned int drawStyle) override;
+
+    void DispatchIndirect() const;
+    void DrawIndirect(unsigned int drawStyle) const;
+
+    static unsigned int NumWorkGroups(unsigned int maxParticles);
+
+private:
+    enum SECTION
+    {
+        SECTION_INDICES = 0,
+        SECTION_BLOCK_SUMS,
+        SECTION_COMMANDS,
+        SECTION_COUNT
+    };
+
+    unsigned int _maxParticles;
+    unsigned int _sectionOffsetBytes[SECTION_COUNT];
+    unsigned int _sectionSizeBytes[SECTION_COUNT];
+
+    // the base class' binding point is the indices
+    unsigned int _blockSumsBindingPointIndex;
+    unsigned int _commandsBindingPointIndex;
+};
@@ -0,0 +1,230 @@
+#include "BenchmarkScenario.h"
+
+#include <fstream>
+#include <sstream>
+#include "Particle.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Reads all of the values that a setting needs from the rest of its line, and checks that
+    there is nothing after them.
+Parameters:
+    lineStream  Already past the setting's name.
+    values      Receives the values.
+    numValues   Self-explanatory
+Returns:
+    False if there were too few values, they weren't numbers, or there were too many.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+template<typename T>
+static bool ReadValues(std::istringstream &lineStream, T *values, unsigned int numValues)
+{
+    for (unsigned int valueIndex = 0; valueIndex < numValues; valueIndex++)
+    {
+        if (!(lineStream >> values[valueIndex]))
+        {
+            return false;
+        }
+    }
+
+    std::string extra;
+    return !(lineStream >> extra);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives members the same values as main.cpp, except that there are no emitters.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+BenchmarkScenario::BenchmarkScenario() :
+    _numParticles(Particle::MAX_PARTICLES),
+    _particleRegionCenter(0.0f, 0.0f),
+    _particleRegionRadius(0.8f),
+    _particlesPerEmitterPerFrame(10),
+    _deltaTimeSec(0.01f),
+    _randomSeed(1),
+    _numFrames(600),
+    _numWarmupFrames(0),
+    _spatialIndexType(SPATIAL_INDEX_QUAD_TREE),
+    _framesOfCollisionLatency(0),
+    _numCollisionThreads(1),
+    _useSymmetricCollisions(false),
+    _useParticleFreeList(false)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Reads a scenario file (see the structure's description).  The name defaults to the file's
+    name without its directory or extension.
+Parameters:
+    filePath        Self-explanatory
+    pErrorMessage   If the file can't be loaded, receives the reason, with the line number.
+Returns:
+    False if the file couldn't be opened, a line couldn't be read, or there were no emitters.
+    The scenario may be partly loaded.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+bool BenchmarkScenario::LoadFromFile(const std::string &filePath, std::string *pErrorMessage)
+{
+    std::ifstream file(filePath.c_str());
+    if (!file.is_open())
+    {
+        *pErrorMessage = "could not open '" + filePath + "'";
+        return false;
+    }
+
+    size_t nameStart = filePath.find_last_of("/\\");
+    nameStart = (nameStart == std::string::npos) ? 0 : nameStart + 1;
+    size_t extensionStart = filePath.find_last_of('.');
+    size_t nameLength = (extensionStart == std::string::npos || extensionStart < nameStart) ?
+        std::string::npos : extensionStart - nameStart;
+    _name = filePath.substr(nameStart, nameLength);
+    _emitters.clear();
+
+    std::string line;
+    unsigned int lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        lineNumber++;
+        size_t commentStart = line.find('#');
+        if (commentStart != std::string::npos)
+        {
+            line.erase(commentStart);
+        }
+
+        std::istringstream lineStream(line);
+        std::string setting;
+        if (!(lineStream >> setting))
+        {
+            // blank
+            continue;
+        }
+
+        bool isValid = false;
+        if (setting == "name")
+        {
+            isValid = ReadValues(lineStream, &_name, 1);
+        }
+        else if (setting == "particles")
+        {
+            isValid = ReadValues(lineStream, &_numParticles, 1) && _numParticles > 0;
+        }
+        else if (setting == "region_center")
+        {
+            float center[2];
+            isValid = ReadValues(lineStream, center, 2);
+            _particleRegionCenter = glm::vec2(center[0], center[1]);
+        }
+        else if (setting == "region_radius")
+        {
+            isValid = ReadValues(lineStream, &_particleRegionRadius, 1) && _particleRegionRadius > 0.0f;
+        }
+        else if (setting == "particles_per_emitter_per_frame")
+        {
+            isValid = ReadValues(lineStream, &_particlesPerEmitterPerFrame, 1);
+        }
+        else if (setting == "delta_time_sec")
+        {
+            isValid = ReadValues(lineStream, &_deltaTimeSec, 1) && _deltaTimeSec > 0.0f;
+        }
+        else if (setting == "random_seed")
+        {
+            isValid = ReadValues(lineStream, &_randomSeed, 1);
+        }
+        else if (setting == "frames")
+        {
+            isValid = ReadValues(lineStream, &_numFrames, 1) && _numFrames > 0;
+        }
+        else if (setting == "warmup_frames")
+        {
+            isValid = ReadValues(lineStream, &_numWarmupFrames, 1);
+        }
+        else if (setting == "spatial_index")
+        {
+            std::string indexName;
+            isValid = ReadValues(lineStream, &indexName, 1);
+            if (indexName == "quad_tree")
+            {
+                _spatialIndexType = SPATIAL_INDEX_QUAD_TREE;
+            }
+            else if (indexName == "compact_quad_tree")
+            {
+                _spatialIndexType = SPATIAL_INDEX_COMPACT_QUAD_TREE;
+            }
+            else if (indexName == "uniform_grid")
+            {
+                _spatialIndexType = SPATIAL_INDEX_UNIFORM_GRID;
+            }
+            else
+            {
+                isValid = false;
+            }
+        }
+        else if (setting == "collision_latency")
+        {
+            isValid = ReadValues(lineStream, &_framesOfCollisionLatency, 1);
+        }
+        else if (setting == "collision_threads")
+        {
+            isValid = ReadValues(lineStream, &_numCollisionThreads, 1) && _numCollisionThreads > 0;
+        }
+        else if (setting == "symmetric_collisions")
+        {
+            isValid = ReadValues(lineStream, &_useSymmetricCollisions, 1);
+        }
+        else if (setting == "particle_free_list")
+        {
+            isValid = ReadValues(lineStream, &_useParticleFreeList, 1);
+        }
+        else if (setting == "point_emitter")
+        {
+            float values[4];
+            isValid = ReadValues(lineStream, values, 4);
+
+            BenchmarkScenarioEmitter emitter;
+            emitter._isBarEmitter = false;
+            emitter._p1 = glm::vec2(values[0], values[1]);
+            emitter._minVelocity = values[2];
+            emitter._maxVelocity = values[3];
+            _emitters.push_back(emitter);
+        }
+        else if (setting == "bar_emitter")
+        {
+            float values[8];
+            isValid = ReadValues(lineStream, values, 8);
+
+            BenchmarkScenarioEmitter emitter;
+            emitter._isBarEmitter = true;
+            emitter._p1 = glm::vec2(values[0], values[1]);
+            emitter._p2 = glm::vec2(values[2], values[3]);
+            emitter._emitDir = glm::vec2(values[4], values[5]);
+            emitter._minVelocity = values[6];
+            emitter._maxVelocity = values[7];
+            _emitters.push_back(emitter);
+        }
+        else
+        {
+            *pErrorMessage = filePath + ":" + std::to_string(lineNumber) + ": unknown setting '" +
+                setting + "'";
+            return false;
+        }
+
+        if (!isValid)
+        {
+            *pErrorMessage = filePath + ":" + std::to_string(lineNumber) + ": bad value(s) for '" +
+                setting + "'";
+            return false;
+        }
+    }
+
+    if (_emitters.empty())
+    {
+        *pErrorMessage = filePath + ": no emitters";
+        return false;
+    }
+
+    return true;
+}
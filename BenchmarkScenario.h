@@ -0,0 +1,75 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "glm/vec2.hpp"
+#include "ISpatialIndex.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    One emitter from a scenario file.  A point emitter only uses _p1.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+struct BenchmarkScenarioEmitter
+{
+    bool _isBarEmitter;
+    glm::vec2 _p1;
+    glm::vec2 _p2;
+    glm::vec2 _emitDir;
+    float _minVelocity;
+    float _maxVelocity;
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Everything that particle_bench needs to run the same frames every time: the particles, the
+    region, the emitters, how many particles they emit, the time step, and the random seed.
+
+    A scenario file is plain text with one setting per line, a name followed by its values,
+    separated by spaces.  Blank lines and anything after a '#' are ignored.  Anything that
+    isn't in the file keeps the default from the constructor, except that there must be at
+    least one emitter.
+
+        name                                two_bars
+        particles                           100000
+        region_center                       0.0 0.0
+        region_radius                       0.8
+        particles_per_emitter_per_frame     10
+        delta_time_sec                      0.01
+        random_seed                         1
+        frames                              600
+        warmup_frames                       0
+        spatial_index                       quad_tree | compact_quad_tree | uniform_grid
+        collision_latency                   0
+        collision_threads                   1
+        symmetric_collisions                0
+        particle_free_list                  0
+        point_emitter   x y  minVel maxVel
+        bar_emitter     x1 y1  x2 y2  emitDirX emitDirY  minVel maxVel
+
+    The emitters are added in the order that they are listed.  The coordinates are the same
+    window space as in main.cpp.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+struct BenchmarkScenario
+{
+    BenchmarkScenario();
+
+    bool LoadFromFile(const std::string &filePath, std::string *pErrorMessage);
+
+    std::string _name;
+    unsigned int _numParticles;
+    glm::vec2 _particleRegionCenter;
+    float _particleRegionRadius;
+    unsigned int _particlesPerEmitterPerFrame;
+    float _deltaTimeSec;
+    unsigned int _randomSeed;
+    unsigned int _numFrames;
+    unsigned int _numWarmupFrames;
+    SPATIAL_INDEX_TYPE _spatialIndexType;
+    unsigned int _framesOfCollisionLatency;
+    unsigned int _numCollisionThreads;
+    bool _useSymmetricCollisions;
+    bool _useParticleFreeList;
+    std::vector<BenchmarkScenarioEmitter> _emitters;
+};
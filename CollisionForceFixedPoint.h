@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cmath>
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The fixed point format of the symmetric collision shaders' force accumulators (see
+    ParticleCollisionsGridSymmetric.comp and CollisionForceSsbo).  Atomic adds are only for
+    integers, and integer adds give the same sum in any order.  This is here so that the CPU
+    can check the format's range and precision against the engine's float forces.
+
+    The range: a force is stored as round(force * 2^16) in an int, so a particle's summed
+    force is good to about +-32768 in x and in y, and to about 1.5e-5.  Each add is clamped to
+    +-MAX_FORCE_PER_ADD first, so a sum can't wrap around in fewer than 512 adds at the
+    clamp.  For comparison, with main.cpp's particles (mass 0.1, a collision radius of 0.005,
+    and speeds of at most 0.5) and a time step of 0.01, one contact is at most about 0.1, and
+    the biggest net force in the two-bar demo is under 1, from about 200 contacts.  A
+    contact's force goes up with 1 / the time step, so the clamp leaves room for time steps
+    hundreds of times smaller.
+
+    Note: The same constants are in ParticleCollisionsGridSymmetric*.comp and
+    ParticleCollisionsResolve*.comp.  If they change here, they must change there too.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+struct CollisionForceFixedPoint
+{
+    /*-------------------------------------------------------------------------------------------
+    Description:
+        Clamps a force (one x or y) to +-MAX_FORCE_PER_ADD and converts it, the same as the
+        shaders' AccumulateCollisionForce(...).
+    Parameters:
+        force   Self-explanatory
+    Returns:
+        The fixed point force.
+    Creator:    John Cox (10-17-2026)
+    -------------------------------------------------------------------------------------------*/
+    static int FromForce(float force)
+    {
+        float maxForce = (float)MAX_FORCE_PER_ADD;
+        float clampedForce = (force < -maxForce) ? -maxForce : ((force > maxForce) ? maxForce : force);
+        return (int)roundf(clampedForce * (float)(1 << SCALE_SHIFT));
+    }
+
+    /*-------------------------------------------------------------------------------------------
+    Description:
+        The other way, the same as ParticleCollisionsResolve.comp.
+    Parameters:
+        fixedPointForce     Self-explanatory
+    Returns:
+        The force.
+    Creator:    John Cox (10-17-2026)
+    -------------------------------------------------------------------------------------------*/
+    static float ToForce(int fixedPointForce)
+    {
+        return (float)fixedPointForce / (float)(1 << SCALE_SHIFT);
+    }
+
+    // 2^16 per unit of force
+    static const unsigned int SCALE_SHIFT = 16;
+
+    // 64 * 2^16 is 2^22, and 2^31 / 2^22 is 512
+    static const int MAX_FORCE_PER_ADD = 64;
+};
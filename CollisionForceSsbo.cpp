@@ -0,0 +1,82 @@
+#include "CollisionForceSsbo.h"
+
+#include <vector>
+#include "glload/include/glload/gl_4_4.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Must match CollisionForce in the shaders.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+struct CollisionForce
+{
+    int _forceX;
+    int _forceY;
+    unsigned int _collisionCount;
+    unsigned int _padding;
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Calls the base class to give members initial values (zeros).
+
+    Allocates one accumulator per particle, all 0.
+Parameters:
+    maxParticles    Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+CollisionForceSsbo::CollisionForceSsbo(unsigned int maxParticles) :
+    SsboBase()  // generate buffers
+{
+    // ignore _numVertices because this SSBO does not draw
+
+    // Note: Only the shaders read and write it, hence "copy".
+    std::vector<CollisionForce> zeroForces(maxParticles, CollisionForce{ 0, 0, 0, 0 });
+    GLuint bufferSizeBytes = sizeof(CollisionForce) * maxParticles;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSizeBytes, zeroForces.data(), GL_DYNAMIC_COPY);
+
+    _bufferSizeBytes = bufferSizeBytes;
+
+    // cleanup
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Binds the buffer to the shader's storage block.  If the shader doesn't have it, nothing 
+    happens.
+
+    Note: It is ok to call this function for multiple compute shaders so that the same SSBO 
+    can be used in each shader.  No member variables are altered in this function.
+Parameters:
+    computeProgramId    Self-explanatory
+    bufferNameInShader  Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void CollisionForceSsbo::ConfigureCompute(unsigned int computeProgramId, 
+    const std::string &bufferNameInShader)
+{
+    GLuint storageBlockIndex = glGetProgramResourceIndex(computeProgramId, GL_SHADER_STORAGE_BLOCK, bufferNameInShader.c_str());
+    if (storageBlockIndex == GL_INVALID_INDEX)
+    {
+        return;
+    }
+
+    glShaderStorageBlockBinding(computeProgramId, storageBlockIndex, _ssboBindingPointIndex);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, _ssboBindingPointIndex, _bufferId);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Like CompactQuadTreeSsbo, this SSBO does not draw.
+Parameters:
+    irrelevant
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void CollisionForceSsbo::ConfigureRender(unsigned int, unsigned int)
+{
+}
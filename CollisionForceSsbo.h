@@ -0,0 +1,21 @@
+#pragma once
+
+#include "SsboBase.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets up the Shader Storage Block Object for the symmetric collision shaders' per-particle 
+    force accumulators (see ParticleCollisionsGridSymmetric.comp).  Each one is a fixed point 
+    force (see CollisionForceFixedPoint.h) and a collision count.  They start at 0, and ParticleCollisionsResolve.comp puts 
+    them back to 0 after adding them to the particles, so the CPU never touches them again.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class CollisionForceSsbo : public SsboBase
+{
+public:
+    CollisionForceSsbo(unsigned int maxParticles);
+    virtual ~CollisionForceSsbo() override = default; // empty override of base destructor
+
+    void ConfigureCompute(unsigned int computeProgramId, const std::string &bufferNameInShader) override;
+    void ConfigureRender(unsigned int renderProgramId, unsigned int drawStyle) override;
+};
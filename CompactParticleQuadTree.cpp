@@ -0,0 +1,612 @@
+#include "CompactParticleQuadTree.h"
+
+#include "ParticleQuadTreeNode.h"
+#include "ParticleSoA.h"
+#include "QuadrantClassification.h"
+#include "MortonOrder.h"
+#include "QuadTreeBuildEmulator.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values.  The tree starts out empty (no nodes).
+
+    Note: The default leaf size is ParticleQuadTree's, so that by default both trees have the 
+    same shape.
+Parameters:
+    particleRegionCenter    In world space
+    particleRegionRadius    In world space.  The tree covers the square around the circle.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+CompactParticleQuadTree::CompactParticleQuadTree(const glm::vec4 &particleRegionCenter, 
+    float particleRegionRadius) :
+    _particleRegionCenter(particleRegionCenter),
+    _particleRegionRadius(particleRegionRadius),
+    _maxParticlesPerLeaf(ParticleQuadTreeNode::MAX_PARTICLES_PER_NODE),
+    _emulateGpuBuild(false),
+    _pGpuBuildEmulator(0),
+    _gpuBuildEmulatorMaxParticles(0)
+{
+    // all the nodes that there could ever be, up front, so that building never moves them
+    _allNodes.reserve(MAX_NODES);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Cleans up the GPU build emulator, if there is one.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+CompactParticleQuadTree::~CompactParticleQuadTree()
+{
+    delete _pGpuBuildEmulator;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets how many particles a node can have before it is split.  Takes effect on the next 
+    Build(...).  
+    
+    Note: Bigger leaves mean fewer nodes and a shallower tree but more particles to check 
+    per collision.
+Parameters:
+    maxParticlesPerLeaf     0 is treated as 1.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void CompactParticleQuadTree::SetMaxParticlesPerLeaf(unsigned int maxParticlesPerLeaf)
+{
+    _maxParticlesPerLeaf = (maxParticlesPerLeaf > 0) ? maxParticlesPerLeaf : 1;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the leaf size.
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int CompactParticleQuadTree::MaxParticlesPerLeaf() const
+{
+    return _maxParticlesPerLeaf;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets whether Build(...) runs CompactParticleQuadTree's own build or emulates the GPU 
+    build's shaders (see QuadTreeBuildEmulator).  Takes effect on the next Build(...).
+Parameters:
+    emulateGpuBuild     Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void CompactParticleQuadTree::SetEmulateGpuBuild(bool emulateGpuBuild)
+{
+    _emulateGpuBuild = emulateGpuBuild;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for whether the GPU build is being emulated.
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+bool CompactParticleQuadTree::EmulateGpuBuild() const
+{
+    return _emulateGpuBuild;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Throws out the old tree and builds a new one from the active particles.
+Parameters:
+    particleCollection  Self-explanatory
+    numParticles        Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void CompactParticleQuadTree::Build(const Particle *particleCollection, int numParticles)
+{
+    if (_emulateGpuBuild)
+    {
+        // the shaders take every particle, active or not, in ParticleSoA's layout
+        _emulatorPositions.resize(numParticles);
+        _emulatorStateFlags.resize(numParticles);
+        for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+        {
+            const Particle &p = particleCollection[particleIndex];
+            _emulatorPositions[particleIndex] = glm::vec2(p._position.x, p._position.y);
+            _emulatorStateFlags[particleIndex] = ParticleSoA::PackStateFlags(p._isActive != 0, 
+                p._collisionCountThisFrame);
+        }
+
+        BuildWithGpuBuildEmulator(_emulatorPositions.data(), _emulatorStateFlags.data(), 
+            numParticles);
+        return;
+    }
+
+    _sortedParticleIndices.clear();
+    _positionsX.clear();
+    _positionsY.clear();
+    for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    {
+        const Particle &p = particleCollection[particleIndex];
+        if (p._isActive == 0)
+        {
+            continue;
+        }
+
+        _sortedParticleIndices.push_back(particleIndex);
+        _positionsX.push_back(p._position.x);
+        _positionsY.push_back(p._position.y);
+    }
+
+    BuildTreeFromGatheredPositions();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Like the other Build(...), but with the particles in ParticleSoA's layout.
+Parameters:
+    positions       Self-explanatory
+    stateFlags      Packed as in ParticleSoA::PackStateFlags(...).
+    numParticles    How many are in each array.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void CompactParticleQuadTree::Build(const glm::vec2 *positions, 
+    const unsigned int *stateFlags, int numParticles)
+{
+    if (_emulateGpuBuild)
+    {
+        BuildWithGpuBuildEmulator(positions, stateFlags, numParticles);
+        return;
+    }
+
+    _sortedParticleIndices.clear();
+    _positionsX.clear();
+    _positionsY.clear();
+    for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    {
+        if (!ParticleSoA::IsActive(stateFlags[particleIndex]))
+        {
+            continue;
+        }
+
+        _sortedParticleIndices.push_back(particleIndex);
+        _positionsX.push_back(positions[particleIndex].x);
+        _positionsY.push_back(positions[particleIndex].y);
+    }
+
+    BuildTreeFromGatheredPositions();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the node buffer.
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+const CompactQuadTreeNode *CompactParticleQuadTree::Nodes() const
+{
+    return _allNodes.data();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of nodes in the last build.  0 before the first build.
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int CompactParticleQuadTree::NumNodes() const
+{
+    return (unsigned int)_allNodes.size();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the particle index pool, which is the active particles' indices in 
+    Morton order.  It doubles as a good order to handle the particles in (see 
+    SimulationEngine::CollideParticles(...)).
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+const int *CompactParticleQuadTree::ParticleIndexPool() const
+{
+    return _sortedParticleIndices.data();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of particles in the pool.
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int CompactParticleQuadTree::ParticleIndexPoolSize() const
+{
+    return (unsigned int)_sortedParticleIndices.size();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Same as NumNodes().  For ISpatialIndex.
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int CompactParticleQuadTree::NumCells() const
+{
+    return NumNodes();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Finds the leaf that the position is in and the leaves around it (see 
+    FindNeighborLeaves(...)), and gives back their runs of the particle index pool.  This is 
+    the CPU version of what ParticleCollisionsCompact.comp does for each particle.
+Parameters:
+    x           In world space.
+    y           In world space.
+    runOffsets  Must have room for MAX_CANDIDATE_RUNS.  The leaf's run comes first.
+    runCounts   Same idea.
+Returns:
+    How many runs were filled in.  0 if the tree is empty.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int CompactParticleQuadTree::FindCandidateRuns(float x, float y, 
+    unsigned int *runOffsets, unsigned int *runCounts) const
+{
+    unsigned int column = 0;
+    unsigned int row = 0;
+    CellOfPosition(x, y, column, row);
+
+    const CompactQuadTreeNode *allNodes = _allNodes.data();
+    unsigned int numNodes = NumNodes();
+    unsigned int leafIndex = FindLeaf(allNodes, numNodes, column, row);
+    if (leafIndex == CompactQuadTreeNode::INVALID_INDEX)
+    {
+        return 0;
+    }
+
+    unsigned int leaves[1 + MAX_NEIGHBOR_LEAVES];
+    leaves[0] = leafIndex;
+    unsigned int numLeaves = 1 + FindNeighborLeaves(allNodes, numNodes, leafIndex, column, row, 
+        leaves + 1);
+    for (unsigned int leafCount = 0; leafCount < numLeaves; leafCount++)
+    {
+        runOffsets[leafCount] = allNodes[leaves[leafCount]]._particleOffset;
+        runCounts[leafCount] = allNodes[leaves[leafCount]]._particleCount;
+    }
+
+    return numLeaves;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Finds the bottom level cell that a position is in.  This is the same arithmetic as the 
+    Morton keys in QuadrantClassification.cpp, so a particle always finds the leaf that the 
+    build put it in.
+Parameters:
+    x       In world space.
+    y       In world space.
+    column  Receives the column, 0 on the left.  Clamped to the region.
+    row     Receives the row, 0 on the top.  Clamped to the region.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void CompactParticleQuadTree::CellOfPosition(float x, float y, unsigned int &column, 
+    unsigned int &row) const
+{
+    float regionLeft = _particleRegionCenter.x - _particleRegionRadius;
+    float regionTop = _particleRegionCenter.y + _particleRegionRadius;
+    float cellsPerWorldUnit = 65536.0f / (2.0f * _particleRegionRadius);
+
+    float columnFloat = (x - regionLeft) * cellsPerWorldUnit;
+    float rowFloat = (regionTop - y) * cellsPerWorldUnit;
+    columnFloat = (columnFloat < 0.0f) ? 0.0f : ((columnFloat > 65535.0f) ? 65535.0f : columnFloat);
+    rowFloat = (rowFloat < 0.0f) ? 0.0f : ((rowFloat > 65535.0f) ? 65535.0f : rowFloat);
+    column = (unsigned int)columnFloat;
+    row = (unsigned int)rowFloat;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Works out a node's edges from its depth and cell.
+Parameters:
+    node    Self-explanatory
+    left    Receives the left edge in world space.
+    top     Same idea.
+    right   Same idea.
+    bottom  Same idea.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void CompactParticleQuadTree::NodeEdges(const CompactQuadTreeNode &node, float &left, 
+    float &top, float &right, float &bottom) const
+{
+    float nodeWidth = (2.0f * _particleRegionRadius) / (float)(1 << node.Depth());
+    left = (_particleRegionCenter.x - _particleRegionRadius) + 
+        (nodeWidth * CompactQuadTreeNode::CellColumn(node._cell));
+    top = (_particleRegionCenter.y + _particleRegionRadius) - 
+        (nodeWidth * CompactQuadTreeNode::CellRow(node._cell));
+    right = left + nodeWidth;
+    bottom = top - nodeWidth;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Dives down from the root to the leaf that contains the given bottom level cell.  Each 
+    level down picks the child with the next bit of the column and the row, just like each 
+    2 bits of a Morton key.
+Parameters:
+    allNodes    A CompactParticleQuadTree's nodes or a copy of them.
+    numNodes    How many are in allNodes.
+    column      A bottom level column (see CellOfPosition(...)).
+    row         A bottom level row.
+Returns:
+    The leaf's index, or CompactQuadTreeNode::INVALID_INDEX if there are no nodes.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int CompactParticleQuadTree::FindLeaf(const CompactQuadTreeNode *allNodes, 
+    unsigned int numNodes, unsigned int column, unsigned int row)
+{
+    if (numNodes == 0)
+    {
+        return CompactQuadTreeNode::INVALID_INDEX;
+    }
+
+    unsigned int nodeIndex = 0;
+    while (allNodes[nodeIndex].IsSubdivided())
+    {
+        const CompactQuadTreeNode &node = allNodes[nodeIndex];
+        unsigned int childBit = (MAX_NODE_DEPTH - 1) - node.Depth();
+        unsigned int quadrant = (((row >> childBit) & 1) << 1) | ((column >> childBit) & 1);
+        unsigned int childIndex = node._firstChildIndex + quadrant;
+        if (childIndex >= numNodes)
+        {
+            // a bad copy; stop at the last good node
+            break;
+        }
+
+        nodeIndex = childIndex;
+    }
+
+    return nodeIndex;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Finds the leaves on the other side of each of a leaf's edges and corners from a particle 
+    in the leaf.  For each of the 8 directions, the bottom level cell just past the leaf's 
+    edge (and in line with the particle on the other axis) is looked up with FindLeaf(...).  
+    
+    The neighbor that is found is the one that the particle is closest to, whether it is 
+    bigger than the leaf, the same size, or smaller.  ParticleQuadTreeNode stored its 
+    neighbors when it was made, at the same depth or higher, so a neighbor that was split 
+    later had no particles in it.
+
+    A big neighbor can be on more than one side, so duplicates are dropped.
+Parameters:
+    allNodes        A CompactParticleQuadTree's nodes or a copy of them.
+    numNodes        How many are in allNodes.
+    leafIndex       The leaf that has the particle in it (see FindLeaf(...)).
+    column          The particle's bottom level column.
+    row             The particle's bottom level row.
+    neighborLeaves  Must have room for MAX_NEIGHBOR_LEAVES.  Left, top left, top, top right, 
+                    right, bottom right, bottom, bottom left, minus the ones that are off the 
+                    edge of the region or found twice.
+Returns:
+    How many leaves were put in neighborLeaves.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int CompactParticleQuadTree::FindNeighborLeaves(const CompactQuadTreeNode *allNodes, 
+    unsigned int numNodes, unsigned int leafIndex, unsigned int column, unsigned int row, 
+    unsigned int *neighborLeaves)
+{
+    static const int directionsX[MAX_NEIGHBOR_LEAVES] = { -1, -1,  0, +1, +1, +1,  0, -1 };
+    static const int directionsY[MAX_NEIGHBOR_LEAVES] = {  0, -1, -1, -1,  0, +1, +1, +1 };
+
+    if (leafIndex >= numNodes)
+    {
+        return 0;
+    }
+
+    // the leaf's first and last bottom level cells on each axis
+    const CompactQuadTreeNode &leaf = allNodes[leafIndex];
+    unsigned int levelsBelowLeaf = MAX_NODE_DEPTH - leaf.Depth();
+    unsigned int firstColumn = CompactQuadTreeNode::CellColumn(leaf._cell) << levelsBelowLeaf;
+    unsigned int lastColumn = firstColumn + (1 << levelsBelowLeaf) - 1;
+    unsigned int firstRow = CompactQuadTreeNode::CellRow(leaf._cell) << levelsBelowLeaf;
+    unsigned int lastRow = firstRow + (1 << levelsBelowLeaf) - 1;
+
+    unsigned int numNeighborLeaves = 0;
+    for (unsigned int direction = 0; direction < MAX_NEIGHBOR_LEAVES; direction++)
+    {
+        unsigned int neighborColumn = column;
+        if (directionsX[direction] < 0)
+        {
+            if (firstColumn == 0)
+            {
+                continue;
+            }
+            neighborColumn = firstColumn - 1;
+        }
+        else if (directionsX[direction] > 0)
+        {
+            if (lastColumn == CELLS_PER_SIDE - 1)
+            {
+                continue;
+            }
+            neighborColumn = lastColumn + 1;
+        }
+
+        // rows count down from the top, so -1 is up
+        unsigned int neighborRow = row;
+        if (directionsY[direction] < 0)
+        {
+            if (firstRow == 0)
+            {
+                continue;
+            }
+            neighborRow = firstRow - 1;
+        }
+        else if (directionsY[direction] > 0)
+        {
+            if (lastRow == CELLS_PER_SIDE - 1)
+            {
+                continue;
+            }
+            neighborRow = lastRow + 1;
+        }
+
+        unsigned int neighborIndex = FindLeaf(allNodes, numNodes, neighborColumn, neighborRow);
+        bool alreadyFound = (neighborIndex == leafIndex);
+        for (unsigned int foundCount = 0; foundCount < numNeighborLeaves; foundCount++)
+        {
+            alreadyFound = alreadyFound || (neighborLeaves[foundCount] == neighborIndex);
+        }
+
+        if (!alreadyFound)
+        {
+            neighborLeaves[numNeighborLeaves++] = neighborIndex;
+        }
+    }
+
+    return numNeighborLeaves;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The build, once the active particles' indices and positions are gathered.
+    (1) Make a Morton key for every active particle and radix sort them, along with the 
+    particle indices.  The sorted indices are the particle index pool.
+    (2) Starting with the root, which has all of the particles, split each node that has too 
+    many particles into four children, and cut its run of the pool into the children's runs 
+    with a binary search on the node's 2 bits of the key.
+
+    Nodes are handled breadth first, so there is no recursion, and a node's four children are 
+    always made together, side by side.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void CompactParticleQuadTree::BuildTreeFromGatheredPositions()
+{
+    float regionLeft = _particleRegionCenter.x - _particleRegionRadius;
+    float regionTop = _particleRegionCenter.y + _particleRegionRadius;
+    float cellsPerWorldUnit = 65536.0f / (2.0f * _particleRegionRadius);
+
+    unsigned int numSortedParticles = (unsigned int)_sortedParticleIndices.size();
+    _mortonKeys.resize(numSortedParticles);
+    ComputeMortonKeys(_positionsX.data(), _positionsY.data(), numSortedParticles, 
+        regionLeft, regionTop, cellsPerWorldUnit, _mortonKeys.data());
+    RadixSortMortonKeys(_mortonKeys, _sortedParticleIndices, _mortonKeysScratch, 
+        _sortedParticleIndicesScratch);
+
+    CompactQuadTreeNode root = {};
+    root._firstChildIndex = CompactQuadTreeNode::INVALID_INDEX;
+    root._parentIndex = CompactQuadTreeNode::INVALID_INDEX;
+    root._particleCount = numSortedParticles;
+
+    _allNodes.clear();
+    _allNodes.push_back(root);
+    _buildQueue.clear();
+    BuildRange rootRange = { 0, 0, numSortedParticles };
+    _buildQueue.push_back(rootRange);
+
+    const unsigned int *keys = _mortonKeys.data();
+    for (size_t queueIndex = 0; queueIndex < _buildQueue.size(); queueIndex++)
+    {
+        // copied because pushing the children may move the queue
+        BuildRange range = _buildQueue[queueIndex];
+        unsigned int depth = _allNodes[range._nodeIndex].Depth();
+        if ((range._end - range._begin) <= _maxParticlesPerLeaf || 
+            depth >= MAX_NODE_DEPTH || 
+            _allNodes.size() + 4 > MAX_NODES)
+        {
+            // stays a leaf, with all of its particles
+            continue;
+        }
+
+        unsigned int firstChildIndex = (unsigned int)_allNodes.size();
+        unsigned int parentCell = _allNodes[range._nodeIndex]._cell;
+        _allNodes[range._nodeIndex]._firstChildIndex = firstChildIndex;
+        _allNodes[range._nodeIndex]._depthAndFlags |= CompactQuadTreeNode::FLAG_IS_SUBDIVIDED;
+
+        // the children's 2 bits of the key; the root's children use the top 2
+        int childKeyShift = 30 - (2 * (int)depth);
+        unsigned int quadrantBegin = range._begin;
+        for (unsigned int quadrant = 0; quadrant < 4; quadrant++)
+        {
+            unsigned int quadrantEnd = (quadrant == 3) ? range._end : 
+                FirstMortonKeyInQuadrant(keys, quadrantBegin, range._end, childKeyShift, 
+                quadrant + 1);
+
+            // quadrant bit 0 is "right" and bit 1 is "bottom"
+            CompactQuadTreeNode child = {};
+            child._firstChildIndex = CompactQuadTreeNode::INVALID_INDEX;
+            child._parentIndex = range._nodeIndex;
+            child._depthAndFlags = depth + 1;
+            child._cell = CompactQuadTreeNode::PackCell(
+                (CompactQuadTreeNode::CellColumn(parentCell) * 2) + (quadrant & 1),
+                (CompactQuadTreeNode::CellRow(parentCell) * 2) + (quadrant >> 1));
+            child._particleOffset = quadrantBegin;
+            child._particleCount = quadrantEnd - quadrantBegin;
+            _allNodes.push_back(child);
+
+            BuildRange childRange = { firstChildIndex + quadrant, quadrantBegin, quadrantEnd };
+            _buildQueue.push_back(childRange);
+            quadrantBegin = quadrantEnd;
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs the emulated GPU build and copies its nodes and pool out, so that everything else 
+    works the same as after the CPU build.
+Parameters:
+    positions       Self-explanatory
+    stateFlags      Packed as in ParticleSoA::PackStateFlags(...).
+    numParticles    How many are in each array.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void CompactParticleQuadTree::BuildWithGpuBuildEmulator(const glm::vec2 *positions, 
+    const unsigned int *stateFlags, int numParticles)
+{
+    unsigned int particleCount = (numParticles > 0) ? (unsigned int)numParticles : 0;
+    if (_pGpuBuildEmulator == 0 || particleCount > _gpuBuildEmulatorMaxParticles)
+    {
+        delete _pGpuBuildEmulator;
+        _pGpuBuildEmulator = new QuadTreeBuildEmulator(particleCount, _particleRegionCenter, 
+            _particleRegionRadius);
+        _gpuBuildEmulatorMaxParticles = particleCount;
+    }
+
+    _pGpuBuildEmulator->Build(positions, stateFlags, particleCount, _maxParticlesPerLeaf);
+
+    const CompactQuadTreeNode *builtNodes = _pGpuBuildEmulator->Nodes();
+    _allNodes.assign(builtNodes, builtNodes + _pGpuBuildEmulator->NumNodes());
+
+    const unsigned int *builtPool = _pGpuBuildEmulator->ParticleIndexPool();
+    unsigned int poolSize = _pGpuBuildEmulator->ParticleIndexPoolSize();
+    _sortedParticleIndices.resize(poolSize);
+    for (unsigned int poolIndex = 0; poolIndex < poolSize; poolIndex++)
+    {
+        _sortedParticleIndices[poolIndex] = (int)builtPool[poolIndex];
+    }
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <vector>
+#include "glm/vec2.hpp"
+#include "glm/vec4.hpp"
+
+#include "CompactQuadTreeNode.h"
+#include "ISpatialIndex.h"
+#include "Particle.h"
+
+class QuadTreeBuildEmulator;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A quad tree over the same particle region as ParticleQuadTree, but made of 
+    CompactQuadTreeNodes and a shared pool of particle indices.  It is always built from 
+    scratch out of sorted Morton keys (see MortonOrder.h).  
+    
+    The pool is the active particles' indices in Morton order.  That order puts every node's 
+    particles in one contiguous run, so a node only has to say where its run is.  There is no 
+    per-node array of particles, and so there is no fixed limit on how many particles a leaf 
+    can hold.  A node is split when it has more than MaxParticlesPerLeaf() particles and it 
+    isn't at the bottom of the key (MAX_NODE_DEPTH) and there are nodes left.  Otherwise it 
+    keeps all of its particles, so no particle is ever left out of the tree.
+
+    The node buffer starts with one root node (depth 0) that covers the whole region.  A 
+    node's children come after it, in breadth-first order.
+
+    Finding leaves and neighbors is done with the nodes alone (see FindLeaf(...) and 
+    FindNeighborLeaves(...)), so it works the same on a copy of the nodes that was handed to 
+    another thread or uploaded to the GPU.  ParticleCollisionsCompact.comp does the same thing 
+    in GLSL.
+
+    As an ISpatialIndex, a particle's candidate runs are its leaf's run and its neighbor 
+    leaves' runs.
+
+    With SetEmulateGpuBuild(true), Build(...) runs the GPU build's shader steps on the CPU 
+    instead (see QuadTreeBuildEmulator).  The tree must come out exactly the same, so this is 
+    how the GPU build is checked against this one.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class CompactParticleQuadTree : public ISpatialIndex
+{
+public:
+    CompactParticleQuadTree(const glm::vec4 &particleRegionCenter, float particleRegionRadius);
+    ~CompactParticleQuadTree();
+
+    void SetMaxParticlesPerLeaf(unsigned int maxParticlesPerLeaf);
+    unsigned int MaxParticlesPerLeaf() const;
+
+    void SetEmulateGpuBuild(bool emulateGpuBuild);
+    bool EmulateGpuBuild() const;
+
+    void Build(const Particle *particleCollection, int numParticles) override;
+    void Build(const glm::vec2 *positions, const unsigned int *stateFlags, 
+        int numParticles) override;
+
+    const CompactQuadTreeNode *Nodes() const;
+    unsigned int NumNodes() const;
+    const int *ParticleIndexPool() const override;
+    unsigned int ParticleIndexPoolSize() const override;
+    unsigned int NumCells() const override;
+    unsigned int FindCandidateRuns(float x, float y, unsigned int *runOffsets, 
+        unsigned int *runCounts) const override;
+
+    void CellOfPosition(float x, float y, unsigned int &column, unsigned int &row) const;
+    void NodeEdges(const CompactQuadTreeNode &node, float &left, float &top, float &right, 
+        float &bottom) const;
+
+    static unsigned int FindLeaf(const CompactQuadTreeNode *allNodes, unsigned int numNodes, 
+        unsigned int column, unsigned int row);
+    static unsigned int FindNeighborLeaves(const CompactQuadTreeNode *allNodes, 
+        unsigned int numNodes, unsigned int leafIndex, unsigned int column, unsigned int row, 
+        unsigned int *neighborLeaves);
+
+    // same size as ParticleQuadTree's buffer so that either one fits in the same SSBO budget
+    static const unsigned int MAX_NODES = 256 * 256;
+
+    // the Morton key has 16 levels (65536x65536 cells)
+    static const unsigned int MAX_NODE_DEPTH = 16;
+    static const unsigned int CELLS_PER_SIDE = 65536;
+
+    // FindNeighborLeaves(...) fills in at most this many
+    static const unsigned int MAX_NEIGHBOR_LEAVES = 8;
+
+private:
+    CompactParticleQuadTree(const CompactParticleQuadTree &) = delete;
+    CompactParticleQuadTree &operator=(const CompactParticleQuadTree &) = delete;
+
+    void BuildTreeFromGatheredPositions();
+    void BuildWithGpuBuildEmulator(const glm::vec2 *positions, const unsigned int *stateFlags, 
+        int numParticles);
+
+    /*-------------------------------------------------------------------------------------------
+    Description:
+        One node that is waiting to be split (or not) and the run of sorted particles in it.
+    Creator:    John Cox (10-17-2026)
+    -------------------------------------------------------------------------------------------*/
+    struct BuildRange
+    {
+        unsigned int _nodeIndex;
+        unsigned int _begin;
+        unsigned int _end;
+    };
+
+    glm::vec4 _particleRegionCenter;
+    float _particleRegionRadius;
+    unsigned int _maxParticlesPerLeaf;
+
+    // members so that they keep their memory from frame to frame
+    std::vector<float> _positionsX;
+    std::vector<float> _positionsY;
+    std::vector<unsigned int> _mortonKeys;
+    std::vector<unsigned int> _mortonKeysScratch;
+    std::vector<int> _sortedParticleIndices;
+    std::vector<int> _sortedParticleIndicesScratch;
+    std::vector<BuildRange> _buildQueue;
+
+    std::vector<CompactQuadTreeNode> _allNodes;
+
+    // only made when the GPU build is emulated, and remade if there are more particles than 
+    // it was made for
+    bool _emulateGpuBuild;
+    QuadTreeBuildEmulator *_pGpuBuildEmulator;
+    unsigned int _gpuBuildEmulatorMaxParticles;
+    std::vector<glm::vec2> _emulatorPositions;
+    std::vector<unsigned int> _emulatorStateFlags;
+};
@@ -0,0 +1,117 @@
+// compact_particle_quad_tree_tests: CompactParticleQuadTree's CPU build and the GPU build's
+// shader steps (run on the CPU by QuadTreeBuildEmulator) must make the same bytes: the same
+// nodes and the same particle index pool.
+
+#include <cstring>
+#include <vector>
+
+#include "CompactParticleQuadTree.h"
+#include "ParticleQuadTreeNode.h"
+#include "ParticleSoA.h"
+#include "TestChecks.h"
+#include "TestParticles.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Checks that the two trees are byte for byte the same.
+Parameters:
+    cpuTree     Built with the CPU build.
+    gpuTree     Built with the emulated GPU build.
+    caseName    For the failure messages.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void CheckTreesMatch(const CompactParticleQuadTree &cpuTree,
+    const CompactParticleQuadTree &gpuTree, const char *caseName)
+{
+    if (TEST_CHECK(cpuTree.NumNodes() == gpuTree.NumNodes(), "%s: %u nodes vs %u", caseName,
+        cpuTree.NumNodes(), gpuTree.NumNodes()))
+    {
+        TEST_CHECK(memcmp(cpuTree.Nodes(), gpuTree.Nodes(),
+            cpuTree.NumNodes() * sizeof(CompactQuadTreeNode)) == 0, "%s: nodes differ", caseName);
+    }
+
+    if (TEST_CHECK(cpuTree.ParticleIndexPoolSize() == gpuTree.ParticleIndexPoolSize(),
+        "%s: pool of %u vs %u", caseName, cpuTree.ParticleIndexPoolSize(),
+        gpuTree.ParticleIndexPoolSize()))
+    {
+        TEST_CHECK(memcmp(cpuTree.ParticleIndexPool(), gpuTree.ParticleIndexPool(),
+            cpuTree.ParticleIndexPoolSize() * sizeof(int)) == 0, "%s: pools differ", caseName);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Builds both ways from the same particles, with both Build(...) overloads, across the
+    distributions, sizes, and leaf sizes.  The sizes go up and down so that the emulator is
+    both remade and reused, and they land on either side of the work group size.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void TestGpuBuildMatchesCpuBuild()
+{
+    const int testSizes[] = { 1000, 20000, 1, 255, 256, 257, 70000, 3000 };
+    const unsigned int testLeafSizes[] = { 1, ParticleQuadTreeNode::MAX_PARTICLES_PER_NODE, 50 };
+
+    CompactParticleQuadTree cpuTree(gParticleRegionCenter, gParticleRegionRadius);
+    CompactParticleQuadTree gpuTree(gParticleRegionCenter, gParticleRegionRadius);
+    gpuTree.SetEmulateGpuBuild(true);
+
+    for (int distribution = 0; distribution < TEST_DISTRIBUTION_COUNT; distribution++)
+    {
+        for (size_t sizeIndex = 0; sizeIndex < sizeof(testSizes) / sizeof(testSizes[0]); sizeIndex++)
+        {
+            int numParticles = testSizes[sizeIndex];
+            std::vector<Particle> particles = MakeParticles((TEST_DISTRIBUTION)distribution,
+                numParticles);
+
+            // the same particles in ParticleSoA's layout
+            std::vector<glm::vec2> positions(numParticles);
+            std::vector<unsigned int> stateFlags(numParticles);
+            for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+            {
+                const Particle &p = particles[particleIndex];
+                positions[particleIndex] = glm::vec2(p._position.x, p._position.y);
+                stateFlags[particleIndex] = ParticleSoA::PackStateFlags(p._isActive != 0, 0);
+            }
+
+            for (size_t leafSizeIndex = 0; leafSizeIndex < sizeof(testLeafSizes) / sizeof(testLeafSizes[0]); leafSizeIndex++)
+            {
+                unsigned int maxParticlesPerLeaf = testLeafSizes[leafSizeIndex];
+                cpuTree.SetMaxParticlesPerLeaf(maxParticlesPerLeaf);
+                gpuTree.SetMaxParticlesPerLeaf(maxParticlesPerLeaf);
+
+                char caseName[128];
+                snprintf(caseName, sizeof(caseName), "%s, %d particles, %u per leaf, AoS",
+                    gDistributionNames[distribution], numParticles, maxParticlesPerLeaf);
+                cpuTree.Build(particles.data(), numParticles);
+                gpuTree.Build(particles.data(), numParticles);
+                CheckTreesMatch(cpuTree, gpuTree, caseName);
+
+                snprintf(caseName, sizeof(caseName), "%s, %d particles, %u per leaf, SoA",
+                    gDistributionNames[distribution], numParticles, maxParticlesPerLeaf);
+                cpuTree.Build(positions.data(), stateFlags.data(), numParticles);
+                gpuTree.Build(positions.data(), stateFlags.data(), numParticles);
+                CheckTreesMatch(cpuTree, gpuTree, caseName);
+            }
+        }
+    }
+
+    // no active particles at all
+    std::vector<Particle> inactiveParticles = MakeParticles(TEST_DISTRIBUTION_UNIFORM, 500);
+    for (size_t particleIndex = 0; particleIndex < inactiveParticles.size(); particleIndex++)
+    {
+        inactiveParticles[particleIndex]._isActive = 0;
+    }
+    cpuTree.Build(inactiveParticles.data(), (int)inactiveParticles.size());
+    gpuTree.Build(inactiveParticles.data(), (int)inactiveParticles.size());
+    CheckTreesMatch(cpuTree, gpuTree, "no active particles");
+}
+
+int main()
+{
+    TestGpuBuildMatchesCpuBuild();
+
+    return TestExitCode("compact_particle_quad_tree_tests");
+}
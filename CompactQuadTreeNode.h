@@ -0,0 +1,70 @@
+#pragma once
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A 32 byte quad tree node for CompactParticleQuadTree, as opposed to ParticleQuadTreeNode's 
+    116 bytes.
+    - The four children are side by side, so only the first one's index is stored.  They are 
+      in Morton order: top left, top right, bottom left, bottom right.
+    - The edges aren't stored.  The node's depth and its cell (its column and row in the 
+      (2^depth)x(2^depth) grid at that depth, counting rows from the top) say where it is.
+    - The particles aren't stored either.  Every node has a run of particle indices 
+      (offset, count) in a pool that is shared by the whole tree.  A leaf's run is its 
+      particles, and a subdivided node's run is all of the particles under it.  There is no 
+      limit on how many particles a leaf can have.
+    - The neighbors aren't stored.  They are looked up when needed (see 
+      CompactParticleQuadTree::FindNeighborLeaves(...)).
+
+    Note: The same structure is declared in the *Compact.comp shaders.  If it changes here, it 
+    must change there too.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+struct CompactQuadTreeNode
+{
+    /*-------------------------------------------------------------------------------------------
+    Description:
+        Packing and unpacking for _depthAndFlags and _cell.
+    Creator:    John Cox (10-17-2026)
+    -------------------------------------------------------------------------------------------*/
+    static unsigned int PackCell(unsigned int column, unsigned int row)
+    {
+        return column | (row << 16);
+    }
+
+    static unsigned int CellColumn(unsigned int cell)
+    {
+        return cell & 0xffff;
+    }
+
+    static unsigned int CellRow(unsigned int cell)
+    {
+        return cell >> 16;
+    }
+
+    unsigned int Depth() const
+    {
+        return _depthAndFlags & DEPTH_MASK;
+    }
+
+    bool IsSubdivided() const
+    {
+        return (_depthAndFlags & FLAG_IS_SUBDIVIDED) != 0;
+    }
+
+    static const unsigned int DEPTH_MASK = 0xff;
+    static const unsigned int FLAG_IS_SUBDIVIDED = 0x100;
+
+    // for "no child" and "no parent", and for lookups that found nothing
+    static const unsigned int INVALID_INDEX = 0xffffffff;
+
+    unsigned int _firstChildIndex;
+    unsigned int _parentIndex;
+    unsigned int _depthAndFlags;
+    unsigned int _cell;
+    unsigned int _particleOffset;
+    unsigned int _particleCount;
+
+    // rounds the node up to 32 bytes so that no node straddles two of the GPU's 32 byte 
+    // memory transactions
+    unsigned int _padding[2];
+};
@@ -0,0 +1,177 @@
+#include "CompactQuadTreeSsbo.h"
+
+#include "CompactQuadTreeNode.h"
+#include "glload/include/glload/gl_4_4.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Calls the base class to give members initial values (zeros).
+
+    Allocates room for the most nodes and particle indices that there could be.  The pool 
+    section starts on a multiple of GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT so that it can be 
+    bound with glBindBufferRange(...).  The nodes use the binding point from SsboBase and the 
+    pool gets its own.
+Parameters:
+    maxNodes        The size of the node section, in nodes.
+    maxParticles    The size of the pool section, in particle indices.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+CompactQuadTreeSsbo::CompactQuadTreeSsbo(unsigned int maxNodes, unsigned int maxParticles) :
+    SsboBase(),  // generate buffers
+    _orphanOnUpload(false),
+    _numActiveNodes(0),
+    _maxNodes(maxNodes),
+    _maxParticles(maxParticles),
+    _particleIndicesOffsetBytes(0),
+    _particleIndicesBindingPointIndex(0)
+{
+    // ignore _numVertices because this SSBO does not draw
+
+    GLint offsetAlignment = 0;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+    if (offsetAlignment < 1)
+    {
+        offsetAlignment = 1;
+    }
+
+    GLuint nodesSizeBytes = sizeof(CompactQuadTreeNode) * maxNodes;
+    _particleIndicesOffsetBytes = 
+        ((nodesSizeBytes + offsetAlignment - 1) / offsetAlignment) * offsetAlignment;
+    GLuint bufferSizeBytes = _particleIndicesOffsetBytes + (sizeof(int) * maxParticles);
+    _particleIndicesBindingPointIndex = NewStorageBlockBindingPointIndex();
+
+    // Note: The tree is uploaded every frame, hence "dynamic".  Nothing is read before the 
+    // first upload, so there is nothing to fill it with.
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSizeBytes, 0, GL_DYNAMIC_DRAW);
+
+    _bufferSizeBytes = bufferSizeBytes;
+
+    // cleanup
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Binds each section to its storage block.  Blocks that the shader doesn't have (the 
+    compiler may remove unused ones) are skipped.
+
+    Note: It is ok to call this function for multiple compute shaders so that the same SSBO 
+    can be used in each shader.  No member variables are altered in this function.
+Parameters:
+    computeProgramId    Self-explanatory
+    bufferNameInShader  The prefix of the two storage block names.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void CompactQuadTreeSsbo::ConfigureCompute(unsigned int computeProgramId, 
+    const std::string &bufferNameInShader)
+{
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+
+    std::string blockName = bufferNameInShader + "Nodes";
+    GLuint storageBlockIndex = glGetProgramResourceIndex(computeProgramId, GL_SHADER_STORAGE_BLOCK, blockName.c_str());
+    if (storageBlockIndex != GL_INVALID_INDEX)
+    {
+        glShaderStorageBlockBinding(computeProgramId, storageBlockIndex, _ssboBindingPointIndex);
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, _ssboBindingPointIndex, _bufferId, 0, 
+            sizeof(CompactQuadTreeNode) * _maxNodes);
+    }
+
+    blockName = bufferNameInShader + "ParticleIndices";
+    storageBlockIndex = glGetProgramResourceIndex(computeProgramId, GL_SHADER_STORAGE_BLOCK, blockName.c_str());
+    if (storageBlockIndex != GL_INVALID_INDEX)
+    {
+        glShaderStorageBlockBinding(computeProgramId, storageBlockIndex, _particleIndicesBindingPointIndex);
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, _particleIndicesBindingPointIndex, _bufferId, 
+            _particleIndicesOffsetBytes, sizeof(int) * _maxParticles);
+    }
+
+    // cleanup
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Like QuadTreeNodeSsbo, this SSBO does not draw.
+Parameters:
+    irrelevant
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void CompactQuadTreeSsbo::ConfigureRender(unsigned int, unsigned int)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    See QuadTreeNodeSsbo::SetOrphanOnUpload(...).
+Parameters:
+    orphanOnUpload  Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void CompactQuadTreeSsbo::SetOrphanOnUpload(bool orphanOnUpload)
+{
+    _orphanOnUpload = orphanOnUpload;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Copies the nodes and the particle index pool into the front of their sections.  Whatever 
+    is past them is left as it was.
+Parameters:
+    allNodes                Self-explanatory
+    numNodes                Clamped to the size of the node section.
+    particleIndexPool       Self-explanatory
+    particleIndexPoolSize   Clamped to the size of the pool section.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void CompactQuadTreeSsbo::UploadTree(const CompactQuadTreeNode *allNodes, unsigned int numNodes,
+    const int *particleIndexPool, unsigned int particleIndexPoolSize)
+{
+    _numActiveNodes = (numNodes < _maxNodes) ? numNodes : _maxNodes;
+    unsigned int numParticleIndices = 
+        (particleIndexPoolSize < _maxParticles) ? particleIndexPoolSize : _maxParticles;
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+    if (_orphanOnUpload)
+    {
+        // same size and usage, so the binding points don't need to be set up again
+        glBufferData(GL_SHADER_STORAGE_BUFFER, _bufferSizeBytes, 0, GL_DYNAMIC_DRAW);
+    }
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, 
+        _numActiveNodes * sizeof(CompactQuadTreeNode), allNodes);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, _particleIndicesOffsetBytes, 
+        numParticleIndices * sizeof(int), particleIndexPool);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of nodes in the last UploadTree(...).
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int CompactQuadTreeSsbo::NumActiveNodes() const
+{
+    return _numActiveNodes;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Where the particle index pool starts in the buffer.  ComputeControllerQuadTreeBuild copies 
+    the pool that it builds there.
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int CompactQuadTreeSsbo::ParticleIndicesOffsetBytes() const
+{
+    return _particleIndicesOffsetBytes;
+}
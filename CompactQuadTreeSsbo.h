@@ -0,0 +1,43 @@
+#pragma once
+
+#include "SsboBase.h"
+
+struct CompactQuadTreeNode;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets up the Shader Storage Block Object for a CompactParticleQuadTree.  The nodes and the 
+    particle index pool are two sections of the same buffer, each bound to its own storage 
+    block (bufferNameInShader + "Nodes" and bufferNameInShader + "ParticleIndices"), in the 
+    same way as ParticleSsbo's structure of arrays layout.
+
+    Like QuadTreeNodeSsbo, only the part of each section that is in use is uploaded each frame 
+    (see UploadTree(...)), and the shaders are told how many nodes that is with a "number of 
+    active nodes" uniform.  The pool doesn't need a count because nodes only point into the 
+    part that was uploaded.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class CompactQuadTreeSsbo : public SsboBase
+{
+public:
+    CompactQuadTreeSsbo(unsigned int maxNodes, unsigned int maxParticles);
+    virtual ~CompactQuadTreeSsbo() override = default; // empty override of base destructor
+
+    void ConfigureCompute(unsigned int computeProgramId, const std::string &bufferNameInShader) override;
+    void ConfigureRender(unsigned int renderProgramId, unsigned int drawStyle) override;
+
+    void SetOrphanOnUpload(bool orphanOnUpload);
+    void UploadTree(const CompactQuadTreeNode *allNodes, unsigned int numNodes, 
+        const int *particleIndexPool, unsigned int particleIndexPoolSize);
+    unsigned int NumActiveNodes() const;
+    unsigned int ParticleIndicesOffsetBytes() const;
+
+private:
+    bool _orphanOnUpload;
+    unsigned int _numActiveNodes;
+
+    unsigned int _maxNodes;
+    unsigned int _maxParticles;
+    unsigned int _particleIndicesOffsetBytes;
+    unsigned int _particleIndicesBindingPointIndex;
+};
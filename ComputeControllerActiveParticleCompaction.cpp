@@ -0,0 +1,99 @@
+#include "ComputeControllerActiveParticleCompaction.h"
+
+#include "glload/include/glload/gl_4_4.h"
+#include "ShaderStorage.h"
+#include "ActiveParticleSsbo.h"
+
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values.
+    Finds the uniforms for the compaction shader and gives the ones that don't change from 
+    step to step their values.
+
+    The SSBOs must already be configured for the shader (see 
+    ActiveParticleSsbo::ConfigureCompute(...) and ParticleSsbo::ConfigureCompute(...)).
+Parameters:
+    maxParticles        Tells the shader how big the particle buffer is.
+    computeShaderKey    ParticleCompactActive.comp (or the SoA version).
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+ComputeControllerActiveParticleCompaction::ComputeControllerActiveParticleCompaction(
+    unsigned int maxParticles, const std::string &computeShaderKey) :
+    _maxParticles(maxParticles),
+    _computeProgramId(0),
+    _unifLocCompactStep(-1),
+    _gpuTimer(PROFILER_STAGE_GPU_UPDATE)
+{
+    ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+
+    _computeProgramId = shaderStorageRef.GetShaderProgram(computeShaderKey);
+    _unifLocCompactStep = shaderStorageRef.GetUniformLocation(computeShaderKey, "uCompactStep");
+
+    glUseProgram(_computeProgramId);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(computeShaderKey, "uMaxParticleCount"), 
+        maxParticles);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(computeShaderKey, "uNumWorkGroups"), 
+        ActiveParticleSsbo::NumWorkGroups(maxParticles));
+
+    // the step will be uploaded in CompactActiveParticles()
+
+    glUseProgram(0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Dispatches the shader's three steps (count, scan, write) with a memory barrier after each 
+    one.  Nothing is read back.  When this returns, the list and the indirect commands are 
+    ready for the update shader, the collision shaders, and the particle draw.
+
+    Note: This is the one dispatch per frame that still goes over every particle, since it 
+    has to look at each one to find out whether it is active.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ComputeControllerActiveParticleCompaction::CompactActiveParticles()
+{
+    // must match STEP_* in ParticleCompactActive.comp
+    const GLuint STEP_COUNT_ACTIVE = 0;
+    const GLuint STEP_SCAN = 1;
+    const GLuint STEP_WRITE_INDICES = 2;
+
+    GLuint particleWorkGroups = ActiveParticleSsbo::NumWorkGroups(_maxParticles);
+
+    glUseProgram(_computeProgramId);
+    _gpuTimer.Begin();
+
+    glUniform1ui(_unifLocCompactStep, STEP_COUNT_ACTIVE);
+    glDispatchCompute(particleWorkGroups, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    glUniform1ui(_unifLocCompactStep, STEP_SCAN);
+    glDispatchCompute(1, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    // the commands are read as commands and the list as an element array from here on
+    glUniform1ui(_unifLocCompactStep, STEP_WRITE_INDICES);
+    glDispatchCompute(particleWorkGroups, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT | 
+        GL_ELEMENT_ARRAY_BARRIER_BIT);
+
+    _gpuTimer.End();
+    glUseProgram(0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Starts timing the dispatches on the GPU (see GpuDispatchTimer).
+Parameters:
+    pBackend    Not owned.  0 to stop timing.
+    pProfiler   Not owned.  The times go to its PROFILER_STAGE_GPU_UPDATE stage.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ComputeControllerActiveParticleCompaction::EnableGpuTiming(IGpuTimerBackend *pBackend, FrameProfiler *pProfiler)
+{
+    _gpuTimer.Enable(pBackend, pProfiler);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include "GpuDispatchTimer.h"
+
+class ActiveParticleSsbo;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Controls ParticleCompactActive.comp, which writes the indices of the active particles into 
+    an ActiveParticleSsbo as a dense list, in index order, along with the indirect dispatch 
+    and draw commands for that many particles.  The update and collision shaders can then be 
+    dispatched with ActiveParticleSsbo::DispatchIndirect() and the particles drawn with 
+    ActiveParticleSsbo::DrawIndirect(...), so their cost follows the number of active 
+    particles instead of Particle::MAX_PARTICLES.
+
+    The list is only as good as the particles' "is active" flags when it was made, so it must 
+    be made after the reset shader (which is the only thing that activates particles) and 
+    before anything that uses it.  Particles that the update shader deactivates are still in 
+    the list until the next compaction, and every shader that uses it still checks the flag.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class ComputeControllerActiveParticleCompaction
+{
+public:
+    ComputeControllerActiveParticleCompaction(unsigned int maxParticles, 
+        const std::string &computeShaderKey);
+
+    // no destructor because the buffer belongs to whoever made it
+
+    void CompactActiveParticles();
+    void EnableGpuTiming(IGpuTimerBackend *pBackend, FrameProfiler *pProfiler);
+
+private:
+    unsigned int _maxParticles;
+    unsigned int _computeProgramId;
+    int _unifLocCompactStep;
+
+    // does nothing until EnableGpuTiming(...)
+    GpuDispatchTimer _gpuTimer;
+};
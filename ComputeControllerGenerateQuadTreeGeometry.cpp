@@ -25,13 +25,16 @@ ComputeControllerGenerateQuadTreeGeometry::ComputeControllerGenerateQuadTreeGeom
     _acOffsetPolygonFacesCrudeMutex(0),
     _atomicCounterCopyBufferId(0),
     _unifLocMaxNodes(0),
-    _unifLocMaxPolygonFaces(0)
+    _unifLocNumActiveNodes(0),
+    _unifLocMaxPolygonFaces(0),
+    _gpuTimer(PROFILER_STAGE_GPU_GEOMETRY)
 {
     _totalNodes = maxNodes;
 
     ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
 
     _unifLocMaxNodes = shaderStorageRef.GetUniformLocation(computeShaderKey, "uMaxNodes");
+    _unifLocNumActiveNodes = shaderStorageRef.GetUniformLocation(computeShaderKey, "uNumActiveNodes");
     _unifLocMaxPolygonFaces = shaderStorageRef.GetUniformLocation(computeShaderKey, "uMaxPolygonFaces");
 
     _computeProgramId = shaderStorageRef.GetShaderProgram(computeShaderKey);
@@ -80,14 +83,22 @@ ComputeControllerGenerateQuadTreeGeometry::~ComputeControllerGenerateQuadTreeGeo
 Description:
     Resets the atomic counters nd dispatches the shader.
 
-    The number of work groups is based on the maximum number of nodes.
-Parameters: None
+    The number of work groups is based on the number of active nodes.
+Parameters: 
+    numActiveNodes  How many nodes were uploaded (see QuadTreeNodeSsbo::UploadNodes(...)).  
+                    Clamped to the maximum number of nodes.
 Returns:    None
 Creator:    John Cox (1-16-2017)
 -----------------------------------------------------------------------------------------------*/
-void ComputeControllerGenerateQuadTreeGeometry::GenerateGeometry()
+void ComputeControllerGenerateQuadTreeGeometry::GenerateGeometry(unsigned int numActiveNodes)
 {
+    if (numActiveNodes > _totalNodes)
+    {
+        numActiveNodes = _totalNodes;
+    }
+
     glUseProgram(_computeProgramId);
+    glUniform1ui(_unifLocNumActiveNodes, numActiveNodes);
 
     // both atomic counters are 0
     // Note: This shader will run through all the nodes and generate new faces for every single 
@@ -101,12 +112,16 @@ void ComputeControllerGenerateQuadTreeGeometry::GenerateGeometry()
     glBufferSubData(GL_ATOMIC_COUNTER_BUFFER, _acOffsetPolygonFacesCrudeMutex, sizeOfGlUint, &zero);
 
     // calculate the number of work groups and start the magic
-    GLuint numWorkGroupsX = (_totalNodes / 256) + 1;
+    // Note: The nodes past the active ones are not cleared, so there is no point in running 
+    // over them.
+    GLuint numWorkGroupsX = (numActiveNodes / 256) + 1;
     GLuint numWorkGroupsY = 1;
     GLuint numWorkGroupsZ = 1;
 
+    _gpuTimer.Begin();
     glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
     glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+    _gpuTimer.End();
 
     // retrieve the number of faces currently in use
     // Note: See ComputeParticleUpdata::Update(...) for more explanation on this.
@@ -136,3 +151,17 @@ unsigned int ComputeControllerGenerateQuadTreeGeometry::NumActiveFaces() const
 {
     return _facesInUse;
 }
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Starts timing the dispatches on the GPU (see GpuDispatchTimer).
+Parameters:
+    pBackend    Not owned.  0 to stop timing.
+    pProfiler   Not owned.  The times go to its PROFILER_STAGE_GPU_GEOMETRY stage.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ComputeControllerGenerateQuadTreeGeometry::EnableGpuTiming(IGpuTimerBackend *pBackend, FrameProfiler *pProfiler)
+{
+    _gpuTimer.Enable(pBackend, pProfiler);
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include "GpuDispatchTimer.h"
 
 
 /*-----------------------------------------------------------------------------------------------
@@ -20,8 +21,9 @@ public:
     ComputeControllerGenerateQuadTreeGeometry(unsigned int maxNodes, unsigned int maxPolygonFaces, const std::string &computeShaderKey);
     ~ComputeControllerGenerateQuadTreeGeometry();
 
-    void GenerateGeometry();
+    void GenerateGeometry(unsigned int numActiveNodes);
     unsigned int NumActiveFaces() const;
+    void EnableGpuTiming(IGpuTimerBackend *pBackend, FrameProfiler *pProfiler);
 
 private:
     unsigned int _computeProgramId;
@@ -35,5 +37,9 @@ private:
     unsigned int _atomicCounterCopyBufferId;
 
     int _unifLocMaxNodes;
+    int _unifLocNumActiveNodes;
     int _unifLocMaxPolygonFaces;
+
+    // does nothing until EnableGpuTiming(...)
+    GpuDispatchTimer _gpuTimer;
 };
@@ -2,6 +2,7 @@
 
 #include "glload/include/glload/gl_4_4.h"
 #include "ShaderStorage.h"
+#include "ActiveParticleSsbo.h"
 #include "glm/gtc/type_ptr.hpp"
 
 
@@ -11,17 +12,31 @@ Description:
     Finds the uniforms for the "particle collisions" compute shader and gives them initial values.
 Parameters:
     maxParticles            Tells the shader how big the "particle" buffer is.
+    maxNodes                Tells the shader how big the quad tree buffer is.
+    particleRegionCenter    Where the quad tree is.
+    particleRegionRadius    How big the quad tree is.  Only the compact quad tree's and the 
+                            uniform grid's shaders use it (see 
+                            ParticleCollisionsCompact.comp and ParticleCollisionsGrid.comp).
     computeShaderKey        Used to look up the shader's uniform and program ID.
 Returns:    None
 Creator:    John Cox (1-21-2017)
 -----------------------------------------------------------------------------------------------*/
-ComputeControllerParticleCollisions::ComputeControllerParticleCollisions(unsigned int maxParticles, unsigned int maxNodes, const glm::vec4 &particleRegionCenter, const std::string computeShaderKey) :
+ComputeControllerParticleCollisions::ComputeControllerParticleCollisions(unsigned int maxParticles, unsigned int maxNodes, const glm::vec4 &particleRegionCenter, float particleRegionRadius, const std::string computeShaderKey) :
     _computeProgramId(0),
     _totalParticles(0),
     _unifLocMaxParticles(-1),
     _unifLocMaxNodes(-1),
+    _unifLocNumActiveNodes(-1),
     _unifLocInverseDeltaTimeSec(-1),
-    _unifLoctParticleRegionCenter(-1)
+    _unifLoctParticleRegionCenter(-1),
+    _unifLocParticleRegionRadius(-1),
+    _unifLocGridCellsPerSide(-1),
+    _unifLocUseParticleLeafIndices(-1),
+    _unifLocUseActiveParticleIndices(-1),
+    _unifLocResolveUseActiveParticleIndices(-1),
+    _resolveProgramId(0),
+    _pActiveParticleBuffer(0),
+    _gpuTimer(PROFILER_STAGE_GPU_COLLIDE)
 {
     _totalParticles = maxParticles;
 
@@ -29,8 +44,13 @@ ComputeControllerParticleCollisions::ComputeControllerParticleCollisions(unsigne
 
     _unifLocMaxParticles = shaderStorageRef.GetUniformLocation(computeShaderKey, "uMaxParticles");
     _unifLocMaxNodes = shaderStorageRef.GetUniformLocation(computeShaderKey, "uMaxNodes");
+    _unifLocNumActiveNodes = shaderStorageRef.GetUniformLocation(computeShaderKey, "uNumActiveNodes");
     _unifLocInverseDeltaTimeSec = shaderStorageRef.GetUniformLocation(computeShaderKey, "uInverseDeltaTimeSec");
     _unifLoctParticleRegionCenter = shaderStorageRef.GetUniformLocation(computeShaderKey, "uParticleRegionCenter");
+    _unifLocParticleRegionRadius = shaderStorageRef.GetUniformLocation(computeShaderKey, "uParticleRegionRadius");
+    _unifLocGridCellsPerSide = shaderStorageRef.GetUniformLocation(computeShaderKey, "uGridCellsPerSide");
+    _unifLocUseParticleLeafIndices = shaderStorageRef.GetUniformLocation(computeShaderKey, "uUseParticleLeafIndices");
+    _unifLocUseActiveParticleIndices = shaderStorageRef.GetUniformLocation(computeShaderKey, "uUseActiveParticleIndices");
     
 
     _computeProgramId = shaderStorageRef.GetShaderProgram(computeShaderKey);
@@ -40,23 +60,123 @@ ComputeControllerParticleCollisions::ComputeControllerParticleCollisions(unsigne
     // uniform initialization
     glUniform1ui(_unifLocMaxParticles, maxParticles);
     glUniform1ui(_unifLocMaxNodes, maxNodes);
+    glUniform1ui(_unifLocNumActiveNodes, 0);
     glUniform4fv(_unifLoctParticleRegionCenter, 1, glm::value_ptr(particleRegionCenter));
+    glUniform1f(_unifLocParticleRegionRadius, particleRegionRadius);
+    glUniform1ui(_unifLocGridCellsPerSide, 0);
+    glUniform1ui(_unifLocUseParticleLeafIndices, 0);
+    glUniform1ui(_unifLocUseActiveParticleIndices, 0);
 
-    // the "inverse delta time" uniform will be uploaded in Update(...)
+    // the "inverse delta time" and "number of active nodes" uniforms will be uploaded in 
+    // Update(...)
 
     glUseProgram(0);
 }
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Dispatches the shader.  
+    Only the uniform grid's shaders use this (see ParticleCollisionsGrid.comp).  The grid's 
+    size doesn't change, so this is only needed once, but it is not known until the grid is 
+    made, so it isn't a constructor argument.  Until then the shader finds no collisions.
+Parameters: 
+    gridCellsPerSide    See ParticleUniformGrid::CellsPerSide().
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ComputeControllerParticleCollisions::SetGridCellsPerSide(unsigned int gridCellsPerSide)
+{
+    glUseProgram(_computeProgramId);
+    glUniform1ui(_unifLocGridCellsPerSide, gridCellsPerSide);
+    glUseProgram(0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The symmetric collision shaders (see ParticleCollisionsGridSymmetric.comp) leave the 
+    forces in a CollisionForceSsbo, and this shader (ParticleCollisionsResolve.comp) adds 
+    them to the particles.  Once it is set, Update(...) dispatches it after the collision 
+    shader.
+Parameters: 
+    resolveShaderKey    Used to look up the shader's uniform and program ID.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ComputeControllerParticleCollisions::SetForceResolveShader(const std::string &resolveShaderKey)
+{
+    ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+    _resolveProgramId = shaderStorageRef.GetShaderProgram(resolveShaderKey);
+
+    glUseProgram(_resolveProgramId);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(resolveShaderKey, "uMaxParticles"), _totalParticles);
+    _unifLocResolveUseActiveParticleIndices = shaderStorageRef.GetUniformLocation(resolveShaderKey, "uUseActiveParticleIndices");
+    glUniform1ui(_unifLocResolveUseActiveParticleIndices, (_pActiveParticleBuffer != 0) ? 1 : 0);
+    glUseProgram(0);
+}
 
-    The number of work groups is based on the maximum number of particles.
-Parameters: None
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Only the ParticleQuadTreeNode shaders use this (see FindLeafNode(...) in 
+    ParticleCollisions.comp).  If true, each particle starts from the leaf in the 
+    ParticleLeafIndexSsbo instead of walking the tree from the root.  It is set every time 
+    that a tree is uploaded, so a tree that came without leaf indices is walked.
+Parameters: 
+    useParticleLeafIndices  Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ComputeControllerParticleCollisions::SetUseParticleLeafIndices(bool useParticleLeafIndices)
+{
+    glUseProgram(_computeProgramId);
+    glUniform1ui(_unifLocUseParticleLeafIndices, useParticleLeafIndices ? 1 : 0);
+    glUseProgram(0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    If given a buffer, Update(...) dispatches the collision shader, and the force resolve 
+    shader if there is one, once for each particle in that buffer's active particle list 
+    instead of once for every particle (see ComputeControllerActiveParticleCompaction).
+
+    Note: The resolve shader only has forces for particles that collided, and a particle 
+    that collided was active when the list was made, so it is safe for the resolve shader to 
+    skip the rest.
+Parameters: 
+    pActiveParticleBuffer   Not owned.  0 to go back to going over every particle.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ComputeControllerParticleCollisions::SetActiveParticleBuffer(const ActiveParticleSsbo *pActiveParticleBuffer)
+{
+    _pActiveParticleBuffer = pActiveParticleBuffer;
+    GLuint useActiveParticleIndices = (pActiveParticleBuffer != 0) ? 1 : 0;
+
+    glUseProgram(_computeProgramId);
+    glUniform1ui(_unifLocUseActiveParticleIndices, useActiveParticleIndices);
+    if (_resolveProgramId != 0)
+    {
+        glUseProgram(_resolveProgramId);
+        glUniform1ui(_unifLocResolveUseActiveParticleIndices, useActiveParticleIndices);
+    }
+    glUseProgram(0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Dispatches the shader, and then the force resolve shader if there is one (see 
+    SetForceResolveShader(...)).  
+
+    The number of work groups is based on the maximum number of particles, or, if there is an 
+    active particle buffer, on the number of active particles, which the GPU supplies itself.
+Parameters: 
+    deltaTimeSec    Self-explanatory
+    numActiveNodes  How many nodes (or grid cells) were uploaded (see 
+                    QuadTreeNodeSsbo::UploadNodes(...), CompactQuadTreeSsbo::UploadTree(...), 
+                    and UniformGridSsbo::UploadGrid(...)).  
+                    The shader treats the rest as empty.
 Returns:    None
 Creator:    John Cox (1-21-2017)
 -----------------------------------------------------------------------------------------------*/
-void ComputeControllerParticleCollisions::Update(float deltaTimeSec)
+void ComputeControllerParticleCollisions::Update(float deltaTimeSec, unsigned int numActiveNodes)
 {
     // calculate the number of work groups and start the magic
     GLuint numWorkGroupsX = (_totalParticles / 256) + 1;
@@ -76,11 +196,48 @@ void ComputeControllerParticleCollisions::Update(float deltaTimeSec)
     // with a multiply.
     float inverseDeltaTime = 1.0f / deltaTimeSec;
     glUniform1f(_unifLocInverseDeltaTimeSec, inverseDeltaTime);
-
-    glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+    glUniform1ui(_unifLocNumActiveNodes, numActiveNodes);
+
+    // the resolve pass is part of the collisions, so it is timed with them
+    _gpuTimer.Begin();
+    if (_pActiveParticleBuffer != 0)
+    {
+        _pActiveParticleBuffer->DispatchIndirect();
+    }
+    else
+    {
+        glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+    }
     glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+
+    if (_resolveProgramId != 0)
+    {
+        glUseProgram(_resolveProgramId);
+        if (_pActiveParticleBuffer != 0)
+        {
+            _pActiveParticleBuffer->DispatchIndirect();
+        }
+        else
+        {
+            glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+        }
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+    }
+    _gpuTimer.End();
     glUseProgram(0);
 
 }
 
-
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Starts timing the dispatches on the GPU (see GpuDispatchTimer).
+Parameters:
+    pBackend    Not owned.  0 to stop timing.
+    pProfiler   Not owned.  The times go to its PROFILER_STAGE_GPU_COLLIDE stage.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ComputeControllerParticleCollisions::EnableGpuTiming(IGpuTimerBackend *pBackend, FrameProfiler *pProfiler)
+{
+    _gpuTimer.Enable(pBackend, pProfiler);
+}
@@ -2,6 +2,9 @@
 
 #include <string>
 #include "glm/vec4.hpp"
+#include "GpuDispatchTimer.h"
+
+class ActiveParticleSsbo;
 
 
 /*-----------------------------------------------------------------------------------------------
@@ -14,11 +17,16 @@ Creator:    John Cox (1-21-2017)
 class ComputeControllerParticleCollisions
 {
 public:
-    ComputeControllerParticleCollisions(unsigned int maxParticles, unsigned int maxNodes, const glm::vec4 &particleRegionCenter, const std::string computeShaderKey);
+    ComputeControllerParticleCollisions(unsigned int maxParticles, unsigned int maxNodes, const glm::vec4 &particleRegionCenter, float particleRegionRadius, const std::string computeShaderKey);
 
     // no destructor because there are no buffers that need to be destroyed
 
-    void Update(float deltaTimeSec);
+    void SetGridCellsPerSide(unsigned int gridCellsPerSide);
+    void SetForceResolveShader(const std::string &resolveShaderKey);
+    void SetUseParticleLeafIndices(bool useParticleLeafIndices);
+    void SetActiveParticleBuffer(const ActiveParticleSsbo *pActiveParticleBuffer);
+    void Update(float deltaTimeSec, unsigned int numActiveNodes);
+    void EnableGpuTiming(IGpuTimerBackend *pBackend, FrameProfiler *pProfiler);
 
 private:
     unsigned int _computeProgramId;
@@ -26,7 +34,22 @@ private:
 
     int _unifLocMaxParticles;
     int _unifLocMaxNodes;
+    int _unifLocNumActiveNodes;
     int _unifLocInverseDeltaTimeSec;
     int _unifLoctParticleRegionCenter;
+    int _unifLocParticleRegionRadius;
+    int _unifLocGridCellsPerSide;
+    int _unifLocUseParticleLeafIndices;
+    int _unifLocUseActiveParticleIndices;
+    int _unifLocResolveUseActiveParticleIndices;
+
+    // 0 unless the collision shader is a symmetric one
+    unsigned int _resolveProgramId;
+
+    // not owned; 0 unless the shaders go over the active particle list
+    const ActiveParticleSsbo *_pActiveParticleBuffer;
+
+    // does nothing until EnableGpuTiming(...)
+    GpuDispatchTimer _gpuTimer;
 };
 
@@ -1,19 +1,16 @@
 #include "ComputeControllerParticleReset.h"
 
 #include "ShaderStorage.h"
+#include "ParticleEmitterSsbo.h"
 
 #include "glload/include/glload/gl_4_4.h"
-#include "glm/gtc/type_ptr.hpp"
-
-// for starting up the atomic counter for the compute shader's rand hash
-#include <random>
-#include <time.h>
 
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Generates atomic counters for use in the "particle reset" compute shader.
+    Generates the atomic counter for use in the "particle reset" compute shader.
     Looks up all uniforms in the compute shader.
+    Makes the emitter buffer and binds it to the compute shader's "ParticleEmitterBuffer".
 
     Note: This constructor takes a string key for the compute shader instead of a program ID 
     because the shader storage object, which is responsible for finding uniforms, takes a shader 
@@ -25,7 +22,12 @@ Returns:    None
 Creator:    John Cox (11-24-2016)
 -----------------------------------------------------------------------------------------------*/
 ComputeControllerParticleReset::ComputeControllerParticleReset(unsigned int numParticles, 
-    const std::string &computeShaderKey)
+    const std::string &computeShaderKey) :
+    _useParticleFreeList(false),
+    _frameNumber(0),
+    _pEmitterBuffer(0),
+    _emitterBufferIsCurrent(false),
+    _gpuTimer(PROFILER_STAGE_GPU_RESET)
 {
     _totalParticleCount = numParticles;
     ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
@@ -33,39 +35,41 @@ ComputeControllerParticleReset::ComputeControllerParticleReset(unsigned int numP
     // find the uniforms in the "reset" compute shader
     _unifLocParticleCount = shaderStorageRef.GetUniformLocation(computeShaderKey, "uMaxParticleCount");
     _unifLocMaxParticleEmitCount = shaderStorageRef.GetUniformLocation(computeShaderKey, "uMaxParticleEmitCount");
-    _unifLocMinParticleVelocity = shaderStorageRef.GetUniformLocation(computeShaderKey, "uMinParticleVelocity");
-    _unifLocDeltaParticleVelocity = shaderStorageRef.GetUniformLocation(computeShaderKey, "uDeltaParticleVelocity");
-    _unifLocUsePointEmitter = shaderStorageRef.GetUniformLocation(computeShaderKey, "uUsePointEmitter");
-    _unifLocPointEmitterCenter = shaderStorageRef.GetUniformLocation(computeShaderKey, "uPointEmitterCenter");
-    _unifLocBarEmitterP1 = shaderStorageRef.GetUniformLocation(computeShaderKey, "uBarEmitterP1");
-    _unifLocBarEmitterP2 = shaderStorageRef.GetUniformLocation(computeShaderKey, "uBarEmitterP2");
-    _unifLocBarEmitterEmitDir = shaderStorageRef.GetUniformLocation(computeShaderKey, "uBarEmitterEmitDir");
-
-    // now set up the atomic counters
+    _unifLocNumEmitters = shaderStorageRef.GetUniformLocation(computeShaderKey, "uNumEmitters");
+    _unifLocUseParticleFreeList = shaderStorageRef.GetUniformLocation(computeShaderKey, "uUseParticleFreeList");
+    _unifLocRandomSeed = shaderStorageRef.GetUniformLocation(computeShaderKey, "uRandomSeed");
+    _unifLocFrameNumber = shaderStorageRef.GetUniformLocation(computeShaderKey, "uFrameNumber");
+
+    // now set up the atomic counter
     _computeProgramId = shaderStorageRef.GetShaderProgram(computeShaderKey);
 
     glUseProgram(_computeProgramId);
 
     // the program in which this uniform is located must be bound in order to set the value
     glUniform1ui(_unifLocParticleCount, numParticles);
+    glUniform1ui(_unifLocUseParticleFreeList, 0);
+    glUniform1ui(_unifLocNumEmitters, 0);
+    glUniform1ui(_unifLocRandomSeed, 0);
+
+    _pEmitterBuffer = new ParticleEmitterSsbo();
+    _pEmitterBuffer->ConfigureCompute(_computeProgramId, "ParticleEmitterBuffer");
 
     // atomic counter initialization courtesy of geeks3D (and my use of glBufferData(...) 
     // instead of glMapBuffer(...) and atomic counter arrays courtesy of lighthouse3d
     // http://www.geeks3d.com/20120309/opengl-4-2-atomic-counter-demo-rendering-order-of-fragments/
     // http://www.lighthouse3d.com/tutorials/opengl-atomic-counters/
 
-    // allocate space for both atomic counters, but don't bother giving them data until 
+    // allocate space for the atomic counter, but don't bother giving it data until 
     // ResetParticles(...)
     glGenBuffers(1, &_atomicCounterBufferId);
     glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, _atomicCounterBufferId);
-    glBufferData(GL_ATOMIC_COUNTER_BUFFER, sizeof(GLuint) * 2, 0, GL_DYNAMIC_DRAW);
+    glBufferData(GL_ATOMIC_COUNTER_BUFFER, sizeof(GLuint), 0, GL_DYNAMIC_DRAW);
     glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
 
-    // both atomic counters are in the same buffer, and they are 32bit unsigned integers, so 
-    // they are 4 bytes apart
-    srand(static_cast<unsigned int>(time(nullptr)));
+    // Note: The random numbers used to come from a second atomic counter that was seeded with 
+    // rand() every frame.  Now they are keyed by the seed and the frame number (see 
+    // SetRandomSeed(...)), so the same seed always gives the same particles.
     _acParticleCounterOffset = 0;
-    _acRandSeedOffset = 4;
 
     glUseProgram(_computeProgramId);
 
@@ -86,17 +90,17 @@ Creator:    John Cox (11-24-2016)
 ComputeControllerParticleReset::~ComputeControllerParticleReset()
 {
     glDeleteBuffers(1, &_atomicCounterBufferId);
+    delete _pEmitterBuffer;
 }
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Adds a point emitter to internal storage.  This is used to initialize particles.  If there 
-    multiple emitters, then the update will need to perform multiple calls to the compute 
-    shader, each with different emitter information.
+    Adds a point emitter to internal storage.  This is used to initialize particles.  All the 
+    emitters are in one table (see ParticleEmitterTable::AddEmitter(...)), and the table is 
+    uploaded again on the next reset, so there is no limit on how many there are.
 
     If, for some reason, the particle emitter cannot be cast to either a point emitter or a bar 
-    emitter, then the emitter will not be added to either particle emitter collection and 
-    "false" is returned. 
+    emitter, then the emitter will not be added and "false" is returned. 
 
     Note: Particles are evenly split between all emitters.
 Parameters:
@@ -107,39 +111,79 @@ Creator:    John Cox (9-18-2016)    (created prior to this class in an earlier d
 -----------------------------------------------------------------------------------------------*/
 bool ComputeControllerParticleReset::AddEmitter(const IParticleEmitter *pEmitter)
 {
-    const ParticleEmitterPoint *pointEmitter =
-        dynamic_cast<const ParticleEmitterPoint *>(pEmitter);
-    const ParticleEmitterBar *barEmitter =
-        dynamic_cast<const ParticleEmitterBar *>(pEmitter);
-
-    if (pointEmitter != 0 && (_pointEmitters.size() < MAX_EMITTERS))
+    if (!_emitterTable.AddEmitter(pEmitter))
     {
-        _pointEmitters.push_back(pointEmitter);
-        return true;
-    }
-    else if (barEmitter != 0 && (_barEmitters.size() < MAX_EMITTERS))
-    {
-        _barEmitters.push_back(barEmitter);
-        return true;
+        return false;
     }
 
-    return false;
+    _emitterBufferIsCurrent = false;
+    return true;
 }
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Resets the atomic counters and dispatches the shader.
+    If true, the reset shader takes the particles that it emits off of a ParticleFreeListSsbo 
+    instead of going through every particle to find inactive ones, so the dispatch is only as 
+    big as the number of particles that the emitters may emit.  The update shader must be 
+    told the same thing (see ComputeControllerParticleUpdate::SetUseParticleFreeList(...)) 
+    so that it fills the free list back up.
+
+    Note: The free list only knows about the particles that have been put in it, so this 
+    must be set before the first reset and never turned off and back on again.
+Parameters:
+    useParticleFreeList     Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ComputeControllerParticleReset::SetUseParticleFreeList(bool useParticleFreeList)
+{
+    _useParticleFreeList = useParticleFreeList;
+
+    glUseProgram(_computeProgramId);
+    glUniform1ui(_unifLocUseParticleFreeList, useParticleFreeList ? 1 : 0);
+    glUseProgram(0);
+}
 
-    The number of work groups is based on the maximum number of particles.
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets the seed of the reset shader's random numbers and starts the frame count over.  The 
+    random numbers are a hash of the seed, the frame, and the particle's index (see 
+    RandomOnRange0To1() in particleReset.comp), so two runs with the same seed emit the same 
+    particles, and so does a SimulationEngine with the same seed (see 
+    SimulationEngine::SetRandomSeed(...)).
+Parameters:
+    randomSeed  0 (the default) or anything else.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ComputeControllerParticleReset::SetRandomSeed(unsigned int randomSeed)
+{
+    _frameNumber = 0;
+
+    glUseProgram(_computeProgramId);
+    glUniform1ui(_unifLocRandomSeed, randomSeed);
+    glUseProgram(0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Resets the atomic counter and dispatches the shader once for all the emitters.  If an 
+    emitter was added since the last reset, the emitter table is uploaded first.
+
+    The number of work groups is based on the maximum number of particles, or, with the free 
+    list, on the number of particles that all the emitters together may emit.
 
     All the particle emitters reset particles to that emitter's location (up to a limit).
 
     Particles are spread out evenly between all the emitters (or at least as best as possible; 
     technically the first emitter emitter gets first dibs at the inactive particles, then the 
-    second emitter gets second dibs, etc.).  This caused some trouble because successive calls 
-    to the compute shader in the same frame caused many particles to have their positions 
-    updated more than once.  To solve this, the compute shader was split into two major 
-    sections: 
+    second emitter gets second dibs, etc.).  This used to be one dispatch per emitter, with a 
+    barrier after each so that successive dispatches didn't reset the same particles, which 
+    cost a barrier and a handful of uniform uploads for every emitter.  Now each particle 
+    that is reset takes a number from the particle counter, and the first 
+    particlesPerEmitterPerFrame numbers go to the first emitter in the table, the next 
+    particlesPerEmitterPerFrame to the second, and so on until every emitter has had its 
+    share.
 Parameters:    
     particlesPerEmitterPerFrame        Limits the number of particles that are reset per frame so 
     that they don't all spawn at once.
@@ -149,80 +193,80 @@ Creator:    John Cox (10-10-2016)
 -----------------------------------------------------------------------------------------------*/
 void ComputeControllerParticleReset::ResetParticles(unsigned int particlesPerEmitterPerFrame)
 {
-    if (_pointEmitters.empty() && _barEmitters.empty())
+    // every call is a frame, even one with nothing to do, so that the frames line up with 
+    // SimulationEngine::ResetParticles(...)
+    _frameNumber++;
+
+    unsigned int numEmitters = _emitterTable.NumEmitters();
+    if (numEmitters == 0 || particlesPerEmitterPerFrame == 0)
     {
         // nothing to do
         return;
     }
 
+    glUseProgram(_computeProgramId);
+
+    if (!_emitterBufferIsCurrent)
+    {
+        _pEmitterBuffer->Upload(_emitterTable);
+        glUniform1ui(_unifLocNumEmitters, numEmitters);
+        _emitterBufferIsCurrent = true;
+    }
+
     GLuint acResetCounterValue = 0;
-    GLuint acRandSeed = rand();
 
     // spreading the particles evenly between multiple emitters is done by letting all the 
-    // particle emitters have a go at all the inactive particles one by one, so all particles 
-    // must be considered
-    // Note: Yes, this algorithm is such that emitters resetting particles have to traverse 
-    // through the entire particle collection, but since there isn't a way of telling the CPU 
-    // where they were when the last particle was reset and since the GPU seems pretty fast on 
-    // running through the entire array, this algorithm is fine.
+    // inactive particles take a number, so all particles must be considered
+    // Note: Yes, this algorithm is such that resetting particles has to traverse through the 
+    // entire particle collection, but since there isn't a way of telling the CPU where they 
+    // were when the last particle was reset and since the GPU seems pretty fast on running 
+    // through the entire array, this algorithm is fine.
+    // Also Note: With the free list, there is a way, so only one invocation per particle that 
+    // the emitters may emit is needed.
     GLuint numWorkGroupsX = (_totalParticleCount / 256) + 1;
+    if (_useParticleFreeList)
+    {
+        numWorkGroupsX = ((numEmitters * particlesPerEmitterPerFrame) / 256) + 1;
+    }
     GLuint numWorkGroupsY = 1;
     GLuint numWorkGroupsZ = 1;
 
-    glUseProgram(_computeProgramId);
-
     glUniform1ui(_unifLocMaxParticleEmitCount, particlesPerEmitterPerFrame);
+    glUniform1ui(_unifLocFrameNumber, _frameNumber);
     glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, _atomicCounterBufferId);
 
-    // give the rand seed some variance from the last frame
-    glBufferSubData(GL_ATOMIC_COUNTER_BUFFER, _acRandSeedOffset, sizeof(GLuint), &acRandSeed);
-
-    // give all point emitters a chance to reactivate inactive particles at their positions
-    glUniform1ui(_unifLocUsePointEmitter, 1);
-    for (size_t pointEmitterCount = 0; pointEmitterCount < _pointEmitters.size(); pointEmitterCount++)
-    {
-        // reset everything necessary to control the emission parameters for this emitter
-        glBufferSubData(GL_ATOMIC_COUNTER_BUFFER, _acParticleCounterOffset, sizeof(GLuint), (void *)&acResetCounterValue);
-
-        const ParticleEmitterPoint *emitter = _pointEmitters[pointEmitterCount];
-        glUniform1f(_unifLocMinParticleVelocity, emitter->GetMinVelocity());
-        glUniform1f(_unifLocDeltaParticleVelocity, emitter->GetDeltaVelocity());
-        glUniform4fv(_unifLocPointEmitterCenter, 1, glm::value_ptr(emitter->GetPos()));
-
-        // compute ALL the resets!
-        glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
-
-        // tell the GPU:
-        // (1) Accesses to the shader buffer after this call will reflect writes prior to the 
-        // barrier.  This is only available in OpenGL 4.3 or higher.
-        // (2) Vertex data sourced from buffer objects after the barrier will reflect data 
-        // written by shaders prior to the barrier.  The affected buffer(s) is determined by the 
-        // buffers that were bound for the vertex attributes.  In this case, that means 
-        // GL_ARRAY_BUFFER.
-        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
-    }
-
-    // repeat for any bar emitters
-    glUniform1ui(_unifLocUsePointEmitter, 0);
-    for (size_t barEmitterCount = 0; barEmitterCount < _barEmitters.size(); barEmitterCount++)
-    {
-        glBufferSubData(GL_ATOMIC_COUNTER_BUFFER, _acParticleCounterOffset, sizeof(GLuint), (void *)&acResetCounterValue);
+    // start the count over
+    glBufferSubData(GL_ATOMIC_COUNTER_BUFFER, _acParticleCounterOffset, sizeof(GLuint), (void *)&acResetCounterValue);
 
-        const ParticleEmitterBar *emitter = _barEmitters[barEmitterCount];
-        glUniform1f(_unifLocMinParticleVelocity, emitter->GetMinVelocity());
-        glUniform1f(_unifLocDeltaParticleVelocity, emitter->GetDeltaVelocity());
+    // compute ALL the resets!
+    _gpuTimer.Begin();
+    glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
 
-        // each bar needs to upload three vectors (p1, p2, and emit direction)
-        glUniform4fv(_unifLocBarEmitterP1, 1, glm::value_ptr(emitter->GetBarStart()));
-        glUniform4fv(_unifLocBarEmitterP2, 1, glm::value_ptr(emitter->GetBarEnd()));
-        glUniform4fv(_unifLocBarEmitterEmitDir, 1, glm::value_ptr(emitter->GetEmitDir()));
-
-        // MOAR resets!
-        glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
-        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
-    }
+    // tell the GPU:
+    // (1) Accesses to the shader buffer after this call will reflect writes prior to the 
+    // barrier.  This is only available in OpenGL 4.3 or higher.
+    // (2) Vertex data sourced from buffer objects after the barrier will reflect data 
+    // written by shaders prior to the barrier.  The affected buffer(s) is determined by the 
+    // buffers that were bound for the vertex attributes.  In this case, that means 
+    // GL_ARRAY_BUFFER.
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+    _gpuTimer.End();
 
     // cleanup
     glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
     glUseProgram(0);
 }
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Starts timing the dispatches on the GPU (see GpuDispatchTimer).
+Parameters:
+    pBackend    Not owned.  0 to stop timing.
+    pProfiler   Not owned.  The times go to its PROFILER_STAGE_GPU_RESET stage.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ComputeControllerParticleReset::EnableGpuTiming(IGpuTimerBackend *pBackend, FrameProfiler *pProfiler)
+{
+    _gpuTimer.Enable(pBackend, pProfiler);
+}
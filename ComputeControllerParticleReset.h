@@ -1,10 +1,11 @@
 #pragma once
 
 #include "IParticleEmitter.h"
-#include "ParticleEmitterPoint.h"
-#include "ParticleEmitterBar.h"
+#include "ParticleEmitterTable.h"
 #include <string>
-#include <vector>
+#include "GpuDispatchTimer.h"
+
+class ParticleEmitterSsbo;
 
 /*-----------------------------------------------------------------------------------------------
 Description:
@@ -18,6 +19,10 @@ Description:
 
     Note: When this class goes "poof", it won't delete the emitter pointers.  This is ensured by
     only using const pointers.
+
+    Also Note: The emitters are copied into a ParticleEmitterTable and uploaded to a
+    ParticleEmitterSsbo that this class owns, so one dispatch resets particles for all of
+    them.
 Creator:    John Cox (11-24-2016)
 -----------------------------------------------------------------------------------------------*/
 class ComputeControllerParticleReset
@@ -27,46 +32,54 @@ public:
     ~ComputeControllerParticleReset();
 
     bool AddEmitter(const IParticleEmitter *pEmitter);
+    void SetUseParticleFreeList(bool useParticleFreeList);
+    void SetRandomSeed(unsigned int randomSeed);
 
     void ResetParticles(unsigned int particlesPerEmitterPerFrame);
+    void EnableGpuTiming(IGpuTimerBackend *pBackend, FrameProfiler *pProfiler);
 
 private:
+    // the emitter buffer would be deleted twice
+    ComputeControllerParticleReset(const ComputeControllerParticleReset &) = delete;
+    ComputeControllerParticleReset &operator=(const ComputeControllerParticleReset &) = delete;
+
     unsigned int _totalParticleCount;
     unsigned int _computeProgramId;
 
+    // see SetUseParticleFreeList(...)
+    bool _useParticleFreeList;
+
+    // the random numbers are keyed by this, counting from 1 since the last 
+    // SetRandomSeed(...) (see RandomOnRange0To1() in particleReset.comp)
+    unsigned int _frameNumber;
+
     //unsigned int _acParticleCounterBufferId;
-    //unsigned int _acRandSeedBufferId;
 
-    // the atomic counters are both in a single buffer
+    // the atomic counter has a buffer to itself
     unsigned int _atomicCounterBufferId;
 
     // this the atomic counter is used to enforce the number of emitted particles per emitter 
-    // per frame 
+    // per frame; it counts for all the emitters at once, and each run of 
+    // particlesPerEmitterPerFrame counts goes to the next emitter in the table
     unsigned int _acParticleCounterOffset;
 
-    // another atomic counter is used as a seed for the random hash
-    // Note: Rather than needing to seed the position and velocity as I did in the 
-    // "single emitter" project, use an atomic counter.  If it reaches maximum unsigned int, 
-    // that is ok.  The value will wrap around to 0 and begin again.  
-    unsigned int _acRandSeedOffset;
-
     // unlike most OpenGL IDs, uniform locations are GLint
     int _unifLocParticleCount;
     int _unifLocMaxParticleEmitCount;
-    int _unifLocMinParticleVelocity;
-    int _unifLocDeltaParticleVelocity;
-    int _unifLocUsePointEmitter;
-    int _unifLocPointEmitterCenter;
-    int _unifLocBarEmitterP1;
-    int _unifLocBarEmitterP2;
-    int _unifLocBarEmitterEmitDir;
-
-    // all the updating heavy lifting goes on in the compute shader, so CPU cache coherency is 
-    // not a concern for emitter storage on the CPU side and a std::vector<...> is acceptable
-    // Note: The compute shader has no concept of inheritance.  Rather than store a single 
-    // collection of IParticleEmitter pointers and cast them to either point or bar emitters on 
-    // every update, just store them separately.
-    static const int MAX_EMITTERS = 4;
-    std::vector<const ParticleEmitterPoint *> _pointEmitters;
-    std::vector<const ParticleEmitterBar *> _barEmitters;
+    int _unifLocNumEmitters;
+    int _unifLocUseParticleFreeList;
+    int _unifLocRandomSeed;
+    int _unifLocFrameNumber;
+
+    // all the updating heavy lifting goes on in the compute shader, so the emitters only 
+    // need to be on the GPU once
+    // Note: The compute shader has no concept of inheritance, so the table flattens point and 
+    // bar emitters into one structure.  It is uploaded by the first ResetParticles(...) after 
+    // an emitter is added.
+    ParticleEmitterTable _emitterTable;
+    ParticleEmitterSsbo *_pEmitterBuffer;
+    bool _emitterBufferIsCurrent;
+
+    // does nothing until EnableGpuTiming(...)
+    GpuDispatchTimer _gpuTimer;
 };
@@ -1,6 +1,7 @@
 #include "ComputeControllerParticleUpdate.h"
 
 #include "ShaderStorage.h"
+#include "ActiveParticleSsbo.h"
 #include "glload/include/glload/gl_4_4.h"
 #include "glm/gtc/type_ptr.hpp"
 
@@ -25,12 +26,16 @@ ComputeControllerParticleUpdate::ComputeControllerParticleUpdate(unsigned int nu
     _totalParticleCount(0),
     _activeParticleCount(0),
     _computeProgramId(0),
+    _pActiveParticleBuffer(0),
     _acParticleCounterBufferId(0),
     _acParticleCounterCopyBufferId(0),
     _unifLocParticleCount(-1),
     _unifLocParticleRegionCenter(-1),
     _unifLocParticleRegionRadiusSqr(-1),
-    _unifLocDeltaTimeSec(-1)
+    _unifLocDeltaTimeSec(-1),
+    _unifLocUseActiveParticleIndices(-1),
+    _unifLocUseParticleFreeList(-1),
+    _gpuTimer(PROFILER_STAGE_GPU_UPDATE)
 {
     _totalParticleCount = numParticles;
 
@@ -40,6 +45,8 @@ ComputeControllerParticleUpdate::ComputeControllerParticleUpdate(unsigned int nu
     _unifLocParticleRegionCenter = shaderStorageRef.GetUniformLocation(computeShaderKey, "uParticleRegionCenter");
     _unifLocParticleRegionRadiusSqr = shaderStorageRef.GetUniformLocation(computeShaderKey, "uParticleRegionRadiusSqr");
     _unifLocDeltaTimeSec = shaderStorageRef.GetUniformLocation(computeShaderKey, "uDeltaTimeSec");
+    _unifLocUseActiveParticleIndices = shaderStorageRef.GetUniformLocation(computeShaderKey, "uUseActiveParticleIndices");
+    _unifLocUseParticleFreeList = shaderStorageRef.GetUniformLocation(computeShaderKey, "uUseParticleFreeList");
 
     _computeProgramId = shaderStorageRef.GetShaderProgram(computeShaderKey);
 
@@ -48,6 +55,8 @@ ComputeControllerParticleUpdate::ComputeControllerParticleUpdate(unsigned int nu
     glUniform1ui(_unifLocParticleCount, numParticles);
     glUniform4fv(_unifLocParticleRegionCenter, 1, glm::value_ptr(particleRegionCenter));
     glUniform1f(_unifLocParticleRegionRadiusSqr, particleRegionRadius * particleRegionRadius);
+    glUniform1ui(_unifLocUseActiveParticleIndices, 0);
+    glUniform1ui(_unifLocUseParticleFreeList, 0);
     // delta time set in Update(...)
 
     // atomic counter initialization courtesy of geeks3D (and my use of glBufferData(...) 
@@ -96,11 +105,48 @@ ComputeControllerParticleUpdate::~ComputeControllerParticleUpdate()
     glDeleteBuffers(1, &_acParticleCounterCopyBufferId);
 }
 
+/*-----------------------------------------------------------------------------------------------
+Description:
+    If given a buffer, Update(...) dispatches the shader once for each particle in that 
+    buffer's active particle list instead of once for every particle (see 
+    ComputeControllerActiveParticleCompaction).  The list must be made after the particles 
+    are reset and before they are updated.
+Parameters: 
+    pActiveParticleBuffer   Not owned.  0 to go back to going over every particle.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ComputeControllerParticleUpdate::SetActiveParticleBuffer(const ActiveParticleSsbo *pActiveParticleBuffer)
+{
+    _pActiveParticleBuffer = pActiveParticleBuffer;
+
+    glUseProgram(_computeProgramId);
+    glUniform1ui(_unifLocUseActiveParticleIndices, (pActiveParticleBuffer != 0) ? 1 : 0);
+    glUseProgram(0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    If true, the shader pushes every particle that it deactivates onto the ParticleFreeListSsbo 
+    (see ComputeControllerParticleReset::SetUseParticleFreeList(...)).
+Parameters: 
+    useParticleFreeList     Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ComputeControllerParticleUpdate::SetUseParticleFreeList(bool useParticleFreeList)
+{
+    glUseProgram(_computeProgramId);
+    glUniform1ui(_unifLocUseParticleFreeList, useParticleFreeList ? 1 : 0);
+    glUseProgram(0);
+}
+
 /*-----------------------------------------------------------------------------------------------
 Description:
     Resets the atomic counter and dispatches the shader.
     
-    The number of work groups is based on the maximum number of particles.
+    The number of work groups is based on the maximum number of particles, or, if there is an 
+    active particle buffer, on the number of active particles, which the GPU supplies itself.
 Parameters:    
     deltaTimeSec    Self-explanatory
 Returns:    None
@@ -121,8 +167,17 @@ void ComputeControllerParticleUpdate::Update(const float deltaTimeSec)
     glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, _acParticleCounterBufferId);
     unsigned int atomicCounterResetValue = 0;
     glBufferSubData(GL_ATOMIC_COUNTER_BUFFER, 0, sizeof(GLuint), (void *)&atomicCounterResetValue);
-    glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+    _gpuTimer.Begin();
+    if (_pActiveParticleBuffer != 0)
+    {
+        _pActiveParticleBuffer->DispatchIndirect();
+    }
+    else
+    {
+        glDispatchCompute(numWorkGroupsX, numWorkGroupsY, numWorkGroupsZ);
+    }
     glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ATOMIC_COUNTER_BARRIER_BIT);
+    _gpuTimer.End();
 
     // cleanup
     glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
@@ -157,3 +212,17 @@ unsigned int ComputeControllerParticleUpdate::NumActiveParticles() const
 {
     return _activeParticleCount;
 }
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Starts timing the dispatches on the GPU (see GpuDispatchTimer).
+Parameters:
+    pBackend    Not owned.  0 to stop timing.
+    pProfiler   Not owned.  The times go to its PROFILER_STAGE_GPU_UPDATE stage.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ComputeControllerParticleUpdate::EnableGpuTiming(IGpuTimerBackend *pBackend, FrameProfiler *pProfiler)
+{
+    _gpuTimer.Enable(pBackend, pProfiler);
+}
@@ -2,6 +2,9 @@
 
 #include <string>
 #include "glm/vec4.hpp"
+#include "GpuDispatchTimer.h"
+
+class ActiveParticleSsbo;
 
 /*-----------------------------------------------------------------------------------------------
 Description:
@@ -25,14 +28,20 @@ public:
         const float particleRegionRadius, const std::string &computeShaderKey);
     ~ComputeControllerParticleUpdate();
 
+    void SetActiveParticleBuffer(const ActiveParticleSsbo *pActiveParticleBuffer);
+    void SetUseParticleFreeList(bool useParticleFreeList);
     void Update(const float deltaTimeSec);
     unsigned int NumActiveParticles() const;
+    void EnableGpuTiming(IGpuTimerBackend *pBackend, FrameProfiler *pProfiler);
 
 private:
     unsigned int _totalParticleCount;
     unsigned int _activeParticleCount;
     unsigned int _computeProgramId;
 
+    // not owned; 0 unless the shader goes over the active particle list
+    const ActiveParticleSsbo *_pActiveParticleBuffer;
+
     // the atomic counter is used to count the total number of active particles after this 
     // update
     // Also Note: The copy buffer is necessary to avoid trashing OpenGL's beautifully 
@@ -49,4 +58,9 @@ private:
     int _unifLocParticleRegionCenter;
     int _unifLocParticleRegionRadiusSqr;
     int _unifLocDeltaTimeSec;
+    int _unifLocUseActiveParticleIndices;
+    int _unifLocUseParticleFreeList;
+
+    // does nothing until EnableGpuTiming(...)
+    GpuDispatchTimer _gpuTimer;
 };
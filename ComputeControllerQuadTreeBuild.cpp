@@ -0,0 +1,210 @@
+#include "ComputeControllerQuadTreeBuild.h"
+
+#include "glload/include/glload/gl_4_4.h"
+#include "ShaderStorage.h"
+#include "QuadTreeBuildSsbo.h"
+#include "QuadTreeBuildEmulator.h"
+#include "CompactQuadTreeSsbo.h"
+#include "CompactParticleQuadTree.h"
+
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values.
+    Finds the uniforms for the four build shaders and gives the ones that don't change from 
+    step to step their values.  The region's edges and scale are worked out here, as in 
+    QuadTreeBuildEmulator's constructor, so that the shader's Morton keys are the same as the 
+    CPU's.
+
+    The SSBOs must already be configured for the shaders (see 
+    QuadTreeBuildSsbo::ConfigureCompute(...), CompactQuadTreeSsbo::ConfigureCompute(...), and 
+    ParticleSsbo::ConfigureCompute(...)).
+Parameters:
+    maxParticles            Tells the shaders how big the particle buffer is.
+    particleRegionCenter    Where the quad tree is.
+    particleRegionRadius    How big the quad tree is.
+    maxParticlesPerLeaf     See CompactParticleQuadTree::SetMaxParticlesPerLeaf(...).
+    pBuildBuffer            Re-bound between radix sort passes.
+    pCompactQuadTreeBuffer  The particle index pool is copied into it.
+    particlesShaderKey      QuadTreeBuildParticles.comp (or the SoA version).
+    scanShaderKey           QuadTreeBuildScan.comp
+    radixSortShaderKey      QuadTreeBuildRadixSort.comp
+    nodesShaderKey          QuadTreeBuildNodes.comp
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+ComputeControllerQuadTreeBuild::ComputeControllerQuadTreeBuild(unsigned int maxParticles, 
+    const glm::vec4 &particleRegionCenter, float particleRegionRadius, 
+    unsigned int maxParticlesPerLeaf, QuadTreeBuildSsbo *pBuildBuffer, 
+    CompactQuadTreeSsbo *pCompactQuadTreeBuffer, const std::string &particlesShaderKey, 
+    const std::string &scanShaderKey, const std::string &radixSortShaderKey, 
+    const std::string &nodesShaderKey) :
+    _maxParticles(maxParticles),
+    _pBuildBuffer(pBuildBuffer),
+    _pCompactQuadTreeBuffer(pCompactQuadTreeBuffer),
+    _particlesProgramId(0),
+    _unifLocParticlesBuildStep(-1),
+    _scanProgramId(0),
+    _unifLocScanNumSums(-1),
+    _radixSortProgramId(0),
+    _unifLocRadixSortBuildStep(-1),
+    _unifLocRadixSortKeyShift(-1),
+    _nodesProgramId(0),
+    _unifLocNodesBuildStep(-1),
+    _unifLocNodesDepth(-1),
+    _gpuTimer(PROFILER_STAGE_GPU_TREE_BUILD)
+{
+    ShaderStorage &shaderStorageRef = ShaderStorage::GetInstance();
+    GLuint particleWorkGroups = QuadTreeBuildEmulator::NumWorkGroups(maxParticles);
+
+    _particlesProgramId = shaderStorageRef.GetShaderProgram(particlesShaderKey);
+    _unifLocParticlesBuildStep = shaderStorageRef.GetUniformLocation(particlesShaderKey, "uBuildStep");
+    glUseProgram(_particlesProgramId);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(particlesShaderKey, "uMaxParticleCount"), maxParticles);
+    glUniform1f(shaderStorageRef.GetUniformLocation(particlesShaderKey, "uRegionLeft"), 
+        particleRegionCenter.x - particleRegionRadius);
+    glUniform1f(shaderStorageRef.GetUniformLocation(particlesShaderKey, "uRegionTop"), 
+        particleRegionCenter.y + particleRegionRadius);
+    glUniform1f(shaderStorageRef.GetUniformLocation(particlesShaderKey, "uCellsPerWorldUnit"), 
+        65536.0f / (2.0f * particleRegionRadius));
+
+    _scanProgramId = shaderStorageRef.GetShaderProgram(scanShaderKey);
+    _unifLocScanNumSums = shaderStorageRef.GetUniformLocation(scanShaderKey, "uNumSums");
+
+    _radixSortProgramId = shaderStorageRef.GetShaderProgram(radixSortShaderKey);
+    _unifLocRadixSortBuildStep = shaderStorageRef.GetUniformLocation(radixSortShaderKey, "uBuildStep");
+    _unifLocRadixSortKeyShift = shaderStorageRef.GetUniformLocation(radixSortShaderKey, "uKeyShift");
+    glUseProgram(_radixSortProgramId);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(radixSortShaderKey, "uNumWorkGroups"), 
+        particleWorkGroups);
+
+    _nodesProgramId = shaderStorageRef.GetShaderProgram(nodesShaderKey);
+    _unifLocNodesBuildStep = shaderStorageRef.GetUniformLocation(nodesShaderKey, "uBuildStep");
+    _unifLocNodesDepth = shaderStorageRef.GetUniformLocation(nodesShaderKey, "uDepth");
+    glUseProgram(_nodesProgramId);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(nodesShaderKey, "uMaxNodes"), 
+        CompactParticleQuadTree::MAX_NODES);
+    glUniform1ui(shaderStorageRef.GetUniformLocation(nodesShaderKey, "uMaxParticlesPerLeaf"), 
+        (maxParticlesPerLeaf > 0) ? maxParticlesPerLeaf : 1);
+
+    // the build steps and the scan's size will be uploaded in BuildTree()
+
+    glUseProgram(0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Dispatches every step of the build, in the same order and with the same number of work 
+    groups as QuadTreeBuildEmulator::Build(...), with a memory barrier after each one, and 
+    then copies the particle index pool into the compact quad tree's buffer.  When this 
+    returns, the collision shader can use the tree.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ComputeControllerQuadTreeBuild::BuildTree()
+{
+    GLuint particleWorkGroups = QuadTreeBuildEmulator::NumWorkGroups(_maxParticles);
+
+    // all three parts and the copy into the compact tree are timed together
+    _gpuTimer.Begin();
+
+    // (1) compact the active particles into the radix sort's first input
+    _pBuildBuffer->BindSortDirection(1);
+    glUseProgram(_particlesProgramId);
+    glUniform1ui(_unifLocParticlesBuildStep, QuadTreeBuildEmulator::PARTICLES_STEP_COUNT_ACTIVE);
+    glDispatchCompute(particleWorkGroups, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    DispatchScan(particleWorkGroups);
+    glUseProgram(_particlesProgramId);
+    glUniform1ui(_unifLocParticlesBuildStep, QuadTreeBuildEmulator::PARTICLES_STEP_WRITE_KEYS);
+    glDispatchCompute(particleWorkGroups, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    // (2) sort them; there is an even number of passes, so it finishes in the arrays at 0
+    for (unsigned int pass = 0; pass < QuadTreeBuildEmulator::RADIX_PASSES; pass++)
+    {
+        _pBuildBuffer->BindSortDirection(pass % 2);
+
+        glUseProgram(_radixSortProgramId);
+        glUniform1ui(_unifLocRadixSortKeyShift, pass * QuadTreeBuildEmulator::RADIX_BITS);
+        glUniform1ui(_unifLocRadixSortBuildStep, QuadTreeBuildEmulator::RADIX_SORT_STEP_COUNT);
+        glDispatchCompute(particleWorkGroups, 1, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        DispatchScan(QuadTreeBuildEmulator::RADIX_BUCKETS * particleWorkGroups);
+        glUseProgram(_radixSortProgramId);
+        glUniform1ui(_unifLocRadixSortBuildStep, QuadTreeBuildEmulator::RADIX_SORT_STEP_SCATTER);
+        glDispatchCompute(particleWorkGroups, 1, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+
+    // (3) emit the nodes from the sorted keys
+    _pBuildBuffer->BindSortDirection(0);
+    for (unsigned int depth = 0; depth <= CompactParticleQuadTree::MAX_NODE_DEPTH; depth++)
+    {
+        glUseProgram(_nodesProgramId);
+        glUniform1ui(_unifLocNodesDepth, depth);
+        glUniform1ui(_unifLocNodesBuildStep, QuadTreeBuildEmulator::NODES_STEP_SETUP_LEVEL);
+        glDispatchCompute(1, 1, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        if (depth == CompactParticleQuadTree::MAX_NODE_DEPTH)
+        {
+            break;
+        }
+
+        GLuint nodeWorkGroups = QuadTreeBuildEmulator::NumNodeWorkGroupsAtDepth(depth);
+        glUniform1ui(_unifLocNodesBuildStep, QuadTreeBuildEmulator::NODES_STEP_COUNT_SPLITS);
+        glDispatchCompute(nodeWorkGroups, 1, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        DispatchScan(nodeWorkGroups);
+        glUseProgram(_nodesProgramId);
+        glUniform1ui(_unifLocNodesBuildStep, QuadTreeBuildEmulator::NODES_STEP_EMIT_CHILDREN);
+        glDispatchCompute(nodeWorkGroups, 1, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+    glUseProgram(0);
+
+    // the sorted particle indices are the pool
+    // Note: The whole array is copied because the CPU doesn't know how many are in use.  
+    // Nodes only point at the ones that are.
+    glBindBuffer(GL_COPY_READ_BUFFER, _pBuildBuffer->BufferId());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, _pCompactQuadTreeBuffer->BufferId());
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 
+        _pBuildBuffer->ValuesOffsetBytes(0), _pCompactQuadTreeBuffer->ParticleIndicesOffsetBytes(),
+        sizeof(unsigned int) * _maxParticles);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    _gpuTimer.End();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Dispatches QuadTreeBuildScan.comp over the first numSums block sums.  It is always one 
+    work group.  Leaves the scan's program in use.
+Parameters: 
+    numSums     Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ComputeControllerQuadTreeBuild::DispatchScan(unsigned int numSums)
+{
+    glUseProgram(_scanProgramId);
+    glUniform1ui(_unifLocScanNumSums, numSums);
+    glDispatchCompute(1, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Starts timing the dispatches on the GPU (see GpuDispatchTimer).
+Parameters:
+    pBackend    Not owned.  0 to stop timing.
+    pProfiler   Not owned.  The times go to its PROFILER_STAGE_GPU_TREE_BUILD stage.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ComputeControllerQuadTreeBuild::EnableGpuTiming(IGpuTimerBackend *pBackend, FrameProfiler *pProfiler)
+{
+    _gpuTimer.Enable(pBackend, pProfiler);
+}
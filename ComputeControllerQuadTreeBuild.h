@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include "glm/vec4.hpp"
+#include "GpuDispatchTimer.h"
+
+class QuadTreeBuildSsbo;
+class CompactQuadTreeSsbo;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Controls the QuadTreeBuild*.comp shaders, which build a CompactParticleQuadTree's nodes and 
+    particle index pool on the GPU, straight from the particle buffer and straight into a 
+    CompactQuadTreeSsbo, so the particles never have to be read back and the tree never has 
+    to be uploaded.  See QuadTreeBuildEmulator for the steps, which BuildTree() dispatches in 
+    the same order.
+
+    Nothing is read back between the steps either.  The number of work groups for each 
+    dispatch is the most that could be needed (every particle, and every node that a depth 
+    could have), and the shaders find out how many are actually in use from the build state 
+    that the previous step left in the QuadTreeBuildSsbo.  That costs some empty work groups, 
+    but the CPU never has to wait on the GPU.
+
+    The nodes that are not in the tree are left as they were, so the collision shader should 
+    be given CompactParticleQuadTree::MAX_NODES as the number of active nodes.  The nodes that 
+    are in the tree only point at each other.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class ComputeControllerQuadTreeBuild
+{
+public:
+    ComputeControllerQuadTreeBuild(unsigned int maxParticles, const glm::vec4 &particleRegionCenter, 
+        float particleRegionRadius, unsigned int maxParticlesPerLeaf, 
+        QuadTreeBuildSsbo *pBuildBuffer, CompactQuadTreeSsbo *pCompactQuadTreeBuffer, 
+        const std::string &particlesShaderKey, const std::string &scanShaderKey, 
+        const std::string &radixSortShaderKey, const std::string &nodesShaderKey);
+
+    // no destructor because the buffers belong to whoever made them
+
+    void BuildTree();
+    void EnableGpuTiming(IGpuTimerBackend *pBackend, FrameProfiler *pProfiler);
+
+private:
+    void DispatchScan(unsigned int numSums);
+
+    unsigned int _maxParticles;
+
+    // not owned
+    QuadTreeBuildSsbo *_pBuildBuffer;
+    CompactQuadTreeSsbo *_pCompactQuadTreeBuffer;
+
+    unsigned int _particlesProgramId;
+    int _unifLocParticlesBuildStep;
+
+    unsigned int _scanProgramId;
+    int _unifLocScanNumSums;
+
+    unsigned int _radixSortProgramId;
+    int _unifLocRadixSortBuildStep;
+    int _unifLocRadixSortKeyShift;
+
+    unsigned int _nodesProgramId;
+    int _unifLocNodesBuildStep;
+    int _unifLocNodesDepth;
+
+    // does nothing until EnableGpuTiming(...)
+    GpuDispatchTimer _gpuTimer;
+};
@@ -0,0 +1,230 @@
+#include "FrameProfiler.h"
+
+#include <algorithm>
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Allocates the ring buffer.
+Parameters:
+    numFramesKept   How many of the latest frames are summarized.  At least 1.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+FrameProfiler::FrameProfiler(unsigned int numFramesKept) :
+    _numFramesKept((numFramesKept > 0) ? numFramesKept : 1),
+    _numFramesEnded(0),
+    _frameIsOpen(false)
+{
+    _stageMsRing.resize(_numFramesKept * PROFILER_STAGE_COUNT, 0.0);
+    for (unsigned int stage = 0; stage < PROFILER_STAGE_COUNT; stage++)
+    {
+        _currentFrameStageMs[stage] = 0.0;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Starts a new frame with every stage at 0.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void FrameProfiler::BeginFrame()
+{
+    for (unsigned int stage = 0; stage < PROFILER_STAGE_COUNT; stage++)
+    {
+        _currentFrameStageMs[stage] = 0.0;
+    }
+    _frameStopwatch.Start();
+    _frameIsOpen = true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Records the whole frame's time and puts the frame in the ring buffer, over the oldest one
+    if the buffer is full.  Does nothing if BeginFrame() wasn't called first.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void FrameProfiler::EndFrame()
+{
+    if (!_frameIsOpen)
+    {
+        return;
+    }
+
+    _currentFrameStageMs[PROFILER_STAGE_FRAME] = _frameStopwatch.TotalTime() * 1000.0;
+
+    unsigned int ringIndex = (unsigned int)(_numFramesEnded % _numFramesKept);
+    double *pFrameStageMs = &_stageMsRing[ringIndex * PROFILER_STAGE_COUNT];
+    for (unsigned int stage = 0; stage < PROFILER_STAGE_COUNT; stage++)
+    {
+        pFrameStageMs[stage] = _currentFrameStageMs[stage];
+    }
+    _numFramesEnded++;
+    _frameIsOpen = false;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Adds time to one of the current frame's stages.
+Parameters:
+    stage           Self-explanatory
+    milliseconds    Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void FrameProfiler::AddStageTime(PROFILER_STAGE stage, double milliseconds)
+{
+    if (stage < PROFILER_STAGE_COUNT)
+    {
+        _currentFrameStageMs[stage] += milliseconds;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the ring buffer's size.
+Parameters: None
+Returns:
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int FrameProfiler::NumFramesKept() const
+{
+    return _numFramesKept;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Summarizes a stage over the frames in the ring buffer.  The 99th percentile is the
+    nearest-rank one: the smallest time that at least 99% of the frames are at or below.
+Parameters:
+    stage   Self-explanatory
+Returns:
+    See description.  All zeros if no frame has ended yet.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+FrameStageSummary FrameProfiler::Summarize(PROFILER_STAGE stage) const
+{
+    FrameStageSummary summary;
+    unsigned int numFrames = (unsigned int)std::min<unsigned long long>(_numFramesEnded, _numFramesKept);
+    if (numFrames == 0 || stage >= PROFILER_STAGE_COUNT)
+    {
+        return summary;
+    }
+
+    std::vector<double> stageMs(numFrames);
+    double totalMs = 0.0;
+    for (unsigned int frameCount = 0; frameCount < numFrames; frameCount++)
+    {
+        stageMs[frameCount] = _stageMsRing[(frameCount * PROFILER_STAGE_COUNT) + stage];
+        totalMs += stageMs[frameCount];
+    }
+    std::sort(stageMs.begin(), stageMs.end());
+
+    unsigned int p99Rank = ((numFrames * 99) + 99) / 100;
+    summary._minMs = stageMs.front();
+    summary._meanMs = totalMs / numFrames;
+    summary._p99Ms = stageMs[p99Rank - 1];
+    summary._maxMs = stageMs.back();
+    summary._numFrames = numFrames;
+    return summary;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Prints every stage's summary as a table, one stage per line.
+Parameters:
+    outFile     stdout, probably.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void FrameProfiler::PrintSummary(FILE *outFile) const
+{
+    fprintf(outFile, "%-12s %10s %10s %10s %10s  (ms over %u frames)\n", "stage", "min",
+        "mean", "p99", "max", Summarize(PROFILER_STAGE_FRAME)._numFrames);
+    for (unsigned int stage = 0; stage < PROFILER_STAGE_COUNT; stage++)
+    {
+        FrameStageSummary summary = Summarize((PROFILER_STAGE)stage);
+        fprintf(outFile, "%-12s %10.3f %10.3f %10.3f %10.3f\n", StageName((PROFILER_STAGE)stage),
+            summary._minMs, summary._meanMs, summary._p99Ms, summary._maxMs);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A name for each stage, for printing.
+Parameters:
+    stage   Self-explanatory
+Returns:
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+const char *FrameProfiler::StageName(PROFILER_STAGE stage)
+{
+    switch (stage)
+    {
+    case PROFILER_STAGE_RESET:
+        return "reset";
+    case PROFILER_STAGE_UPDATE:
+        return "update";
+    case PROFILER_STAGE_READBACK:
+        return "readback";
+    case PROFILER_STAGE_TREE_BUILD:
+        return "tree build";
+    case PROFILER_STAGE_TREE_WAIT:
+        return "tree wait";
+    case PROFILER_STAGE_UPLOAD:
+        return "upload";
+    case PROFILER_STAGE_COLLIDE:
+        return "collide";
+    case PROFILER_STAGE_RENDER:
+        return "render";
+    case PROFILER_STAGE_GPU_RESET:
+        return "gpu reset";
+    case PROFILER_STAGE_GPU_UPDATE:
+        return "gpu update";
+    case PROFILER_STAGE_GPU_TREE_BUILD:
+        return "gpu tree";
+    case PROFILER_STAGE_GPU_COLLIDE:
+        return "gpu collide";
+    case PROFILER_STAGE_GPU_GEOMETRY:
+        return "gpu geometry";
+    case PROFILER_STAGE_FRAME:
+        return "frame";
+    default:
+        return "unknown";
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Starts timing.  The stopwatch started when it was constructed.
+Parameters:
+    pProfiler   May be 0.
+    stage       Which stage the time goes to.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+FrameProfileZone::FrameProfileZone(FrameProfiler *pProfiler, PROFILER_STAGE stage) :
+    _pProfiler(pProfiler),
+    _stage(stage)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Adds the time since construction to the stage.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+FrameProfileZone::~FrameProfileZone()
+{
+    if (_pProfiler != 0)
+    {
+        _pProfiler->AddStageTime(_stage, _stopwatch.TotalTime() * 1000.0);
+    }
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdio>
+#include <vector>
+#include "Stopwatch.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The parts of a frame that FrameProfiler keeps times for.  PROFILER_STAGE_FRAME is the
+    whole frame, from BeginFrame() to EndFrame(), so it includes whatever the other stages
+    don't cover.
+
+    The PROFILER_STAGE_GPU_* stages are how long the compute shaders took on the GPU (see
+    GpuDispatchTimer).  They arrive a frame or two late, so they are added to whichever frame
+    is open when they are read.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+enum PROFILER_STAGE
+{
+    PROFILER_STAGE_RESET = 0,
+    PROFILER_STAGE_UPDATE,
+    PROFILER_STAGE_READBACK,
+    PROFILER_STAGE_TREE_BUILD,
+    PROFILER_STAGE_TREE_WAIT,
+    PROFILER_STAGE_UPLOAD,
+    PROFILER_STAGE_COLLIDE,
+    PROFILER_STAGE_RENDER,
+    PROFILER_STAGE_GPU_RESET,
+    PROFILER_STAGE_GPU_UPDATE,
+    PROFILER_STAGE_GPU_TREE_BUILD,
+    PROFILER_STAGE_GPU_COLLIDE,
+    PROFILER_STAGE_GPU_GEOMETRY,
+    PROFILER_STAGE_FRAME,
+    PROFILER_STAGE_COUNT
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    One stage's milliseconds over the frames that FrameProfiler still has.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+struct FrameStageSummary
+{
+    FrameStageSummary() :
+        _minMs(0.0),
+        _meanMs(0.0),
+        _p99Ms(0.0),
+        _maxMs(0.0),
+        _numFrames(0)
+    {
+    }
+
+    double _minMs;
+    double _meanMs;
+    double _p99Ms;
+    double _maxMs;
+    unsigned int _numFrames;
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Keeps how long each stage of the last numFramesKept frames took, in a ring buffer, so that
+    a frame's time can be split up between the stages, and summarizes each stage with its
+    minimum, mean, 99th percentile, and maximum.
+
+    A frame goes between BeginFrame() and EndFrame().  Stages are timed with a
+    FrameProfileZone around them, or added with AddStageTime(...) if they were timed some
+    other way (the tree build is timed on the tree-builder thread; see FrameScheduler).  A
+    stage that happens more than once in a frame adds up.  EndFrame() without a BeginFrame()
+    does nothing, so a redraw that didn't come after an update (a resize, for example) isn't
+    counted as a frame.
+
+    Note: Only for the thread that runs the frame.  Nothing here is locked.
+
+    Also Note: For the stages that run on the GPU, the CPU stages are how long the CPU took to
+    submit the work.  The PROFILER_STAGE_GPU_* stages are how long the GPU took to do it.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class FrameProfiler
+{
+public:
+    FrameProfiler(unsigned int numFramesKept = 300);
+
+    void BeginFrame();
+    void EndFrame();
+    void AddStageTime(PROFILER_STAGE stage, double milliseconds);
+
+    unsigned int NumFramesKept() const;
+    FrameStageSummary Summarize(PROFILER_STAGE stage) const;
+    void PrintSummary(FILE *outFile) const;
+
+    static const char *StageName(PROFILER_STAGE stage);
+
+private:
+    unsigned int _numFramesKept;
+
+    // frame N is at [(N % _numFramesKept) * PROFILER_STAGE_COUNT]
+    std::vector<double> _stageMsRing;
+    unsigned long long _numFramesEnded;
+    bool _frameIsOpen;
+
+    double _currentFrameStageMs[PROFILER_STAGE_COUNT];
+    Stopwatch _frameStopwatch;
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Times the scope that it is in and adds the time to a stage of the profiler's current
+    frame when it goes out of scope.  Does nothing if the profiler is 0, so that callers don't
+    need to check.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class FrameProfileZone
+{
+public:
+    FrameProfileZone(FrameProfiler *pProfiler, PROFILER_STAGE stage);
+    ~FrameProfileZone();
+
+private:
+    FrameProfileZone(const FrameProfileZone &) = delete;
+    FrameProfileZone &operator=(const FrameProfileZone &) = delete;
+
+    FrameProfiler *_pProfiler;
+    PROFILER_STAGE _stage;
+    Stopwatch _stopwatch;
+};
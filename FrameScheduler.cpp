@@ -0,0 +1,482 @@
+#include "FrameScheduler.h"
+
+#include <chrono>
+
+#include "CompactParticleQuadTree.h"
+#include "ParticleUniformGrid.h"
+#include "FrameProfiler.h"
+
+// TryPush(...) takes it by reference, so it needs a definition (LTO builds won't link without it)
+const unsigned int FrameScheduler::STOP_TREE_BUILDER;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A convenience function for the stage timings.
+Parameters:
+    start   When the stage started.
+Returns:
+    Milliseconds since start.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static double MillisecondsSince(const std::chrono::steady_clock::time_point &start)
+{
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Allocates the frame slots and the quad tree (or the slots' spatial indices) and starts the tree-builder thread.
+Parameters:
+    pStages                 The scheduler does not own this, and it must outlive the scheduler.
+    particleRegionCenter    For the quad tree.
+    particleRegionRadius    For the quad tree.
+    framesOfCollisionLatency    0 to collide with this frame's tree, 1 to collide with last 
+                            frame's tree and overlap this frame's build.  Clamped to 
+                            MAX_FRAMES_OF_COLLISION_LATENCY.
+    spatialIndexType        What to build.  The stages' collisions must be set up for it.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+FrameScheduler::FrameScheduler(IFrameStages *pStages, const glm::vec4 &particleRegionCenter, 
+    float particleRegionRadius, unsigned int framesOfCollisionLatency, 
+    SPATIAL_INDEX_TYPE spatialIndexType) :
+    _pStages(pStages),
+    _framesOfCollisionLatency(0),
+    _numFrames(0),
+    _slotsToBuild(MAX_FRAMES_OF_COLLISION_LATENCY + 2),
+    _slotsBuilt(MAX_FRAMES_OF_COLLISION_LATENCY + 1),
+    _pQuadTree(0),
+    _uploadParticleLeafIndices(false),
+    _numActiveNodes(0),
+    _numNodePopulations(0),
+    _pProfiler(0)
+{
+    _framesOfCollisionLatency = (framesOfCollisionLatency < MAX_FRAMES_OF_COLLISION_LATENCY) ? 
+        framesOfCollisionLatency : MAX_FRAMES_OF_COLLISION_LATENCY;
+
+    unsigned int numParticles = _pStages->NumParticles();
+    _slots.resize(_framesOfCollisionLatency + 1);
+    for (unsigned int slotIndex = 0; slotIndex < _slots.size(); slotIndex++)
+    {
+        FrameSlot &slot = _slots[slotIndex];
+        slot._hasParticles = false;
+        slot._positions.resize(numParticles);
+        slot._stateFlags.resize(numParticles);
+        slot._pSpatialIndex = 0;
+        slot._numNodes = 0;
+        slot._numNodePopulations = 0;
+        slot._treeBuildMs = 0.0;
+
+        if (spatialIndexType == SPATIAL_INDEX_COMPACT_QUAD_TREE)
+        {
+            slot._pSpatialIndex = new CompactParticleQuadTree(particleRegionCenter, 
+                particleRegionRadius);
+        }
+        else if (spatialIndexType == SPATIAL_INDEX_UNIFORM_GRID)
+        {
+            slot._pSpatialIndex = new ParticleUniformGrid(particleRegionCenter, 
+                particleRegionRadius);
+        }
+    }
+
+    if (spatialIndexType == SPATIAL_INDEX_QUAD_TREE)
+    {
+        _pQuadTree = new ParticleQuadTree(particleRegionCenter, particleRegionRadius, numParticles);
+    }
+    _treeBuilderThread = std::thread(&FrameScheduler::TreeBuilderThread, this);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Tells the tree-builder thread to quit once it is done with whatever it was given, waits 
+    for it, and then cleans up the tree.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+FrameScheduler::~FrameScheduler()
+{
+    // Note: _slotsToBuild has room for one more than every slot, so this always fits.
+    PushSlot(_slotsToBuild, _slotToBuildPushed, STOP_TREE_BUILDER);
+    _treeBuilderThread.join();
+
+    delete _pQuadTree;
+    for (unsigned int slotIndex = 0; slotIndex < _slots.size(); slotIndex++)
+    {
+        delete _slots[slotIndex]._pSpatialIndex;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs one frame (see the class description) and records how long each stage took.
+Parameters:
+    deltaTimeSec    Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void FrameScheduler::RunFrame(float deltaTimeSec)
+{
+    FrameStageTimings timings;
+    std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point stageStart = frameStart;
+
+    _pStages->UpdateParticles(deltaTimeSec);
+    timings._updateMs = MillisecondsSince(stageStart);
+
+    // the slot for this frame was given back by the collisions (framesOfCollisionLatency + 1) 
+    // frames ago, or has never been used
+    stageStart = std::chrono::steady_clock::now();
+    unsigned int slotIndex = (unsigned int)(_numFrames % _slots.size());
+    FrameSlot &slot = _slots[slotIndex];
+    slot._hasParticles = _pStages->ReadParticles(slot._positions.data(), slot._stateFlags.data());
+    timings._readParticlesMs = MillisecondsSince(stageStart);
+
+    // there is always room because there are never more slots out than the queue can hold
+    PushSlot(_slotsToBuild, _slotToBuildPushed, slotIndex);
+
+    if (_numFrames >= _framesOfCollisionLatency)
+    {
+        // the thread builds them in order, so the next one out is the one from 
+        // framesOfCollisionLatency frames ago
+        stageStart = std::chrono::steady_clock::now();
+        unsigned int builtSlotIndex = WaitForSlot(_slotsBuilt, _slotBuiltPushed);
+        timings._waitForTreeMs = MillisecondsSince(stageStart);
+
+        const FrameSlot &builtSlot = _slots[builtSlotIndex];
+        timings._treeBuildMs = builtSlot._treeBuildMs;
+        _numActiveNodes = builtSlot._numNodes;
+        _numNodePopulations += builtSlot._numNodePopulations;
+
+        stageStart = std::chrono::steady_clock::now();
+        if (builtSlot._pSpatialIndex != 0)
+        {
+            _pStages->UploadSpatialIndex(builtSlot._pSpatialIndex);
+        }
+        else
+        {
+            const unsigned int *particleLeafIndices = builtSlot._leafIndices.empty() ? 
+                0 : builtSlot._leafIndices.data();
+            _pStages->UploadQuadTree(builtSlot._nodes.data(), builtSlot._numNodes, 
+                particleLeafIndices);
+        }
+        timings._uploadTreeMs = MillisecondsSince(stageStart);
+
+        stageStart = std::chrono::steady_clock::now();
+        _pStages->CollideParticles(deltaTimeSec);
+        timings._collideMs = MillisecondsSince(stageStart);
+    }
+
+    timings._frameMs = MillisecondsSince(frameStart);
+
+    _lastFrameTimings = timings;
+    _totalTimings._updateMs += timings._updateMs;
+    _totalTimings._readParticlesMs += timings._readParticlesMs;
+    _totalTimings._treeBuildMs += timings._treeBuildMs;
+    _totalTimings._waitForTreeMs += timings._waitForTreeMs;
+    _totalTimings._uploadTreeMs += timings._uploadTreeMs;
+    _totalTimings._collideMs += timings._collideMs;
+    _totalTimings._frameMs += timings._frameMs;
+    _numFrames++;
+
+    // the stages time the update themselves, and the profiler times the whole frame
+    if (_pProfiler != 0)
+    {
+        _pProfiler->AddStageTime(PROFILER_STAGE_READBACK, timings._readParticlesMs);
+        _pProfiler->AddStageTime(PROFILER_STAGE_TREE_BUILD, timings._treeBuildMs);
+        _pProfiler->AddStageTime(PROFILER_STAGE_TREE_WAIT, timings._waitForTreeMs);
+        _pProfiler->AddStageTime(PROFILER_STAGE_UPLOAD, timings._uploadTreeMs);
+        _pProfiler->AddStageTime(PROFILER_STAGE_COLLIDE, timings._collideMs);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the latency that was given to the constructor (after clamping).
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int FrameScheduler::FramesOfCollisionLatency() const
+{
+    return _framesOfCollisionLatency;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for how many times RunFrame(...) has been called.
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned long long FrameScheduler::NumFrames() const
+{
+    return _numFrames;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the last frame's stage timings.
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+const FrameStageTimings &FrameScheduler::LastFrameTimings() const
+{
+    return _lastFrameTimings;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Averages each stage's time over every frame so far.  
+    
+    Note: The first framesOfCollisionLatency frames have no tree build, upload, or collisions, 
+    so they pull those averages down a little.
+Parameters: None
+Returns:    
+    See description.  All zeros if there haven't been any frames.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+FrameStageTimings FrameScheduler::AverageFrameTimings() const
+{
+    FrameStageTimings averages;
+    if (_numFrames == 0)
+    {
+        return averages;
+    }
+
+    double inverseNumFrames = 1.0 / (double)_numFrames;
+    averages._updateMs = _totalTimings._updateMs * inverseNumFrames;
+    averages._readParticlesMs = _totalTimings._readParticlesMs * inverseNumFrames;
+    averages._treeBuildMs = _totalTimings._treeBuildMs * inverseNumFrames;
+    averages._waitForTreeMs = _totalTimings._waitForTreeMs * inverseNumFrames;
+    averages._uploadTreeMs = _totalTimings._uploadTreeMs * inverseNumFrames;
+    averages._collideMs = _totalTimings._collideMs * inverseNumFrames;
+    averages._frameMs = _totalTimings._frameMs * inverseNumFrames;
+    return averages;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    If true, the tree-builder thread also copies each particle's leaf out of the quad tree 
+    (4 bytes per particle), and it is uploaded with the nodes so that the collisions can skip 
+    walking the tree to find it.  Only applies to SPATIAL_INDEX_QUAD_TREE.
+
+    Note: Must be called before the first RunFrame(...).  The tree-builder thread only reads 
+    it after it has been handed a slot, so nothing more than that is needed to keep it safe.
+Parameters:
+    uploadParticleLeafIndices   false (the default) leaves the collisions to find the leaves.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void FrameScheduler::SetUploadParticleLeafIndices(bool uploadParticleLeafIndices)
+{
+    _uploadParticleLeafIndices = uploadParticleLeafIndices;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives each frame's stage timings to the profiler as well, and gives the profiler to the 
+    stages so that they can time the reset and the update separately.  The scheduler does not 
+    begin or end the profiler's frames because the caller's frame is more than RunFrame(...) 
+    (it renders too).
+
+    Note: The tree build's time comes from the tree-builder thread through the frame slot, so 
+    the profiler is still only used on this thread.
+Parameters:
+    pProfiler   Not owned.  0 to stop profiling.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void FrameScheduler::SetProfiler(FrameProfiler *pProfiler)
+{
+    _pProfiler = pProfiler;
+    _pStages->SetProfiler(pProfiler);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of nodes in the last tree that was uploaded.
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int FrameScheduler::NumActiveNodes() const
+{
+    return _numActiveNodes;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Like ParticleQuadTree::NumNodePopulations(), but summed over the trees (or other spatial 
+    indexes) that have been uploaded since the last ResetNumNodePopulations().  The tree's 
+    own counter can't be read from here because the tree-builder thread is changing it.
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+int FrameScheduler::NumNodePopulations() const
+{
+    return _numNodePopulations;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets the node population count back to 0.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void FrameScheduler::ResetNumNodePopulations()
+{
+    _numNodePopulations = 0;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Pushes a slot index into one of the queues and wakes up the other side if it is waiting 
+    for it (see WaitForSlot(...)).
+
+    Note: The mutex is taken (and let go of) between the push and the notify so that the 
+    other side is either still before its check, and will see the slot, or already asleep, 
+    and will get the notify.  Without it, the notify could land between the other side's 
+    check and its wait and be lost.
+Parameters:
+    queue       Self-explanatory
+    slotPushed  The condition variable that goes with the queue.
+    slotIndex   Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void FrameScheduler::PushSlot(SpscQueue<unsigned int> &queue, 
+    std::condition_variable &slotPushed, unsigned int slotIndex)
+{
+    // the callers make sure that there is room
+    queue.TryPush(slotIndex);
+    {
+        std::lock_guard<std::mutex> lock(_slotWaitMutex);
+    }
+    slotPushed.notify_one();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Takes the next slot index out of one of the queues, sleeping until PushSlot(...) pushes 
+    one if the queue is empty.  If there already is one, the mutex is taken but nothing 
+    waits.
+Parameters:
+    queue       Self-explanatory
+    slotPushed  The condition variable that goes with the queue.
+Returns:
+    The slot index.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int FrameScheduler::WaitForSlot(SpscQueue<unsigned int> &queue, 
+    std::condition_variable &slotPushed)
+{
+    unsigned int slotIndex = 0;
+    std::unique_lock<std::mutex> lock(_slotWaitMutex);
+    slotPushed.wait(lock, [&queue, &slotIndex]() { return queue.TryPop(slotIndex); });
+    return slotIndex;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The tree-builder thread's loop.  Builds a tree for each slot that it is given, in the order 
+    that they were given, and hands each one back.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void FrameScheduler::TreeBuilderThread()
+{
+    while (true)
+    {
+        unsigned int slotIndex = WaitForSlot(_slotsToBuild, _slotToBuildPushed);
+        if (slotIndex == STOP_TREE_BUILDER)
+        {
+            return;
+        }
+
+        BuildTreeForSlot(_slots[slotIndex]);
+
+        // there is always room for the same reason as in RunFrame(...)
+        PushSlot(_slotsBuilt, _slotBuiltPushed, slotIndex);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Updates the quad tree from the slot's snapshot and copies the nodes that are in use into 
+    the slot.  If the snapshot is empty (the particles couldn't be read yet), the tree is left 
+    as it was and its nodes are still copied so that there is something to collide with.  
+    The particles' leaves are copied too if they are going to be uploaded.
+Parameters:
+    slot    Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void FrameScheduler::BuildTreeForSlot(FrameSlot &slot)
+{
+    std::chrono::steady_clock::time_point buildStart = std::chrono::steady_clock::now();
+
+    if (slot._pSpatialIndex != 0)
+    {
+        BuildSpatialIndexForSlot(slot);
+        slot._treeBuildMs = MillisecondsSince(buildStart);
+        return;
+    }
+
+    if (slot._hasParticles)
+    {
+        _pQuadTree->UpdateTree(slot._positions.data(), slot._stateFlags.data(), 
+            (int)slot._positions.size());
+    }
+
+    // Note: NumActiveNodes() is the highest node in use, so every node that the tree points 
+    // to is below it.
+    const ParticleQuadTreeNode *allNodes = _pQuadTree->QuadTreeBuffer();
+    slot._numNodes = _pQuadTree->NumActiveNodes();
+    slot._nodes.assign(allNodes, allNodes + slot._numNodes);
+    if (_uploadParticleLeafIndices)
+    {
+        slot._leafIndices.resize(slot._positions.size());
+        _pQuadTree->CopyParticleLeafIndices(slot._leafIndices.data(), 
+            (int)slot._leafIndices.size());
+    }
+    slot._numNodePopulations = _pQuadTree->NumNodePopulations();
+    _pQuadTree->ResetNumNodePopulations();
+
+    slot._treeBuildMs = MillisecondsSince(buildStart);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The ISpatialIndex version of BuildTreeForSlot(...).  The slot's index is rebuilt from 
+    scratch.  Like ParticleQuadTree::NumNodePopulations(), the population count is the 
+    number of builds that ran (1 or 0), not how many nodes or cells were filled in.
+
+    If the snapshot is empty, the slot's index is left as it was the last time that the slot 
+    was used (empty at first), so the collisions may find nothing that frame.
+Parameters:
+    slot    Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void FrameScheduler::BuildSpatialIndexForSlot(FrameSlot &slot)
+{
+    if (slot._hasParticles)
+    {
+        slot._pSpatialIndex->Build(slot._positions.data(), slot._stateFlags.data(), 
+            (int)slot._positions.size());
+    }
+
+    slot._numNodes = slot._pSpatialIndex->NumCells();
+    slot._numNodePopulations = slot._hasParticles ? 1 : 0;
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include "glm/vec2.hpp"
+#include "glm/vec4.hpp"
+
+#include "IFrameStages.h"
+#include "ParticleQuadTree.h"
+#include "ISpatialIndex.h"
+#include "SpscQueue.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Milliseconds spent in each stage of a frame.  The tree build happens on another thread, so 
+    it overlaps the others, and "wait for tree" is how long RunFrame(...) had to wait for it.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+struct FrameStageTimings
+{
+    FrameStageTimings() :
+        _updateMs(0.0),
+        _readParticlesMs(0.0),
+        _treeBuildMs(0.0),
+        _waitForTreeMs(0.0),
+        _uploadTreeMs(0.0),
+        _collideMs(0.0),
+        _frameMs(0.0)
+    {
+    }
+
+    double _updateMs;
+    double _readParticlesMs;
+    double _treeBuildMs;
+    double _waitForTreeMs;
+    double _uploadTreeMs;
+    double _collideMs;
+    double _frameMs;
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs the frame's stages (see IFrameStages) with the quad tree built on a dedicated thread 
+    so that the CPU's tree build and the GPU's dispatches can overlap.
+    (1) Update the particles.
+    (2) Read the particles into a snapshot and hand the snapshot to the tree-builder thread 
+    through a lock-free single-producer single-consumer queue.
+    (3) Take the tree that was built framesOfCollisionLatency frames ago from a second queue, 
+    waiting for it if it isn't done.
+
+    The queues themselves don't lock, but whoever is waiting on an empty one (the thread for 
+    a snapshot, RunFrame(...) for a tree) sleeps on a condition variable instead of spinning, 
+    so a waiting side doesn't take a core away from the side that it is waiting on.
+    (4) Upload it and collide the particles with it.
+
+    With no latency, (3) waits for the tree from this frame's snapshot, which is the same order 
+    of events as before and there is no overlap.  With one frame of latency, the collisions 
+    use the tree from the previous frame's snapshot, and this frame's tree is built while this 
+    frame collides, renders, and updates the next one.  The particles have only moved for one 
+    more frame, so a particle's leaf is usually still right, but a few collisions near leaf 
+    edges may be a frame late.
+
+    The tree-builder thread keeps one ParticleQuadTree and updates it incrementally 
+    (ParticleQuadTree::UpdateTree(...)) from each snapshot, and then copies its nodes out into 
+    the snapshot's frame slot.  There are framesOfCollisionLatency + 1 slots, so the slot 
+    being read by the collisions is never the one being built.
+
+    With any other SPATIAL_INDEX_TYPE, every slot has its own ISpatialIndex, and the thread 
+    builds the slot's index from scratch in place.  Nothing is copied, and the index is 
+    uploaded straight from the slot.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class FrameScheduler
+{
+public:
+    FrameScheduler(IFrameStages *pStages, const glm::vec4 &particleRegionCenter, 
+        float particleRegionRadius, unsigned int framesOfCollisionLatency = 0, 
+        SPATIAL_INDEX_TYPE spatialIndexType = SPATIAL_INDEX_QUAD_TREE);
+    ~FrameScheduler();
+
+    void RunFrame(float deltaTimeSec);
+
+    unsigned int FramesOfCollisionLatency() const;
+    unsigned long long NumFrames() const;
+    const FrameStageTimings &LastFrameTimings() const;
+    FrameStageTimings AverageFrameTimings() const;
+    void SetUploadParticleLeafIndices(bool uploadParticleLeafIndices);
+    void SetProfiler(FrameProfiler *pProfiler);
+
+    // the tree belongs to the tree-builder thread, so these are about the last uploaded one
+    unsigned int NumActiveNodes() const;
+    int NumNodePopulations() const;
+    void ResetNumNodePopulations();
+
+    // framesOfCollisionLatency is clamped to this
+    static const unsigned int MAX_FRAMES_OF_COLLISION_LATENCY = 3;
+
+private:
+    // the thread holds a pointer to this object, so it must stay put
+    FrameScheduler(const FrameScheduler &) = delete;
+    FrameScheduler &operator=(const FrameScheduler &) = delete;
+
+    /*-------------------------------------------------------------------------------------------
+    Description:
+        One frame's snapshot of the particles and the tree that was built from it.  
+        RunFrame(...) writes the snapshot and the tree-builder thread writes the rest.  Only 
+        one of them has the slot at any time, and the queues hand it back and forth.
+    Creator:    John Cox (10-17-2026)
+    -------------------------------------------------------------------------------------------*/
+    struct FrameSlot
+    {
+        bool _hasParticles;
+        std::vector<glm::vec2> _positions;
+        std::vector<unsigned int> _stateFlags;
+
+        // only one of these is used, depending on the kind of spatial index
+        std::vector<ParticleQuadTreeNode> _nodes;
+        std::vector<unsigned int> _leafIndices;
+        ISpatialIndex *_pSpatialIndex;
+        unsigned int _numNodes;
+        int _numNodePopulations;
+        double _treeBuildMs;
+    };
+
+    void PushSlot(SpscQueue<unsigned int> &queue, std::condition_variable &slotPushed, 
+        unsigned int slotIndex);
+    unsigned int WaitForSlot(SpscQueue<unsigned int> &queue, 
+        std::condition_variable &slotPushed);
+    void TreeBuilderThread();
+    void BuildTreeForSlot(FrameSlot &slot);
+    void BuildSpatialIndexForSlot(FrameSlot &slot);
+
+    // slot indices are passed through the queues; this one tells the thread to quit
+    static const unsigned int STOP_TREE_BUILDER = 0xffffffff;
+
+    IFrameStages *_pStages;
+    unsigned int _framesOfCollisionLatency;
+    unsigned long long _numFrames;
+
+    std::vector<FrameSlot> _slots;
+    SpscQueue<unsigned int> _slotsToBuild;
+    SpscQueue<unsigned int> _slotsBuilt;
+
+    // only for sleeping while a queue is empty (see WaitForSlot(...)); the queues don't need it
+    std::mutex _slotWaitMutex;
+    std::condition_variable _slotToBuildPushed;
+    std::condition_variable _slotBuiltPushed;
+
+    // only touched by the tree-builder thread after construction; 0 if the slots have their 
+    // own spatial indices
+    ParticleQuadTree *_pQuadTree;
+    std::thread _treeBuilderThread;
+
+    // see SetUploadParticleLeafIndices(...)
+    bool _uploadParticleLeafIndices;
+
+    unsigned int _numActiveNodes;
+    int _numNodePopulations;
+
+    FrameStageTimings _lastFrameTimings;
+    FrameStageTimings _totalTimings;
+
+    // not owned; 0 if nothing is profiled
+    FrameProfiler *_pProfiler;
+};
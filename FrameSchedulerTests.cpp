@@ -0,0 +1,154 @@
+// frame_scheduler_tests: FrameScheduler's "tree fill rate" count must be one per spatial index
+// build that ran, whichever spatial index it is, and the built indexes must come back
+// FramesOfCollisionLatency() frames late.
+
+#include <vector>
+
+#include "FrameScheduler.h"
+#include "IFrameStages.h"
+#include "ParticleSoA.h"
+#include "TestChecks.h"
+#include "TestParticles.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    An IFrameStages with particles that don't move.  Every third frame's ReadParticles(...)
+    has nothing to give, like a GPU readback that isn't ready yet, so the scheduler has empty
+    snapshots to deal with too.  Counts the uploads.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class FakeFrameStages : public IFrameStages
+{
+public:
+    FakeFrameStages(const std::vector<Particle> &particles) :
+        _particles(particles),
+        _numReads(0),
+        _numUploads(0)
+    {
+    }
+
+    virtual unsigned int NumParticles() const override
+    {
+        return (unsigned int)_particles.size();
+    }
+
+    virtual void UpdateParticles(float) override
+    {
+    }
+
+    virtual bool ReadParticles(glm::vec2 *positions, unsigned int *stateFlags) override
+    {
+        unsigned int readIndex = _numReads++;
+        if (!ReadHasParticles(readIndex))
+        {
+            return false;
+        }
+
+        for (size_t particleIndex = 0; particleIndex < _particles.size(); particleIndex++)
+        {
+            const Particle &p = _particles[particleIndex];
+            positions[particleIndex] = glm::vec2(p._position.x, p._position.y);
+            stateFlags[particleIndex] = ParticleSoA::PackStateFlags(p._isActive != 0, 0);
+        }
+        return true;
+    }
+
+    virtual void UploadQuadTree(const ParticleQuadTreeNode *, unsigned int,
+        const unsigned int *) override
+    {
+        _numUploads++;
+    }
+
+    virtual void UploadSpatialIndex(const ISpatialIndex *) override
+    {
+        _numUploads++;
+    }
+
+    virtual void CollideParticles(float) override
+    {
+    }
+
+    virtual void SetProfiler(FrameProfiler *) override
+    {
+    }
+
+    // the frames that ReadParticles(...) gives particles on
+    static bool ReadHasParticles(unsigned int readIndex)
+    {
+        return (readIndex % 3) != 2;
+    }
+
+    std::vector<Particle> _particles;
+    unsigned int _numReads;
+    unsigned int _numUploads;
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    For each spatial index and a few latencies, runs frames and checks that
+    NumNodePopulations() is the number of uploaded frames that had particles to build from.
+    It used to be the node or cell count for anything but ParticleQuadTree.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void TestOnePopulationPerBuild()
+{
+    const SPATIAL_INDEX_TYPE spatialIndexTypes[] =
+    {
+        SPATIAL_INDEX_QUAD_TREE, SPATIAL_INDEX_COMPACT_QUAD_TREE, SPATIAL_INDEX_UNIFORM_GRID
+    };
+    const char *const spatialIndexNames[] =
+    {
+        "quad tree", "compact quad tree", "uniform grid"
+    };
+    const unsigned int numFrames = 20;
+
+    std::vector<Particle> particles = MakeParticles(TEST_DISTRIBUTION_UNIFORM, 5000);
+    for (int typeIndex = 0; typeIndex < 3; typeIndex++)
+    {
+        for (unsigned int latency = 0; latency <= FrameScheduler::MAX_FRAMES_OF_COLLISION_LATENCY; latency++)
+        {
+            FakeFrameStages stages(particles);
+            FrameScheduler scheduler(&stages, gParticleRegionCenter, gParticleRegionRadius,
+                latency, spatialIndexTypes[typeIndex]);
+            for (unsigned int frame = 0; frame < numFrames; frame++)
+            {
+                scheduler.RunFrame(0.01f);
+            }
+
+            unsigned int numUploadedFrames = numFrames - latency;
+            int expectedPopulations = 0;
+            for (unsigned int frame = 0; frame < numUploadedFrames; frame++)
+            {
+                expectedPopulations += FakeFrameStages::ReadHasParticles(frame) ? 1 : 0;
+            }
+
+            const char *indexName = spatialIndexNames[typeIndex];
+            TEST_CHECK(stages._numUploads == numUploadedFrames, "%s, latency %u: %u uploads",
+                indexName, latency, stages._numUploads);
+            TEST_CHECK(scheduler.NumNodePopulations() == expectedPopulations,
+                "%s, latency %u: %d populations instead of %d", indexName, latency,
+                scheduler.NumNodePopulations(), expectedPopulations);
+
+            // Note: A slot whose snapshot was empty uploads whatever it built the last time
+            // (nothing, if it never built anything), so only check a build that ran.
+            if (FakeFrameStages::ReadHasParticles(numUploadedFrames - 1))
+            {
+                TEST_CHECK(scheduler.NumActiveNodes() > 1, "%s, latency %u: %u nodes",
+                    indexName, latency, scheduler.NumActiveNodes());
+            }
+
+            scheduler.ResetNumNodePopulations();
+            TEST_CHECK(scheduler.NumNodePopulations() == 0, "%s, latency %u", indexName,
+                latency);
+        }
+    }
+}
+
+int main()
+{
+    TestOnePopulationPerBuild();
+
+    return TestExitCode("frame_scheduler_tests");
+}
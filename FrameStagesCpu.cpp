@@ -0,0 +1,154 @@
+#include "FrameStagesCpu.h"
+
+#include "ParticleSoA.h"
+#include "FrameProfiler.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values.
+Parameters:
+    pEngine     Not owned, and must outlive this object.
+    particlesPerEmitterPerFrame     Passed on to SimulationEngine::ResetParticles(...).
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+FrameStagesCpu::FrameStagesCpu(SimulationEngine *pEngine, 
+    unsigned int particlesPerEmitterPerFrame) :
+    _pEngine(pEngine),
+    _particlesPerEmitterPerFrame(particlesPerEmitterPerFrame),
+    _pProfiler(0),
+    _pUploadedNodes(0),
+    _numUploadedNodes(0),
+    _pUploadedLeafIndices(0),
+    _pUploadedSpatialIndex(0)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the engine's particle count.
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int FrameStagesCpu::NumParticles() const
+{
+    return _pEngine->NumParticles();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The first two stages of SimulationEngine::Update(...).
+Parameters:
+    deltaTimeSec    Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void FrameStagesCpu::UpdateParticles(float deltaTimeSec)
+{
+    {
+        FrameProfileZone resetZone(_pProfiler, PROFILER_STAGE_RESET);
+        _pEngine->ResetParticles(_particlesPerEmitterPerFrame);
+    }
+    {
+        FrameProfileZone updateZone(_pProfiler, PROFILER_STAGE_UPDATE);
+        _pEngine->UpdateParticles(deltaTimeSec);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Copies the engine's particle positions and "is active" flags.  Unlike the GPU, the engine's 
+    particles are always ready.
+Parameters:
+    positions   Must have room for NumParticles().
+    stateFlags  Must have room for NumParticles().
+Returns:    
+    Always true.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+bool FrameStagesCpu::ReadParticles(glm::vec2 *positions, unsigned int *stateFlags)
+{
+    const Particle *allParticles = _pEngine->ParticleBuffer();
+    unsigned int numParticles = _pEngine->NumParticles();
+    for (unsigned int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    {
+        const Particle &p = allParticles[particleIndex];
+        positions[particleIndex] = glm::vec2(p._position.x, p._position.y);
+        stateFlags[particleIndex] = ParticleSoA::PackStateFlags(p._isActive != 0, 
+            p._collisionCountThisFrame);
+    }
+
+    return true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Remembers the nodes (and the leaf indices) for CollideParticles(...).  They are 
+    FrameScheduler's, and it keeps them valid until then.
+Parameters:
+    allNodes    Self-explanatory
+    numNodes    Self-explanatory
+    particleLeafIndices     May be 0.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void FrameStagesCpu::UploadQuadTree(const ParticleQuadTreeNode *allNodes, unsigned int numNodes,
+    const unsigned int *particleLeafIndices)
+{
+    _pUploadedNodes = allNodes;
+    _numUploadedNodes = numNodes;
+    _pUploadedLeafIndices = particleLeafIndices;
+    _pUploadedSpatialIndex = 0;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Like UploadQuadTree(...), but for an ISpatialIndex.
+Parameters:
+    pSpatialIndex   Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void FrameStagesCpu::UploadSpatialIndex(const ISpatialIndex *pSpatialIndex)
+{
+    _pUploadedNodes = 0;
+    _numUploadedNodes = 0;
+    _pUploadedLeafIndices = 0;
+    _pUploadedSpatialIndex = pSpatialIndex;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Collides the engine's particles with the last uploaded tree.
+Parameters:
+    deltaTimeSec    Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void FrameStagesCpu::CollideParticles(float deltaTimeSec)
+{
+    if (_pUploadedSpatialIndex != 0)
+    {
+        _pEngine->CollideParticles(deltaTimeSec, _pUploadedSpatialIndex);
+    }
+    else if (_pUploadedNodes != 0)
+    {
+        _pEngine->CollideParticles(deltaTimeSec, _pUploadedNodes, _numUploadedNodes, 
+            _pUploadedLeafIndices);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets the profiler that the reset and the update are timed with.  The stages do not own it.
+Parameters:
+    pProfiler   0 to stop timing.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void FrameStagesCpu::SetProfiler(FrameProfiler *pProfiler)
+{
+    _pProfiler = pProfiler;
+}
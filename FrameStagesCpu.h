@@ -0,0 +1,38 @@
+#pragma once
+
+#include "IFrameStages.h"
+#include "SimulationEngine.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs FrameScheduler's stages with SimulationEngine so that the scheduler can be run (and 
+    timed) without an OpenGL context.  The engine's own quad tree is not used; the collisions 
+    run against whatever tree the scheduler uploads.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class FrameStagesCpu : public IFrameStages
+{
+public:
+    FrameStagesCpu(SimulationEngine *pEngine, unsigned int particlesPerEmitterPerFrame);
+
+    unsigned int NumParticles() const override;
+    void UpdateParticles(float deltaTimeSec) override;
+    bool ReadParticles(glm::vec2 *positions, unsigned int *stateFlags) override;
+    void UploadQuadTree(const ParticleQuadTreeNode *allNodes, unsigned int numNodes, 
+        const unsigned int *particleLeafIndices) override;
+    void UploadSpatialIndex(const ISpatialIndex *pSpatialIndex) override;
+    void CollideParticles(float deltaTimeSec) override;
+    void SetProfiler(FrameProfiler *pProfiler) override;
+
+private:
+    SimulationEngine *_pEngine;
+    unsigned int _particlesPerEmitterPerFrame;
+    FrameProfiler *_pProfiler;
+
+    // "uploading" only remembers where the nodes (or the index) are; only one of the two 
+    // pointers is non-zero at a time
+    const ParticleQuadTreeNode *_pUploadedNodes;
+    unsigned int _numUploadedNodes;
+    const unsigned int *_pUploadedLeafIndices;
+    const ISpatialIndex *_pUploadedSpatialIndex;
+};
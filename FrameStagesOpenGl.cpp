@@ -0,0 +1,247 @@
+#include "FrameStagesOpenGl.h"
+
+#include <string.h>
+#include <algorithm>    // for std::copy(...)
+
+#include "ComputeControllerParticleReset.h"
+#include "ComputeControllerParticleUpdate.h"
+#include "ComputeControllerParticleCollisions.h"
+#include "ComputeControllerActiveParticleCompaction.h"
+#include "ParticleSsbo.h"
+#include "ParticleReadbackRing.h"
+#include "QuadTreeNodeSsbo.h"
+#include "CompactQuadTreeSsbo.h"
+#include "UniformGridSsbo.h"
+#include "ParticleLeafIndexSsbo.h"
+#include "CompactParticleQuadTree.h"
+#include "ParticleUniformGrid.h"
+#include "FrameProfiler.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values.
+Parameters:
+    pParticleReseter    Not owned.
+    pParticleUpdater    Not owned.
+    pParticleCollider   Not owned.
+    pActiveParticleCompactor    Not owned.  May be 0, and then nothing makes the active 
+                        particle list, so the updater and the collider must not be using it.
+    pParticleBuffer     Not owned.  Tells ReadParticles(...) which layout the readback is in.
+    pParticleReadbackRing   Not owned.  Must read back pParticleBuffer's 
+                        TreeInputSizeBytes().
+    pQuadTreeBuffer     Not owned.  Must have room for ParticleQuadTree::MAX_NODES.  May 
+                        be 0 if only spatial indexes are uploaded.
+    pCompactQuadTreeBuffer  Not owned.  Must have room for CompactParticleQuadTree::MAX_NODES 
+                        and numParticles particle indices.  May be 0 if no 
+                        CompactParticleQuadTrees are uploaded.
+    pUniformGridBuffer  Not owned.  Must have room for the uploaded grid's cells and 
+                        numParticles particle indices.  May be 0 if no ParticleUniformGrids 
+                        are uploaded.
+    pParticleLeafIndexBuffer    Not owned.  Must have room for numParticles leaf indices.  
+                        May be 0, and then the collisions always walk the quad tree.
+    numParticles        The number of particles in pParticleBuffer.
+    particlesPerEmitterPerFrame     Passed on to the reseter.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+FrameStagesOpenGl::FrameStagesOpenGl(ComputeControllerParticleReset *pParticleReseter,
+    ComputeControllerParticleUpdate *pParticleUpdater,
+    ComputeControllerParticleCollisions *pParticleCollider,
+    ComputeControllerActiveParticleCompaction *pActiveParticleCompactor,
+    const ParticleSsbo *pParticleBuffer, ParticleReadbackRing *pParticleReadbackRing,
+    QuadTreeNodeSsbo *pQuadTreeBuffer, CompactQuadTreeSsbo *pCompactQuadTreeBuffer, 
+    UniformGridSsbo *pUniformGridBuffer, ParticleLeafIndexSsbo *pParticleLeafIndexBuffer, 
+    unsigned int numParticles, unsigned int particlesPerEmitterPerFrame) :
+    _pParticleReseter(pParticleReseter),
+    _pParticleUpdater(pParticleUpdater),
+    _pParticleCollider(pParticleCollider),
+    _pActiveParticleCompactor(pActiveParticleCompactor),
+    _pParticleBuffer(pParticleBuffer),
+    _pParticleReadbackRing(pParticleReadbackRing),
+    _pQuadTreeBuffer(pQuadTreeBuffer),
+    _pCompactQuadTreeBuffer(pCompactQuadTreeBuffer),
+    _pUniformGridBuffer(pUniformGridBuffer),
+    _pParticleLeafIndexBuffer(pParticleLeafIndexBuffer),
+    _numUploadedNodes(0),
+    _numParticles(numParticles),
+    _particlesPerEmitterPerFrame(particlesPerEmitterPerFrame),
+    _pProfiler(0)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of particles that was given to the constructor.
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int FrameStagesOpenGl::NumParticles() const
+{
+    return _numParticles;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Resets inactive particles and updates active particles (the MAGIC happens here).  If 
+    there is a compactor, the active particle list is made in between, after the last 
+    particle that will be active this frame has been activated.
+Parameters:
+    deltaTimeSec    Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void FrameStagesOpenGl::UpdateParticles(float deltaTimeSec)
+{
+    {
+        FrameProfileZone resetZone(_pProfiler, PROFILER_STAGE_RESET);
+        _pParticleReseter->ResetParticles(_particlesPerEmitterPerFrame);
+    }
+    {
+        // the compaction is only there for the update, so it is counted with it
+        FrameProfileZone updateZone(_pProfiler, PROFILER_STAGE_UPDATE);
+        if (_pActiveParticleCompactor != 0)
+        {
+            _pActiveParticleCompactor->CompactActiveParticles();
+        }
+        _pParticleUpdater->Update(deltaTimeSec);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Queues a copy of this frame's particles and then copies out the oldest one that the ring 
+    has finished (see ParticleReadbackRing).  In the structure of arrays layout, the positions 
+    and the state flags are copied as they are.  Otherwise they are gathered out of the 
+    Particle structures.
+Parameters:
+    positions   Must have room for NumParticles().
+    stateFlags  Must have room for NumParticles().
+Returns:    
+    False during the ring's first few frames, when there is nothing to read yet.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+bool FrameStagesOpenGl::ReadParticles(glm::vec2 *positions, unsigned int *stateFlags)
+{
+    _pParticleReadbackRing->QueueReadback();
+    const void *bufferPtr = _pParticleReadbackRing->AcquireReadback();
+    if (bufferPtr == 0)
+    {
+        return false;
+    }
+
+    const unsigned char *bytePtr = static_cast<const unsigned char *>(bufferPtr);
+    if (_pParticleBuffer->IsStructureOfArrays())
+    {
+        const glm::vec2 *mappedPositions = reinterpret_cast<const glm::vec2 *>(
+            bytePtr + _pParticleBuffer->SectionOffsetBytes(ParticleSsbo::SOA_SECTION_POSITIONS));
+        std::copy(mappedPositions, mappedPositions + _numParticles, positions);
+        memcpy(stateFlags, 
+            bytePtr + _pParticleBuffer->SectionOffsetBytes(ParticleSsbo::SOA_SECTION_STATE_FLAGS),
+            _numParticles * sizeof(unsigned int));
+    }
+    else
+    {
+        const Particle *allParticles = reinterpret_cast<const Particle *>(bytePtr);
+        for (unsigned int particleIndex = 0; particleIndex < _numParticles; particleIndex++)
+        {
+            const Particle &p = allParticles[particleIndex];
+            positions[particleIndex] = glm::vec2(p._position.x, p._position.y);
+            stateFlags[particleIndex] = ParticleSoA::PackStateFlags(p._isActive != 0, 
+                p._collisionCountThisFrame);
+        }
+    }
+
+    return true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Copies the nodes that are in use into the quad tree's SSBO (see 
+    QuadTreeNodeSsbo::UploadNodes(...)), and the particles' leaf indices into theirs if 
+    there are any and there is somewhere to put them.  The collider is told whether to use 
+    them.
+    
+    Note: glBufferSubData(...) copies the data before it returns, so the nodes don't have to 
+    outlive this call here.
+Parameters:
+    allNodes    Self-explanatory
+    numNodes    Self-explanatory
+    particleLeafIndices     May be 0.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void FrameStagesOpenGl::UploadQuadTree(const ParticleQuadTreeNode *allNodes, 
+    unsigned int numNodes, const unsigned int *particleLeafIndices)
+{
+    _pQuadTreeBuffer->UploadNodes(allNodes, numNodes);
+    _numUploadedNodes = _pQuadTreeBuffer->NumActiveNodes();
+
+    bool useParticleLeafIndices = (particleLeafIndices != 0) && (_pParticleLeafIndexBuffer != 0);
+    if (useParticleLeafIndices)
+    {
+        _pParticleLeafIndexBuffer->UploadLeafIndices(particleLeafIndices, _numParticles);
+    }
+    _pParticleCollider->SetUseParticleLeafIndices(useParticleLeafIndices);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Like UploadQuadTree(...), but for an ISpatialIndex.  Each kind of index has its own 
+    buffer layout, so this checks which kind it is and uses that kind's buffer.  Only the 
+    part of the particle index pool that is in use is copied.
+Parameters:
+    pSpatialIndex   Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void FrameStagesOpenGl::UploadSpatialIndex(const ISpatialIndex *pSpatialIndex)
+{
+    const CompactParticleQuadTree *pCompactQuadTree = 
+        dynamic_cast<const CompactParticleQuadTree *>(pSpatialIndex);
+    const ParticleUniformGrid *pUniformGrid = 
+        dynamic_cast<const ParticleUniformGrid *>(pSpatialIndex);
+    if (pCompactQuadTree != 0)
+    {
+        _pCompactQuadTreeBuffer->UploadTree(pCompactQuadTree->Nodes(), 
+            pCompactQuadTree->NumNodes(), pCompactQuadTree->ParticleIndexPool(), 
+            pCompactQuadTree->ParticleIndexPoolSize());
+        _numUploadedNodes = _pCompactQuadTreeBuffer->NumActiveNodes();
+    }
+    else if (pUniformGrid != 0)
+    {
+        _pUniformGridBuffer->UploadGrid(pUniformGrid->CellOffsets(), pUniformGrid->NumCells(), 
+            pUniformGrid->ParticleIndexPool(), pUniformGrid->ParticleIndexPoolSize());
+        _numUploadedNodes = _pUniformGridBuffer->NumActiveCells();
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Dispatches the collision shader against the last uploaded tree or grid.  The shader 
+    ignores the nodes (or cells) past the ones that were uploaded.
+Parameters:
+    deltaTimeSec    Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void FrameStagesOpenGl::CollideParticles(float deltaTimeSec)
+{
+    // Note: The collider's shader must be the one for the kind of tree or grid that is 
+    // uploaded (see main.cpp).
+    _pParticleCollider->Update(deltaTimeSec, _numUploadedNodes);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets the profiler that the reset and the update are timed with.  The stages do not own it.
+Parameters:
+    pProfiler   0 to stop timing.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void FrameStagesOpenGl::SetProfiler(FrameProfiler *pProfiler)
+{
+    _pProfiler = pProfiler;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "IFrameStages.h"
+
+class ComputeControllerParticleReset;
+class ComputeControllerParticleUpdate;
+class ComputeControllerParticleCollisions;
+class ComputeControllerActiveParticleCompaction;
+class ParticleSsbo;
+class ParticleReadbackRing;
+class QuadTreeNodeSsbo;
+class CompactQuadTreeSsbo;
+class UniformGridSsbo;
+class ParticleLeafIndexSsbo;
+class FrameProfiler;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs FrameScheduler's stages with the compute shaders, as UpdateAllTheThings() in main.cpp 
+    used to do itself.  The particles are read through a ParticleReadbackRing, so the 
+    snapshot that is handed to the tree builder is already that ring's latency behind.
+
+    Note: Like ComputeControllerParticleReset, this class does not own anything that it is 
+    given.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class FrameStagesOpenGl : public IFrameStages
+{
+public:
+    FrameStagesOpenGl(ComputeControllerParticleReset *pParticleReseter, 
+        ComputeControllerParticleUpdate *pParticleUpdater, 
+        ComputeControllerParticleCollisions *pParticleCollider, 
+        ComputeControllerActiveParticleCompaction *pActiveParticleCompactor, 
+        const ParticleSsbo *pParticleBuffer, ParticleReadbackRing *pParticleReadbackRing, 
+        QuadTreeNodeSsbo *pQuadTreeBuffer, CompactQuadTreeSsbo *pCompactQuadTreeBuffer, 
+        UniformGridSsbo *pUniformGridBuffer, ParticleLeafIndexSsbo *pParticleLeafIndexBuffer, 
+        unsigned int numParticles, unsigned int particlesPerEmitterPerFrame);
+
+    unsigned int NumParticles() const override;
+    void UpdateParticles(float deltaTimeSec) override;
+    bool ReadParticles(glm::vec2 *positions, unsigned int *stateFlags) override;
+    void UploadQuadTree(const ParticleQuadTreeNode *allNodes, unsigned int numNodes, 
+        const unsigned int *particleLeafIndices) override;
+    void UploadSpatialIndex(const ISpatialIndex *pSpatialIndex) override;
+    void CollideParticles(float deltaTimeSec) override;
+    void SetProfiler(FrameProfiler *pProfiler) override;
+
+private:
+    ComputeControllerParticleReset *_pParticleReseter;
+    ComputeControllerParticleUpdate *_pParticleUpdater;
+    ComputeControllerParticleCollisions *_pParticleCollider;
+    ComputeControllerActiveParticleCompaction *_pActiveParticleCompactor;
+    const ParticleSsbo *_pParticleBuffer;
+    ParticleReadbackRing *_pParticleReadbackRing;
+    QuadTreeNodeSsbo *_pQuadTreeBuffer;
+    CompactQuadTreeSsbo *_pCompactQuadTreeBuffer;
+    UniformGridSsbo *_pUniformGridBuffer;
+    ParticleLeafIndexSsbo *_pParticleLeafIndexBuffer;
+
+    // nodes or cells, depending on what was uploaded last
+    unsigned int _numUploadedNodes;
+    unsigned int _numParticles;
+    unsigned int _particlesPerEmitterPerFrame;
+    FrameProfiler *_pProfiler;
+};
@@ -0,0 +1,161 @@
+#include "GpuDispatchTimer.h"
+
+#include "IGpuTimerBackend.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values.  Nothing is timed until Enable(...).
+Parameters:
+    stage   Which of the profiler's PROFILER_STAGE_GPU_* stages the times go to.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+GpuDispatchTimer::GpuDispatchTimer(PROFILER_STAGE stage) :
+    _stage(stage),
+    _pBackend(0),
+    _pProfiler(0),
+    _currentQueryIndex(0),
+    _isTiming(false),
+    _lastGpuMs(0.0)
+{
+    for (unsigned int queryIndex = 0; queryIndex < NUM_QUERIES; queryIndex++)
+    {
+        _queryIds[queryIndex] = 0;
+        _queryIsPending[queryIndex] = false;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Deletes the queries, if there are any.  Any results that haven't been picked up are lost.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+GpuDispatchTimer::~GpuDispatchTimer()
+{
+    Enable(0, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Creates the queries with the backend, or deletes them if the backend is 0.
+Parameters:
+    pBackend    Not owned, and must outlive this timer or be taken away with Enable(0, 0).
+    pProfiler   Not owned.  May be 0, and then only LastGpuMs() is updated.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void GpuDispatchTimer::Enable(IGpuTimerBackend *pBackend, FrameProfiler *pProfiler)
+{
+    if (_pBackend != 0)
+    {
+        for (unsigned int queryIndex = 0; queryIndex < NUM_QUERIES; queryIndex++)
+        {
+            _pBackend->DeleteTimerQuery(_queryIds[queryIndex]);
+            _queryIds[queryIndex] = 0;
+            _queryIsPending[queryIndex] = false;
+        }
+    }
+
+    _pBackend = pBackend;
+    _pProfiler = pProfiler;
+    _currentQueryIndex = 0;
+    _isTiming = false;
+
+    if (_pBackend != 0)
+    {
+        for (unsigned int queryIndex = 0; queryIndex < NUM_QUERIES; queryIndex++)
+        {
+            _queryIds[queryIndex] = _pBackend->CreateTimerQuery();
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Picks up whatever results have finished, oldest first, and then starts timing with this
+    frame's query if that query's last result has been picked up.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void GpuDispatchTimer::Begin()
+{
+    if (_pBackend == 0)
+    {
+        return;
+    }
+
+    // the current query is from the frame before last, and the other one is from last frame
+    unsigned int previousQueryIndex = (_currentQueryIndex + 1) % NUM_QUERIES;
+    CollectResult(_currentQueryIndex);
+    CollectResult(previousQueryIndex);
+
+    if (_queryIsPending[_currentQueryIndex])
+    {
+        // still not done; don't wait for it
+        return;
+    }
+
+    _pBackend->BeginTimeElapsed(_queryIds[_currentQueryIndex]);
+    _isTiming = true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Stops timing, if Begin() started, and moves on to the other query for the next frame.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void GpuDispatchTimer::End()
+{
+    if (!_isTiming)
+    {
+        return;
+    }
+
+    _pBackend->EndTimeElapsed();
+    _queryIsPending[_currentQueryIndex] = true;
+    _currentQueryIndex = (_currentQueryIndex + 1) % NUM_QUERIES;
+    _isTiming = false;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the latest result that was picked up.
+Parameters: None
+Returns:
+    Milliseconds that the GPU took, or 0 if no result has been picked up yet.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+double GpuDispatchTimer::LastGpuMs() const
+{
+    return _lastGpuMs;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    If the query is waiting on a result and the result is available, reads it and adds it to
+    the profiler.  Otherwise does nothing.
+Parameters:
+    queryIndex  Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void GpuDispatchTimer::CollectResult(unsigned int queryIndex)
+{
+    unsigned int queryId = _queryIds[queryIndex];
+    if (!_queryIsPending[queryIndex] || !_pBackend->IsTimerResultAvailable(queryId))
+    {
+        return;
+    }
+
+    _lastGpuMs = (double)_pBackend->TimerResultNanoseconds(queryId) / 1000000.0;
+    _queryIsPending[queryIndex] = false;
+    if (_pProfiler != 0)
+    {
+        _pProfiler->AddStageTime(_stage, _lastGpuMs);
+    }
+}
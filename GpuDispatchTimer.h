@@ -0,0 +1,57 @@
+#pragma once
+
+#include "FrameProfiler.h"
+
+class IGpuTimerBackend;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Times a compute controller's dispatches on the GPU without waiting for the GPU.  Each
+    controller has one, and calls Begin() before its dispatches and End() after them.
+
+    There are two queries, and each frame uses the one that the frame before last used.  The
+    GPU is usually a frame behind, so Begin() first picks up any results that have finished
+    since and adds them to the profiler's GPU stage.  If a query still isn't done by the time
+    that it comes around again, that frame isn't timed rather than waiting for it.
+
+    Until Enable(...) is called with a backend, Begin() and End() do nothing, so the
+    controllers don't have to check, and nothing is timed with the headless stages (see
+    FrameStagesCpu), which have no dispatches anyway.
+
+    Note: OpenGL only has one GL_TIME_ELAPSED query going at a time, so the timers must not
+    overlap.  Each controller's Begin() and End() are in the same function, and the
+    controllers are called one after the other.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class GpuDispatchTimer
+{
+public:
+    GpuDispatchTimer(PROFILER_STAGE stage);
+    ~GpuDispatchTimer();
+
+    void Enable(IGpuTimerBackend *pBackend, FrameProfiler *pProfiler);
+    void Begin();
+    void End();
+
+    double LastGpuMs() const;
+
+private:
+    GpuDispatchTimer(const GpuDispatchTimer &) = delete;
+    GpuDispatchTimer &operator=(const GpuDispatchTimer &) = delete;
+
+    void CollectResult(unsigned int queryIndex);
+
+    static const unsigned int NUM_QUERIES = 2;
+
+    PROFILER_STAGE _stage;
+
+    // neither is owned; the backend is 0 until Enable(...), and the profiler may be 0
+    IGpuTimerBackend *_pBackend;
+    FrameProfiler *_pProfiler;
+
+    unsigned int _queryIds[NUM_QUERIES];
+    bool _queryIsPending[NUM_QUERIES];
+    unsigned int _currentQueryIndex;
+    bool _isTiming;
+    double _lastGpuMs;
+};
@@ -0,0 +1,91 @@
+#include "GpuTimerBackendOpenGl.h"
+
+#include "glload/include/glload/gl_4_4.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Generates a query object.  It doesn't become a timer query until it is first begun.
+Parameters: None
+Returns:
+    The query's ID.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int GpuTimerBackendOpenGl::CreateTimerQuery()
+{
+    GLuint queryId = 0;
+    glGenQueries(1, &queryId);
+    return queryId;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Self-explanatory
+Parameters:
+    queryId     From CreateTimerQuery().
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void GpuTimerBackendOpenGl::DeleteTimerQuery(unsigned int queryId)
+{
+    glDeleteQueries(1, &queryId);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Starts timing the commands that follow.  This is queued like any other command, so it
+    doesn't wait for anything.
+Parameters:
+    queryId     From CreateTimerQuery().
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void GpuTimerBackendOpenGl::BeginTimeElapsed(unsigned int queryId)
+{
+    glBeginQuery(GL_TIME_ELAPSED, queryId);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Stops timing.  There is only one GL_TIME_ELAPSED target, so it doesn't need the ID.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void GpuTimerBackendOpenGl::EndTimeElapsed()
+{
+    glEndQuery(GL_TIME_ELAPSED);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Asks whether the GPU has gotten to the end of the query yet.  Doesn't wait.
+Parameters:
+    queryId     Must have been begun and ended at least once.
+Returns:
+    True if TimerResultNanoseconds(...) will return right away.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+bool GpuTimerBackendOpenGl::IsTimerResultAvailable(unsigned int queryId)
+{
+    GLint isAvailable = GL_FALSE;
+    glGetQueryObjectiv(queryId, GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+    return isAvailable != GL_FALSE;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Reads the query's result.
+
+    Note: The 32-bit result would overflow after ~4 seconds, so this uses the 64-bit one.
+Parameters:
+    queryId     Must be available (see IsTimerResultAvailable(...)), or this waits for it.
+Returns:
+    Nanoseconds between the begin and the end.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned long long GpuTimerBackendOpenGl::TimerResultNanoseconds(unsigned int queryId)
+{
+    GLuint64 nanoseconds = 0;
+    glGetQueryObjectui64v(queryId, GL_QUERY_RESULT, &nanoseconds);
+    return nanoseconds;
+}
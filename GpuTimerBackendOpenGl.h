@@ -0,0 +1,21 @@
+#pragma once
+
+#include "IGpuTimerBackend.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The OpenGL implementation of IGpuTimerBackend with GL_TIME_ELAPSED queries.  Requires
+    OpenGL 3.3 for the 64-bit results, and like the SSBOs, the OpenGL context must be started
+    before any of these are called.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class GpuTimerBackendOpenGl : public IGpuTimerBackend
+{
+public:
+    unsigned int CreateTimerQuery() override;
+    void DeleteTimerQuery(unsigned int queryId) override;
+    void BeginTimeElapsed(unsigned int queryId) override;
+    void EndTimeElapsed() override;
+    bool IsTimerResultAvailable(unsigned int queryId) override;
+    unsigned long long TimerResultNanoseconds(unsigned int queryId) override;
+};
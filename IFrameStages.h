@@ -0,0 +1,45 @@
+#pragma once
+
+#include "ParticleQuadTreeNode.h"
+#include "ISpatialIndex.h"
+#include "glm/vec2.hpp"
+
+class FrameProfiler;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The stages of a frame that FrameScheduler puts in order around its tree-builder thread.  
+    FrameStagesOpenGl runs them with the compute shaders, and FrameStagesCpu runs them with 
+    SimulationEngine so that the scheduler can be run headless.
+
+    All of these are called from the thread that calls FrameScheduler::RunFrame(...) (the 
+    thread with the OpenGL context), never from the tree-builder thread.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class IFrameStages
+{
+public:
+    virtual ~IFrameStages() {}
+
+    virtual unsigned int NumParticles() const = 0;
+
+    // reset inactive particles to the emitters and integrate the active ones
+    virtual void UpdateParticles(float deltaTimeSec) = 0;
+
+    // fills NumParticles() positions and state flags (packed as in ParticleSoA); returns false 
+    // if there is nothing to read yet
+    virtual bool ReadParticles(glm::vec2 *positions, unsigned int *stateFlags) = 0;
+
+    // the nodes (or the index) stay valid until after the following CollideParticles(...), 
+    // which collides with whichever was uploaded last
+    // Note: particleLeafIndices, if not 0, is NumParticles() leaf indices (see 
+    // ParticleQuadTree::CopyParticleLeafIndices(...)) so that the collisions don't have to 
+    // find each particle's leaf themselves.
+    virtual void UploadQuadTree(const ParticleQuadTreeNode *allNodes, unsigned int numNodes, 
+        const unsigned int *particleLeafIndices) = 0;
+    virtual void UploadSpatialIndex(const ISpatialIndex *pSpatialIndex) = 0;
+    virtual void CollideParticles(float deltaTimeSec) = 0;
+
+    // the stages time their own reset and update with it; 0 (the default) times nothing
+    virtual void SetProfiler(FrameProfiler *pProfiler) = 0;
+};
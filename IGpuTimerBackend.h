@@ -0,0 +1,28 @@
+#pragma once
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The OpenGL timer query calls that GpuDispatchTimer needs, behind an interface like
+    IReadbackBackend so that the timer's double buffering can be run without an OpenGL
+    context.  GpuTimerBackendOpenGl is the real one.
+
+    Query IDs are the same unsigned ints as elsewhere in this program, and 0 is never a query.
+    Only one query can be timing at a time.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class IGpuTimerBackend
+{
+public:
+    virtual ~IGpuTimerBackend() {}
+
+    virtual unsigned int CreateTimerQuery() = 0;
+    virtual void DeleteTimerQuery(unsigned int queryId) = 0;
+
+    // the time between these is how long the GPU took with the commands between them
+    virtual void BeginTimeElapsed(unsigned int queryId) = 0;
+    virtual void EndTimeElapsed() = 0;
+
+    // the result must not be asked for until it is available, or it will wait for the GPU
+    virtual bool IsTimerResultAvailable(unsigned int queryId) = 0;
+    virtual unsigned long long TimerResultNanoseconds(unsigned int queryId) = 0;
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The handful of OpenGL calls that ParticleReadbackRing needs, behind an interface so that the 
+    ring's bookkeeping can be run without an OpenGL context.  ReadbackBackendOpenGl is the real 
+    one.  A fake one only needs to hand out some system memory for each buffer, do a memcpy for 
+    the copy, and decide when each fence is signaled.
+
+    Buffer IDs are the same unsigned ints as elsewhere in this program.  Fences are opaque 
+    pointers (GLsync is a pointer too), and 0 means "no fence".
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class IReadbackBackend
+{
+public:
+    virtual ~IReadbackBackend() {}
+
+    // creates a buffer that stays mapped for reading for its whole life; returns 0 on failure
+    virtual unsigned int CreatePersistentReadBuffer(unsigned int sizeBytes, const void **mappedPtr) = 0;
+    virtual void DeletePersistentReadBuffer(unsigned int bufferId) = 0;
+
+    // queues a GPU-side copy of the first sizeBytes of the source into the destination
+    virtual void CopyBuffer(unsigned int sourceBufferId, unsigned int destinationBufferId, 
+        unsigned int sizeBytes) = 0;
+
+    // a fence is signaled once every command before it has finished
+    virtual void *InsertFence() = 0;
+    virtual bool WaitForFence(void *fence, unsigned long long timeoutNanoseconds) = 0;
+    virtual void DeleteFence(void *fence) = 0;
+};
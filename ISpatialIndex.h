@@ -0,0 +1,53 @@
+#pragma once
+
+#include "glm/vec2.hpp"
+#include "Particle.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Which broadphase structure the collisions run against.  ParticleQuadTree is not an 
+    ISpatialIndex (its leaves hold their own particles and store their neighbors), so it is 
+    handled separately by whatever takes one of these.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+enum SPATIAL_INDEX_TYPE
+{
+    SPATIAL_INDEX_QUAD_TREE = 0,
+    SPATIAL_INDEX_COMPACT_QUAD_TREE,
+    SPATIAL_INDEX_UNIFORM_GRID
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A broadphase for the particle collisions that puts the active particles' indices in one 
+    pool, sorted so that the particles that are close together are in runs, and that can say 
+    which runs of the pool might have particles within collision range of a position.  
+    CompactParticleQuadTree and ParticleUniformGrid are the two kinds.
+
+    The index is rebuilt from scratch on every Build(...).  Nothing else about it changes 
+    between builds, so a built index can be handed to another thread and read there.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class ISpatialIndex
+{
+public:
+    virtual ~ISpatialIndex() {}
+
+    // only the active particles are put in the pool
+    virtual void Build(const Particle *particleCollection, int numParticles) = 0;
+    virtual void Build(const glm::vec2 *positions, const unsigned int *stateFlags, 
+        int numParticles) = 0;
+
+    virtual const int *ParticleIndexPool() const = 0;
+    virtual unsigned int ParticleIndexPoolSize() const = 0;
+
+    // nodes for a tree, cells for a grid; only for stats
+    virtual unsigned int NumCells() const = 0;
+
+    // fills in up to MAX_CANDIDATE_RUNS (offset, count) runs of the pool, the first one being 
+    // the one that the position is in; returns how many
+    virtual unsigned int FindCandidateRuns(float x, float y, unsigned int *runOffsets, 
+        unsigned int *runCounts) const = 0;
+
+    static const unsigned int MAX_CANDIDATE_RUNS = 9;
+};
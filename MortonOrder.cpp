@@ -0,0 +1,93 @@
+#include "MortonOrder.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sorts the keys, and the particle indices along with them, 8 bits at a time, starting with 
+    the lowest.  Each pass is stable, so particles with the same key stay in index order.  
+    Passes where every key has the same 8 bits are skipped, which is common for the top byte.
+Parameters: 
+    keys                    The Morton keys.
+    particleIndices         Same size as keys.  Moved around with them.
+    keysScratch             Resized as needed.  Passed in so that it can keep its memory 
+                            from frame to frame.
+    particleIndicesScratch  Same idea.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+            (moved out of ParticleQuadTree 10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void RadixSortMortonKeys(std::vector<unsigned int> &keys, std::vector<int> &particleIndices, 
+    std::vector<unsigned int> &keysScratch, std::vector<int> &particleIndicesScratch)
+{
+    unsigned int numKeys = (unsigned int)keys.size();
+    keysScratch.resize(numKeys);
+    particleIndicesScratch.resize(numKeys);
+
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        unsigned int bucketOffsets[256] = { 0 };
+        for (unsigned int keyIndex = 0; keyIndex < numKeys; keyIndex++)
+        {
+            bucketOffsets[(keys[keyIndex] >> shift) & 0xff]++;
+        }
+
+        if (numKeys == 0 || bucketOffsets[(keys[0] >> shift) & 0xff] == numKeys)
+        {
+            // already sorted on these bits
+            continue;
+        }
+
+        // bucket counts -> where each bucket starts
+        unsigned int runningTotal = 0;
+        for (int bucket = 0; bucket < 256; bucket++)
+        {
+            unsigned int bucketSize = bucketOffsets[bucket];
+            bucketOffsets[bucket] = runningTotal;
+            runningTotal += bucketSize;
+        }
+
+        for (unsigned int keyIndex = 0; keyIndex < numKeys; keyIndex++)
+        {
+            unsigned int key = keys[keyIndex];
+            unsigned int destination = bucketOffsets[(key >> shift) & 0xff]++;
+            keysScratch[destination] = key;
+            particleIndicesScratch[destination] = particleIndices[keyIndex];
+        }
+
+        keys.swap(keysScratch);
+        particleIndices.swap(particleIndicesScratch);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The keys in the given range share everything above the 2 bits at keyShift, and those 2 
+    bits only go up, so a binary search finds where one quadrant stops and the next one starts.
+Parameters: 
+    keys        Morton keys, sorted.
+    begin       The first key in the range.
+    end         One past the last key in the range.
+    keyShift    Where the quadrant's 2 bits are.
+    quadrant    0-3 (see ClassifyQuadrants(...)).
+Returns:    
+    The index of the first key in the range whose quadrant is at least the given one.
+Creator:    John Cox (10-16-2026)
+            (moved out of ParticleQuadTree 10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int FirstMortonKeyInQuadrant(const unsigned int *keys, unsigned int begin, 
+    unsigned int end, int keyShift, unsigned int quadrant)
+{
+    while (begin < end)
+    {
+        unsigned int middle = begin + ((end - begin) / 2);
+        if (((keys[middle] >> keyShift) & 3) < quadrant)
+        {
+            begin = middle + 1;
+        }
+        else
+        {
+            end = middle;
+        }
+    }
+
+    return begin;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <vector>
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Helpers for building a quad tree out of Morton keys (see ComputeMortonKeys(...) in 
+    QuadrantClassification.h).  Once the keys are sorted, every quad tree node's particles are 
+    one contiguous run of the sorted particles, and each node's run can be cut into its four 
+    children's runs with a binary search on that node's 2 bits of the key.
+
+    CompactParticleQuadTree builds this way.  ParticleQuadTree's linear build only uses the 
+    sort, and cuts the runs with the same center line comparisons as the rest of 
+    ParticleQuadTree.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+
+void RadixSortMortonKeys(std::vector<unsigned int> &keys, std::vector<int> &particleIndices, 
+    std::vector<unsigned int> &keysScratch, std::vector<int> &particleIndicesScratch);
+unsigned int FirstMortonKeyInQuadrant(const unsigned int *keys, unsigned int begin, 
+    unsigned int end, int keyShift, unsigned int quadrant);
@@ -58,7 +58,7 @@ void APIENTRY DebugFunc(GLenum source, GLenum type, GLuint id, GLenum severity,
         break;
     }
 
-    fprintf(stderr, "DebugFunc: length = '%d', id = '%u', userParam = '%x'\n", length, id, (unsigned int)userParam);
+    fprintf(stderr, "DebugFunc: length = '%d', id = '%u', userParam = '%p'\n", length, id, userParam);
     fprintf(stderr, "%s from %s,\t%s priority\nMessage: %s\n",
         errorType.c_str(), srcName.c_str(), typeSeverity.c_str(), message);
     fprintf(stderr, "\n");  // separate this error from the next thing that prints
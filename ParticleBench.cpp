@@ -0,0 +1,393 @@
+// particle_bench: runs scenario files (see BenchmarkScenario) headless, with SimulationEngine
+// behind the same FrameScheduler as main.cpp, and reports how fast each one ran.  There is no
+// window, so GLUT, FreeType, and OpenGL aren't needed.
+//
+//  particle_bench [--frames N] [--format csv|json] [--out file] scenario.txt [scenario.txt ...]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "BenchmarkScenario.h"
+#include "SimulationEngine.h"
+#include "ParticleEmitterBar.h"
+#include "ParticleEmitterPoint.h"
+#include "FrameStagesCpu.h"
+#include "FrameScheduler.h"
+#include "FrameProfiler.h"
+#include "Stopwatch.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <psapi.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "psapi.lib")
+#endif
+#else
+#include <sys/resource.h>
+#endif
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    What one scenario's run is reported as.  The per-frame times are over the measured frames
+    only, not the warmup.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+struct BenchmarkResult
+{
+    std::string _scenarioName;
+    unsigned int _numFrames;
+    double _totalSeconds;
+    double _framesPerSecond;
+    FrameStageSummary _frame;
+    FrameStageSummary _treeBuild;
+    FrameStageSummary _collide;
+    double _meanActiveParticles;
+    double _meanCollisionPairs;
+    unsigned long long _totalCollisionPairs;
+    unsigned long long _peakMemoryBytes;
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Asks the OS for the most memory that this process has had resident at one time.
+Parameters: None
+Returns:
+    Bytes, or 0 if the OS wouldn't say.  This is for the whole process so far, so with more
+    than one scenario, it is the biggest of them up to that one.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static unsigned long long PeakMemoryBytes()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS memoryCounters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &memoryCounters, sizeof(memoryCounters)))
+    {
+        return 0;
+    }
+    return memoryCounters.PeakWorkingSetSize;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+#ifdef __APPLE__
+    // already bytes
+    return (unsigned long long)usage.ru_maxrss;
+#else
+    // kilobytes
+    return (unsigned long long)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Counts the collisions from the last CollideParticles(...).  Both particles in a collision
+    count it, so each pair is counted twice.
+Parameters:
+    engine  Self-explanatory
+Returns:
+    The number of colliding pairs.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static unsigned long long CountCollisionPairs(const SimulationEngine &engine)
+{
+    const Particle *allParticles = engine.ParticleBuffer();
+    unsigned long long numCollisions = 0;
+    for (unsigned int particleIndex = 0; particleIndex < engine.NumParticles(); particleIndex++)
+    {
+        numCollisions += (unsigned int)allParticles[particleIndex]._collisionCountThisFrame;
+    }
+    return numCollisions / 2;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets up the engine, the emitters, and the scheduler as the scenario says, runs the warmup
+    frames, and then runs and times the measured ones.
+Parameters:
+    scenario    Self-explanatory
+    pResult     Receives the run's numbers.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void RunScenario(const BenchmarkScenario &scenario, BenchmarkResult *pResult)
+{
+    glm::vec4 particleRegionCenter(scenario._particleRegionCenter, 0.0f, 1.0f);
+    SimulationEngine engine(scenario._numParticles, particleRegionCenter,
+        scenario._particleRegionRadius);
+    engine.SetRandomSeed(scenario._randomSeed);
+    engine.SetNumCollisionThreads(scenario._numCollisionThreads);
+    engine.SetSymmetricCollisions(scenario._useSymmetricCollisions);
+    engine.SetUseParticleFreeList(scenario._useParticleFreeList);
+
+    // the engine doesn't own the emitters
+    std::vector<IParticleEmitter *> emitters;
+    for (size_t emitterIndex = 0; emitterIndex < scenario._emitters.size(); emitterIndex++)
+    {
+        const BenchmarkScenarioEmitter &emitter = scenario._emitters[emitterIndex];
+        IParticleEmitter *pEmitter = 0;
+        if (emitter._isBarEmitter)
+        {
+            pEmitter = new ParticleEmitterBar(emitter._p1, emitter._p2, emitter._emitDir,
+                emitter._minVelocity, emitter._maxVelocity);
+        }
+        else
+        {
+            pEmitter = new ParticleEmitterPoint(emitter._p1, emitter._minVelocity,
+                emitter._maxVelocity);
+        }
+        emitters.push_back(pEmitter);
+        engine.AddEmitter(pEmitter);
+    }
+
+    FrameStagesCpu stages(&engine, scenario._particlesPerEmitterPerFrame);
+    FrameScheduler scheduler(&stages, particleRegionCenter, scenario._particleRegionRadius,
+        scenario._framesOfCollisionLatency, scenario._spatialIndexType);
+
+    for (unsigned int frameCount = 0; frameCount < scenario._numWarmupFrames; frameCount++)
+    {
+        scheduler.RunFrame(scenario._deltaTimeSec);
+    }
+
+    // every measured frame is kept, so the summaries are over all of them
+    FrameProfiler profiler(scenario._numFrames);
+    scheduler.SetProfiler(&profiler);
+
+    unsigned long long totalActiveParticles = 0;
+    unsigned long long totalCollisionPairs = 0;
+    Stopwatch runStopwatch;
+    for (unsigned int frameCount = 0; frameCount < scenario._numFrames; frameCount++)
+    {
+        profiler.BeginFrame();
+        scheduler.RunFrame(scenario._deltaTimeSec);
+        profiler.EndFrame();
+
+        // not timed as part of the frame, but still part of the run's wall time
+        totalActiveParticles += engine.NumActiveParticles();
+        totalCollisionPairs += CountCollisionPairs(engine);
+    }
+    double totalSeconds = runStopwatch.TotalTime();
+    scheduler.SetProfiler(0);
+
+    pResult->_scenarioName = scenario._name;
+    pResult->_numFrames = scenario._numFrames;
+    pResult->_totalSeconds = totalSeconds;
+    pResult->_framesPerSecond = (double)scenario._numFrames / totalSeconds;
+    pResult->_frame = profiler.Summarize(PROFILER_STAGE_FRAME);
+    pResult->_treeBuild = profiler.Summarize(PROFILER_STAGE_TREE_BUILD);
+    pResult->_collide = profiler.Summarize(PROFILER_STAGE_COLLIDE);
+    pResult->_meanActiveParticles = (double)totalActiveParticles / scenario._numFrames;
+    pResult->_meanCollisionPairs = (double)totalCollisionPairs / scenario._numFrames;
+    pResult->_totalCollisionPairs = totalCollisionPairs;
+    pResult->_peakMemoryBytes = PeakMemoryBytes();
+
+    for (size_t emitterIndex = 0; emitterIndex < emitters.size(); emitterIndex++)
+    {
+        delete emitters[emitterIndex];
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Writes the results as CSV with a header row and one row per scenario.
+Parameters:
+    outFile     Self-explanatory
+    results     Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void WriteCsv(FILE *outFile, const std::vector<BenchmarkResult> &results)
+{
+    fprintf(outFile, "scenario,frames,seconds,frames_per_sec,"
+        "frame_ms_mean,frame_ms_p99,tree_build_ms_mean,tree_build_ms_p99,"
+        "collide_ms_mean,collide_ms_p99,active_particles_mean,"
+        "collision_pairs_mean,collision_pairs_total,peak_memory_bytes\n");
+    for (size_t resultIndex = 0; resultIndex < results.size(); resultIndex++)
+    {
+        const BenchmarkResult &result = results[resultIndex];
+        fprintf(outFile, "%s,%u,%.4f,%.2f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.1f,%.1f,%llu,%llu\n",
+            result._scenarioName.c_str(), result._numFrames, result._totalSeconds,
+            result._framesPerSecond, result._frame._meanMs, result._frame._p99Ms,
+            result._treeBuild._meanMs, result._treeBuild._p99Ms, result._collide._meanMs,
+            result._collide._p99Ms, result._meanActiveParticles, result._meanCollisionPairs,
+            result._totalCollisionPairs, result._peakMemoryBytes);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Writes the results as a JSON array with one object per scenario.
+
+    Note: Scenario names come from the scenario files and aren't escaped, so they shouldn't
+    have quotes or backslashes in them.
+Parameters:
+    outFile     Self-explanatory
+    results     Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void WriteJson(FILE *outFile, const std::vector<BenchmarkResult> &results)
+{
+    fprintf(outFile, "[\n");
+    for (size_t resultIndex = 0; resultIndex < results.size(); resultIndex++)
+    {
+        const BenchmarkResult &result = results[resultIndex];
+        fprintf(outFile, "  {\n");
+        fprintf(outFile, "    \"scenario\": \"%s\",\n", result._scenarioName.c_str());
+        fprintf(outFile, "    \"frames\": %u,\n", result._numFrames);
+        fprintf(outFile, "    \"seconds\": %.4f,\n", result._totalSeconds);
+        fprintf(outFile, "    \"frames_per_sec\": %.2f,\n", result._framesPerSecond);
+        fprintf(outFile, "    \"frame_ms\": { \"min\": %.4f, \"mean\": %.4f, \"p99\": %.4f, \"max\": %.4f },\n",
+            result._frame._minMs, result._frame._meanMs, result._frame._p99Ms, result._frame._maxMs);
+        fprintf(outFile, "    \"tree_build_ms\": { \"min\": %.4f, \"mean\": %.4f, \"p99\": %.4f, \"max\": %.4f },\n",
+            result._treeBuild._minMs, result._treeBuild._meanMs, result._treeBuild._p99Ms,
+            result._treeBuild._maxMs);
+        fprintf(outFile, "    \"collide_ms\": { \"min\": %.4f, \"mean\": %.4f, \"p99\": %.4f, \"max\": %.4f },\n",
+            result._collide._minMs, result._collide._meanMs, result._collide._p99Ms,
+            result._collide._maxMs);
+        fprintf(outFile, "    \"active_particles_mean\": %.1f,\n", result._meanActiveParticles);
+        fprintf(outFile, "    \"collision_pairs_mean\": %.1f,\n", result._meanCollisionPairs);
+        fprintf(outFile, "    \"collision_pairs_total\": %llu,\n", result._totalCollisionPairs);
+        fprintf(outFile, "    \"peak_memory_bytes\": %llu\n", result._peakMemoryBytes);
+        fprintf(outFile, "  }%s\n", (resultIndex + 1 < results.size()) ? "," : "");
+    }
+    fprintf(outFile, "]\n");
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Self-explanatory
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void PrintUsage()
+{
+    fprintf(stderr, "usage: particle_bench [--frames N] [--format csv|json] [--out file] "
+        "scenario.txt [scenario.txt ...]\n");
+    fprintf(stderr, "  --frames N   overrides every scenario's \"frames\"\n");
+    fprintf(stderr, "  --format     csv (the default) or json\n");
+    fprintf(stderr, "  --out file   writes there instead of to stdout\n");
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Loads every scenario first, so that a typo in the last one doesn't waste the runs before
+    it, then runs them in order and writes the results.
+Parameters:
+    argc    See PrintUsage().
+    argv    See PrintUsage().
+Returns:
+    0 if every scenario ran, 1 if the arguments or a scenario file were bad.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+int main(int argc, char *argv[])
+{
+    unsigned int framesOverride = 0;
+    bool writeJson = false;
+    const char *outFilePath = 0;
+    std::vector<std::string> scenarioFilePaths;
+    for (int argIndex = 1; argIndex < argc; argIndex++)
+    {
+        const char *arg = argv[argIndex];
+        bool hasValue = (argIndex + 1) < argc;
+        if (strcmp(arg, "--frames") == 0 && hasValue)
+        {
+            framesOverride = (unsigned int)strtoul(argv[++argIndex], 0, 10);
+            if (framesOverride == 0)
+            {
+                PrintUsage();
+                return 1;
+            }
+        }
+        else if (strcmp(arg, "--format") == 0 && hasValue)
+        {
+            const char *format = argv[++argIndex];
+            if (strcmp(format, "json") == 0)
+            {
+                writeJson = true;
+            }
+            else if (strcmp(format, "csv") != 0)
+            {
+                PrintUsage();
+                return 1;
+            }
+        }
+        else if (strcmp(arg, "--out") == 0 && hasValue)
+        {
+            outFilePath = argv[++argIndex];
+        }
+        else if (arg[0] == '-')
+        {
+            PrintUsage();
+            return 1;
+        }
+        else
+        {
+            scenarioFilePaths.push_back(arg);
+        }
+    }
+
+    if (scenarioFilePaths.empty())
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    std::vector<BenchmarkScenario> scenarios(scenarioFilePaths.size());
+    for (size_t scenarioIndex = 0; scenarioIndex < scenarios.size(); scenarioIndex++)
+    {
+        std::string errorMessage;
+        if (!scenarios[scenarioIndex].LoadFromFile(scenarioFilePaths[scenarioIndex], &errorMessage))
+        {
+            fprintf(stderr, "particle_bench: %s\n", errorMessage.c_str());
+            return 1;
+        }
+
+        if (framesOverride > 0)
+        {
+            scenarios[scenarioIndex]._numFrames = framesOverride;
+        }
+    }
+
+    std::vector<BenchmarkResult> results(scenarios.size());
+    for (size_t scenarioIndex = 0; scenarioIndex < scenarios.size(); scenarioIndex++)
+    {
+        // progress goes to stderr so that stdout is only the results
+        fprintf(stderr, "running %s (%u frames)\n", scenarios[scenarioIndex]._name.c_str(),
+            scenarios[scenarioIndex]._numFrames);
+        RunScenario(scenarios[scenarioIndex], &results[scenarioIndex]);
+    }
+
+    FILE *outFile = stdout;
+    if (outFilePath != 0)
+    {
+        outFile = fopen(outFilePath, "w");
+        if (outFile == 0)
+        {
+            fprintf(stderr, "particle_bench: could not open '%s'\n", outFilePath);
+            return 1;
+        }
+    }
+
+    if (writeJson)
+    {
+        WriteJson(outFile, results);
+    }
+    else
+    {
+        WriteCsv(outFile, results);
+    }
+
+    if (outFile != stdout)
+    {
+        fclose(outFile);
+    }
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include "ParticleEmitterSsbo.h"
+
+#include "glload/include/glload/gl_4_4.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Calls the base class to give members initial values (zeros).
+
+    Allocates room for one emitter so that the buffer can be bound before there is a table
+    to upload.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleEmitterSsbo::ParticleEmitterSsbo() :
+    SsboBase()  // generate buffers
+{
+    // ignore _numVertices because this SSBO does not draw
+
+    GLuint bufferSizeBytes = sizeof(ParticleEmitterData);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSizeBytes, 0, GL_STATIC_DRAW);
+
+    _bufferSizeBytes = bufferSizeBytes;
+
+    // cleanup
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Binds the buffer to the shader's storage block.  If the shader doesn't have it, nothing
+    happens.
+
+    Note: It is ok to call this function for multiple compute shaders so that the same SSBO
+    can be used in each shader.  No member variables are altered in this function.
+Parameters:
+    computeProgramId    Self-explanatory
+    bufferNameInShader  Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleEmitterSsbo::ConfigureCompute(unsigned int computeProgramId,
+    const std::string &bufferNameInShader)
+{
+    GLuint storageBlockIndex = glGetProgramResourceIndex(computeProgramId, GL_SHADER_STORAGE_BLOCK, bufferNameInShader.c_str());
+    if (storageBlockIndex == GL_INVALID_INDEX)
+    {
+        return;
+    }
+
+    glShaderStorageBlockBinding(computeProgramId, storageBlockIndex, _ssboBindingPointIndex);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, _ssboBindingPointIndex, _bufferId);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Like CompactQuadTreeSsbo, this SSBO does not draw.
+Parameters:
+    irrelevant
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleEmitterSsbo::ConfigureRender(unsigned int, unsigned int)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Replaces the buffer's contents with the table.  The buffer only grows, and it is bound
+    again because glBufferData(...) makes a new data store.
+Parameters:
+    emitterTable    Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleEmitterSsbo::Upload(const ParticleEmitterTable &emitterTable)
+{
+    GLuint tableSizeBytes = sizeof(ParticleEmitterData) * emitterTable.NumEmitters();
+    if (tableSizeBytes == 0)
+    {
+        return;
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+    if (tableSizeBytes > _bufferSizeBytes)
+    {
+        glBufferData(GL_SHADER_STORAGE_BUFFER, tableSizeBytes, emitterTable.Emitters(), GL_STATIC_DRAW);
+        _bufferSizeBytes = tableSizeBytes;
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, _ssboBindingPointIndex, _bufferId);
+    }
+    else
+    {
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, tableSizeBytes, emitterTable.Emitters());
+    }
+
+    // cleanup
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "SsboBase.h"
+#include "ParticleEmitterTable.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets up the Shader Storage Block Object for a ParticleEmitterTable so that the reset
+    shader can spawn particles for every emitter in one dispatch (see
+    ComputeControllerParticleReset).  The emitters don't move, so the table is uploaded once,
+    and again only if an emitter is added.
+
+    Nothing here is ever read by the CPU.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class ParticleEmitterSsbo : public SsboBase
+{
+public:
+    ParticleEmitterSsbo();
+    virtual ~ParticleEmitterSsbo() override = default; // empty override of base destructor
+
+    void ConfigureCompute(unsigned int computeProgramId, const std::string &bufferNameInShader) override;
+    void ConfigureRender(unsigned int renderProgramId, unsigned int drawStyle) override;
+
+    void Upload(const ParticleEmitterTable &emitterTable);
+};
@@ -0,0 +1,94 @@
+#include "ParticleEmitterTable.h"
+
+#include "ParticleEmitterPoint.h"
+#include "ParticleEmitterBar.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Starts out with no emitters.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleEmitterTable::ParticleEmitterTable() :
+    _numPointEmitters(0)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Copies a point or bar emitter into the table.  A point emitter goes after the other point
+    emitters and ahead of every bar emitter, and a bar emitter goes at the end.
+
+    If, for some reason, the particle emitter cannot be cast to either a point emitter or a bar
+    emitter, then the table is left alone and "false" is returned.
+Parameters:
+    pEmitter    A pointer to a "particle emitter" interface.
+Returns:
+    True if the emitter was added, otherwise false.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticleEmitterTable::AddEmitter(const IParticleEmitter *pEmitter)
+{
+    const ParticleEmitterPoint *pointEmitter =
+        dynamic_cast<const ParticleEmitterPoint *>(pEmitter);
+    const ParticleEmitterBar *barEmitter =
+        dynamic_cast<const ParticleEmitterBar *>(pEmitter);
+
+    ParticleEmitterData emitter;
+    emitter._padding = 0;
+    if (pointEmitter != 0)
+    {
+        emitter._p1 = pointEmitter->GetPos();
+        emitter._p2 = pointEmitter->GetPos();
+        emitter._emitDir = glm::vec4();
+        emitter._minVelocity = pointEmitter->GetMinVelocity();
+        emitter._deltaVelocity = pointEmitter->GetDeltaVelocity();
+        emitter._isBarEmitter = 0;
+
+        _emitters.insert(_emitters.begin() + _numPointEmitters, emitter);
+        _numPointEmitters++;
+        return true;
+    }
+    else if (barEmitter != 0)
+    {
+        emitter._p1 = barEmitter->GetBarStart();
+        emitter._p2 = barEmitter->GetBarEnd();
+        emitter._emitDir = barEmitter->GetEmitDir();
+        emitter._minVelocity = barEmitter->GetMinVelocity();
+        emitter._deltaVelocity = barEmitter->GetDeltaVelocity();
+        emitter._isBarEmitter = 1;
+
+        _emitters.push_back(emitter);
+        return true;
+    }
+
+    return false;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    How many emitters are in the table.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int ParticleEmitterTable::NumEmitters() const
+{
+    return (unsigned int)_emitters.size();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter.
+Parameters: None
+Returns:
+    A pointer to the first of NumEmitters() emitters.  Not valid after the next
+    AddEmitter(...).
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+const ParticleEmitterData *ParticleEmitterTable::Emitters() const
+{
+    return _emitters.data();
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "IParticleEmitter.h"
+#include "glm/vec4.hpp"
+#include <vector>
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Everything that the reset needs to know about one emitter, point or bar, so that all of
+    them can be in one array.  Must match the ParticleEmitter structure in the
+    particleReset*.comp shaders.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+struct ParticleEmitterData
+{
+    // a point emitter's center is _p1; a bar emitter goes from _p1 to _p2 and launches its
+    // particles along _emitDir
+    glm::vec4 _p1;
+    glm::vec4 _p2;
+    glm::vec4 _emitDir;
+    float _minVelocity;
+    float _deltaVelocity;
+    unsigned int _isBarEmitter;
+
+    // std430 rounds the structure up to a multiple of a vec4
+    unsigned int _padding;
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A flat array of every emitter, point emitters first and then bar emitters, each in the
+    order that they were added.  That is the order that the reset used to give each emitter
+    its turn, so emitter N gets the inactive particles that the Nth of those turns would have
+    gotten.  Both ComputeControllerParticleReset, which uploads it to a ParticleEmitterSsbo,
+    and SimulationEngine use it, so that the GPU and the CPU spawn from the same table.
+
+    Note: An emitter is read when it is added, so it must have its transform by then.
+
+    Also Note: Like ComputeControllerParticleReset, this class does not own the emitters,
+    and it doesn't keep them either.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class ParticleEmitterTable
+{
+public:
+    ParticleEmitterTable();
+
+    bool AddEmitter(const IParticleEmitter *pEmitter);
+
+    unsigned int NumEmitters() const;
+    const ParticleEmitterData *Emitters() const;
+
+private:
+    unsigned int _numPointEmitters;
+    std::vector<ParticleEmitterData> _emitters;
+};
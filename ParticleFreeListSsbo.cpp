@@ -0,0 +1,79 @@
+#include "ParticleFreeListSsbo.h"
+
+#include <vector>
+#include "glload/include/glload/gl_4_4.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Calls the base class to give members initial values (zeros).
+
+    Allocates the count and room for every particle's index, and fills it with every particle, 
+    in reverse so that the first pops come out in index order like the reset shader's scan 
+    used to pick them.
+Parameters:
+    maxParticles    Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleFreeListSsbo::ParticleFreeListSsbo(unsigned int maxParticles) :
+    SsboBase()  // generate buffers
+{
+    // ignore _numVertices because this SSBO does not draw
+
+    // the count (an int in the shaders so that a pop can go below 0 and be undone) and then 
+    // the indices
+    std::vector<unsigned int> initialData(1 + maxParticles);
+    initialData[0] = maxParticles;
+    for (unsigned int slot = 0; slot < maxParticles; slot++)
+    {
+        initialData[1 + slot] = maxParticles - 1 - slot;
+    }
+
+    // Note: Only the shaders read and write it, hence "copy".
+    GLuint bufferSizeBytes = sizeof(unsigned int) * (1 + maxParticles);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSizeBytes, initialData.data(), GL_DYNAMIC_COPY);
+
+    _bufferSizeBytes = bufferSizeBytes;
+
+    // cleanup
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Binds the buffer to the shader's storage block.  If the shader doesn't have it, nothing 
+    happens.
+
+    Note: It is ok to call this function for multiple compute shaders so that the same SSBO 
+    can be used in each shader.  No member variables are altered in this function.
+Parameters:
+    computeProgramId    Self-explanatory
+    bufferNameInShader  Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleFreeListSsbo::ConfigureCompute(unsigned int computeProgramId, 
+    const std::string &bufferNameInShader)
+{
+    GLuint storageBlockIndex = glGetProgramResourceIndex(computeProgramId, GL_SHADER_STORAGE_BLOCK, bufferNameInShader.c_str());
+    if (storageBlockIndex == GL_INVALID_INDEX)
+    {
+        return;
+    }
+
+    glShaderStorageBlockBinding(computeProgramId, storageBlockIndex, _ssboBindingPointIndex);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, _ssboBindingPointIndex, _bufferId);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Like CompactQuadTreeSsbo, this SSBO does not draw.
+Parameters:
+    irrelevant
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleFreeListSsbo::ConfigureRender(unsigned int, unsigned int)
+{
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "SsboBase.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets up the Shader Storage Block Object for a stack of the indices of inactive particles, 
+    so that the reset shader can take as many as it will emit instead of going through every 
+    particle to find them (see ComputeControllerParticleReset::SetUseParticleFreeList(...)).  
+    The update shader pushes each particle that it deactivates and the reset shader pops, 
+    both with an atomic add on the count, and since they are never dispatched at the same 
+    time, the entries below the count never move.
+
+    It starts out with every particle, with particle 0 on top, so it must be made along with 
+    the particle buffer, before any particle is active, and it must be used from then on.
+
+    Nothing here is ever read by the CPU.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class ParticleFreeListSsbo : public SsboBase
+{
+public:
+    ParticleFreeListSsbo(unsigned int maxParticles);
+    virtual ~ParticleFreeListSsbo() override = default; // empty override of base destructor
+
+    void ConfigureCompute(unsigned int computeProgramId, const std::string &bufferNameInShader) override;
+    void ConfigureRender(unsigned int renderProgramId, unsigned int drawStyle) override;
+};
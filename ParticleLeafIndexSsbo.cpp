@@ -0,0 +1,111 @@
+#include "ParticleLeafIndexSsbo.h"
+
+#include <vector>
+#include "glload/include/glload/gl_4_4.h"
+#include "ParticleQuadTree.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Calls the base class to give members initial values (zeros).
+
+    Allocates one leaf index per particle, all ParticleQuadTree::NO_LEAF, so that the shader 
+    walks the tree for every particle until the first UploadLeafIndices(...).
+Parameters:
+    maxParticles    Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleLeafIndexSsbo::ParticleLeafIndexSsbo(unsigned int maxParticles) :
+    SsboBase(),  // generate buffers
+    _orphanOnUpload(false)
+{
+    // ignore _numVertices because this SSBO does not draw
+
+    // Note: The leaves are uploaded every frame, hence "dynamic".
+    std::vector<unsigned int> noLeaves(maxParticles, ParticleQuadTree::NO_LEAF);
+    GLuint bufferSizeBytes = sizeof(unsigned int) * maxParticles;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSizeBytes, noLeaves.data(), GL_DYNAMIC_DRAW);
+
+    _bufferSizeBytes = bufferSizeBytes;
+
+    // cleanup
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Binds the buffer to the shader's storage block.  If the shader doesn't have it, nothing 
+    happens.
+
+    Note: It is ok to call this function for multiple compute shaders so that the same SSBO 
+    can be used in each shader.  No member variables are altered in this function.
+Parameters:
+    computeProgramId    Self-explanatory
+    bufferNameInShader  Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleLeafIndexSsbo::ConfigureCompute(unsigned int computeProgramId, 
+    const std::string &bufferNameInShader)
+{
+    GLuint storageBlockIndex = glGetProgramResourceIndex(computeProgramId, GL_SHADER_STORAGE_BLOCK, bufferNameInShader.c_str());
+    if (storageBlockIndex == GL_INVALID_INDEX)
+    {
+        return;
+    }
+
+    glShaderStorageBlockBinding(computeProgramId, storageBlockIndex, _ssboBindingPointIndex);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, _ssboBindingPointIndex, _bufferId);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Like QuadTreeNodeSsbo, this SSBO does not draw.
+Parameters:
+    irrelevant
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleLeafIndexSsbo::ConfigureRender(unsigned int, unsigned int)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    See QuadTreeNodeSsbo::SetOrphanOnUpload(...).
+Parameters:
+    orphanOnUpload  Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleLeafIndexSsbo::SetOrphanOnUpload(bool orphanOnUpload)
+{
+    _orphanOnUpload = orphanOnUpload;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Copies the particles' leaf indices into the front of the buffer.
+Parameters:
+    particleLeafIndices     Self-explanatory
+    numParticles            Clamped to the size of the buffer.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleLeafIndexSsbo::UploadLeafIndices(const unsigned int *particleLeafIndices, 
+    unsigned int numParticles)
+{
+    unsigned int maxParticles = _bufferSizeBytes / sizeof(unsigned int);
+    numParticles = (numParticles < maxParticles) ? numParticles : maxParticles;
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+    if (_orphanOnUpload)
+    {
+        // same size and usage, so the binding points don't need to be set up again
+        glBufferData(GL_SHADER_STORAGE_BUFFER, _bufferSizeBytes, 0, GL_DYNAMIC_DRAW);
+    }
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, numParticles * sizeof(unsigned int), 
+        particleLeafIndices);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
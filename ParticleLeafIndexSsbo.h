@@ -0,0 +1,27 @@
+#pragma once
+
+#include "SsboBase.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets up the Shader Storage Block Object for the leaf that the CPU's quad tree put each 
+    particle in (see ParticleQuadTree::CopyParticleLeafIndices(...)).  It is 4 bytes per 
+    particle, so it costs a sixteenth of uploading the particles themselves, and it lets 
+    ParticleCollisions.comp skip walking the tree from the root for every particle.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class ParticleLeafIndexSsbo : public SsboBase
+{
+public:
+    ParticleLeafIndexSsbo(unsigned int maxParticles);
+    virtual ~ParticleLeafIndexSsbo() override = default; // empty override of base destructor
+
+    void ConfigureCompute(unsigned int computeProgramId, const std::string &bufferNameInShader) override;
+    void ConfigureRender(unsigned int renderProgramId, unsigned int drawStyle) override;
+
+    void SetOrphanOnUpload(bool orphanOnUpload);
+    void UploadLeafIndices(const unsigned int *particleLeafIndices, unsigned int numParticles);
+
+private:
+    bool _orphanOnUpload;
+};
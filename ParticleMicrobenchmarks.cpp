@@ -0,0 +1,417 @@
+// particle_microbenchmarks: Google Benchmark timings for the quad tree's build kernels and the
+// CPU collision kernel, over synthetic particle distributions from 1k to 1M particles.  Like
+// particle_bench, it doesn't need OpenGL, GLUT, or FreeType.
+//
+// Each benchmark's name ends in /<distribution>/<particle count>; the distribution is also in
+// the label.  The usual Google Benchmark flags apply, e.g.
+//  particle_microbenchmarks --benchmark_filter=AddParticlestoTree --benchmark_format=json
+
+#include <cmath>
+#include <vector>
+#include "benchmark/benchmark.h"
+
+#include "ParticleQuadTree.h"
+#include "SimulationEngine.h"
+#include "RandomToast.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Where the synthetic particles are put.  All of them are inside the same particle region as
+    main.cpp's (center (0, 0), radius 0.8).
+    UNIFORM_DISK        Evenly over the whole region.
+    GAUSSIAN_CLUSTER    A normal distribution around where main.cpp's two bar emitters'
+                        particles meet.
+    COLLIDING_JETS      Two thin streams, one from the left and one from below, that meet at
+                        that same spot.
+    ONE_LEAF            The worst case: all of them in a square so small that floats can
+                        barely split it, so they pile up in a handful of leaves.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+enum PARTICLE_DISTRIBUTION
+{
+    PARTICLE_DISTRIBUTION_UNIFORM_DISK = 0,
+    PARTICLE_DISTRIBUTION_GAUSSIAN_CLUSTER,
+    PARTICLE_DISTRIBUTION_COLLIDING_JETS,
+    PARTICLE_DISTRIBUTION_ONE_LEAF,
+    PARTICLE_DISTRIBUTION_COUNT
+};
+
+static const glm::vec4 gParticleRegionCenter(0.0f, 0.0f, 0.0f, 1.0f);
+static const float gParticleRegionRadius = 0.8f;
+static const glm::vec2 gEmittersMeet(0.05f, 0.25f);
+static const float gDeltaTimeSec = 0.01f;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Self-explanatory
+Parameters:
+    distribution    Self-explanatory
+Returns:
+    A name for the benchmarks' labels.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static const char *DistributionName(PARTICLE_DISTRIBUTION distribution)
+{
+    switch (distribution)
+    {
+    case PARTICLE_DISTRIBUTION_UNIFORM_DISK:
+        return "uniform_disk";
+    case PARTICLE_DISTRIBUTION_GAUSSIAN_CLUSTER:
+        return "gaussian_cluster";
+    case PARTICLE_DISTRIBUTION_COLLIDING_JETS:
+        return "colliding_jets";
+    case PARTICLE_DISTRIBUTION_ONE_LEAF:
+        return "one_leaf";
+    default:
+        return "unknown";
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A standard normal random number by the Box-Muller transform.
+Parameters:
+    random  Self-explanatory
+Returns:
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static float NextGaussian(RandomStream &random)
+{
+    // 1 - u so that the log never sees 0
+    float u1 = 1.0f - random.NextOnRange0to1();
+    float u2 = random.NextOnRange0to1();
+    return sqrtf(-2.0f * logf(u1)) * cosf(6.28318530718f * u2);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Makes active particles in the distribution, with small random velocities (or the jets'
+    velocities).  The same distribution and count always give the same particles.
+Parameters:
+    distribution    Self-explanatory
+    numParticles    Self-explanatory
+    particles       Resized and filled.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void MakeParticles(PARTICLE_DISTRIBUTION distribution, unsigned int numParticles,
+    std::vector<Particle> &particles)
+{
+    RandomStream random(12345, (unsigned int)distribution);
+    particles.assign(numParticles, Particle());
+    float maxRadius = gParticleRegionRadius * 0.999f;
+    for (unsigned int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    {
+        glm::vec2 position;
+        glm::vec2 velocity((random.NextOnRange0to1() - 0.5f) * 0.2f,
+            (random.NextOnRange0to1() - 0.5f) * 0.2f);
+
+        if (distribution == PARTICLE_DISTRIBUTION_UNIFORM_DISK)
+        {
+            float radius = maxRadius * sqrtf(random.NextOnRange0to1());
+            float angle = 6.28318530718f * random.NextOnRange0to1();
+            position = glm::vec2(radius * cosf(angle), radius * sinf(angle));
+        }
+        else if (distribution == PARTICLE_DISTRIBUTION_GAUSSIAN_CLUSTER)
+        {
+            // the tails that leave the region are drawn again
+            do
+            {
+                position = gEmittersMeet + 0.05f * glm::vec2(NextGaussian(random), NextGaussian(random));
+            } while (((position.x * position.x) + (position.y * position.y)) > (maxRadius * maxRadius));
+        }
+        else if (distribution == PARTICLE_DISTRIBUTION_COLLIDING_JETS)
+        {
+            float along = random.NextOnRange0to1();
+            float across = 0.01f * NextGaussian(random);
+            if ((particleIndex % 2) == 0)
+            {
+                position = glm::vec2(-0.7f + (along * (gEmittersMeet.x + 0.7f)), gEmittersMeet.y + across);
+                velocity = glm::vec2(0.5f, 0.0f);
+            }
+            else
+            {
+                position = glm::vec2(gEmittersMeet.x + across, -0.7f + (along * (gEmittersMeet.y + 0.7f)));
+                velocity = glm::vec2(0.0f, 0.5f);
+            }
+        }
+        else
+        {
+            position = glm::vec2(0.3f, 0.3f) + 1.0e-6f * glm::vec2(random.NextOnRange0to1(),
+                random.NextOnRange0to1());
+        }
+
+        Particle &p = particles[particleIndex];
+        p._position = glm::vec4(position, 0.0f, 1.0f);
+        p._velocity = glm::vec4(velocity, 0.0f, 0.0f);
+        p._isActive = 1;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Every distribution at 1k, 10k, 100k, and 1M particles.
+
+    Note: The tree has ParticleQuadTree::MAX_NODES nodes, and 1M evenly spread particles need
+    more leaves than that, so past ~500k particles the uniform builds run out of nodes and
+    stop subdividing, just like the real tree would.
+Parameters:
+    pBenchmark  Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void DistributionsAndCounts(benchmark::internal::Benchmark *pBenchmark)
+{
+    pBenchmark->ArgNames({ "distribution", "particles" });
+    for (int distribution = 0; distribution < PARTICLE_DISTRIBUTION_COUNT; distribution++)
+    {
+        for (int numParticles = 1000; numParticles <= 1000000; numParticles *= 10)
+        {
+            pBenchmark->Args({ distribution, numParticles });
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    ParticleQuadTree::ResetTree().  It only resets the four starting nodes, so the particles
+    don't matter and it is only run once.
+Parameters:
+    state   Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void BM_ResetTree(benchmark::State &state)
+{
+    // the node array is far too big for the stack
+    ParticleQuadTree *pTree = new ParticleQuadTree(gParticleRegionCenter, gParticleRegionRadius);
+    for (auto _ : state)
+    {
+        pTree->ResetTree();
+        benchmark::ClobberMemory();
+    }
+    delete pTree;
+}
+BENCHMARK(BM_ResetTree);
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    ParticleQuadTree::AddParticlestoTree(...), with the single-threaded build, from a reset
+    tree every time.
+Parameters:
+    state   Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void BM_AddParticlestoTree(benchmark::State &state)
+{
+    PARTICLE_DISTRIBUTION distribution = (PARTICLE_DISTRIBUTION)state.range(0);
+    int numParticles = (int)state.range(1);
+    std::vector<Particle> particles;
+    MakeParticles(distribution, numParticles, particles);
+
+    ParticleQuadTree *pTree = new ParticleQuadTree(gParticleRegionCenter, gParticleRegionRadius,
+        numParticles);
+    for (auto _ : state)
+    {
+        pTree->ResetTree();
+        pTree->AddParticlestoTree(particles.data(), numParticles);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetLabel(DistributionName(distribution));
+    state.SetItemsProcessed(state.iterations() * numParticles);
+    state.counters["nodes"] = pTree->NumActiveNodes();
+    delete pTree;
+}
+BENCHMARK(BM_AddParticlestoTree)->Apply(DistributionsAndCounts)->Unit(benchmark::kMicrosecond);
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    ParticleQuadTree's SubdivideNode(...) by itself, through SubdivideLeaf(...).  The tree is
+    built from the particles, and then every leaf that has particles in it is subdivided once.  Those are
+    real leaves, so they have as many particles, spread the same way, as the build leaves them
+    with.  The build is done with the timer paused, so only the subdivisions are timed.
+
+    Note: The build is redone every iteration, so it is redone with only the particles that
+    the first build kept.  That makes the same tree, but when most of the particles don't fit
+    (the one-leaf distribution), the untimed builds don't take thousands of times longer than
+    the timed subdivisions.
+Parameters:
+    state   Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void BM_SubdivideNode(benchmark::State &state)
+{
+    PARTICLE_DISTRIBUTION distribution = (PARTICLE_DISTRIBUTION)state.range(0);
+    int numParticles = (int)state.range(1);
+    std::vector<Particle> particles;
+    MakeParticles(distribution, numParticles, particles);
+
+    ParticleQuadTree *pTree = new ParticleQuadTree(gParticleRegionCenter, gParticleRegionRadius,
+        numParticles);
+    pTree->AddParticlestoTree(particles.data(), numParticles);
+    std::vector<bool> particleWasKept(numParticles, false);
+    const ParticleQuadTreeNode *allNodes = pTree->QuadTreeBuffer();
+    for (unsigned int nodeIndex = 0; nodeIndex < pTree->NumActiveNodes(); nodeIndex++)
+    {
+        for (unsigned int particleCount = 0; particleCount < allNodes[nodeIndex]._numCurrentParticles; particleCount++)
+        {
+            particleWasKept[allNodes[nodeIndex]._indicesForContainedParticles[particleCount]] = true;
+        }
+    }
+
+    // same order as before so that the build goes the same way
+    std::vector<Particle> keptParticles;
+    for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    {
+        if (particleWasKept[particleIndex])
+        {
+            keptParticles.push_back(particles[particleIndex]);
+        }
+    }
+
+    std::vector<int> leavesWithParticles;
+    long long numSubdivisions = 0;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        pTree->ResetTree();
+        pTree->AddParticlestoTree(keptParticles.data(), (int)keptParticles.size());
+        allNodes = pTree->QuadTreeBuffer();
+        leavesWithParticles.clear();
+        for (unsigned int nodeIndex = 0; nodeIndex < pTree->NumActiveNodes(); nodeIndex++)
+        {
+            if (allNodes[nodeIndex]._isSubdivided == 0 && allNodes[nodeIndex]._numCurrentParticles > 0)
+            {
+                leavesWithParticles.push_back((int)nodeIndex);
+            }
+        }
+        state.ResumeTiming();
+
+        for (size_t leafCount = 0; leafCount < leavesWithParticles.size(); leafCount++)
+        {
+            // out of nodes, or a leaf that is too small to split, doesn't count
+            if (pTree->SubdivideLeaf(leavesWithParticles[leafCount]))
+            {
+                numSubdivisions++;
+            }
+        }
+        benchmark::ClobberMemory();
+
+        if (numSubdivisions == 0)
+        {
+            // the build used every node (see DistributionsAndCounts(...)), or left only 
+            // leaves that are too small to split, so there is nothing to time, and the untimed 
+            // builds would go on for a very long time
+            state.SkipWithError("no leaf could be subdivided");
+            break;
+        }
+    }
+
+    state.SetLabel(DistributionName(distribution));
+    state.SetItemsProcessed(numSubdivisions);
+    state.counters["leaves"] = (double)leavesWithParticles.size();
+    delete pTree;
+}
+BENCHMARK(BM_SubdivideNode)->Apply(DistributionsAndCounts)->Unit(benchmark::kMicrosecond);
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    SimulationEngine::ParticleCollisionP1WithP2(...), the CPU port of the collision shader's,
+    by itself.  The pairs are every ordered pair of particles that share a leaf in
+    the tree built from the particles, which is the bulk of what the collisions give it.
+    There is no distance check in it, so how close the pairs are doesn't change its cost.
+Parameters:
+    state   Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void BM_ParticleCollisionP1WithP2(benchmark::State &state)
+{
+    PARTICLE_DISTRIBUTION distribution = (PARTICLE_DISTRIBUTION)state.range(0);
+    unsigned int numParticles = (unsigned int)state.range(1);
+    std::vector<Particle> particles;
+    MakeParticles(distribution, numParticles, particles);
+
+    ParticleQuadTree *pTree = new ParticleQuadTree(gParticleRegionCenter, gParticleRegionRadius,
+        numParticles);
+    pTree->AddParticlestoTree(particles.data(), numParticles);
+    std::vector<unsigned int> pairs;
+    const ParticleQuadTreeNode *allNodes = pTree->QuadTreeBuffer();
+    for (unsigned int nodeIndex = 0; nodeIndex < pTree->NumActiveNodes(); nodeIndex++)
+    {
+        const ParticleQuadTreeNode &node = allNodes[nodeIndex];
+        if (node._isSubdivided != 0)
+        {
+            continue;
+        }
+
+        for (unsigned int p1Count = 0; p1Count < node._numCurrentParticles; p1Count++)
+        {
+            for (unsigned int p2Count = 0; p2Count < node._numCurrentParticles; p2Count++)
+            {
+                if (p1Count != p2Count)
+                {
+                    pairs.push_back(node._indicesForContainedParticles[p1Count]);
+                    pairs.push_back(node._indicesForContainedParticles[p2Count]);
+                }
+            }
+        }
+    }
+    delete pTree;
+
+    float inverseDeltaTimeSec = 1.0f / gDeltaTimeSec;
+    for (auto _ : state)
+    {
+        for (size_t pairIndex = 0; pairIndex < pairs.size(); pairIndex += 2)
+        {
+            SimulationEngine::ParticleCollisionP1WithP2(particles[pairs[pairIndex]],
+                particles[pairs[pairIndex + 1]], inverseDeltaTimeSec);
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetLabel(DistributionName(distribution));
+    state.SetItemsProcessed(state.iterations() * (long long)(pairs.size() / 2));
+    state.counters["pairs"] = (double)(pairs.size() / 2);
+}
+BENCHMARK(BM_ParticleCollisionP1WithP2)->Apply(DistributionsAndCounts)->Unit(benchmark::kMicrosecond);
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The whole single-threaded CPU collision pass, SimulationEngine::CollideParticles(...),
+    against a tree built from the particles, for comparison with the kernel by itself: the
+    difference is finding each particle's leaf and gathering its neighbors' particles.
+Parameters:
+    state   Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void BM_CollideParticles(benchmark::State &state)
+{
+    PARTICLE_DISTRIBUTION distribution = (PARTICLE_DISTRIBUTION)state.range(0);
+    unsigned int numParticles = (unsigned int)state.range(1);
+    SimulationEngine engine(numParticles, gParticleRegionCenter, gParticleRegionRadius);
+    std::vector<Particle> particles;
+    MakeParticles(distribution, numParticles, particles);
+    engine.SetParticles(particles.data());
+
+    ParticleQuadTree *pTree = new ParticleQuadTree(gParticleRegionCenter, gParticleRegionRadius,
+        numParticles);
+    pTree->AddParticlestoTree(particles.data(), numParticles);
+    for (auto _ : state)
+    {
+        engine.CollideParticles(gDeltaTimeSec, pTree->QuadTreeBuffer(), pTree->NumActiveNodes(), 0);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetLabel(DistributionName(distribution));
+    state.SetItemsProcessed(state.iterations() * numParticles);
+    delete pTree;
+}
+BENCHMARK(BM_CollideParticles)->Apply(DistributionsAndCounts)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -1,5 +1,14 @@
 #include "ParticleQuadTree.h"
 #include "Particle.h"
+#include "ParticleSoA.h"
+#include "QuadrantClassification.h"
+#include "MortonOrder.h"
+#include "WorkStealingTaskPool.h"
+
+#include <algorithm>    // for std::copy(...)
+
+// it is passed by reference (e.g. to std::vector's constructor), so it needs a definition
+const unsigned int ParticleQuadTree::NO_LEAF;
 
 /*-----------------------------------------------------------------------------------------------
 Description:
@@ -9,14 +18,27 @@ Description:
 Parameters:
     particleRegionCenter    In world space
     particleRegionRadius    In world space
+    maxParticles            The largest particle collection that will be given to 
+                            AddParticlestoTree(...).
 Returns:    None
 Exception:  Safe
 Creator:    John Cox (12-17-2016)
 -----------------------------------------------------------------------------------------------*/
-ParticleQuadTree::ParticleQuadTree(const glm::vec4 &particleRegionCenter, float particleRegionRadius) :
+ParticleQuadTree::ParticleQuadTree(const glm::vec4 &particleRegionCenter, float particleRegionRadius, 
+    unsigned int maxParticles) :
     _completedNodePopulations(0),
+    _canUpdateIncrementally(false),
+    _numParticlesInTree(0),
+    _parentNodeIndex(MAX_NODES, -1),
+    _subtreeParticleCount(MAX_NODES, 0),
+    _numBuildThreads(1),
+    _pBuildTaskPool(0),
+    _numBuildTasks(0),
+    _numTopNodes(0),
+    _numReservedNodes(0),
     _particleRegionCenter(particleRegionCenter),
-    _particleRegionRadius(particleRegionRadius)
+    _particleRegionRadius(particleRegionRadius),
+    _localParticleArray(maxParticles)
 {
     float particleRegionLeft = _particleRegionCenter.x - _particleRegionRadius;
     float particleRegionRight = _particleRegionCenter.x + _particleRegionRadius;
@@ -86,10 +108,10 @@ ParticleQuadTree::ParticleQuadTree(const glm::vec4 &particleRegionCenter, float
         node._rightEdge = particleRegionRight;
         node._topEdge = particleRegionCenter.y;
         node._bottomEdge = particleRegionBottom;
-        node._neighborIndexLeft;
-        node._neighborIndexTopLeft;
-        node._neighborIndexTop;
-        // no top left neighbor
+        node._neighborIndexLeft = FIRST_FOUR_NODE_INDEXES::BOTTOM_LEFT;
+        node._neighborIndexTopLeft = FIRST_FOUR_NODE_INDEXES::TOP_LEFT;
+        node._neighborIndexTop = FIRST_FOUR_NODE_INDEXES::TOP_RIGHT;
+        // no top right neighbor
         // no right neighbor
         // no bottom right neighbor
         // no bottom neighbor
@@ -101,12 +123,23 @@ ParticleQuadTree::ParticleQuadTree(const glm::vec4 &particleRegionCenter, float
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Runs through the node array and resets every single node except those in the initial 
-    subdivision.
+    Stops the build threads, if there are any.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleQuadTree::~ParticleQuadTree()
+{
+    delete _pBuildTaskPool;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Resets the nodes of the initial subdivision and forgets the rest.
 
-    Note: Rather than have a loop that runs through every single node and resets them one by 
-    one, this method makes use spelling out the first four nodes' resets manually, and then a 
-    memset(...) for the rest.
+    Note: The rest of the nodes are not cleared.  AssignChildNodes(...) starts each node 
+    fresh when it is handed out again, and only the nodes below NumActiveNodes() are uploaded 
+    (see QuadTreeNodeSsbo::UploadNodes(...)), so whatever is left in the others is never read.
 Parameters: None
 Returns:    None
 Creator:    John Cox (1-28-2017)
@@ -114,6 +147,8 @@ Creator:    John Cox (1-28-2017)
 void ParticleQuadTree::ResetTree()
 {
     _numActiveNodes = FIRST_FOUR_NODE_INDEXES::NUM_STARTING_NODES;
+    _canUpdateIncrementally = false;
+    _freeChildBlocks.clear();
 
     // top left
     {
@@ -158,60 +193,294 @@ void ParticleQuadTree::ResetTree()
         node._childNodeIndexBottomLeft = -1;
         node._childNodeIndexBottomRight = -1;
     }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets how many threads AddParticlestoTree(...) uses.  1 is the single-threaded linear 
+    build.  More than 1 hands subtrees out to worker threads (see 
+    AddParticlestoTreeParallel(...)).  The resulting buffer has the same layout either way, 
+    so the GPU upload doesn't care which one was used.
+
+    The worker threads are started here, once, and sleep between builds.
+Parameters: 
+    numThreads  0 is treated as 1.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleQuadTree::SetNumBuildThreads(unsigned int numThreads)
+{
+    numThreads = (numThreads == 0) ? 1 : numThreads;
+    if (numThreads == _numBuildThreads)
+    {
+        return;
+    }
 
-    // wipe out the rest of the nodes
-    ParticleQuadTreeNode *startHere = &_allNodes[FIRST_FOUR_NODE_INDEXES::NUM_STARTING_NODES];
-    size_t numBytes = sizeof(ParticleQuadTreeNode) * (MAX_NODES - FIRST_FOUR_NODE_INDEXES::NUM_STARTING_NODES);
-    memset(startHere, 0, numBytes);
+    _numBuildThreads = numThreads;
+    delete _pBuildTaskPool;
+    _pBuildTaskPool = 0;
+    if (_numBuildThreads > 1)
+    {
+        _pBuildTaskPool = new WorkStealingTaskPool(_numBuildThreads);
+    }
 }
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Governs the addition of particles to the quad tree.  AddParticleToNode(...) will 
-    handle subdivision and addition of particles to child nodes.
+    Governs the addition of particles to the quad tree.  AddParticlestoTreeLinear(...) (or 
+    AddParticlestoTreeParallel(...) if there is more than one build thread) will handle 
+    subdivision and addition of particles to child nodes.
 Parameters: 
     particleCollection  An updated particle array.
 Returns:    None
 Exception:  Safe
 Creator:    John Cox (12-17-2016)
 -----------------------------------------------------------------------------------------------*/
-void ParticleQuadTree::AddParticlestoTree(Particle *particleCollection, int numParticles)
+void ParticleQuadTree::AddParticlestoTree(const Particle *particleCollection, int numParticles)
+{
+    // numParticles should be no larger than the "max particles" given to the constructor; if 
+    // it is; the crash is deserved :)
+    std::copy(particleCollection, particleCollection + numParticles, _localParticleArray.begin());
+
+    // the caller may have built this tree without UpdateTree(...), and that doesn't keep the 
+    // incremental bookkeeping
+    _canUpdateIncrementally = false;
+    BuildTree(numParticles);
+    _completedNodePopulations++;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Builds the tree from the particles that are already in _localParticleArray.  Uses 
+    AddParticlestoTreeParallel(...) if there is more than one build thread, and 
+    AddParticlestoTreeLinear(...) otherwise.
+
+    Note: Every particle's leaf is set to NO_LEAF first.  The builds only set the leaves of 
+    the particles that they put in the tree, so one that is left out (a full leaf that 
+    can't be subdivided) would otherwise keep whatever node it had before.
+Parameters: 
+    numParticles    How many particles in _localParticleArray to consider.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleQuadTree::BuildTree(int numParticles)
+{
+    for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    {
+        _localParticleArray[particleIndex]._indexOfNodeThatItIsOccupying = NO_LEAF;
+    }
+
+    if (_numBuildThreads > 1)
+    {
+        // the parallel build inserts particles subtree by subtree and does not sort them
+        _sortedParticleIndices.clear();
+        AddParticlestoTreeParallel(numParticles);
+    }
+    else
+    {
+        AddParticlestoTreeLinear(numParticles);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Does the same job as ResetTree() followed by AddParticlestoTree(...), but keeps the last 
+    frame's tree and only moves the particles that have left their leaves.  At a small delta 
+    time most particles move much less than a leaf's width from one frame to the next, so 
+    this skips the wipe of every node and most of the insertions.
+    (1) Any particle that is no longer inside its leaf, or was deactivated, is taken out of 
+    it.
+    (2) Active particles that are not in the tree (they moved or were just emitted) are 
+    dropped in from the top.  Leaves subdivide just like they do during a full build.
+    (3) A subdivided node whose children are all leaves and which is down to 
+    MERGE_PARTICLE_COUNT particles takes its children's particles and gives the four nodes 
+    back for reuse.  Merging cascades upwards.
+
+    Falls back to a full build on the first call, when the particle count changes, or when 
+    more than MAX_MIGRATING_PARTICLE_PERCENT of the particles in the tree have to move.
+
+    Note: Nodes that are given back are marked as not in use and stay in the buffer until they 
+    are reused, so NumActiveNodes() is the highest node in use rather than the number of 
+    nodes in use.  The nodes in use are still a valid tree for the collision and geometry 
+    shaders.
+
+    Also Note: Only the nodes that particles left are checked for merging, and a node can 
+    only merge after its children have, so the tree is the same shape as a full build's.  
+    Only the node numbering and the order of the particles within a leaf differ.
+Parameters: 
+    particleCollection  An updated particle array.
+    numParticles        Should be the same every frame.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleQuadTree::UpdateTree(const Particle *particleCollection, int numParticles)
+{
+    std::copy(particleCollection, particleCollection + numParticles, _localParticleArray.begin());
+    UpdateTreeFromLocalParticles(numParticles);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Like the other AddParticlestoTree(...), but takes the particles in ParticleSoA's structure 
+    of arrays layout.  Only the positions and the state flags are read, so this is 12 bytes per 
+    particle instead of a whole Particle.
+Parameters: 
+    positions       Self-explanatory.
+    stateFlags      Packed as in ParticleSoA::PackStateFlags(...).
+    numParticles    How many particles are in each array.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleQuadTree::AddParticlestoTree(const glm::vec2 *positions, 
+    const unsigned int *stateFlags, int numParticles)
 {
-    // numParticles should be no larger that Particle::MAX_PARTICLES; if it is; the crash is 
-    // deserved :)
-    memcpy(_localParticleArray, particleCollection, sizeof(Particle) * numParticles);
+    CopyParticlePositions(positions, stateFlags, numParticles);
 
-    for (size_t particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    // same as the other version
+    _canUpdateIncrementally = false;
+    BuildTree(numParticles);
+    _completedNodePopulations++;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Like the other UpdateTree(...), but takes the particles in ParticleSoA's structure of 
+    arrays layout.  Only the positions and the state flags are read.
+Parameters: 
+    positions       Self-explanatory.
+    stateFlags      Packed as in ParticleSoA::PackStateFlags(...).
+    numParticles    Should be the same every frame.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleQuadTree::UpdateTree(const glm::vec2 *positions, const unsigned int *stateFlags, 
+    int numParticles)
+{
+    CopyParticlePositions(positions, stateFlags, numParticles);
+    UpdateTreeFromLocalParticles(numParticles);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Copies the only things that the tree looks at, the position and the "is active" flag, into 
+    _localParticleArray.  Everything else in there is left alone.
+Parameters: 
+    positions       Self-explanatory.
+    stateFlags      Packed as in ParticleSoA::PackStateFlags(...).
+    numParticles    How many particles are in each array.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleQuadTree::CopyParticlePositions(const glm::vec2 *positions, 
+    const unsigned int *stateFlags, int numParticles)
+{
+    for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
     {
         Particle &p = _localParticleArray[particleIndex];
-        if (p._isActive == 0)
+        p._position.x = positions[particleIndex].x;
+        p._position.y = positions[particleIndex].y;
+        p._isActive = ParticleSoA::IsActive(stateFlags[particleIndex]) ? 1 : 0;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The body of UpdateTree(...) once the particles are in _localParticleArray.
+Parameters: 
+    numParticles    Should be the same every frame.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleQuadTree::UpdateTreeFromLocalParticles(int numParticles)
+{
+    bool rebuild = !_canUpdateIncrementally || (numParticles != _numParticlesInTree);
+    if (!rebuild)
+    {
+        // find who has to move, and stop looking once it is clear that there are too many
+        // Note: The particles that were in the tree last frame stand in for the active count, 
+        // which isn't known until the end.
+        int numParticlesInTree = 0;
+        for (int nodeIndex = 0; nodeIndex < FIRST_FOUR_NODE_INDEXES::NUM_STARTING_NODES; nodeIndex++)
         {
-            // only add active particles
-            continue;
+            numParticlesInTree += _subtreeParticleCount[nodeIndex];
         }
+        size_t maxMigratingParticles = 
+            (size_t)(numParticlesInTree * MAX_MIGRATING_PARTICLE_PERCENT) / 100;
 
-        // attempting conditional elimination to improve performance
-        // Note: it didn't seem to gain me any frames over nested 
-        // if (left of center) { if (higher than middle) { ... conditions.  It is less code 
-        // though.
-        int isLeft = int(p._position.x < _particleRegionCenter.x);
-        int isRight = 1 - isLeft;
-        int isTop = int(p._position.y > _particleRegionCenter.y);
-        int isBottom = 1 - isTop;
+        _migratingParticles.clear();
+        for (int particleIndex = 0; particleIndex < numParticles && !rebuild; particleIndex++)
+        {
+            const Particle &p = _localParticleArray[particleIndex];
+            int leafNodeIndex = _leafOfParticle[particleIndex];
+            if (leafNodeIndex == -1)
+            {
+                if (p._isActive != 0)
+                {
+                    // just emitted (or left out of a full node last time)
+                    _migratingParticles.push_back(particleIndex);
+                }
+            }
+            else if (p._isActive == 0 || !NodeContains(_allNodes[leafNodeIndex], p._position))
+            {
+                _migratingParticles.push_back(particleIndex);
+            }
 
-        int isTopLeftIndex = FIRST_FOUR_NODE_INDEXES::TOP_LEFT * (isLeft * isTop);
-        int isTopRightIndex = FIRST_FOUR_NODE_INDEXES::TOP_RIGHT * (isRight * isTop);
-        int isBottomLeftIndex = FIRST_FOUR_NODE_INDEXES::BOTTOM_LEFT * (isLeft * isBottom);
-        int isBottomRightIndex = FIRST_FOUR_NODE_INDEXES::BOTTOM_RIGHT * (isRight * isBottom);
+            rebuild = _migratingParticles.size() > maxMigratingParticles;
+        }
+    }
 
-        // only one of the first four indices will be non-zero
-        int childNodeIndex = isTopLeftIndex + isTopRightIndex + isBottomLeftIndex + isBottomRightIndex;
+    if (rebuild)
+    {
+        ResetTree();
+        BuildTree(numParticles);
+        RecordIncrementalState(numParticles);
+        _completedNodePopulations++;
+        return;
+    }
+
+    // the sorted order was from the last full build and does not include the migrants
+    _sortedParticleIndices.clear();
+
+    _mergeCandidates.clear();
+    _migrantPreviousLeaves.clear();
+    for (size_t migrantCount = 0; migrantCount < _migratingParticles.size(); migrantCount++)
+    {
+        int particleIndex = _migratingParticles[migrantCount];
+        int leafNodeIndex = _leafOfParticle[particleIndex];
+        _migrantPreviousLeaves.push_back(leafNodeIndex);
+        if (leafNodeIndex != -1)
+        {
+            RemoveParticleFromLeaf(particleIndex, leafNodeIndex);
+        }
+    }
 
-        AddParticleToNode(particleIndex, childNodeIndex);
+    // most particles only went next door, so they start looking from where they were
+    // Note: Nothing has been merged yet, so the previous leaves are all still in the tree.
+    for (size_t migrantCount = 0; migrantCount < _migratingParticles.size(); migrantCount++)
+    {
+        int particleIndex = _migratingParticles[migrantCount];
+        if (_localParticleArray[particleIndex]._isActive != 0)
+        {
+            InsertParticle(particleIndex, _migrantPreviousLeaves[migrantCount]);
+        }
     }
 
-    _completedNodePopulations++;
+    // merging can queue up more candidates, so this list may grow as it is run over
+    for (size_t candidateCount = 0; candidateCount < _mergeCandidates.size(); candidateCount++)
+    {
+        MergeNode(_mergeCandidates[candidateCount]);
+    }
+
+    // the new particle data came with whatever node indices the caller had, and particles 
+    // that aren't in the tree (inactive, or left out of a full leaf) get NO_LEAF
+    for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    {
+        int leafNodeIndex = _leafOfParticle[particleIndex];
+        _localParticleArray[particleIndex]._indexOfNodeThatItIsOccupying = 
+            (leafNodeIndex != -1) ? (unsigned int)leafNodeIndex : NO_LEAF;
+    }
 
+    _completedNodePopulations++;
 }
 
 /*-----------------------------------------------------------------------------------------------
@@ -241,7 +510,87 @@ Creator:    John Cox (2-4-2017)
 -----------------------------------------------------------------------------------------------*/
 const Particle *ParticleQuadTree::ParticleBuffer() const
 {
-    return _localParticleArray;
+    return _localParticleArray.data();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Returns the indices of the active particles from the most recent build in Morton (Z) 
+    order, which is the order that they sit in the leaves from left to right.  Particles that 
+    are next to each other in this list are next to each other in space, so walking through 
+    the particles in this order keeps neighboring nodes in the cache.
+
+    Note: This is empty if the tree was built with more than one build thread or was last 
+    updated incrementally by UpdateTree(...).
+Parameters: None
+Returns:    
+    A pointer to said indices.
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+const int *ParticleQuadTree::SortedParticleIndices() const
+{
+    return _sortedParticleIndices.data();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Returns the number of entries in SortedParticleIndices().
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int ParticleQuadTree::NumSortedParticles() const
+{
+    return (unsigned int)_sortedParticleIndices.size();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Copies the leaf that each particle was put in during the last build (or update) into a 
+    plain array, 4 bytes per particle, so that the collisions can be told each particle's 
+    leaf without uploading the whole particle (see ParticleLeafIndexSsbo).  Particles that 
+    were inactive, or were left out of a full leaf, get NO_LEAF.
+Parameters: 
+    leafIndices     Receives numParticles leaf indices.
+    numParticles    How many particles the tree was last built from.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleQuadTree::CopyParticleLeafIndices(unsigned int *leafIndices, int numParticles) const
+{
+    for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    {
+        const Particle &p = _localParticleArray[particleIndex];
+        leafIndices[particleIndex] = (p._isActive != 0) ? p._indexOfNodeThatItIsOccupying : NO_LEAF;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Subdivides one leaf of the last built tree and splits its particles amongst the new 
+    children, the same as a build would if one more particle went into it.  Meant for 
+    timing SubdivideNode(...) by itself (see ParticleMicrobenchmarks.cpp) on real leaves.
+
+    Note: The tree is no longer one that a build would make, so the next UpdateTree(...) 
+    rebuilds it from scratch.
+Parameters: 
+    nodeIndex   Self-explanatory
+Returns:    
+    False if the node isn't a leaf in use, there weren't enough nodes, or the leaf is too 
+    small to subdivide, otherwise true.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticleQuadTree::SubdivideLeaf(int nodeIndex)
+{
+    if (nodeIndex < 0 || nodeIndex >= _numActiveNodes || _allNodes[nodeIndex]._inUse == 0 || 
+        _allNodes[nodeIndex]._isSubdivided != 0)
+    {
+        return false;
+    }
+
+    _canUpdateIncrementally = false;
+    return SubdivideNode(nodeIndex);
 }
 
 /*-----------------------------------------------------------------------------------------------
@@ -287,108 +636,166 @@ void ParticleQuadTree::ResetNumNodePopulations()
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Adds a single particle to a single node.  The particle collection has to come along for the 
-    ride because of the risk of particle addition causing the node to subdivide.
+    Acquires four new nodes and sets them as children to the provided node.  Sets their 
+    dimensions and neighbors based on the parent.  Then takes the node's particles and divides 
+    them amongst the child nodes.
 Parameters: 
-    particleIndex   Self-explanatory.
     nodeIndex       Self-explanatory
 Returns:    
-    A pointer to said buffer.
+    True if the subdivision was successful, false if there weren't enough nodes for the 
+    subdivision or the node is too small to subdivide (see IsTooSmallToSubdivide(...)).
 Creator:    John Cox (1-28-2017)
 -----------------------------------------------------------------------------------------------*/
-bool ParticleQuadTree::AddParticleToNode(int particleIndex, int nodeIndex)
+bool ParticleQuadTree::SubdivideNode(int nodeIndex)
 {
     // don't bother checking the pointer; if a null pointer was passed, just crash
-    ParticleQuadTreeNode &node = _allNodes[nodeIndex];
-    Particle &p = _localParticleArray[particleIndex];
 
-    if (node._numCurrentParticles == ParticleQuadTreeNode::MAX_PARTICLES_PER_NODE)
+    if (IsTooSmallToSubdivide(_allNodes[nodeIndex]))
     {
-        if (!SubdivideNode(nodeIndex))
-        {
-            // subdivision failed (ran out of nodes) and cannot add particle
-            return false;
-        }
+        return false;
     }
 
-    // TODO: attempt performance boost by checking if (!subdivided) to see if the CPU assumes that the condition is true
-    if (!node._isSubdivided)
+    int childNodeIndexTopLeft = 0;
+    if (!_freeChildBlocks.empty())
     {
-        // not subdivided, so add the particle to this node
-        node._indicesForContainedParticles[node._numCurrentParticles++] = particleIndex;
-        _localParticleArray[particleIndex]._indexOfNodeThatItIsOccupying = nodeIndex;
-
-        return true;
+        // four nodes that UpdateTree(...) merged away; they are still side by side
+        childNodeIndexTopLeft = _freeChildBlocks.back();
+        _freeChildBlocks.pop_back();
+    }
+    else if (_numActiveNodes > (MAX_NODES - 4))
+    {
+        // not enough to nodes to subdivide again
+        return false;
     }
     else
     {
-        // don't need to check >left && < right && >bottom && <top because the first calculations already determined that the particle was (1) within bounds (read, "active") and (2) within one of the first nodes, so every following quadrant check just needs to check against the center values
-        float nodeCenterX = (node._leftEdge + node._rightEdge) * 0.5f;
-        float nodeCenterY = (node._bottomEdge + node._topEdge) * 0.5f;
+        childNodeIndexTopLeft = _numActiveNodes;
+        _numActiveNodes += 4;
+    }
+
+    int childNodeIndexTopRight = childNodeIndexTopLeft + 1;
+    int childNodeIndexBottomRight = childNodeIndexTopLeft + 2;
+    int childNodeIndexBottomLeft = childNodeIndexTopLeft + 3;
+
+    ParticleQuadTreeNode &node = _allNodes[nodeIndex];
+    node._isSubdivided = 1;
+    node._childNodeIndexTopLeft = childNodeIndexTopLeft;
+    node._childNodeIndexTopRight = childNodeIndexTopRight;
+    node._childNodeIndexBottomRight = childNodeIndexBottomRight;
+    node._childNodeIndexBottomLeft = childNodeIndexBottomLeft;
 
-        // attempting conditional elimination to improve performance
-        // Note: it didn't seem to gain me any frames over nested 
-        // if (left of center) { if (higher than middle) { ... conditions.  It is less code though.
+    float nodeCenterX = (node._leftEdge + node._rightEdge) * 0.5f;
+    float nodeCenterY = (node._bottomEdge + node._topEdge) * 0.5f;
+
+    AssignChildNodes(node, 
+        _allNodes[childNodeIndexTopLeft], _allNodes[childNodeIndexTopRight], 
+        _allNodes[childNodeIndexBottomRight], _allNodes[childNodeIndexBottomLeft]);
+
+    // redistribute the particles amongst the children
+    for (unsigned int particleCount = 0; particleCount < node._numCurrentParticles; particleCount++)
+    {
+        int particleIndex = node._indicesForContainedParticles[particleCount];
+        //int childNodeIndex = WhichNodeIsOccupied(particleIndex, nodeCenter, childNodeIndexTopLeft, childNodeIndexTopRight, childNodeIndexBottomLeft, childNodeIndexBottomRight);
+
+        // attempting conditional elimination to improve performance, but it doesn't seem to be getting anything  better than nest if (left of center) { if (higher than center) { ... conditions.  It's less code though.
+        Particle &p = _localParticleArray[particleIndex];
         int isLeft = int(p._position.x < nodeCenterX);
         int isRight = 1 - isLeft;
         int isTop = int(p._position.y > nodeCenterY);
         int isBottom = 1 - isTop;
 
-        int isTopLeftIndex = node._childNodeIndexTopLeft * (isLeft * isTop);
-        int isTopRightIndex = node._childNodeIndexTopRight * (isRight * isTop);
-        int isBottomLeftIndex = node._childNodeIndexBottomLeft * (isLeft * isBottom);
-        int isBottomRightIndex = node._childNodeIndexBottomRight * (isRight * isBottom);
+        int isTopLeftIndex = childNodeIndexTopLeft * (isLeft * isTop);
+        int isTopRightIndex = childNodeIndexTopRight * (isRight * isTop);
+        int isBottomLeftIndex = childNodeIndexBottomLeft * (isLeft * isBottom);
+        int isBottomRightIndex = childNodeIndexBottomRight * (isRight * isBottom);
 
-        // only one of the first four indices will be non-zero
+        // only one of these will be non-zero
         int childNodeIndex = isTopLeftIndex + isTopRightIndex + isBottomLeftIndex + isBottomRightIndex;
 
-        // go deeper
-        return AddParticleToNode(particleIndex, childNodeIndex);
+        ParticleQuadTreeNode &childNode = _allNodes[childNodeIndex];
+        childNode._indicesForContainedParticles[childNode._numCurrentParticles++] = particleIndex;
+        p._indexOfNodeThatItIsOccupying = childNodeIndex;
+
+        // not actually necessary because the array will be run over on the next update, but I 
+        // still like to clean up after myself in case of debugging
+        node._indicesForContainedParticles[particleCount] = -1;
     }
+
+    // reset the subdivided node's particle count so that it doesn't try to subdivide again
+    node._numCurrentParticles = 0;
+
+    return true;
 }
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Acquires four new nodes and sets them as children to the provided node.  Sets their 
-    dimensions and neighbors based on the parent.  Then takes the node's particles and divides 
-    them amongst the child nodes.
+    Checks if the node is so small that a float can't put its center between its edges.  Its 
+    children would not split its particles up, and neither would theirs, so every build 
+    stops there instead of spending the rest of the nodes on a chain of them (particles that 
+    are on top of each other would do that).
 Parameters: 
-    nodeIndex       Self-explanatory
+    node    Self-explanatory
 Returns:    
-    True if the subdivision was successful, false if there weren't enough nodes for the 
-    subdivision.
-Creator:    John Cox (1-28-2017)
+    True if the node can't usefully be subdivided, otherwise false.
+Creator:    John Cox (10-17-2026)
 -----------------------------------------------------------------------------------------------*/
-bool ParticleQuadTree::SubdivideNode(int nodeIndex)
+bool ParticleQuadTree::IsTooSmallToSubdivide(const ParticleQuadTreeNode &node)
 {
-    // don't bother checking the pointer; if a null pointer was passed, just crash
-
-    if (_numActiveNodes > (MAX_NODES - 4))
-    {
-        // not enough to nodes to subdivide again
-        return false;
-    }
-
-    int childNodeIndexTopLeft = _numActiveNodes++;
-    int childNodeIndexTopRight = _numActiveNodes++;
-    int childNodeIndexBottomRight = _numActiveNodes++;
-    int childNodeIndexBottomLeft = _numActiveNodes++;
+    float nodeCenterX = (node._leftEdge + node._rightEdge) * 0.5f;
+    float nodeCenterY = (node._bottomEdge + node._topEdge) * 0.5f;
+    return !(nodeCenterX > node._leftEdge && nodeCenterX < node._rightEdge && 
+        nodeCenterY > node._bottomEdge && nodeCenterY < node._topEdge);
+}
 
-    ParticleQuadTreeNode &node = _allNodes[nodeIndex];
-    node._isSubdivided = 1;
-    node._childNodeIndexTopLeft = childNodeIndexTopLeft;
-    node._childNodeIndexTopRight = childNodeIndexTopRight;
-    node._childNodeIndexBottomRight = childNodeIndexBottomRight;
-    node._childNodeIndexBottomLeft = childNodeIndexBottomLeft;
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets the dimensions and neighbors of a freshly subdivided node's children.  The node's 
+    child indices must already be set.  Split out of SubdivideNode(...) so that the parallel 
+    build's subdivision does not need its own copy of the neighbor bookkeeping.
 
+    The children are also emptied, since ResetTree() leaves whatever an earlier tree put in 
+    them.
+Parameters: 
+    node            The node that was just subdivided.
+    childTopLeft    The node at node._childNodeIndexTopLeft.
+    childTopRight   Same idea.
+    childBottomRight    Same idea.
+    childBottomLeft     Same idea.
+Returns:    None
+Creator:    John Cox (1-28-2017)
+            (split out of SubdivideNode(...) 10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleQuadTree::AssignChildNodes(const ParticleQuadTreeNode &node, 
+    ParticleQuadTreeNode &childTopLeft, ParticleQuadTreeNode &childTopRight, 
+    ParticleQuadTreeNode &childBottomRight, ParticleQuadTreeNode &childBottomLeft)
+{
     float nodeCenterX = (node._leftEdge + node._rightEdge) * 0.5f;
     float nodeCenterY = (node._bottomEdge + node._topEdge) * 0.5f;
 
+    int childNodeIndexTopLeft = node._childNodeIndexTopLeft;
+    int childNodeIndexTopRight = node._childNodeIndexTopRight;
+    int childNodeIndexBottomRight = node._childNodeIndexBottomRight;
+    int childNodeIndexBottomLeft = node._childNodeIndexBottomLeft;
+
+    ParticleQuadTreeNode *children[4] = 
+    { 
+        &childTopLeft, &childTopRight, &childBottomRight, &childBottomLeft 
+    };
+    for (int childCount = 0; childCount < 4; childCount++)
+    {
+        ParticleQuadTreeNode &child = *children[childCount];
+        child._numCurrentParticles = 0;
+        child._isSubdivided = 0;
+        child._childNodeIndexTopLeft = 0;
+        child._childNodeIndexTopRight = 0;
+        child._childNodeIndexBottomRight = 0;
+        child._childNodeIndexBottomLeft = 0;
+    }
+
     // assign neighbors
     // Note: This is going to get really messy when I move to 3D and have to use octrees, each 
     // with 26 neighbors ((3 * 3 * 3) - 1 center node).
 
-    ParticleQuadTreeNode &childTopLeft = _allNodes[childNodeIndexTopLeft];
     childTopLeft._inUse = 1;
     childTopLeft._neighborIndexLeft = node._neighborIndexLeft;
     childTopLeft._neighborIndexTopLeft = node._neighborIndexTopLeft;
@@ -403,7 +810,6 @@ bool ParticleQuadTree::SubdivideNode(int nodeIndex)
     childTopLeft._rightEdge = nodeCenterX;
     childTopLeft._bottomEdge = nodeCenterY;
 
-    ParticleQuadTreeNode &childTopRight = _allNodes[childNodeIndexTopRight];
     childTopRight._inUse = 1;
     childTopRight._neighborIndexLeft = childNodeIndexTopLeft;
     childTopRight._neighborIndexTopLeft = node._neighborIndexTop;
@@ -418,7 +824,6 @@ bool ParticleQuadTree::SubdivideNode(int nodeIndex)
     childTopRight._rightEdge = node._rightEdge;
     childTopRight._bottomEdge = nodeCenterY;
 
-    ParticleQuadTreeNode &childBottomLeft = _allNodes[childNodeIndexBottomLeft];
     childBottomLeft._inUse = 1;
     childBottomLeft._neighborIndexLeft = node._neighborIndexLeft;
     childBottomLeft._neighborIndexTopLeft = node._neighborIndexLeft;
@@ -433,7 +838,6 @@ bool ParticleQuadTree::SubdivideNode(int nodeIndex)
     childBottomLeft._rightEdge = nodeCenterX;
     childBottomLeft._bottomEdge = node._bottomEdge;
 
-    ParticleQuadTreeNode &childBottomRight = _allNodes[childNodeIndexBottomRight];
     childBottomRight._inUse = 1;
     childBottomRight._neighborIndexLeft = childNodeIndexBottomLeft;
     childBottomRight._neighborIndexTopLeft = childNodeIndexTopLeft;
@@ -447,14 +851,292 @@ bool ParticleQuadTree::SubdivideNode(int nodeIndex)
     childBottomRight._topEdge = nodeCenterY;
     childBottomRight._rightEdge = node._rightEdge;
     childBottomRight._bottomEdge = node._bottomEdge;
+}
 
-    // redistribute the particles amongst the children
-    for (int particleCount = 0; particleCount < node._numCurrentParticles; particleCount++)
-    {
-        int particleIndex = node._indicesForContainedParticles[particleCount];
-        //int childNodeIndex = WhichNodeIsOccupied(particleIndex, nodeCenter, childNodeIndexTopLeft, childNodeIndexTopRight, childNodeIndexBottomLeft, childNodeIndexBottomRight);
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The multithreaded version of the loop in AddParticlestoTree(...).
 
-        // attempting conditional elimination to improve performance, but it doesn't seem to be getting anything  better than nest if (left of center) { if (higher than center) { ... conditions.  It's less code though.
+    (1) Hand the active particles out to the four starting nodes.
+    (2) Subdivide the most crowded of those up front (see SplitBuildTasks(...)) until there 
+    is enough work to go around.
+    (3) Every worker builds whole subtrees, each in its own node slab, so no locking is 
+    needed.  The only thing that is shared is the count of reserved nodes, which keeps all 
+    the slabs together under MAX_NODES.
+    (4) Every slab is copied into _allNodes after the slabs before it and its indices are 
+    fixed up.
+
+    Note: A node is subdivided if and only if more than MAX_PARTICLES_PER_NODE particles end up 
+    in it, regardless of the order that they were added, so the tree has the same shape as the 
+    single-threaded build and each leaf has the same particles.  Only the node numbering and 
+    the order of the particles within a leaf differ (see AddParticlestoTreeLinear(...)).  The 
+    exception is when the tree runs out of nodes, in which case which particles get left out 
+    depends on which thread got there first.
+Parameters: 
+    numParticles    How many particles in _localParticleArray to consider.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleQuadTree::AddParticlestoTreeParallel(int numParticles)
+{
+    // the task collection only grows so that the particle lists and slabs keep their memory 
+    // from frame to frame
+    if (_buildTasks.size() < FIRST_FOUR_NODE_INDEXES::NUM_STARTING_NODES)
+    {
+        _buildTasks.resize(FIRST_FOUR_NODE_INDEXES::NUM_STARTING_NODES);
+    }
+
+    _numBuildTasks = FIRST_FOUR_NODE_INDEXES::NUM_STARTING_NODES;
+    for (int taskIndex = 0; taskIndex < FIRST_FOUR_NODE_INDEXES::NUM_STARTING_NODES; taskIndex++)
+    {
+        BuildTask &task = _buildTasks[taskIndex];
+        task._rootNodeIndex = taskIndex;
+        task._particleIndices.clear();
+        task._nodes.clear();
+    }
+
+    // the starting nodes' indices are in the same TL, TR, BL, BR order as the quadrants
+    GatherActivePositions(numParticles, _splitScratch);
+    _quadrants.resize(_splitScratch.size());
+    ClassifyQuadrants(_positionsX.data(), _positionsY.data(), (unsigned int)_splitScratch.size(), 
+        _particleRegionCenter.x, _particleRegionCenter.y, _quadrants.data());
+    for (size_t particleCount = 0; particleCount < _splitScratch.size(); particleCount++)
+    {
+        _buildTasks[_quadrants[particleCount]]._particleIndices.push_back(_splitScratch[particleCount]);
+    }
+
+    // a few tasks per thread so that one crowded subtree doesn't hold everyone up
+    SplitBuildTasks(_numBuildThreads * 4);
+
+    _numTopNodes = _numActiveNodes;
+    _numReservedNodes = _numActiveNodes;
+    RunBuildTasks(&ParticleQuadTree::BuildTaskSubtree);
+
+    int stitchOffset = _numTopNodes;
+    for (unsigned int taskIndex = 0; taskIndex < _numBuildTasks; taskIndex++)
+    {
+        _buildTasks[taskIndex]._stitchOffset = stitchOffset;
+        stitchOffset += (int)_buildTasks[taskIndex]._nodes.size();
+    }
+    _numActiveNodes = stitchOffset;
+
+    RunBuildTasks(&ParticleQuadTree::StitchTask);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Splits the most crowded build task into four by subdividing its root node in _allNodes 
+    and handing its particles out to the children.  Repeats until there are enough tasks.
+
+    Only tasks with more than MAX_PARTICLES_PER_NODE particles are split because those are 
+    the only nodes that the single-threaded build would have subdivided anyway.
+Parameters: 
+    targetNumTasks  Stop once there are at least this many tasks.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleQuadTree::SplitBuildTasks(unsigned int targetNumTasks)
+{
+    while (_numBuildTasks < targetNumTasks)
+    {
+        unsigned int mostCrowdedTaskIndex = 0;
+        for (unsigned int taskIndex = 1; taskIndex < _numBuildTasks; taskIndex++)
+        {
+            if (_buildTasks[taskIndex]._particleIndices.size() > 
+                _buildTasks[mostCrowdedTaskIndex]._particleIndices.size())
+            {
+                mostCrowdedTaskIndex = taskIndex;
+            }
+        }
+
+        if (_buildTasks[mostCrowdedTaskIndex]._particleIndices.size() <= 
+            ParticleQuadTreeNode::MAX_PARTICLES_PER_NODE)
+        {
+            // nothing left that would be subdivided
+            return;
+        }
+
+        int nodeIndex = _buildTasks[mostCrowdedTaskIndex]._rootNodeIndex;
+        if (!SubdivideNode(nodeIndex))
+        {
+            // out of nodes (or too small); the tasks will run into it too, but that is their 
+            // problem
+            return;
+        }
+
+        if (_buildTasks.size() < _numBuildTasks + 3)
+        {
+            _buildTasks.resize(_numBuildTasks + 3);
+        }
+
+        // the crowded task becomes the top left child and the other three are tacked on
+        _splitScratch.swap(_buildTasks[mostCrowdedTaskIndex]._particleIndices);
+        BuildTask *childTasks[4] = 
+        {
+            &_buildTasks[mostCrowdedTaskIndex],
+            &_buildTasks[_numBuildTasks],
+            &_buildTasks[_numBuildTasks + 1],
+            &_buildTasks[_numBuildTasks + 2]
+        };
+        _numBuildTasks += 3;
+
+        // same TL, TR, BL, BR order as the starting nodes
+        const ParticleQuadTreeNode &node = _allNodes[nodeIndex];
+        childTasks[0]->_rootNodeIndex = node._childNodeIndexTopLeft;
+        childTasks[1]->_rootNodeIndex = node._childNodeIndexTopRight;
+        childTasks[2]->_rootNodeIndex = node._childNodeIndexBottomLeft;
+        childTasks[3]->_rootNodeIndex = node._childNodeIndexBottomRight;
+        for (int childCount = 0; childCount < 4; childCount++)
+        {
+            childTasks[childCount]->_particleIndices.clear();
+            childTasks[childCount]->_nodes.clear();
+        }
+
+        float nodeCenterX = (node._leftEdge + node._rightEdge) * 0.5f;
+        float nodeCenterY = (node._bottomEdge + node._topEdge) * 0.5f;
+        unsigned int numSplitParticles = (unsigned int)_splitScratch.size();
+        _positionsX.resize(numSplitParticles);
+        _positionsY.resize(numSplitParticles);
+        _quadrants.resize(numSplitParticles);
+        for (unsigned int particleCount = 0; particleCount < numSplitParticles; particleCount++)
+        {
+            const Particle &p = _localParticleArray[_splitScratch[particleCount]];
+            _positionsX[particleCount] = p._position.x;
+            _positionsY[particleCount] = p._position.y;
+        }
+
+        ClassifyQuadrants(_positionsX.data(), _positionsY.data(), numSplitParticles, 
+            nodeCenterX, nodeCenterY, _quadrants.data());
+        for (unsigned int particleCount = 0; particleCount < numSplitParticles; particleCount++)
+        {
+            childTasks[_quadrants[particleCount]]->_particleIndices.push_back(_splitScratch[particleCount]);
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Looks up a node while a build task is running.  Indices below _numTopNodes are shared 
+    nodes in _allNodes (the only one of which the task writes to is its own root), and the 
+    rest are in the task's slab.
+
+    Note: Slab references are invalidated by the next subdivision because the slab may grow.
+Parameters: 
+    task        The build task.
+    nodeIndex   The index as the task sees it.
+Returns:    
+    A reference to the node.
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleQuadTreeNode &ParticleQuadTree::TaskNode(BuildTask &task, int nodeIndex)
+{
+    if (nodeIndex < _numTopNodes)
+    {
+        return _allNodes[nodeIndex];
+    }
+
+    return task._nodes[nodeIndex - _numTopNodes];
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Adds a single particle to a single node of a build task's subtree, subdividing the node 
+    if it is full, and recurses into the children if it is already subdivided.
+Parameters: 
+    task            The build task that owns the node.
+    particleIndex   Self-explanatory.
+    nodeIndex       The index as the task sees it.
+Returns:    
+    True if the particle was added, false if the tree ran out of nodes.
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticleQuadTree::AddParticleToTaskNode(BuildTask &task, int particleIndex, int nodeIndex)
+{
+    if (TaskNode(task, nodeIndex)._numCurrentParticles == ParticleQuadTreeNode::MAX_PARTICLES_PER_NODE)
+    {
+        if (!SubdivideTaskNode(task, nodeIndex))
+        {
+            return false;
+        }
+    }
+
+    // look it up after the subdivision because the slab may have moved
+    ParticleQuadTreeNode &node = TaskNode(task, nodeIndex);
+    Particle &p = _localParticleArray[particleIndex];
+    if (!node._isSubdivided)
+    {
+        node._indicesForContainedParticles[node._numCurrentParticles++] = particleIndex;
+        p._indexOfNodeThatItIsOccupying = nodeIndex;
+        return true;
+    }
+
+    float nodeCenterX = (node._leftEdge + node._rightEdge) * 0.5f;
+    float nodeCenterY = (node._bottomEdge + node._topEdge) * 0.5f;
+
+    int isLeft = int(p._position.x < nodeCenterX);
+    int isRight = 1 - isLeft;
+    int isTop = int(p._position.y > nodeCenterY);
+    int isBottom = 1 - isTop;
+
+    int isTopLeftIndex = node._childNodeIndexTopLeft * (isLeft * isTop);
+    int isTopRightIndex = node._childNodeIndexTopRight * (isRight * isTop);
+    int isBottomLeftIndex = node._childNodeIndexBottomLeft * (isLeft * isBottom);
+    int isBottomRightIndex = node._childNodeIndexBottomRight * (isRight * isBottom);
+
+    // only one of these will be non-zero
+    int childNodeIndex = isTopLeftIndex + isTopRightIndex + isBottomLeftIndex + isBottomRightIndex;
+
+    return AddParticleToTaskNode(task, particleIndex, childNodeIndex);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The build task version of SubdivideNode(...).  The four children come out of the task's 
+    slab, but they still count against MAX_NODES for the whole tree.
+Parameters: 
+    task        The build task that owns the node.
+    nodeIndex   The index as the task sees it.
+Returns:    
+    True if the subdivision was successful, false if there weren't enough nodes for the 
+    subdivision or the node is too small to subdivide.
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticleQuadTree::SubdivideTaskNode(BuildTask &task, int nodeIndex)
+{
+    if (IsTooSmallToSubdivide(TaskNode(task, nodeIndex)))
+    {
+        return false;
+    }
+
+    if (_numReservedNodes.fetch_add(4) > (MAX_NODES - 4))
+    {
+        // not enough to nodes to subdivide again; give them back
+        _numReservedNodes.fetch_sub(4);
+        return false;
+    }
+
+    int childNodeIndexTopLeft = _numTopNodes + (int)task._nodes.size();
+    int childNodeIndexTopRight = childNodeIndexTopLeft + 1;
+    int childNodeIndexBottomRight = childNodeIndexTopLeft + 2;
+    int childNodeIndexBottomLeft = childNodeIndexTopLeft + 3;
+    task._nodes.resize(task._nodes.size() + 4);
+
+    ParticleQuadTreeNode &node = TaskNode(task, nodeIndex);
+    node._isSubdivided = 1;
+    node._childNodeIndexTopLeft = childNodeIndexTopLeft;
+    node._childNodeIndexTopRight = childNodeIndexTopRight;
+    node._childNodeIndexBottomRight = childNodeIndexBottomRight;
+    node._childNodeIndexBottomLeft = childNodeIndexBottomLeft;
+
+    AssignChildNodes(node,
+        TaskNode(task, childNodeIndexTopLeft), TaskNode(task, childNodeIndexTopRight),
+        TaskNode(task, childNodeIndexBottomRight), TaskNode(task, childNodeIndexBottomLeft));
+
+    float nodeCenterX = (node._leftEdge + node._rightEdge) * 0.5f;
+    float nodeCenterY = (node._bottomEdge + node._topEdge) * 0.5f;
+    for (unsigned int particleCount = 0; particleCount < node._numCurrentParticles; particleCount++)
+    {
+        int particleIndex = node._indicesForContainedParticles[particleCount];
         Particle &p = _localParticleArray[particleIndex];
         int isLeft = int(p._position.x < nodeCenterX);
         int isRight = 1 - isLeft;
@@ -469,15 +1151,629 @@ bool ParticleQuadTree::SubdivideNode(int nodeIndex)
         // only one of these will be non-zero
         int childNodeIndex = isTopLeftIndex + isTopRightIndex + isBottomLeftIndex + isBottomRightIndex;
 
-        ParticleQuadTreeNode &childNode = _allNodes[childNodeIndex];
+        ParticleQuadTreeNode &childNode = TaskNode(task, childNodeIndex);
         childNode._indicesForContainedParticles[childNode._numCurrentParticles++] = particleIndex;
         p._indexOfNodeThatItIsOccupying = childNodeIndex;
-
-        // not actually necessary because the array will be run over on the next update, but I 
-        // still like to clean up after myself in case of debugging
         node._indicesForContainedParticles[particleCount] = -1;
     }
 
-    // reset the subdivided node's particle count so that it doesn't try to subdivide again
     node._numCurrentParticles = 0;
+
+    return true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Adds all of a build task's particles to its subtree.  Runs on a worker thread.
+Parameters: 
+    task    Self-explanatory.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleQuadTree::BuildTaskSubtree(BuildTask &task)
+{
+    for (size_t particleCount = 0; particleCount < task._particleIndices.size(); particleCount++)
+    {
+        AddParticleToTaskNode(task, task._particleIndices[particleCount], task._rootNodeIndex);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A helper for StitchTask(...).  Moves a slab index to where the slab ended up in 
+    _allNodes.  Shared node indices and "no node" (-1) are left alone.
+Parameters: 
+    nodeIndex       The index as the task saw it.
+    numTopNodes     See ParticleQuadTree::_numTopNodes.
+    stitchOffset    Where the task's slab starts in _allNodes.
+Returns:    
+    The index into _allNodes.
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+static inline unsigned int StitchedNodeIndex(unsigned int nodeIndex, int numTopNodes, 
+    int stitchOffset)
+{
+    if (nodeIndex == (unsigned int)-1 || nodeIndex < (unsigned int)numTopNodes)
+    {
+        return nodeIndex;
+    }
+
+    return nodeIndex - numTopNodes + stitchOffset;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Copies a build task's slab into _allNodes at the task's stitch offset, fixes up the 
+    child and neighbor indices, and tells the particles where their leaves ended up.  Runs on 
+    a worker thread; every task writes to a different part of _allNodes.
+Parameters: 
+    task    Self-explanatory.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleQuadTree::StitchTask(BuildTask &task)
+{
+    int offset = task._stitchOffset;
+
+    ParticleQuadTreeNode &root = _allNodes[task._rootNodeIndex];
+    if (root._isSubdivided)
+    {
+        root._childNodeIndexTopLeft = StitchedNodeIndex(root._childNodeIndexTopLeft, _numTopNodes, offset);
+        root._childNodeIndexTopRight = StitchedNodeIndex(root._childNodeIndexTopRight, _numTopNodes, offset);
+        root._childNodeIndexBottomRight = StitchedNodeIndex(root._childNodeIndexBottomRight, _numTopNodes, offset);
+        root._childNodeIndexBottomLeft = StitchedNodeIndex(root._childNodeIndexBottomLeft, _numTopNodes, offset);
+    }
+
+    for (size_t slabIndex = 0; slabIndex < task._nodes.size(); slabIndex++)
+    {
+        int nodeIndex = offset + (int)slabIndex;
+        ParticleQuadTreeNode &node = _allNodes[nodeIndex];
+        node = task._nodes[slabIndex];
+
+        node._childNodeIndexTopLeft = StitchedNodeIndex(node._childNodeIndexTopLeft, _numTopNodes, offset);
+        node._childNodeIndexTopRight = StitchedNodeIndex(node._childNodeIndexTopRight, _numTopNodes, offset);
+        node._childNodeIndexBottomRight = StitchedNodeIndex(node._childNodeIndexBottomRight, _numTopNodes, offset);
+        node._childNodeIndexBottomLeft = StitchedNodeIndex(node._childNodeIndexBottomLeft, _numTopNodes, offset);
+
+        node._neighborIndexLeft = StitchedNodeIndex(node._neighborIndexLeft, _numTopNodes, offset);
+        node._neighborIndexTopLeft = StitchedNodeIndex(node._neighborIndexTopLeft, _numTopNodes, offset);
+        node._neighborIndexTop = StitchedNodeIndex(node._neighborIndexTop, _numTopNodes, offset);
+        node._neighborIndexTopRight = StitchedNodeIndex(node._neighborIndexTopRight, _numTopNodes, offset);
+        node._neighborIndexRight = StitchedNodeIndex(node._neighborIndexRight, _numTopNodes, offset);
+        node._neighborIndexBottomRight = StitchedNodeIndex(node._neighborIndexBottomRight, _numTopNodes, offset);
+        node._neighborIndexBottom = StitchedNodeIndex(node._neighborIndexBottom, _numTopNodes, offset);
+        node._neighborIndexBottomLeft = StitchedNodeIndex(node._neighborIndexBottomLeft, _numTopNodes, offset);
+
+        for (unsigned int particleCount = 0; particleCount < node._numCurrentParticles; particleCount++)
+        {
+            _localParticleArray[node._indicesForContainedParticles[particleCount]]._indexOfNodeThatItIsOccupying = nodeIndex;
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs a task function over every build task on the build task pool's threads (this one 
+    included).  Threads that run out of tasks steal from the others so that uneven tasks even 
+    out.
+Parameters: 
+    taskFunction    BuildTaskSubtree or StitchTask.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleQuadTree::RunBuildTasks(void (ParticleQuadTree::*taskFunction)(BuildTask &))
+{
+    _pBuildTaskPool->Run(_numBuildTasks, 
+        [this, taskFunction](unsigned int taskIndex, unsigned int)
+    {
+        (this->*taskFunction)(_buildTasks[taskIndex]);
+    });
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Builds the tree without inserting particles one at a time.
+    (1) Make a Morton key for every active particle (see ComputeMortonKeys(...)) and radix 
+    sort the particle indices by them.  Every node's particles are now (nearly) one 
+    contiguous run of the sorted particles, already in the order of the node's quadrants.
+    (2) Starting with the first four nodes, split each node's run into its four quadrants 
+    (see PartitionLinearBuildRange(...)).  If the node has more than MAX_PARTICLES_PER_NODE 
+    particles, it gets four children and its quadrants are queued up for them.  Otherwise 
+    its particles are copied into it.
+
+    Nodes are handled breadth first, so there is no recursion, and the only writes into 
+    _allNodes are to the nodes that are being made.  A node is subdivided if and only if it 
+    has more than MAX_PARTICLES_PER_NODE particles, just like with one-at-a-time insertion, 
+    and the quadrants are decided with the same center line comparisons as 
+    SubdivideNode(...), so the tree has the same shape and each leaf has the same particles.  
+    Only the node numbering and the order of the particles within a leaf (sorted order 
+    instead of index order) differ.
+
+    Note: The keys only say which quadrant a particle is in to within 1/65536th of the region, 
+    so they are only used for the order.  The partition has the final say, and a particle 
+    that the key put on the wrong side of a center line is moved across it there.
+
+    Also Note: Like with one-at-a-time insertion, a node that has to be subdivided when there 
+    are no more nodes (or that is too small, see IsTooSmallToSubdivide(...)) keeps the first 
+    MAX_PARTICLES_PER_NODE particles and leaves the rest out.  Which ones are left out 
+    depends on the order, so this is the one case where the builds can disagree.  Particles 
+    that are left out get NO_LEAF (see BuildTree(...)).
+Parameters: 
+    numParticles    How many particles in _localParticleArray to consider.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleQuadTree::AddParticlestoTreeLinear(int numParticles)
+{
+    float regionLeft = _particleRegionCenter.x - _particleRegionRadius;
+    float regionTop = _particleRegionCenter.y + _particleRegionRadius;
+    float cellsPerWorldUnit = 65536.0f / (2.0f * _particleRegionRadius);
+
+    // pull the active particles' positions out into a structure of arrays so that the keys 
+    // can be made several at a time
+    GatherActivePositions(numParticles, _sortedParticleIndices);
+    unsigned int numSortedParticles = (unsigned int)_sortedParticleIndices.size();
+    _mortonKeys.resize(numSortedParticles);
+    ComputeMortonKeys(_positionsX.data(), _positionsY.data(), numSortedParticles, 
+        regionLeft, regionTop, cellsPerWorldUnit, _mortonKeys.data());
+    RadixSortMortonKeys(_mortonKeys, _sortedParticleIndices, _mortonKeysScratch, 
+        _sortedParticleIndicesScratch);
+
+    // the positions follow the particles into sorted order so that the partitions can 
+    // classify them several at a time too
+    for (unsigned int sortedIndex = 0; sortedIndex < numSortedParticles; sortedIndex++)
+    {
+        const Particle &p = _localParticleArray[_sortedParticleIndices[sortedIndex]];
+        _positionsX[sortedIndex] = p._position.x;
+        _positionsY[sortedIndex] = p._position.y;
+    }
+    _quadrants.resize(numSortedParticles);
+    _sortedParticleIndicesScratch.resize(numSortedParticles);
+    _positionsXScratch.resize(numSortedParticles);
+    _positionsYScratch.resize(numSortedParticles);
+
+    // the first four nodes already exist, so queue up their quadrants
+    // Note: The starting nodes' indices are in the same TL, TR, BL, BR order as the 
+    // quadrants.
+    _linearBuildQueue.clear();
+    unsigned int quadrantEnds[4];
+    PartitionLinearBuildRange(0, numSortedParticles, _particleRegionCenter.x, 
+        _particleRegionCenter.y, quadrantEnds);
+    unsigned int quadrantBegin = 0;
+    for (unsigned int quadrant = 0; quadrant < 4; quadrant++)
+    {
+        LinearBuildRange range = { (int)quadrant, quadrantBegin, quadrantEnds[quadrant] };
+        _linearBuildQueue.push_back(range);
+        quadrantBegin = quadrantEnds[quadrant];
+    }
+
+    for (size_t queueIndex = 0; queueIndex < _linearBuildQueue.size(); queueIndex++)
+    {
+        // copied because pushing the children may move the queue
+        LinearBuildRange range = _linearBuildQueue[queueIndex];
+        ParticleQuadTreeNode &node = _allNodes[range._nodeIndex];
+        unsigned int numParticlesInNode = range._end - range._begin;
+
+        if (numParticlesInNode > ParticleQuadTreeNode::MAX_PARTICLES_PER_NODE && 
+            _numActiveNodes <= (MAX_NODES - 4) && !IsTooSmallToSubdivide(node))
+        {
+            // same child order as SubdivideNode(...)
+            node._isSubdivided = 1;
+            node._childNodeIndexTopLeft = _numActiveNodes++;
+            node._childNodeIndexTopRight = _numActiveNodes++;
+            node._childNodeIndexBottomRight = _numActiveNodes++;
+            node._childNodeIndexBottomLeft = _numActiveNodes++;
+            AssignChildNodes(node, 
+                _allNodes[node._childNodeIndexTopLeft], _allNodes[node._childNodeIndexTopRight], 
+                _allNodes[node._childNodeIndexBottomRight], _allNodes[node._childNodeIndexBottomLeft]);
+
+            // in the quadrants' order
+            unsigned int childNodeIndexes[4] = 
+            {
+                node._childNodeIndexTopLeft,
+                node._childNodeIndexTopRight,
+                node._childNodeIndexBottomLeft,
+                node._childNodeIndexBottomRight
+            };
+
+            float nodeCenterX = (node._leftEdge + node._rightEdge) * 0.5f;
+            float nodeCenterY = (node._bottomEdge + node._topEdge) * 0.5f;
+            PartitionLinearBuildRange(range._begin, range._end, nodeCenterX, nodeCenterY, 
+                quadrantEnds);
+            quadrantBegin = range._begin;
+            for (unsigned int quadrant = 0; quadrant < 4; quadrant++)
+            {
+                LinearBuildRange childRange = 
+                { 
+                    (int)childNodeIndexes[quadrant], quadrantBegin, quadrantEnds[quadrant]
+                };
+                _linearBuildQueue.push_back(childRange);
+                quadrantBegin = quadrantEnds[quadrant];
+            }
+        }
+        else
+        {
+            if (numParticlesInNode > ParticleQuadTreeNode::MAX_PARTICLES_PER_NODE)
+            {
+                // out of nodes (or too small), so like AddParticleToTaskNode(...) the rest 
+                // are left out
+                numParticlesInNode = ParticleQuadTreeNode::MAX_PARTICLES_PER_NODE;
+            }
+
+            for (unsigned int particleCount = 0; particleCount < numParticlesInNode; particleCount++)
+            {
+                int particleIndex = _sortedParticleIndices[range._begin + particleCount];
+                node._indicesForContainedParticles[particleCount] = particleIndex;
+                _localParticleArray[particleIndex]._indexOfNodeThatItIsOccupying = range._nodeIndex;
+            }
+            node._numCurrentParticles = numParticlesInNode;
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A helper for AddParticlestoTreeLinear(...).  Classifies a run of the sorted particles 
+    against a node's center (see ClassifyQuadrants(...)) and makes sure that the run is in 
+    TL, TR, BL, BR order.
+
+    The Morton sort almost always has it in that order already, and then nothing moves.  
+    Otherwise the run is put in order with a stable counting sort, so the particles in each 
+    quadrant keep their sorted order.
+Parameters: 
+    begin           The first of the run in _sortedParticleIndices.
+    end             One past the last.
+    centerX         The node's center.
+    centerY         The node's center.
+    quadrantEnds    Gets where each quadrant's run ends.  Each one begins where the one 
+                    before it ends, and the first one begins at begin.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleQuadTree::PartitionLinearBuildRange(unsigned int begin, unsigned int end, 
+    float centerX, float centerY, unsigned int quadrantEnds[4])
+{
+    ClassifyQuadrants(_positionsX.data() + begin, _positionsY.data() + begin, end - begin, 
+        centerX, centerY, _quadrants.data() + begin);
+
+    unsigned int numInQuadrant[4] = { 0, 0, 0, 0 };
+    bool isInOrder = true;
+    for (unsigned int sortedIndex = begin; sortedIndex < end; sortedIndex++)
+    {
+        numInQuadrant[_quadrants[sortedIndex]]++;
+        if (sortedIndex > begin && _quadrants[sortedIndex] < _quadrants[sortedIndex - 1])
+        {
+            isInOrder = false;
+        }
+    }
+
+    unsigned int quadrantBegins[4];
+    unsigned int quadrantBegin = begin;
+    for (unsigned int quadrant = 0; quadrant < 4; quadrant++)
+    {
+        quadrantBegins[quadrant] = quadrantBegin;
+        quadrantBegin += numInQuadrant[quadrant];
+        quadrantEnds[quadrant] = quadrantBegin;
+    }
+
+    if (isInOrder)
+    {
+        return;
+    }
+
+    for (unsigned int sortedIndex = begin; sortedIndex < end; sortedIndex++)
+    {
+        unsigned int destination = quadrantBegins[_quadrants[sortedIndex]]++;
+        _sortedParticleIndicesScratch[destination] = _sortedParticleIndices[sortedIndex];
+        _positionsXScratch[destination] = _positionsX[sortedIndex];
+        _positionsYScratch[destination] = _positionsY[sortedIndex];
+    }
+
+    std::copy(_sortedParticleIndicesScratch.begin() + begin, 
+        _sortedParticleIndicesScratch.begin() + end, _sortedParticleIndices.begin() + begin);
+    std::copy(_positionsXScratch.begin() + begin, _positionsXScratch.begin() + end, 
+        _positionsX.begin() + begin);
+    std::copy(_positionsYScratch.begin() + begin, _positionsYScratch.begin() + end, 
+        _positionsY.begin() + begin);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Fills in the bookkeeping that UpdateTree(...) needs after a full build: every node's 
+    parent, how many particles are under every node, and which leaf every particle is in.
+
+    Note: Right after a full build, every node's children come after it in the buffer, so 
+    going backwards through the nodes counts the children before their parents.
+Parameters: 
+    numParticles    How many particles in _localParticleArray were considered.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleQuadTree::RecordIncrementalState(int numParticles)
+{
+    _leafOfParticle.assign(numParticles, -1);
+    for (int nodeIndex = 0; nodeIndex < FIRST_FOUR_NODE_INDEXES::NUM_STARTING_NODES; nodeIndex++)
+    {
+        _parentNodeIndex[nodeIndex] = -1;
+    }
+
+    for (int nodeIndex = _numActiveNodes - 1; nodeIndex >= 0; nodeIndex--)
+    {
+        const ParticleQuadTreeNode &node = _allNodes[nodeIndex];
+        if (node._isSubdivided)
+        {
+            _parentNodeIndex[node._childNodeIndexTopLeft] = nodeIndex;
+            _parentNodeIndex[node._childNodeIndexTopRight] = nodeIndex;
+            _parentNodeIndex[node._childNodeIndexBottomRight] = nodeIndex;
+            _parentNodeIndex[node._childNodeIndexBottomLeft] = nodeIndex;
+            _subtreeParticleCount[nodeIndex] = 
+                _subtreeParticleCount[node._childNodeIndexTopLeft] + 
+                _subtreeParticleCount[node._childNodeIndexTopRight] + 
+                _subtreeParticleCount[node._childNodeIndexBottomRight] + 
+                _subtreeParticleCount[node._childNodeIndexBottomLeft];
+        }
+        else
+        {
+            _subtreeParticleCount[nodeIndex] = node._numCurrentParticles;
+            for (unsigned int particleCount = 0; particleCount < node._numCurrentParticles; particleCount++)
+            {
+                _leafOfParticle[node._indicesForContainedParticles[particleCount]] = nodeIndex;
+            }
+        }
+    }
+
+    _freeChildBlocks.clear();
+    _numParticlesInTree = numParticles;
+    _canUpdateIncrementally = true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Checks if a position would end up in the given node when dropped in from the top.  Uses 
+    the same "less than the center goes left, greater than the center goes up" rule as the 
+    build, so a position on the line between two nodes belongs to the right or bottom one.
+Parameters: 
+    node        Self-explanatory.
+    position    In world space.
+Returns:    
+    True if the node contains the position, otherwise false.
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticleQuadTree::NodeContains(const ParticleQuadTreeNode &node, 
+    const glm::vec4 &position) const
+{
+    return (position.x >= node._leftEdge) && (position.x < node._rightEdge) &&
+        (position.y > node._bottomEdge) && (position.y <= node._topEdge);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Takes a particle out of its leaf and queues up the leaf's parent to be checked for 
+    merging.  The leaf's last particle fills the hole, so the order of the rest changes.
+Parameters: 
+    particleIndex   Self-explanatory.
+    nodeIndex       The leaf that the particle is in.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleQuadTree::RemoveParticleFromLeaf(int particleIndex, int nodeIndex)
+{
+    ParticleQuadTreeNode &node = _allNodes[nodeIndex];
+    for (unsigned int particleCount = 0; particleCount < node._numCurrentParticles; particleCount++)
+    {
+        if (node._indicesForContainedParticles[particleCount] == (unsigned int)particleIndex)
+        {
+            node._numCurrentParticles--;
+            node._indicesForContainedParticles[particleCount] = 
+                node._indicesForContainedParticles[node._numCurrentParticles];
+            node._indicesForContainedParticles[node._numCurrentParticles] = -1;
+            break;
+        }
+    }
+
+    _leafOfParticle[particleIndex] = -1;
+    AddToSubtreeParticleCounts(nodeIndex, -1);
+    if (_parentNodeIndex[nodeIndex] != -1)
+    {
+        _mergeCandidates.push_back(_parentNodeIndex[nodeIndex]);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Climbs up from the given node until it finds one that contains the particle (or runs out 
+    of tree and starts from the top), and then drops the particle in from there, subdividing 
+    a full leaf on the way like a full build does.
+Parameters: 
+    particleIndex   Self-explanatory.
+    startNodeIndex  Where to start looking.  -1 starts from the top.
+Returns:    
+    True if the particle was added, false if the leaf was full and could not be subdivided 
+    (out of nodes, or too small).
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticleQuadTree::InsertParticle(int particleIndex, int startNodeIndex)
+{
+    const Particle &p = _localParticleArray[particleIndex];
+
+    int nodeIndex = startNodeIndex;
+    while (nodeIndex != -1 && !NodeContains(_allNodes[nodeIndex], p._position))
+    {
+        nodeIndex = _parentNodeIndex[nodeIndex];
+    }
+
+    int isLeft = 0;
+    int isTop = 0;
+    if (nodeIndex == -1)
+    {
+        // the starting nodes' indices are in the order TL, TR, BL, BR
+        isLeft = int(p._position.x < _particleRegionCenter.x);
+        isTop = int(p._position.y > _particleRegionCenter.y);
+        nodeIndex = ((1 - isTop) * 2) + (1 - isLeft);
+    }
+
+    while (true)
+    {
+        ParticleQuadTreeNode &node = _allNodes[nodeIndex];
+        if (!node._isSubdivided)
+        {
+            if (node._numCurrentParticles < ParticleQuadTreeNode::MAX_PARTICLES_PER_NODE)
+            {
+                node._indicesForContainedParticles[node._numCurrentParticles++] = particleIndex;
+                _leafOfParticle[particleIndex] = nodeIndex;
+                AddToSubtreeParticleCounts(nodeIndex, +1);
+                return true;
+            }
+
+            if (!SubdivideNode(nodeIndex))
+            {
+                return false;
+            }
+
+            // SubdivideNode(...) moved the particles, so the bookkeeping follows them
+            unsigned int childNodeIndexes[4] = 
+            {
+                node._childNodeIndexTopLeft,
+                node._childNodeIndexTopRight,
+                node._childNodeIndexBottomRight,
+                node._childNodeIndexBottomLeft
+            };
+            for (int childCount = 0; childCount < 4; childCount++)
+            {
+                const ParticleQuadTreeNode &childNode = _allNodes[childNodeIndexes[childCount]];
+                _parentNodeIndex[childNodeIndexes[childCount]] = nodeIndex;
+                _subtreeParticleCount[childNodeIndexes[childCount]] = childNode._numCurrentParticles;
+                for (unsigned int particleCount = 0; particleCount < childNode._numCurrentParticles; particleCount++)
+                {
+                    _leafOfParticle[childNode._indicesForContainedParticles[particleCount]] = 
+                        childNodeIndexes[childCount];
+                }
+            }
+        }
+
+        float nodeCenterX = (node._leftEdge + node._rightEdge) * 0.5f;
+        float nodeCenterY = (node._bottomEdge + node._topEdge) * 0.5f;
+        isLeft = int(p._position.x < nodeCenterX);
+        isTop = int(p._position.y > nodeCenterY);
+        if (isTop)
+        {
+            nodeIndex = isLeft ? node._childNodeIndexTopLeft : node._childNodeIndexTopRight;
+        }
+        else
+        {
+            nodeIndex = isLeft ? node._childNodeIndexBottomLeft : node._childNodeIndexBottomRight;
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    If the node is subdivided, all of its children are leaves, and it is down to 
+    MERGE_PARTICLE_COUNT particles, then the children's particles are moved up into the node 
+    and the four children are given back for SubdivideNode(...) to reuse.  The node's parent 
+    is then queued up to be checked too.
+
+    Note: Only the node's children and their descendants can have the children as neighbors 
+    (see AssignChildNodes(...)), so no other node is left pointing at the freed nodes.
+Parameters: 
+    nodeIndex   Self-explanatory.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleQuadTree::MergeNode(int nodeIndex)
+{
+    ParticleQuadTreeNode &node = _allNodes[nodeIndex];
+    if (!node._isSubdivided || 
+        _subtreeParticleCount[nodeIndex] > (int)MERGE_PARTICLE_COUNT)
+    {
+        return;
+    }
+
+    // children were allocated side by side, starting with the top left
+    int firstChildNodeIndex = node._childNodeIndexTopLeft;
+    for (int childNodeIndex = firstChildNodeIndex; childNodeIndex < firstChildNodeIndex + 4; childNodeIndex++)
+    {
+        if (_allNodes[childNodeIndex]._isSubdivided)
+        {
+            // a grandchild has to merge first, and it will queue this node up again if it does
+            return;
+        }
+    }
+
+    node._numCurrentParticles = 0;
+    for (int childNodeIndex = firstChildNodeIndex; childNodeIndex < firstChildNodeIndex + 4; childNodeIndex++)
+    {
+        ParticleQuadTreeNode &childNode = _allNodes[childNodeIndex];
+        for (unsigned int particleCount = 0; particleCount < childNode._numCurrentParticles; particleCount++)
+        {
+            int particleIndex = childNode._indicesForContainedParticles[particleCount];
+            node._indicesForContainedParticles[node._numCurrentParticles++] = particleIndex;
+            _leafOfParticle[particleIndex] = nodeIndex;
+        }
+
+        childNode._inUse = 0;
+        childNode._numCurrentParticles = 0;
+        _parentNodeIndex[childNodeIndex] = -1;
+        _subtreeParticleCount[childNodeIndex] = 0;
+    }
+
+    node._isSubdivided = 0;
+    node._childNodeIndexTopLeft = -1;
+    node._childNodeIndexTopRight = -1;
+    node._childNodeIndexBottomRight = -1;
+    node._childNodeIndexBottomLeft = -1;
+    _freeChildBlocks.push_back(firstChildNodeIndex);
+
+    if (_parentNodeIndex[nodeIndex] != -1)
+    {
+        _mergeCandidates.push_back(_parentNodeIndex[nodeIndex]);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Adds to the particle count of a node and every node above it.
+Parameters: 
+    nodeIndex   Self-explanatory.
+    delta       +1 or -1.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleQuadTree::AddToSubtreeParticleCounts(int nodeIndex, int delta)
+{
+    while (nodeIndex != -1)
+    {
+        _subtreeParticleCount[nodeIndex] += delta;
+        nodeIndex = _parentNodeIndex[nodeIndex];
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Copies the active particles' X and Y values out of _localParticleArray and into 
+    _positionsX and _positionsY (see QuadrantClassification.h for why).
+Parameters: 
+    numParticles        How many particles in _localParticleArray to consider.
+    particleIndices     Gets the index of the particle that each position came from.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleQuadTree::GatherActivePositions(int numParticles, std::vector<int> &particleIndices)
+{
+    particleIndices.clear();
+    _positionsX.clear();
+    _positionsY.clear();
+    for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    {
+        const Particle &p = _localParticleArray[particleIndex];
+        if (p._isActive == 0)
+        {
+            // only add active particles
+            continue;
+        }
+
+        particleIndices.push_back(particleIndex);
+        _positionsX.push_back(p._position.x);
+        _positionsY.push_back(p._position.y);
+    }
 }
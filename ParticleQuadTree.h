@@ -1,11 +1,15 @@
 #pragma once
 
 #include <vector>
+#include <atomic>
+#include "glm/vec2.hpp"
 #include "glm/vec4.hpp"
 
 #include "ParticleQuadTreeNode.h"
 #include "Particle.h"
 
+class WorkStealingTaskPool;
+
 
 /*-----------------------------------------------------------------------------------------------
 Description:
@@ -23,12 +27,24 @@ Creator:    John Cox (1-10-2017)
 class ParticleQuadTree
 {
 public:
-    ParticleQuadTree(const glm::vec4 &particleRegionCenter, float particleRegionRadius);
+    ParticleQuadTree(const glm::vec4 &particleRegionCenter, float particleRegionRadius, 
+        unsigned int maxParticles = Particle::MAX_PARTICLES);
+    ~ParticleQuadTree();
 
     void ResetTree();
-    void AddParticlestoTree(Particle *particleCollection, int numParticles);
+    void SetNumBuildThreads(unsigned int numThreads);
+    void AddParticlestoTree(const Particle *particleCollection, int numParticles);
+    void UpdateTree(const Particle *particleCollection, int numParticles);
+    void AddParticlestoTree(const glm::vec2 *positions, const unsigned int *stateFlags, 
+        int numParticles);
+    void UpdateTree(const glm::vec2 *positions, const unsigned int *stateFlags, 
+        int numParticles);
     const ParticleQuadTreeNode *QuadTreeBuffer() const;
     const Particle *ParticleBuffer() const;
+    const int *SortedParticleIndices() const;
+    unsigned int NumSortedParticles() const;
+    void CopyParticleLeafIndices(unsigned int *leafIndices, int numParticles) const;
+    bool SubdivideLeaf(int nodeIndex);
 
     unsigned int NumActiveNodes() const;
     int NumNodePopulations() const;
@@ -37,9 +53,84 @@ public:
 public:
     static const int MAX_NODES = 256 * 256;
 
+    // UpdateTree(...) gives up and rebuilds if more than this percent of the particles in the 
+    // tree left their leaves (or were just emitted)
+    static const int MAX_MIGRATING_PARTICLE_PERCENT = 25;
+
+    // a subdivided node whose children are all leaves is merged back into a leaf when it is 
+    // down to this many particles
+    // Note: Merging any later than a full build would have made it a leaf costs collisions 
+    // because the collision shader only looks at leaves that are neighbors, and a tree that 
+    // is deeper than it needs to be has more neighbors that are subdivided (no particles).
+    static const unsigned int MERGE_PARTICLE_COUNT = ParticleQuadTreeNode::MAX_PARTICLES_PER_NODE;
+
+    // what CopyParticleLeafIndices(...) gives a particle that isn't in the tree
+    static const unsigned int NO_LEAF = 0xffffffff;
+
 private:
-    bool AddParticleToNode(int particleIndex, int nodeIndex);
+    // the build task pool is owned
+    ParticleQuadTree(const ParticleQuadTree &) = delete;
+    ParticleQuadTree &operator=(const ParticleQuadTree &) = delete;
+
+    void CopyParticlePositions(const glm::vec2 *positions, const unsigned int *stateFlags, 
+        int numParticles);
+    void UpdateTreeFromLocalParticles(int numParticles);
+    void AddParticlestoTreeLinear(int numParticles);
+    void PartitionLinearBuildRange(unsigned int begin, unsigned int end, float centerX, 
+        float centerY, unsigned int quadrantEnds[4]);
+    void GatherActivePositions(int numParticles, std::vector<int> &particleIndices);
+    void BuildTree(int numParticles);
     bool SubdivideNode(int nodeIndex);
+    static bool IsTooSmallToSubdivide(const ParticleQuadTreeNode &node);
+    static void AssignChildNodes(const ParticleQuadTreeNode &node, 
+        ParticleQuadTreeNode &childTopLeft, ParticleQuadTreeNode &childTopRight, 
+        ParticleQuadTreeNode &childBottomRight, ParticleQuadTreeNode &childBottomLeft);
+
+    /*-------------------------------------------------------------------------------------------
+    Description:
+        One unit of work for the parallel build: a subtree root that is already in _allNodes, 
+        the particles that fall inside it, and a private slab of nodes for that subtree's 
+        subdivisions.  While building, slab node N goes by the index 
+        (_numTopNodes + N) so that it can never be confused with a node that is shared by 
+        everyone.  Stitching moves the slab into _allNodes and fixes up those indices.
+    Creator:    John Cox (10-16-2026)
+    -------------------------------------------------------------------------------------------*/
+    struct BuildTask
+    {
+        int _rootNodeIndex;
+        int _stitchOffset;
+        std::vector<int> _particleIndices;
+        std::vector<ParticleQuadTreeNode> _nodes;
+    };
+
+    void AddParticlestoTreeParallel(int numParticles);
+    void SplitBuildTasks(unsigned int targetNumTasks);
+    ParticleQuadTreeNode &TaskNode(BuildTask &task, int nodeIndex);
+    bool AddParticleToTaskNode(BuildTask &task, int particleIndex, int nodeIndex);
+    bool SubdivideTaskNode(BuildTask &task, int nodeIndex);
+    void StitchTask(BuildTask &task);
+    void RunBuildTasks(void (ParticleQuadTree::*taskFunction)(BuildTask &));
+    void BuildTaskSubtree(BuildTask &task);
+
+    void RecordIncrementalState(int numParticles);
+    bool NodeContains(const ParticleQuadTreeNode &node, const glm::vec4 &position) const;
+    void RemoveParticleFromLeaf(int particleIndex, int nodeIndex);
+    bool InsertParticle(int particleIndex, int startNodeIndex);
+    void MergeNode(int nodeIndex);
+    void AddToSubtreeParticleCounts(int nodeIndex, int delta);
+
+    /*-------------------------------------------------------------------------------------------
+    Description:
+        One node's worth of work for the linear build: the node and the run of sorted 
+        particles that fall inside it.
+    Creator:    John Cox (10-16-2026)
+    -------------------------------------------------------------------------------------------*/
+    struct LinearBuildRange
+    {
+        int _nodeIndex;
+        unsigned int _begin;
+        unsigned int _end;
+    };
 
     enum FIRST_FOUR_NODE_INDEXES
     {
@@ -52,11 +143,53 @@ private:
 
     int _completedNodePopulations;
 
+    // for the linear build; members so that they keep their memory from frame to frame
+    std::vector<unsigned int> _mortonKeys;
+    std::vector<unsigned int> _mortonKeysScratch;
+    std::vector<int> _sortedParticleIndices;
+    std::vector<int> _sortedParticleIndicesScratch;
+    std::vector<LinearBuildRange> _linearBuildQueue;
+
+    // structure of arrays copies of the particles' positions for QuadrantClassification.h
+    std::vector<float> _positionsX;
+    std::vector<float> _positionsY;
+    std::vector<float> _positionsXScratch;
+    std::vector<float> _positionsYScratch;
+    std::vector<unsigned char> _quadrants;
+
+    // for UpdateTree(...)
+    // Note: Only valid after a full build by UpdateTree(...), and only until the next 
+    // ResetTree() or AddParticlestoTree(...).
+    bool _canUpdateIncrementally;
+    int _numParticlesInTree;
+    std::vector<int> _parentNodeIndex;
+    std::vector<int> _subtreeParticleCount;
+    std::vector<int> _leafOfParticle;
+    std::vector<int> _freeChildBlocks;
+    std::vector<int> _migratingParticles;
+    std::vector<int> _migrantPreviousLeaves;
+    std::vector<int> _mergeCandidates;
+
+    // 1 (the default) is the single-threaded linear build, and then there is no pool
+    unsigned int _numBuildThreads;
+    WorkStealingTaskPool *_pBuildTaskPool;
+    std::vector<BuildTask> _buildTasks;
+    unsigned int _numBuildTasks;
+    std::vector<int> _splitScratch;
+
+    // nodes at indices below this were made before the tasks were handed out and are shared
+    int _numTopNodes;
+
+    // enforces MAX_NODES across all the tasks' slabs
+    std::atomic<int> _numReservedNodes;
+
 
     int _numActiveNodes;
     ParticleQuadTreeNode _allNodes[MAX_NODES];
     glm::vec4 _particleRegionCenter;
     float _particleRegionRadius;
 
-    Particle _localParticleArray[Particle::MAX_PARTICLES];
+    // sized on construction so that the headless CPU simulation can run more than 
+    // Particle::MAX_PARTICLES without the GPU's buffer limit getting in the way
+    std::vector<Particle> _localParticleArray;
 };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <cstring>   // for memset(...)
 
 /*-----------------------------------------------------------------------------------------------
 Description:
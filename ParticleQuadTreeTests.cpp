@@ -0,0 +1,332 @@
+// particle_quad_tree_tests: ParticleQuadTree's three builds (the single-threaded linear build,
+// the parallel build, and the incremental UpdateTree(...)) must put every particle in the
+// same leaf, and every particle's leaf index must be the leaf that it is actually in.  Every
+// quadrant classification path that the CPU can run must agree with the scalar path.
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "ParticleQuadTree.h"
+#include "QuadrantClassification.h"
+#include "TestChecks.h"
+#include "TestParticles.h"
+
+// a leaf's edges (left, right, bottom, top) -> the particles in it, sorted
+// Note: The builds number the nodes differently, so leaves are matched up by their edges.
+typedef std::map<std::vector<float>, std::vector<int> > LeafMembership;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Self-explanatory.  The same rule as ParticleQuadTree's NodeContains(...).
+Parameters:
+    node        Self-explanatory
+    position    Self-explanatory
+Returns:
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static bool NodeContains(const ParticleQuadTreeNode &node, const glm::vec4 &position)
+{
+    return position.x >= node._leftEdge && position.x < node._rightEdge &&
+        position.y > node._bottomEdge && position.y <= node._topEdge;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Checks the tree against the particles that it was built from: every particle in a leaf is
+    inside it and is active, no particle is in two leaves, and CopyParticleLeafIndices(...)
+    gives each particle the leaf that it is in, or NO_LEAF if it isn't in one.
+Parameters:
+    tree        Self-explanatory
+    particles   What the tree was last built from.
+    buildName   For the failure messages.
+Returns:
+    The leaves and their particles.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static LeafMembership CheckLeaves(const ParticleQuadTree &tree,
+    const std::vector<Particle> &particles, const char *buildName)
+{
+    LeafMembership leaves;
+    int numParticles = (int)particles.size();
+    std::vector<unsigned int> leafOfParticle(numParticles, ParticleQuadTree::NO_LEAF);
+    const ParticleQuadTreeNode *allNodes = tree.QuadTreeBuffer();
+    for (unsigned int nodeIndex = 0; nodeIndex < tree.NumActiveNodes(); nodeIndex++)
+    {
+        const ParticleQuadTreeNode &node = allNodes[nodeIndex];
+        if (node._inUse == 0 || node._isSubdivided != 0)
+        {
+            continue;
+        }
+
+        std::vector<float> edges =
+        {
+            node._leftEdge, node._rightEdge, node._bottomEdge, node._topEdge
+        };
+        std::vector<int> &members = leaves[edges];
+        for (unsigned int particleCount = 0; particleCount < node._numCurrentParticles; particleCount++)
+        {
+            int particleIndex = node._indicesForContainedParticles[particleCount];
+            const Particle &p = particles[particleIndex];
+            TEST_CHECK(p._isActive != 0, "%s: particle %d", buildName, particleIndex);
+            TEST_CHECK(NodeContains(node, p._position),
+                "%s: particle %d at (%.9g, %.9g) is in node %u, (%.9g, %.9g) to (%.9g, %.9g)",
+                buildName, particleIndex, p._position.x, p._position.y, nodeIndex,
+                node._leftEdge, node._bottomEdge, node._rightEdge, node._topEdge);
+            TEST_CHECK(leafOfParticle[particleIndex] == ParticleQuadTree::NO_LEAF,
+                "%s: particle %d is in nodes %u and %u", buildName, particleIndex,
+                leafOfParticle[particleIndex], nodeIndex);
+            leafOfParticle[particleIndex] = nodeIndex;
+            members.push_back(particleIndex);
+        }
+        std::sort(members.begin(), members.end());
+    }
+
+    std::vector<unsigned int> copiedLeafIndices(numParticles);
+    tree.CopyParticleLeafIndices(copiedLeafIndices.data(), numParticles);
+    for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    {
+        TEST_CHECK(copiedLeafIndices[particleIndex] == leafOfParticle[particleIndex],
+            "%s: particle %d has leaf index %u but is in %u", buildName, particleIndex,
+            copiedLeafIndices[particleIndex], leafOfParticle[particleIndex]);
+    }
+
+    return leaves;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Counts the particles in the leaves.
+Parameters:
+    leaves  Self-explanatory
+Returns:
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static size_t NumParticlesInLeaves(const LeafMembership &leaves)
+{
+    size_t numParticles = 0;
+    for (LeafMembership::const_iterator leaf = leaves.begin(); leaf != leaves.end(); leaf++)
+    {
+        numParticles += leaf->second.size();
+    }
+    return numParticles;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Builds the tree with the linear build, the parallel build, and incrementally, and checks
+    that each particle ends up in the same leaf.  The incremental tree is first built from
+    the particles squeezed a little towards the middle, so that the update has to move some
+    of them and merge and subdivide some leaves.
+Parameters:
+    distribution    Self-explanatory
+    numParticles    Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void TestBuildsAgree(TEST_DISTRIBUTION distribution, int numParticles)
+{
+    std::vector<Particle> particles = MakeParticles(distribution, numParticles);
+    const char *distributionName = gDistributionNames[distribution];
+
+    // the node array is far too big for the stack
+    ParticleQuadTree *pTree = new ParticleQuadTree(gParticleRegionCenter,
+        gParticleRegionRadius, numParticles);
+    pTree->AddParticlestoTree(particles.data(), numParticles);
+    LeafMembership linearLeaves = CheckLeaves(*pTree, particles, "linear");
+    delete pTree;
+
+    pTree = new ParticleQuadTree(gParticleRegionCenter, gParticleRegionRadius, numParticles);
+    pTree->SetNumBuildThreads(4);
+    pTree->AddParticlestoTree(particles.data(), numParticles);
+    LeafMembership parallelLeaves = CheckLeaves(*pTree, particles, "parallel");
+    delete pTree;
+
+    std::vector<Particle> squeezedParticles = particles;
+    for (size_t particleIndex = 0; particleIndex < squeezedParticles.size(); particleIndex++)
+    {
+        squeezedParticles[particleIndex]._position.x *= 0.999f;
+    }
+    pTree = new ParticleQuadTree(gParticleRegionCenter, gParticleRegionRadius, numParticles);
+    pTree->UpdateTree(squeezedParticles.data(), numParticles);
+    pTree->UpdateTree(particles.data(), numParticles);
+    LeafMembership incrementalLeaves = CheckLeaves(*pTree, particles, "incremental");
+    delete pTree;
+
+    // all of the active particles fit, so none are left out
+    size_t numActiveParticles = numParticles - ((numParticles + 6) / 7);
+    TEST_CHECK(NumParticlesInLeaves(linearLeaves) == numActiveParticles,
+        "%s, %d particles: %zu of %zu active particles are in the tree", distributionName,
+        numParticles, NumParticlesInLeaves(linearLeaves), numActiveParticles);
+    TEST_CHECK(linearLeaves == parallelLeaves, "%s, %d particles", distributionName,
+        numParticles);
+    TEST_CHECK(linearLeaves == incrementalLeaves, "%s, %d particles", distributionName,
+        numParticles);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Particles on top of each other can't be split up, so all but MAX_PARTICLES_PER_NODE of
+    them are left out of the tree.  Whichever ones are left out must get NO_LEAF, even though
+    they were in the tree the frame before.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void TestLeftOutParticlesGetNoLeaf()
+{
+    const int numParticles = 2000;
+    const int numStacked = 40;
+    const char *buildNames[3] = { "linear", "parallel", "incremental" };
+    for (int buildType = 0; buildType < 3; buildType++)
+    {
+        std::vector<Particle> particles = MakeParticles(TEST_DISTRIBUTION_UNIFORM, numParticles);
+        ParticleQuadTree *pTree = new ParticleQuadTree(gParticleRegionCenter,
+            gParticleRegionRadius, numParticles);
+        pTree->SetNumBuildThreads((buildType == 1) ? 4 : 1);
+
+        // the second frame stacks some of the particles that were in the tree on the first
+        for (int frame = 0; frame < 2; frame++)
+        {
+            if (frame == 1)
+            {
+                for (int particleIndex = 0; particleIndex < numStacked; particleIndex++)
+                {
+                    particles[particleIndex]._position = glm::vec4(0.3f, 0.3f, 0.0f, 1.0f);
+                    particles[particleIndex]._isActive = 1;
+                }
+            }
+
+            if (buildType == 2)
+            {
+                pTree->UpdateTree(particles.data(), numParticles);
+            }
+            else
+            {
+                pTree->ResetTree();
+                pTree->AddParticlestoTree(particles.data(), numParticles);
+            }
+        }
+
+        CheckLeaves(*pTree, particles, buildNames[buildType]);
+        std::vector<unsigned int> leafIndices(numParticles);
+        pTree->CopyParticleLeafIndices(leafIndices.data(), numParticles);
+        int numLeftOut = 0;
+        for (int particleIndex = 0; particleIndex < numStacked; particleIndex++)
+        {
+            numLeftOut += (leafIndices[particleIndex] == ParticleQuadTree::NO_LEAF) ? 1 : 0;
+        }
+        int expectedNumLeftOut = numStacked - (int)ParticleQuadTreeNode::MAX_PARTICLES_PER_NODE;
+        TEST_CHECK(numLeftOut == expectedNumLeftOut, "%s: %d left out instead of %d",
+            buildNames[buildType], numLeftOut, expectedNumLeftOut);
+        delete pTree;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Forces each of the CPU's quadrant classification paths in turn and checks that
+    ClassifyQuadrants(...) and ComputeMortonKeys(...) give the same answers as the scalar
+    path.  Some positions are put exactly on the center lines (both signs of 0 at the region's
+    center) to check the ties, and some outside the region to check the Morton keys' clamp.
+    The count isn't a multiple of 8 or 4, so the vector paths' leftovers are checked too.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void TestClassificationPathsMatchScalar()
+{
+    const unsigned int numPositions = 1003;
+
+    // the region's center (with both signs of 0), the center of a first-level node, and
+    // centers on the grid lines distribution's lines
+    const float centers[][2] =
+    {
+        { 0.0f, 0.0f }, { -0.0f, -0.0f }, { 0.4f, -0.4f }, { 0.25f, -0.125f },
+        { 0.0f, 0.25f + (1.0f / 64.0f) }
+    };
+    const float regionLeft = gParticleRegionCenter.x - gParticleRegionRadius;
+    const float regionTop = gParticleRegionCenter.y + gParticleRegionRadius;
+    const float cellsPerWorldUnit = 65536.0f / (2.0f * gParticleRegionRadius);
+
+    QUADRANT_CLASSIFICATION_PATH bestPath = BestQuadrantClassificationPath();
+    for (int distribution = 0; distribution < TEST_DISTRIBUTION_COUNT; distribution++)
+    {
+        std::vector<Particle> particles = MakeParticles((TEST_DISTRIBUTION)distribution,
+            numPositions);
+        for (size_t centerIndex = 0; centerIndex < sizeof(centers) / sizeof(centers[0]); centerIndex++)
+        {
+            float centerX = centers[centerIndex][0];
+            float centerY = centers[centerIndex][1];
+            std::vector<float> positionsX(numPositions);
+            std::vector<float> positionsY(numPositions);
+            for (unsigned int positionIndex = 0; positionIndex < numPositions; positionIndex++)
+            {
+                const glm::vec4 &position = particles[positionIndex]._position;
+                positionsX[positionIndex] = ((positionIndex % 5) == 0) ? centerX : position.x;
+                positionsY[positionIndex] = ((positionIndex % 3) == 0) ? centerY : position.y;
+                if ((positionIndex % 11) == 0)
+                {
+                    positionsX[positionIndex] *= 1.5f;
+                    positionsY[positionIndex] *= 1.5f;
+                }
+            }
+
+            SetQuadrantClassificationPath(QUADRANT_CLASSIFICATION_SCALAR);
+            std::vector<unsigned char> scalarQuadrants(numPositions);
+            std::vector<unsigned int> scalarKeys(numPositions);
+            ClassifyQuadrants(positionsX.data(), positionsY.data(), numPositions, centerX,
+                centerY, scalarQuadrants.data());
+            ComputeMortonKeys(positionsX.data(), positionsY.data(), numPositions, regionLeft,
+                regionTop, cellsPerWorldUnit, scalarKeys.data());
+
+            // the scalar rule itself: less than the center's X is left, greater than its Y
+            // is top, so ties go right and down
+            unsigned int numWrongQuadrants = 0;
+            for (unsigned int positionIndex = 0; positionIndex < numPositions; positionIndex++)
+            {
+                unsigned int isRight = (positionsX[positionIndex] < centerX) ? 0 : 1;
+                unsigned int isBottom = (positionsY[positionIndex] > centerY) ? 0 : 1;
+                numWrongQuadrants += (scalarQuadrants[positionIndex] != (isBottom * 2) + isRight) ? 1 : 0;
+            }
+            TEST_CHECK(numWrongQuadrants == 0, "%s, center (%g, %g): %u wrong quadrants",
+                gDistributionNames[distribution], centerX, centerY, numWrongQuadrants);
+
+            for (int path = QUADRANT_CLASSIFICATION_SSE2; path <= bestPath; path++)
+            {
+                const char *pathName = QuadrantClassificationPathName((QUADRANT_CLASSIFICATION_PATH)path);
+                SetQuadrantClassificationPath((QUADRANT_CLASSIFICATION_PATH)path);
+                std::vector<unsigned char> quadrants(numPositions);
+                std::vector<unsigned int> keys(numPositions);
+                ClassifyQuadrants(positionsX.data(), positionsY.data(), numPositions, centerX,
+                    centerY, quadrants.data());
+                ComputeMortonKeys(positionsX.data(), positionsY.data(), numPositions,
+                    regionLeft, regionTop, cellsPerWorldUnit, keys.data());
+                TEST_CHECK(quadrants == scalarQuadrants, "%s, %s, center (%g, %g)", pathName,
+                    gDistributionNames[distribution], centerX, centerY);
+                TEST_CHECK(keys == scalarKeys, "%s, %s, center (%g, %g)", pathName,
+                    gDistributionNames[distribution], centerX, centerY);
+            }
+        }
+    }
+
+    // back to the automatic choice for the other tests
+    SetQuadrantClassificationPath(bestPath);
+}
+
+int main()
+{
+    TestClassificationPathsMatchScalar();
+
+    // Note: Stacked particles don't all fit, so they have their own test.
+    for (int distribution = 0; distribution < TEST_DISTRIBUTION_STACKED; distribution++)
+    {
+        TestBuildsAgree((TEST_DISTRIBUTION)distribution, 1000);
+        TestBuildsAgree((TEST_DISTRIBUTION)distribution, 20000);
+    }
+    TestLeftOutParticlesGetNoLeaf();
+
+    return TestExitCode("particle_quad_tree_tests");
+}
@@ -0,0 +1,232 @@
+#include "ParticleReadbackRing.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Creates and maps the ring's buffers.  If any of them can't be mapped, then the ring is not 
+    valid (see IsValid()) and AcquireReadback() will always return 0.
+Parameters: 
+    pBackend            The ring does not own this, and it must outlive the ring.
+    sourceBufferId      The buffer to read back (the particle SSBO).
+    readbackSizeBytes   How much of the source to read back, starting from the beginning.
+    numSlots            Clamped to at least 1.
+    framesOfLatency     How many frames old the copy from AcquireReadback() is.  Clamped to 
+                        numSlots - 1.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleReadbackRing::ParticleReadbackRing(IReadbackBackend *pBackend, 
+    unsigned int sourceBufferId, unsigned int readbackSizeBytes, unsigned int numSlots, 
+    unsigned int framesOfLatency) :
+    _pBackend(pBackend),
+    _sourceBufferId(sourceBufferId),
+    _readbackSizeBytes(readbackSizeBytes),
+    _framesOfLatency(0),
+    _isValid(true),
+    _numQueuedReadbacks(0),
+    _numStalls(0)
+{
+    if (numSlots < 1)
+    {
+        numSlots = 1;
+    }
+    _framesOfLatency = (framesOfLatency < numSlots) ? framesOfLatency : (numSlots - 1);
+
+    _slots.resize(numSlots);
+    for (unsigned int slotIndex = 0; slotIndex < _slots.size(); slotIndex++)
+    {
+        ReadbackSlot &slot = _slots[slotIndex];
+        slot._mappedPtr = 0;
+        slot._fence = 0;
+        slot._bufferId = _pBackend->CreatePersistentReadBuffer(readbackSizeBytes, &slot._mappedPtr);
+        if (slot._bufferId == 0)
+        {
+            _isValid = false;
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Cleans up the fences and buffers.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleReadbackRing::~ParticleReadbackRing()
+{
+    for (unsigned int slotIndex = 0; slotIndex < _slots.size(); slotIndex++)
+    {
+        ReadbackSlot &slot = _slots[slotIndex];
+        if (slot._fence != 0)
+        {
+            _pBackend->DeleteFence(slot._fence);
+        }
+        if (slot._bufferId != 0)
+        {
+            _pBackend->DeletePersistentReadBuffer(slot._bufferId);
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for whether all of the ring's buffers were created and mapped.
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticleReadbackRing::IsValid() const
+{
+    return _isValid;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Queues a copy of the source buffer into the next slot and puts a fence after it.  Call this 
+    once per frame after the shaders that write the source.
+
+    The last copy in the slot was either read, and then its fence is gone, or skipped.  A 
+    skipped one may not have finished yet, and a slot is never given a new copy before its 
+    fence signals, so this waits for it (and counts a stall).  If that wait times out, this 
+    frame's copy is skipped instead, and AcquireReadback() keeps giving the older one.
+
+    Note: The pointer from the last AcquireReadback() stays valid until this overwrites its 
+    slot, which is (NumSlots() - FramesOfLatency()) calls later.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleReadbackRing::QueueReadback()
+{
+    if (!_isValid)
+    {
+        return;
+    }
+
+    ReadbackSlot &slot = _slots[_numQueuedReadbacks % _slots.size()];
+    if (!WaitForSlot(slot))
+    {
+        return;
+    }
+
+    _pBackend->CopyBuffer(_sourceBufferId, slot._bufferId, _readbackSizeBytes);
+    slot._fence = _pBackend->InsertFence();
+    _numQueuedReadbacks++;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gets the copy that was queued FramesOfLatency() calls to QueueReadback() ago, waiting for it 
+    if the GPU hasn't finished it.  It can be called more than once per frame.  
+    
+    Each time that it does have to wait, the stall count goes up, which is a sign that the 
+    latency is too low for how far behind the GPU is.  If there aren't enough copies yet, it 
+    returns right away without waiting on anything.
+Parameters: None
+Returns:    
+    A pointer to ReadbackSizeBytes() of the source buffer's contents, or 0 if there aren't 
+    enough copies yet, if the wait timed out, or if the ring isn't valid.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+const void *ParticleReadbackRing::AcquireReadback()
+{
+    if (!_isValid || _numQueuedReadbacks <= _framesOfLatency)
+    {
+        return 0;
+    }
+
+    unsigned long long readbackNumber = _numQueuedReadbacks - 1 - _framesOfLatency;
+    ReadbackSlot &slot = _slots[readbackNumber % _slots.size()];
+    if (!WaitForSlot(slot))
+    {
+        return 0;
+    }
+
+    return slot._mappedPtr;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Waits for the copy in the slot to finish if it hasn't, and then gets rid of its fence.  
+    The fence is checked without waiting first so that only real waits are counted as 
+    stalls.
+Parameters: 
+    slot    Self-explanatory
+Returns:    
+    False if the wait timed out (the fence is kept), otherwise true.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ParticleReadbackRing::WaitForSlot(ReadbackSlot &slot)
+{
+    if (slot._fence == 0)
+    {
+        return true;
+    }
+
+    if (!_pBackend->WaitForFence(slot._fence, 0))
+    {
+        _numStalls++;
+        if (!_pBackend->WaitForFence(slot._fence, FENCE_TIMEOUT_NANOSECONDS))
+        {
+            return false;
+        }
+    }
+
+    _pBackend->DeleteFence(slot._fence);
+    slot._fence = 0;
+    return true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of buffers in the ring.
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int ParticleReadbackRing::NumSlots() const
+{
+    return _slots.size();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for how many frames old the copy from AcquireReadback() is.
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int ParticleReadbackRing::FramesOfLatency() const
+{
+    return _framesOfLatency;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for how many bytes of the source are copied each frame.
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int ParticleReadbackRing::ReadbackSizeBytes() const
+{
+    return _readbackSizeBytes;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for how many times AcquireReadback() or QueueReadback() had to wait on the 
+    GPU.
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int ParticleReadbackRing::NumStalls() const
+{
+    return _numStalls;
+}
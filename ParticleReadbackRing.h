@@ -0,0 +1,70 @@
+#pragma once
+
+#include "IReadbackBackend.h"
+#include <vector>
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Reads the particle SSBO back to the CPU without stalling on the GPU.  Mapping the SSBO 
+    right after the update dispatch makes the CPU wait for the GPU to finish and then copy the 
+    whole thing.  Instead, every frame the GPU copies the SSBO into one of a ring of buffers 
+    that are always mapped, and a fence marks when that copy is done.  The CPU reads a copy 
+    from framesOfLatency frames ago, which is almost always finished by the time that it is 
+    needed, so the tree build for frame N can use frame N-1's particles while the GPU works on 
+    frame N.
+
+    The ring needs at least framesOfLatency + 1 slots so that the slot being read is never the 
+    one being written.  Any more slots than that give whoever reads the pointer more time to 
+    finish with it (see AcquireReadback()).
+
+    All OpenGL calls go through an IReadbackBackend so that this can be run with a fake one.
+
+    Note: framesOfLatency = 0 gives the old behavior (copy and then wait right away), only 
+    without the glMapBuffer(...).
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class ParticleReadbackRing
+{
+public:
+    ParticleReadbackRing(IReadbackBackend *pBackend, unsigned int sourceBufferId, 
+        unsigned int readbackSizeBytes, unsigned int numSlots = 3, 
+        unsigned int framesOfLatency = 1);
+    ~ParticleReadbackRing();
+
+    bool IsValid() const;
+    void QueueReadback();
+    const void *AcquireReadback();
+
+    unsigned int NumSlots() const;
+    unsigned int FramesOfLatency() const;
+    unsigned int ReadbackSizeBytes() const;
+    unsigned int NumStalls() const;
+
+    // how long AcquireReadback() and QueueReadback() will wait before giving up (1 second)
+    static const unsigned long long FENCE_TIMEOUT_NANOSECONDS = 1000000000;
+
+private:
+    // the buffers belong to the backend's context and must only be deleted once
+    ParticleReadbackRing(const ParticleReadbackRing &) = delete;
+    ParticleReadbackRing &operator=(const ParticleReadbackRing &) = delete;
+
+    struct ReadbackSlot
+    {
+        unsigned int _bufferId;
+        const void *_mappedPtr;
+
+        // 0 once the copy is known to be finished
+        void *_fence;
+    };
+
+    bool WaitForSlot(ReadbackSlot &slot);
+
+    IReadbackBackend *_pBackend;
+    unsigned int _sourceBufferId;
+    unsigned int _readbackSizeBytes;
+    unsigned int _framesOfLatency;
+    bool _isValid;
+    unsigned long long _numQueuedReadbacks;
+    unsigned int _numStalls;
+    std::vector<ReadbackSlot> _slots;
+};
@@ -0,0 +1,422 @@
+// particle_readback_ring_tests: ParticleReadbackRing's bookkeeping, run against a fake
+// backend that decides when each fence is signaled.  Checks that the copies come out
+// FramesOfLatency() frames late, that nothing waits when there is nothing to wait for, and that
+// a slot is never given a new copy while its last one is still in flight.
+
+#include <cstring>
+#include <map>
+#include <vector>
+
+#include "IReadbackBackend.h"
+#include "ParticleReadbackRing.h"
+#include "TestChecks.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    An IReadbackBackend that runs on system memory.  Like the GPU, it does the copies and
+    signals the fences in the order that they were queued, but only when the test says so
+    (see CompleteCommands(...)), so the test plays the part of a GPU that is as far behind as
+    it wants.
+
+    It also keeps track of how it was used: how many times a fence was checked without
+    waiting and how many times it was waited on, and whether a copy was ever queued into a
+    buffer that already had one in flight.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class FakeReadbackBackend : public IReadbackBackend
+{
+public:
+    FakeReadbackBackend(unsigned int sourceSizeBytes) :
+        _nextBufferId(2),
+        _signalOnTimedWait(false),
+        _failBufferCreation(false),
+        _numPolls(0),
+        _numTimedWaits(0),
+        _numCopiesIntoBusyBuffers(0),
+        _numBadFenceUses(0),
+        _numCompletedCommands(0)
+    {
+        _buffers[SOURCE_BUFFER_ID].resize(sourceSizeBytes);
+    }
+
+    virtual ~FakeReadbackBackend()
+    {
+        for (size_t commandIndex = 0; commandIndex < _commands.size(); commandIndex++)
+        {
+            delete _commands[commandIndex]._pFence;
+        }
+    }
+
+    virtual unsigned int CreatePersistentReadBuffer(unsigned int sizeBytes, const void **mappedPtr)
+    {
+        if (_failBufferCreation)
+        {
+            return 0;
+        }
+
+        unsigned int bufferId = _nextBufferId++;
+        _buffers[bufferId].resize(sizeBytes);
+        *mappedPtr = _buffers[bufferId].data();
+        return bufferId;
+    }
+
+    virtual void DeletePersistentReadBuffer(unsigned int bufferId)
+    {
+        _buffers.erase(bufferId);
+    }
+
+    virtual void CopyBuffer(unsigned int sourceBufferId, unsigned int destinationBufferId,
+        unsigned int sizeBytes)
+    {
+        for (size_t commandIndex = _numCompletedCommands; commandIndex < _commands.size(); commandIndex++)
+        {
+            if (_commands[commandIndex]._destinationBufferId == destinationBufferId)
+            {
+                _numCopiesIntoBusyBuffers++;
+            }
+        }
+
+        // the source is read when the command is queued; the tests don't change the source
+        // until after it is, so it is the same as reading it when the copy runs
+        Command command;
+        command._destinationBufferId = destinationBufferId;
+        command._contents.assign(_buffers[sourceBufferId].begin(),
+            _buffers[sourceBufferId].begin() + sizeBytes);
+        command._pFence = 0;
+        _commands.push_back(command);
+    }
+
+    virtual void *InsertFence()
+    {
+        Command command;
+        command._destinationBufferId = 0;
+        command._pFence = new Fence();
+        command._pFence->_isSignaled = false;
+        command._pFence->_isDeleted = false;
+        _commands.push_back(command);
+        return command._pFence;
+    }
+
+    virtual bool WaitForFence(void *fence, unsigned long long timeoutNanoseconds)
+    {
+        Fence *pFence = static_cast<Fence *>(fence);
+        if (pFence->_isDeleted)
+        {
+            _numBadFenceUses++;
+            return false;
+        }
+
+        if (timeoutNanoseconds == 0)
+        {
+            _numPolls++;
+        }
+        else
+        {
+            _numTimedWaits++;
+            if (!pFence->_isSignaled && _signalOnTimedWait)
+            {
+                CompleteCommands(_commands.size());
+            }
+        }
+
+        return pFence->_isSignaled;
+    }
+
+    virtual void DeleteFence(void *fence)
+    {
+        Fence *pFence = static_cast<Fence *>(fence);
+        if (pFence->_isDeleted)
+        {
+            _numBadFenceUses++;
+        }
+        pFence->_isDeleted = true;
+    }
+
+    /*-------------------------------------------------------------------------------------------
+    Description:
+        Plays the GPU: runs the queued commands, in order, until numCommands have run in
+        total.  Copies are done and fences are signaled.
+    Parameters:
+        numCommands     How many commands, since the backend was made, should have run.
+    Returns:    None
+    Creator:    John Cox (10-17-2026)
+    -------------------------------------------------------------------------------------------*/
+    void CompleteCommands(size_t numCommands)
+    {
+        for (size_t commandIndex = _numCompletedCommands; commandIndex < numCommands && commandIndex < _commands.size(); commandIndex++)
+        {
+            Command &command = _commands[commandIndex];
+            if (command._pFence != 0)
+            {
+                command._pFence->_isSignaled = true;
+            }
+            else
+            {
+                std::vector<unsigned char> &destination = _buffers[command._destinationBufferId];
+                memcpy(destination.data(), command._contents.data(), command._contents.size());
+            }
+            _numCompletedCommands++;
+        }
+    }
+
+    // every queued command
+    void CompleteAllCommands()
+    {
+        CompleteCommands(_commands.size());
+    }
+
+    // the tests write a frame number into the source
+    void SetSourceFrame(unsigned int frameNumber)
+    {
+        memcpy(_buffers[SOURCE_BUFFER_ID].data(), &frameNumber, sizeof(frameNumber));
+    }
+
+    static const unsigned int SOURCE_BUFFER_ID = 1;
+
+    unsigned int _nextBufferId;
+    bool _signalOnTimedWait;
+    bool _failBufferCreation;
+    unsigned int _numPolls;
+    unsigned int _numTimedWaits;
+    unsigned int _numCopiesIntoBusyBuffers;
+    unsigned int _numBadFenceUses;
+
+private:
+    struct Fence
+    {
+        bool _isSignaled;
+        bool _isDeleted;
+    };
+
+    // either a copy (the fence is 0) or a fence
+    struct Command
+    {
+        unsigned int _destinationBufferId;
+        std::vector<unsigned char> _contents;
+        Fence *_pFence;
+    };
+
+    std::map<unsigned int, std::vector<unsigned char> > _buffers;
+    std::vector<Command> _commands;
+    size_t _numCompletedCommands;
+};
+
+const unsigned int FakeReadbackBackend::SOURCE_BUFFER_ID;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Reads the frame number that FakeReadbackBackend::SetSourceFrame(...) wrote.
+Parameters:
+    readback    What AcquireReadback() gave.  Must not be 0.
+Returns:
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static unsigned int ReadbackFrame(const void *readback)
+{
+    unsigned int frameNumber = 0;
+    memcpy(&frameNumber, readback, sizeof(frameNumber));
+    return frameNumber;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    With a GPU that always keeps up, every frame's readback is the source from
+    framesOfLatency frames ago, and until there is one that old, there is nothing.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void TestFrameLatency()
+{
+    for (unsigned int framesOfLatency = 0; framesOfLatency < 3; framesOfLatency++)
+    {
+        FakeReadbackBackend backend(64);
+        ParticleReadbackRing ring(&backend, FakeReadbackBackend::SOURCE_BUFFER_ID, 64, 3,
+            framesOfLatency);
+        TEST_CHECK(ring.IsValid(), "latency %u", framesOfLatency);
+        TEST_CHECK(ring.FramesOfLatency() == framesOfLatency, "latency %u", framesOfLatency);
+
+        for (unsigned int frame = 0; frame < 10; frame++)
+        {
+            backend.SetSourceFrame(frame);
+            ring.QueueReadback();
+            backend.CompleteAllCommands();
+
+            const void *readback = ring.AcquireReadback();
+            if (frame < framesOfLatency)
+            {
+                TEST_CHECK(readback == 0, "latency %u, frame %u", framesOfLatency, frame);
+            }
+            else if (TEST_CHECK(readback != 0, "latency %u, frame %u", framesOfLatency, frame))
+            {
+                TEST_CHECK(ReadbackFrame(readback) == frame - framesOfLatency,
+                    "latency %u, frame %u: got frame %u", framesOfLatency, frame,
+                    ReadbackFrame(readback));
+            }
+        }
+
+        TEST_CHECK(ring.NumStalls() == 0, "latency %u: %u stalls", framesOfLatency,
+            ring.NumStalls());
+        TEST_CHECK(backend._numTimedWaits == 0, "latency %u: %u timed waits", framesOfLatency,
+            backend._numTimedWaits);
+    }
+
+    // a latency that the slots can't hold is clamped
+    FakeReadbackBackend backend(64);
+    ParticleReadbackRing ring(&backend, FakeReadbackBackend::SOURCE_BUFFER_ID, 64, 2, 5);
+    TEST_CHECK(ring.FramesOfLatency() == 1, "got %u", ring.FramesOfLatency());
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    When there isn't a copy that is old enough yet, AcquireReadback() gives 0 without
+    touching a fence.  When the copy is finished, it only checks the fence, without waiting.
+    Neither counts as a stall.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void TestNotReadyDoesNotStall()
+{
+    FakeReadbackBackend backend(64);
+    ParticleReadbackRing ring(&backend, FakeReadbackBackend::SOURCE_BUFFER_ID, 64, 3, 2);
+
+    // the GPU hasn't done anything, but the copies aren't old enough to ask about anyway
+    for (unsigned int frame = 0; frame < 2; frame++)
+    {
+        backend.SetSourceFrame(frame);
+        ring.QueueReadback();
+        TEST_CHECK(ring.AcquireReadback() == 0, "frame %u", frame);
+    }
+    TEST_CHECK(backend._numPolls == 0, "%u polls", backend._numPolls);
+    TEST_CHECK(backend._numTimedWaits == 0, "%u timed waits", backend._numTimedWaits);
+
+    // now frame 0's copy is old enough, and it is done
+    backend.SetSourceFrame(2);
+    ring.QueueReadback();
+    backend.CompleteAllCommands();
+    const void *readback = ring.AcquireReadback();
+    if (TEST_CHECK(readback != 0, "frame 2"))
+    {
+        TEST_CHECK(ReadbackFrame(readback) == 0, "got frame %u", ReadbackFrame(readback));
+    }
+    TEST_CHECK(backend._numPolls == 1, "%u polls", backend._numPolls);
+    TEST_CHECK(backend._numTimedWaits == 0, "%u timed waits", backend._numTimedWaits);
+    TEST_CHECK(ring.NumStalls() == 0, "%u stalls", ring.NumStalls());
+
+    // asking again is free because the fence is already gone
+    TEST_CHECK(ring.AcquireReadback() == readback, "second acquire");
+    TEST_CHECK(backend._numPolls == 1, "%u polls", backend._numPolls);
+
+    // a ring that couldn't make its buffers never gives anything and never waits
+    FakeReadbackBackend failingBackend(64);
+    failingBackend._failBufferCreation = true;
+    ParticleReadbackRing invalidRing(&failingBackend, FakeReadbackBackend::SOURCE_BUFFER_ID,
+        64, 3, 0);
+    TEST_CHECK(!invalidRing.IsValid(), "invalid ring");
+    invalidRing.QueueReadback();
+    TEST_CHECK(invalidRing.AcquireReadback() == 0, "invalid ring");
+    TEST_CHECK(failingBackend._numPolls == 0 && failingBackend._numTimedWaits == 0,
+        "invalid ring: %u polls, %u timed waits", failingBackend._numPolls,
+        failingBackend._numTimedWaits);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    When the GPU is behind, AcquireReadback() waits, counts a stall, and gives 0 if the wait
+    times out.  The fence is kept, so once the GPU catches up the copy is given as usual.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void TestGpuBehind()
+{
+    FakeReadbackBackend backend(64);
+    ParticleReadbackRing ring(&backend, FakeReadbackBackend::SOURCE_BUFFER_ID, 64, 3, 1);
+    for (unsigned int frame = 0; frame < 2; frame++)
+    {
+        backend.SetSourceFrame(frame);
+        ring.QueueReadback();
+    }
+
+    TEST_CHECK(ring.AcquireReadback() == 0, "timed out");
+    TEST_CHECK(ring.NumStalls() == 1, "%u stalls", ring.NumStalls());
+    TEST_CHECK(backend._numTimedWaits == 1, "%u timed waits", backend._numTimedWaits);
+
+    // the GPU finishes while the ring waits
+    backend._signalOnTimedWait = true;
+    const void *readback = ring.AcquireReadback();
+    if (TEST_CHECK(readback != 0, "after the GPU caught up"))
+    {
+        TEST_CHECK(ReadbackFrame(readback) == 0, "got frame %u", ReadbackFrame(readback));
+    }
+    TEST_CHECK(ring.NumStalls() == 2, "%u stalls", ring.NumStalls());
+    TEST_CHECK(backend._numBadFenceUses == 0, "%u bad fence uses", backend._numBadFenceUses);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Frames whose copies are never read (the caller skipped AcquireReadback()) leave their
+    fences behind.  When the ring comes back around to one of those slots before the GPU is
+    done with it, QueueReadback() must wait for the fence rather than queue a second copy into
+    the same buffer, and if the wait times out, it must skip the copy.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void TestSlotNotReusedBeforeFence()
+{
+    FakeReadbackBackend backend(64);
+    ParticleReadbackRing ring(&backend, FakeReadbackBackend::SOURCE_BUFFER_ID, 64, 2, 1);
+
+    // fill both slots without the GPU doing anything
+    for (unsigned int frame = 0; frame < 2; frame++)
+    {
+        backend.SetSourceFrame(frame);
+        ring.QueueReadback();
+    }
+
+    // slot 0 again; its copy is still in flight and the wait times out, so nothing is queued
+    backend.SetSourceFrame(2);
+    ring.QueueReadback();
+    TEST_CHECK(backend._numCopiesIntoBusyBuffers == 0, "%u copies into busy buffers",
+        backend._numCopiesIntoBusyBuffers);
+    TEST_CHECK(ring.NumStalls() == 1, "%u stalls", ring.NumStalls());
+
+    // the skipped copy leaves frame 0 as the one that is a frame old
+    backend.CompleteAllCommands();
+    const void *readback = ring.AcquireReadback();
+    if (TEST_CHECK(readback != 0, "after the skipped copy"))
+    {
+        TEST_CHECK(ReadbackFrame(readback) == 0, "got frame %u", ReadbackFrame(readback));
+    }
+
+    // now the GPU finishes whenever the ring waits on it, and the frames are never read
+    backend._signalOnTimedWait = true;
+    for (unsigned int frame = 3; frame < 10; frame++)
+    {
+        backend.SetSourceFrame(frame);
+        ring.QueueReadback();
+    }
+    TEST_CHECK(backend._numCopiesIntoBusyBuffers == 0, "%u copies into busy buffers",
+        backend._numCopiesIntoBusyBuffers);
+    TEST_CHECK(backend._numBadFenceUses == 0, "%u bad fence uses", backend._numBadFenceUses);
+
+    backend.CompleteAllCommands();
+    readback = ring.AcquireReadback();
+    if (TEST_CHECK(readback != 0, "frame 9"))
+    {
+        TEST_CHECK(ReadbackFrame(readback) == 8, "got frame %u", ReadbackFrame(readback));
+    }
+}
+
+int main()
+{
+    TestFrameLatency();
+    TestNotReadyDoesNotStall();
+    TestGpuBehind();
+    TestSlotNotReusedBeforeFence();
+
+    return TestExitCode("particle_readback_ring_tests");
+}
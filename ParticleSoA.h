@@ -0,0 +1,122 @@
+#pragma once
+
+#include <vector>
+#include "glm/vec2.hpp"
+#include "Particle.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The same particles as a std::vector<Particle>, but stored as one array per member (a
+    "structure of arrays") instead of one array of structures.  This is a 2D demo, so the
+    positions, velocities, and forces are glm::vec2s, and the "is active" flag and the
+    collision count are packed into one unsigned int.  That is 36 bytes per particle instead of
+    Particle's 64.
+
+    The bigger win is that each array can be read on its own.  The quad tree only needs the
+    positions and the "is active" flag, which is 12 bytes per particle, so ParticleSsbo puts
+    those two arrays at the front of the buffer where they can be mapped without the rest.
+
+    Note: The GPU side of this layout is in the *SoA.comp and ParticleRenderSoA.vert shaders.
+    If the packing of the state flags changes here, it must change there too.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+struct ParticleSoA
+{
+    /*-------------------------------------------------------------------------------------------
+    Description:
+        Gives every particle the same starting values as Particle's constructor.
+    Parameters:
+        numParticles    Self-explanatory.
+    Returns:    None
+    Creator: John Cox, 10-17-2026
+    -------------------------------------------------------------------------------------------*/
+    ParticleSoA(unsigned int numParticles) :
+        _positions(numParticles),
+        _stateFlags(numParticles),
+        _velocities(numParticles),
+        _netForcesThisFrame(numParticles),
+        _masses(numParticles),
+        _radiiOfInfluence(numParticles)
+    {
+        Particle defaultParticle;
+        for (unsigned int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+        {
+            SetParticle(particleIndex, defaultParticle);
+        }
+    }
+
+    /*-------------------------------------------------------------------------------------------
+    Description:
+        Copies one Particle into the arrays.  The Z and W values and the node index are
+        dropped.
+    Parameters:
+        particleIndex   Self-explanatory.
+        p               Self-explanatory.
+    Returns:    None
+    Creator: John Cox, 10-17-2026
+    -------------------------------------------------------------------------------------------*/
+    void SetParticle(unsigned int particleIndex, const Particle &p)
+    {
+        _positions[particleIndex] = glm::vec2(p._position.x, p._position.y);
+        _stateFlags[particleIndex] = PackStateFlags(p._isActive != 0, p._collisionCountThisFrame);
+        _velocities[particleIndex] = glm::vec2(p._velocity.x, p._velocity.y);
+        _netForcesThisFrame[particleIndex] = glm::vec2(p._netForceThisFrame.x, p._netForceThisFrame.y);
+        _masses[particleIndex] = p._mass;
+        _radiiOfInfluence[particleIndex] = p._radiusOfInfluence;
+    }
+
+    /*-------------------------------------------------------------------------------------------
+    Description:
+        The opposite of SetParticle(...).
+    Parameters:
+        particleIndex   Self-explanatory.
+    Returns:
+        A Particle with Z = 0 and W = 1 on the position and Z = W = 0 on the vectors.
+    Creator: John Cox, 10-17-2026
+    -------------------------------------------------------------------------------------------*/
+    Particle GetParticle(unsigned int particleIndex) const
+    {
+        Particle p;
+        p._position = glm::vec4(_positions[particleIndex], 0.0f, 1.0f);
+        p._velocity = glm::vec4(_velocities[particleIndex], 0.0f, 0.0f);
+        p._netForceThisFrame = glm::vec4(_netForcesThisFrame[particleIndex], 0.0f, 0.0f);
+        p._collisionCountThisFrame = CollisionCount(_stateFlags[particleIndex]);
+        p._mass = _masses[particleIndex];
+        p._radiusOfInfluence = _radiiOfInfluence[particleIndex];
+        p._isActive = IsActive(_stateFlags[particleIndex]) ? 1 : 0;
+        return p;
+    }
+
+    /*-------------------------------------------------------------------------------------------
+    Description:
+        Packing and unpacking for the state flags.  Bit 0 is "is active", and the rest of the
+        bits are the collision count.
+    Creator: John Cox, 10-17-2026
+    -------------------------------------------------------------------------------------------*/
+    static unsigned int PackStateFlags(bool isActive, int collisionCount)
+    {
+        return (isActive ? STATE_FLAG_IS_ACTIVE : 0) |
+            ((unsigned int)collisionCount << STATE_FLAG_COLLISION_COUNT_SHIFT);
+    }
+
+    static bool IsActive(unsigned int stateFlags)
+    {
+        return (stateFlags & STATE_FLAG_IS_ACTIVE) != 0;
+    }
+
+    static int CollisionCount(unsigned int stateFlags)
+    {
+        return (int)(stateFlags >> STATE_FLAG_COLLISION_COUNT_SHIFT);
+    }
+
+    static const unsigned int STATE_FLAG_IS_ACTIVE = 0x1;
+    static const unsigned int STATE_FLAG_COLLISION_COUNT_SHIFT = 1;
+
+    // in the order that ParticleSsbo lays them out in the buffer
+    std::vector<glm::vec2> _positions;
+    std::vector<unsigned int> _stateFlags;
+    std::vector<glm::vec2> _velocities;
+    std::vector<glm::vec2> _netForcesThisFrame;
+    std::vector<float> _masses;
+    std::vector<float> _radiiOfInfluence;
+};
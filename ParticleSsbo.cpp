@@ -22,8 +22,16 @@ Returns:    None
 Creator: John Cox, 9-6-2016
 -----------------------------------------------------------------------------------------------*/
 ParticleSsbo::ParticleSsbo(const std::vector<Particle> &allParticles) :
-    SsboBase()  // generate buffers
+    SsboBase(),  // generate buffers
+    _isStructureOfArrays(false)
 {
+    for (int section = 0; section < NUM_SOA_SECTIONS; section++)
+    {
+        _sectionOffsetBytes[section] = 0;
+        _sectionSizeBytes[section] = 0;
+        _sectionBindingPointIndices[section] = 0;
+    }
+
     _numVertices = allParticles.size();
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
     GLuint bufferSizeBytes = sizeof(Particle) * allParticles.size();
@@ -35,6 +43,77 @@ ParticleSsbo::ParticleSsbo(const std::vector<Particle> &allParticles) :
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 }
 
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Like the other constructor, but lays the particles out as one array per member (see 
+    ParticleSoA).  The arrays go one after another in the same buffer in SOA_SECTION order.  
+    Each array starts on a multiple of GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT so that it can 
+    be bound to its own storage block with glBindBufferRange(...).
+
+    The first array (positions) uses the binding point from SsboBase and the rest get their 
+    own.
+Parameters: 
+    allParticles    Every array must have the same number of particles.
+Returns:    None
+Creator: John Cox, 10-17-2026
+-----------------------------------------------------------------------------------------------*/
+ParticleSsbo::ParticleSsbo(const ParticleSoA &allParticles) :
+    SsboBase(),  // generate buffers
+    _isStructureOfArrays(true)
+{
+    unsigned int numParticles = allParticles._positions.size();
+    _numVertices = numParticles;
+
+    const void *sectionData[NUM_SOA_SECTIONS] = {};
+    sectionData[SOA_SECTION_POSITIONS] = allParticles._positions.data();
+    sectionData[SOA_SECTION_STATE_FLAGS] = allParticles._stateFlags.data();
+    sectionData[SOA_SECTION_VELOCITIES] = allParticles._velocities.data();
+    sectionData[SOA_SECTION_NET_FORCES] = allParticles._netForcesThisFrame.data();
+    sectionData[SOA_SECTION_MASSES] = allParticles._masses.data();
+    sectionData[SOA_SECTION_RADII] = allParticles._radiiOfInfluence.data();
+
+    _sectionSizeBytes[SOA_SECTION_POSITIONS] = sizeof(glm::vec2) * numParticles;
+    _sectionSizeBytes[SOA_SECTION_STATE_FLAGS] = sizeof(unsigned int) * numParticles;
+    _sectionSizeBytes[SOA_SECTION_VELOCITIES] = sizeof(glm::vec2) * numParticles;
+    _sectionSizeBytes[SOA_SECTION_NET_FORCES] = sizeof(glm::vec2) * numParticles;
+    _sectionSizeBytes[SOA_SECTION_MASSES] = sizeof(float) * numParticles;
+    _sectionSizeBytes[SOA_SECTION_RADII] = sizeof(float) * numParticles;
+
+    // Note: The alignment is usually somewhere between 16 and 256 bytes, so the padding 
+    // between arrays is small.
+    GLint offsetAlignment = 0;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+    if (offsetAlignment < 1)
+    {
+        offsetAlignment = 1;
+    }
+
+    GLuint bufferSizeBytes = 0;
+    for (int section = 0; section < NUM_SOA_SECTIONS; section++)
+    {
+        bufferSizeBytes = ((bufferSizeBytes + offsetAlignment - 1) / offsetAlignment) * offsetAlignment;
+        _sectionOffsetBytes[section] = bufferSizeBytes;
+        bufferSizeBytes += _sectionSizeBytes[section];
+
+        _sectionBindingPointIndices[section] = (section == SOA_SECTION_POSITIONS) ? 
+            _ssboBindingPointIndex : NewStorageBlockBindingPointIndex();
+    }
+
+    // allocate the whole thing, and then fill in each array
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSizeBytes, 0, GL_STATIC_DRAW);
+    for (int section = 0; section < NUM_SOA_SECTIONS; section++)
+    {
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, _sectionOffsetBytes[section], 
+            _sectionSizeBytes[section], sectionData[section]);
+    }
+
+    _bufferSizeBytes = bufferSizeBytes;
+
+    // cleanup
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
 /*-----------------------------------------------------------------------------------------------
 Description:
     Binds the SSBO object (a CPU-side thing) to its corresponding buffer in the shader (GPU).
@@ -45,6 +124,12 @@ Creator: John Cox, 11-24-2016
 -----------------------------------------------------------------------------------------------*/
 void ParticleSsbo::ConfigureCompute(unsigned int computeProgramId, const std::string &bufferNameInShader)
 {
+    if (_isStructureOfArrays)
+    {
+        ConfigureComputeStructureOfArrays(computeProgramId, bufferNameInShader);
+        return;
+    }
+
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
 
     // binding requires some setup
@@ -104,6 +189,17 @@ void ParticleSsbo::ConfigureRender(unsigned int renderProgramId, unsigned int dr
     glBindBuffer(GL_ARRAY_BUFFER, _bufferId);
     // do NOT call glBufferData(...) because it was called earlier for the shader storage buffer
 
+    if (_isStructureOfArrays)
+    {
+        ConfigureRenderStructureOfArrays();
+
+        // cleanup
+        glBindVertexArray(0);   // unbind this BEFORE the array
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glUseProgram(0);    // render program
+        return;
+    }
+
     // vertex attribute order is same as the structure
     // - glm::vec4 _position;
     // - glm::vec4 _velocity;
@@ -202,3 +298,150 @@ void ParticleSsbo::ConfigureRender(unsigned int renderProgramId, unsigned int dr
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glUseProgram(0);    // render program
 }
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for whether this buffer was made from a ParticleSoA.
+Parameters: None
+Returns:    
+    See description.
+Creator: John Cox, 10-17-2026
+-----------------------------------------------------------------------------------------------*/
+bool ParticleSsbo::IsStructureOfArrays() const
+{
+    return _isStructureOfArrays;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Where one of the structure of arrays layout's arrays starts in the buffer.  Always 0 for 
+    the array of structures layout.
+Parameters: 
+    section     Self-explanatory.
+Returns:    
+    See description.
+Creator: John Cox, 10-17-2026
+-----------------------------------------------------------------------------------------------*/
+unsigned int ParticleSsbo::SectionOffsetBytes(SOA_SECTION section) const
+{
+    return _sectionOffsetBytes[section];
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The quad tree only needs the particles' positions and "is active" flags.  In the structure 
+    of arrays layout, those are the first two arrays, so mapping this many bytes from the start 
+    of the buffer gets them without the rest.  In the array of structures layout, everything 
+    is interleaved, so this is the whole buffer.
+Parameters: None
+Returns:    
+    See description.
+Creator: John Cox, 10-17-2026
+-----------------------------------------------------------------------------------------------*/
+unsigned int ParticleSsbo::TreeInputSizeBytes() const
+{
+    if (!_isStructureOfArrays)
+    {
+        return _bufferSizeBytes;
+    }
+
+    return _sectionOffsetBytes[SOA_SECTION_STATE_FLAGS] + _sectionSizeBytes[SOA_SECTION_STATE_FLAGS];
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The structure of arrays version of ConfigureCompute(...).  Each array has its own storage 
+    block in the shader, and they are named after bufferNameInShader plus a suffix (for 
+    example, "ParticleBufferPositions"; see the *SoA.comp shaders).  Storage blocks that the 
+    shader does not declare (or that the compiler optimized away) are skipped, so a shader only 
+    needs to declare the arrays that it uses.
+Parameters: 
+    computeProgramId    Self-explanatory
+    bufferNameInShader  The prefix of the storage block names.
+Returns:    None
+Creator: John Cox, 10-17-2026
+-----------------------------------------------------------------------------------------------*/
+void ParticleSsbo::ConfigureComputeStructureOfArrays(unsigned int computeProgramId, 
+    const std::string &bufferNameInShader)
+{
+    static const char *sectionSuffixes[NUM_SOA_SECTIONS] =
+    {
+        "Positions",
+        "StateFlags",
+        "Velocities",
+        "NetForces",
+        "Masses",
+        "Radii"
+    };
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+
+    for (int section = 0; section < NUM_SOA_SECTIONS; section++)
+    {
+        std::string blockName = bufferNameInShader + sectionSuffixes[section];
+        GLuint storageBlockIndex = glGetProgramResourceIndex(computeProgramId, GL_SHADER_STORAGE_BLOCK, blockName.c_str());
+        if (storageBlockIndex == GL_INVALID_INDEX)
+        {
+            continue;
+        }
+
+        // same idea as the array of structures version, but only this array's part of the 
+        // buffer is bound
+        glShaderStorageBlockBinding(computeProgramId, storageBlockIndex, _sectionBindingPointIndices[section]);
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, _sectionBindingPointIndices[section], 
+            _bufferId, _sectionOffsetBytes[section], _sectionSizeBytes[section]);
+    }
+
+    // cleanup
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The structure of arrays version of ConfigureRender(...)'s vertex attributes.  The arrays 
+    are tightly packed, so each attribute's stride is the size of its own type and its offset 
+    is where its array starts.  The VAO and the array buffer must already be bound.
+
+    Attribute order is the same as SOA_SECTION (see ParticleRenderSoA.vert).
+Parameters: None
+Returns:    None
+Creator: John Cox, 10-17-2026
+-----------------------------------------------------------------------------------------------*/
+void ParticleSsbo::ConfigureRenderStructureOfArrays()
+{
+    // position
+    unsigned int vertexArrayIndex = SOA_SECTION_POSITIONS;
+    glEnableVertexAttribArray(vertexArrayIndex);
+    glVertexAttribPointer(vertexArrayIndex, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2),
+        (GLvoid *)(size_t)_sectionOffsetBytes[SOA_SECTION_POSITIONS]);
+
+    // state flags ("is active" and collision count)
+    vertexArrayIndex = SOA_SECTION_STATE_FLAGS;
+    glEnableVertexAttribArray(vertexArrayIndex);
+    glVertexAttribIPointer(vertexArrayIndex, 1, GL_UNSIGNED_INT, sizeof(unsigned int),
+        (GLvoid *)(size_t)_sectionOffsetBytes[SOA_SECTION_STATE_FLAGS]);
+
+    // velocity
+    vertexArrayIndex = SOA_SECTION_VELOCITIES;
+    glEnableVertexAttribArray(vertexArrayIndex);
+    glVertexAttribPointer(vertexArrayIndex, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2),
+        (GLvoid *)(size_t)_sectionOffsetBytes[SOA_SECTION_VELOCITIES]);
+
+    // net force
+    vertexArrayIndex = SOA_SECTION_NET_FORCES;
+    glEnableVertexAttribArray(vertexArrayIndex);
+    glVertexAttribPointer(vertexArrayIndex, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2),
+        (GLvoid *)(size_t)_sectionOffsetBytes[SOA_SECTION_NET_FORCES]);
+
+    // mass
+    vertexArrayIndex = SOA_SECTION_MASSES;
+    glEnableVertexAttribArray(vertexArrayIndex);
+    glVertexAttribPointer(vertexArrayIndex, 1, GL_FLOAT, GL_FALSE, sizeof(float),
+        (GLvoid *)(size_t)_sectionOffsetBytes[SOA_SECTION_MASSES]);
+
+    // radius of influence
+    vertexArrayIndex = SOA_SECTION_RADII;
+    glEnableVertexAttribArray(vertexArrayIndex);
+    glVertexAttribPointer(vertexArrayIndex, 1, GL_FLOAT, GL_FALSE, sizeof(float),
+        (GLvoid *)(size_t)_sectionOffsetBytes[SOA_SECTION_RADII]);
+}
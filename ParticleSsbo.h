@@ -2,23 +2,58 @@
 
 #include "SsboBase.h"
 #include "Particle.h"
+#include "ParticleSoA.h"
 #include <vector>
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Encapsulates the SSBO that stores Particles.  It generates a chunk of space on the GPU that 
-    is big enough to store the requested number of particles, and since this buffer will be used 
-    in a drawing shader as well as a compute shader, this class will also up the VAO and the 
+    Encapsulates the SSBO that stores Particles.  It generates a chunk of space on the GPU that
+    is big enough to store the requested number of particles, and since this buffer will be used
+    in a drawing shader as well as a compute shader, this class will also up the VAO and the
     vertex attributes.
+
+    Particles can be stored either as an array of Particle structures or, when constructed from
+    a ParticleSoA, as one array per member.  In the latter case the arrays are laid out one
+    after another in the same buffer, each one is bound to its own storage block, and the
+    positions and state flags come first so that the quad tree's input can be mapped on its own
+    (see TreeInputSizeBytes()).
 Creator:    John Cox (9-3-2016)
 -----------------------------------------------------------------------------------------------*/
 class ParticleSsbo : public SsboBase
 {
 public:
     ParticleSsbo(const std::vector<Particle> &allParticles);
+    ParticleSsbo(const ParticleSoA &allParticles);
     virtual ~ParticleSsbo() override = default; // empty override of base destructor
-    
+
     void ConfigureCompute(unsigned int computeProgramId, const std::string &bufferNameInShader) override;
     void ConfigureRender(unsigned int renderProgramId, unsigned int drawStyle) override;
-};
 
+    // in the order that they are laid out in the buffer
+    enum SOA_SECTION
+    {
+        SOA_SECTION_POSITIONS = 0,
+        SOA_SECTION_STATE_FLAGS,
+        SOA_SECTION_VELOCITIES,
+        SOA_SECTION_NET_FORCES,
+        SOA_SECTION_MASSES,
+        SOA_SECTION_RADII,
+        NUM_SOA_SECTIONS
+    };
+
+    bool IsStructureOfArrays() const;
+    unsigned int SectionOffsetBytes(SOA_SECTION section) const;
+    unsigned int TreeInputSizeBytes() const;
+
+private:
+    void ConfigureComputeStructureOfArrays(unsigned int computeProgramId,
+        const std::string &bufferNameInShader);
+    void ConfigureRenderStructureOfArrays();
+
+    bool _isStructureOfArrays;
+
+    // only used by the structure of arrays layout
+    unsigned int _sectionOffsetBytes[NUM_SOA_SECTIONS];
+    unsigned int _sectionSizeBytes[NUM_SOA_SECTIONS];
+    unsigned int _sectionBindingPointIndices[NUM_SOA_SECTIONS];
+};
@@ -0,0 +1,292 @@
+#include "ParticleUniformGrid.h"
+
+#include "ParticleSoA.h"
+
+// Particle's default radius of influence is 0.005, and two of them collide when they are 
+// closer than the sum of their radii
+const float ParticleUniformGrid::DEFAULT_MIN_CELL_SIZE = 0.01f;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Works out the grid's size and allocates the cell offsets.  The grid covers the square 
+    around the particle region's circle.  The number of cells per side is rounded down so 
+    that the cells are never narrower than minCellSize.
+Parameters:
+    particleRegionCenter    In world space
+    particleRegionRadius    In world space
+    minCellSize             Must be at least the largest collision distance (the sum of the 
+                            two biggest radii of influence), or collisions will be missed.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+ParticleUniformGrid::ParticleUniformGrid(const glm::vec4 &particleRegionCenter, 
+    float particleRegionRadius, float minCellSize) :
+    _particleRegionCenter(particleRegionCenter),
+    _particleRegionRadius(particleRegionRadius),
+    _cellsPerSide(1),
+    _cellsPerWorldUnit(0.0f)
+{
+    float regionWidth = 2.0f * particleRegionRadius;
+    if (minCellSize > 0.0f && (regionWidth / minCellSize) >= 1.0f)
+    {
+        float cellsPerSide = regionWidth / minCellSize;
+        _cellsPerSide = (cellsPerSide < (float)MAX_CELLS_PER_SIDE) ? 
+            (unsigned int)cellsPerSide : MAX_CELLS_PER_SIDE;
+    }
+    _cellsPerWorldUnit = (float)_cellsPerSide / regionWidth;
+
+    // all empty until the first build
+    _cellOffsets.resize(NumCells() + 1, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Throws out the old grid and sorts the active particles into a new one.
+Parameters:
+    particleCollection  Self-explanatory
+    numParticles        Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleUniformGrid::Build(const Particle *particleCollection, int numParticles)
+{
+    _gatheredParticleIndices.clear();
+    _gatheredParticleCells.clear();
+    for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    {
+        const Particle &p = particleCollection[particleIndex];
+        if (p._isActive != 0)
+        {
+            AddActiveParticle(particleIndex, p._position.x, p._position.y);
+        }
+    }
+
+    SortGatheredParticles();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Like the other Build(...), but with the particles in ParticleSoA's layout.
+Parameters:
+    positions       Self-explanatory
+    stateFlags      Packed as in ParticleSoA::PackStateFlags(...).
+    numParticles    How many are in each array.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleUniformGrid::Build(const glm::vec2 *positions, const unsigned int *stateFlags, 
+    int numParticles)
+{
+    _gatheredParticleIndices.clear();
+    _gatheredParticleCells.clear();
+    for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    {
+        if (ParticleSoA::IsActive(stateFlags[particleIndex]))
+        {
+            AddActiveParticle(particleIndex, positions[particleIndex].x, 
+                positions[particleIndex].y);
+        }
+    }
+
+    SortGatheredParticles();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the particle index pool.  The active particles' indices, cell by 
+    cell, and in index order within each cell.
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+const int *ParticleUniformGrid::ParticleIndexPool() const
+{
+    return _particleIndexPool.data();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of particles in the pool.
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int ParticleUniformGrid::ParticleIndexPoolSize() const
+{
+    return (unsigned int)_particleIndexPool.size();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of cells.  It doesn't change after construction.
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int ParticleUniformGrid::NumCells() const
+{
+    return _cellsPerSide * _cellsPerSide;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives back the runs of the particle index pool for the 3x3 cells around the position's 
+    cell, one run per row.  The position's own row comes first.  Rows that are off the grid 
+    are left out, and so are cells off the left or right edge.
+Parameters:
+    x           In world space.
+    y           In world space.
+    runOffsets  Must have room for MAX_CANDIDATE_RUNS (only 3 are used).
+    runCounts   Same idea.
+Returns:
+    How many runs were filled in.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int ParticleUniformGrid::FindCandidateRuns(float x, float y, unsigned int *runOffsets, 
+    unsigned int *runCounts) const
+{
+    unsigned int column = 0;
+    unsigned int row = 0;
+    CellOfPosition(x, y, column, row);
+
+    unsigned int firstColumn = (column > 0) ? (column - 1) : 0;
+    unsigned int lastColumn = (column + 1 < _cellsPerSide) ? (column + 1) : column;
+
+    static const int rowOrder[3] = { 0, -1, +1 };
+    unsigned int numRuns = 0;
+    for (int rowCount = 0; rowCount < 3; rowCount++)
+    {
+        int neighborRow = (int)row + rowOrder[rowCount];
+        if (neighborRow < 0 || neighborRow >= (int)_cellsPerSide)
+        {
+            continue;
+        }
+
+        unsigned int rowStartCell = (unsigned int)neighborRow * _cellsPerSide;
+        unsigned int runBegin = _cellOffsets[rowStartCell + firstColumn];
+        unsigned int runEnd = _cellOffsets[rowStartCell + lastColumn + 1];
+        runOffsets[numRuns] = runBegin;
+        runCounts[numRuns] = runEnd - runBegin;
+        numRuns++;
+    }
+
+    return numRuns;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of cells on each side of the grid.
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int ParticleUniformGrid::CellsPerSide() const
+{
+    return _cellsPerSide;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the cell offsets.  There are NumCells() + 1 of them (see the class 
+    description).
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+const unsigned int *ParticleUniformGrid::CellOffsets() const
+{
+    return _cellOffsets.data();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Finds the cell that a position is in.  Positions outside the grid are clamped to the 
+    nearest edge cell.  ParticleCollisionsGrid.comp must do the same arithmetic.
+Parameters:
+    x       In world space.
+    y       In world space.
+    column  Receives the column, 0 on the left.
+    row     Receives the row, 0 on the top.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleUniformGrid::CellOfPosition(float x, float y, unsigned int &column, 
+    unsigned int &row) const
+{
+    float regionLeft = _particleRegionCenter.x - _particleRegionRadius;
+    float regionTop = _particleRegionCenter.y + _particleRegionRadius;
+    float maxCell = (float)(_cellsPerSide - 1);
+
+    float columnFloat = (x - regionLeft) * _cellsPerWorldUnit;
+    float rowFloat = (regionTop - y) * _cellsPerWorldUnit;
+    columnFloat = (columnFloat < 0.0f) ? 0.0f : ((columnFloat > maxCell) ? maxCell : columnFloat);
+    rowFloat = (rowFloat < 0.0f) ? 0.0f : ((rowFloat > maxCell) ? maxCell : rowFloat);
+    column = (unsigned int)columnFloat;
+    row = (unsigned int)rowFloat;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Remembers an active particle and its cell for SortGatheredParticles().
+Parameters:
+    particleIndex   Self-explanatory
+    x               The particle's position.
+    y               Same idea.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleUniformGrid::AddActiveParticle(int particleIndex, float x, float y)
+{
+    unsigned int column = 0;
+    unsigned int row = 0;
+    CellOfPosition(x, y, column, row);
+    _gatheredParticleIndices.push_back(particleIndex);
+    _gatheredParticleCells.push_back((row * _cellsPerSide) + column);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The counting sort (see the class description).  The particles are gathered in index 
+    order and the scatter goes in the same order, so each cell's particles stay in index 
+    order.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ParticleUniformGrid::SortGatheredParticles()
+{
+    unsigned int numCells = NumCells();
+    unsigned int numGathered = (unsigned int)_gatheredParticleIndices.size();
+
+    // counts go one entry up so that the prefix sum leaves each cell's start in its own entry
+    _cellOffsets.assign(numCells + 1, 0);
+    for (unsigned int gatheredIndex = 0; gatheredIndex < numGathered; gatheredIndex++)
+    {
+        _cellOffsets[_gatheredParticleCells[gatheredIndex] + 1]++;
+    }
+
+    for (unsigned int cellIndex = 0; cellIndex < numCells; cellIndex++)
+    {
+        _cellOffsets[cellIndex + 1] += _cellOffsets[cellIndex];
+    }
+
+    // scatter, using each cell's offset as its cursor
+    _particleIndexPool.resize(numGathered);
+    for (unsigned int gatheredIndex = 0; gatheredIndex < numGathered; gatheredIndex++)
+    {
+        unsigned int cellIndex = _gatheredParticleCells[gatheredIndex];
+        _particleIndexPool[_cellOffsets[cellIndex]++] = _gatheredParticleIndices[gatheredIndex];
+    }
+
+    // the scatter moved every offset up to the next cell's, so shift them back down
+    for (unsigned int cellIndex = numCells; cellIndex > 0; cellIndex--)
+    {
+        _cellOffsets[cellIndex] = _cellOffsets[cellIndex - 1];
+    }
+    _cellOffsets[0] = 0;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+#include "glm/vec2.hpp"
+#include "glm/vec4.hpp"
+
+#include "ISpatialIndex.h"
+#include "Particle.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A uniform grid over the same particle region as ParticleQuadTree.  Every cell is at least 
+    as wide as the largest collision distance, so a particle can only collide with particles 
+    in its own cell and the 8 cells around it.  There is no recursion, no neighbor 
+    bookkeeping, and no limit on how many particles a cell can have.
+
+    The grid is built with a counting sort.
+    (1) Count the active particles in each cell.
+    (2) Prefix sum the counts into each cell's offset into the particle index pool.
+    (3) Put each particle's index at its cell's next spot in the pool.
+    Afterwards, cell c's particles are the pool from CellOffsets()[c] to CellOffsets()[c + 1].  
+    Cells are numbered row by row, starting at the top left, so the 3 cells in one row of a 
+    particle's neighborhood are one run of the pool.
+
+    ParticleCollisionsGrid.comp does the same lookups in GLSL.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class ParticleUniformGrid : public ISpatialIndex
+{
+public:
+    ParticleUniformGrid(const glm::vec4 &particleRegionCenter, float particleRegionRadius, 
+        float minCellSize = DEFAULT_MIN_CELL_SIZE);
+
+    void Build(const Particle *particleCollection, int numParticles) override;
+    void Build(const glm::vec2 *positions, const unsigned int *stateFlags, 
+        int numParticles) override;
+
+    const int *ParticleIndexPool() const override;
+    unsigned int ParticleIndexPoolSize() const override;
+    unsigned int NumCells() const override;
+    unsigned int FindCandidateRuns(float x, float y, unsigned int *runOffsets, 
+        unsigned int *runCounts) const override;
+
+    unsigned int CellsPerSide() const;
+    const unsigned int *CellOffsets() const;
+    void CellOfPosition(float x, float y, unsigned int &column, unsigned int &row) const;
+
+    // two particles with the default radius of influence collide within this distance
+    static const float DEFAULT_MIN_CELL_SIZE;
+
+    // a cap on the cell count so that a tiny cell size can't allocate without limit
+    static const unsigned int MAX_CELLS_PER_SIDE = 1024;
+
+private:
+    void AddActiveParticle(int particleIndex, float x, float y);
+    void SortGatheredParticles();
+
+    glm::vec4 _particleRegionCenter;
+    float _particleRegionRadius;
+    unsigned int _cellsPerSide;
+    float _cellsPerWorldUnit;
+
+    // NumCells() + 1 entries, so that the last cell's end is there too
+    std::vector<unsigned int> _cellOffsets;
+
+    // members so that they keep their memory from frame to frame
+    std::vector<int> _gatheredParticleIndices;
+    std::vector<unsigned int> _gatheredParticleCells;
+    std::vector<int> _particleIndexPool;
+};
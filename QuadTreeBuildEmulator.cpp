@@ -0,0 +1,573 @@
+#include "QuadTreeBuildEmulator.h"
+
+#include "CompactParticleQuadTree.h"
+#include "ParticleSoA.h"
+#include "MortonOrder.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Spreads the low 16 bits of a value out to the even bits.  Same as SpreadBits16(...) in
+    QuadTreeBuildParticles.comp.
+Parameters:
+    value   Self-explanatory
+Returns:
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static unsigned int SpreadBits16(unsigned int value)
+{
+    value &= 0x0000ffff;
+    value = (value | (value << 8)) & 0x00ff00ff;
+    value = (value | (value << 4)) & 0x0f0f0f0f;
+    value = (value | (value << 2)) & 0x33333333;
+    value = (value | (value << 1)) & 0x55555555;
+    return value;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Allocates the storage blocks at the same sizes as QuadTreeBuildSsbo does.
+Parameters:
+    maxParticles            The most particles that Build(...) will be given.
+    particleRegionCenter    In world space
+    particleRegionRadius    In world space
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+QuadTreeBuildEmulator::QuadTreeBuildEmulator(unsigned int maxParticles,
+    const glm::vec4 &particleRegionCenter, float particleRegionRadius) :
+    _maxParticles(maxParticles),
+    _numParticles(0),
+    _maxParticlesPerLeaf(1),
+    _regionLeft(particleRegionCenter.x - particleRegionRadius),
+    _regionTop(particleRegionCenter.y + particleRegionRadius),
+    _cellsPerWorldUnit(65536.0f / (2.0f * particleRegionRadius)),
+    _pPositions(0),
+    _pStateFlags(0)
+{
+    _keys[0].resize(maxParticles);
+    _keys[1].resize(maxParticles);
+    _values[0].resize(maxParticles);
+    _values[1].resize(maxParticles);
+
+    _blockSums.resize(MaxBlockSums(maxParticles));
+    _nodes.resize(CompactParticleQuadTree::MAX_NODES);
+
+    _state._numActiveParticles = 0;
+    _state._scanTotal = 0;
+    _state._levelBegin = 0;
+    _state._levelEnd = 0;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs every step of the build, in the same order and with the same number of work groups
+    as ComputeControllerQuadTreeBuild::BuildTree().  Like the GPU, it doesn't know how many
+    particles are active or how deep the tree goes until it is done, so every radix sort pass
+    runs over every particle's work group and every depth is visited.
+Parameters:
+    positions           Self-explanatory
+    stateFlags          Packed as in ParticleSoA::PackStateFlags(...).
+    numParticles        Clamped to the maxParticles that was given to the constructor.
+    maxParticlesPerLeaf See CompactParticleQuadTree::SetMaxParticlesPerLeaf(...).
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void QuadTreeBuildEmulator::Build(const glm::vec2 *positions, const unsigned int *stateFlags,
+    unsigned int numParticles, unsigned int maxParticlesPerLeaf)
+{
+    _pPositions = positions;
+    _pStateFlags = stateFlags;
+    _numParticles = (numParticles < _maxParticles) ? numParticles : _maxParticles;
+    _maxParticlesPerLeaf = (maxParticlesPerLeaf > 0) ? maxParticlesPerLeaf : 1;
+
+    // (1) compact the active particles
+    unsigned int particleWorkGroups = NumWorkGroups(_maxParticles);
+    for (unsigned int workGroupIndex = 0; workGroupIndex < particleWorkGroups; workGroupIndex++)
+    {
+        ParticlesCountActiveKernel(workGroupIndex);
+    }
+    ScanKernel(particleWorkGroups);
+    for (unsigned int workGroupIndex = 0; workGroupIndex < particleWorkGroups; workGroupIndex++)
+    {
+        ParticlesWriteKeysKernel(workGroupIndex);
+    }
+
+    // (2) sort them
+    for (unsigned int pass = 0; pass < RADIX_PASSES; pass++)
+    {
+        unsigned int keyShift = pass * RADIX_BITS;
+        unsigned int inputIndex = pass % 2;
+        for (unsigned int workGroupIndex = 0; workGroupIndex < particleWorkGroups; workGroupIndex++)
+        {
+            RadixSortCountKernel(workGroupIndex, keyShift, inputIndex);
+        }
+        ScanKernel(RADIX_BUCKETS * particleWorkGroups);
+        for (unsigned int workGroupIndex = 0; workGroupIndex < particleWorkGroups; workGroupIndex++)
+        {
+            RadixSortScatterKernel(workGroupIndex, keyShift, inputIndex);
+        }
+    }
+
+    // (3) emit the nodes; nodes at the deepest level are never split, so that level only
+    // needs to be set up
+    for (unsigned int depth = 0; depth <= CompactParticleQuadTree::MAX_NODE_DEPTH; depth++)
+    {
+        NodesSetupLevelKernel(depth);
+        if (depth == CompactParticleQuadTree::MAX_NODE_DEPTH)
+        {
+            break;
+        }
+
+        unsigned int nodeWorkGroups = NumNodeWorkGroupsAtDepth(depth);
+        for (unsigned int workGroupIndex = 0; workGroupIndex < nodeWorkGroups; workGroupIndex++)
+        {
+            NodesCountSplitsKernel(workGroupIndex);
+        }
+        ScanKernel(nodeWorkGroups);
+        for (unsigned int workGroupIndex = 0; workGroupIndex < nodeWorkGroups; workGroupIndex++)
+        {
+            NodesEmitChildrenKernel(workGroupIndex);
+        }
+    }
+
+    _pPositions = 0;
+    _pStateFlags = 0;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the nodes.  The first NumNodes() are the tree.
+Parameters: None
+Returns:
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+const CompactQuadTreeNode *QuadTreeBuildEmulator::Nodes() const
+{
+    return _nodes.data();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The last depth that was set up ends where the tree ends.  0 before the first build.
+Parameters: None
+Returns:
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int QuadTreeBuildEmulator::NumNodes() const
+{
+    return _state._levelEnd;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the sorted particle indices.  The first ParticleIndexPoolSize() are
+    the pool.
+Parameters: None
+Returns:
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+const unsigned int *QuadTreeBuildEmulator::ParticleIndexPool() const
+{
+    return _values[0].data();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of active particles in the last build.
+Parameters: None
+Returns:
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int QuadTreeBuildEmulator::ParticleIndexPoolSize() const
+{
+    return _state._numActiveParticles;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    How many work groups it takes to give every item its own invocation.
+Parameters:
+    numItems    Self-explanatory
+Returns:
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int QuadTreeBuildEmulator::NumWorkGroups(unsigned int numItems)
+{
+    return (numItems + WORK_GROUP_SIZE - 1) / WORK_GROUP_SIZE;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The most block sums that any step writes: 16 per particle work group for the radix sort, 
+    or one per node work group for the deepest levels, whichever is more.  Both the emulator 
+    and QuadTreeBuildSsbo are this big.
+Parameters:
+    maxParticles    Self-explanatory
+Returns:
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int QuadTreeBuildEmulator::MaxBlockSums(unsigned int maxParticles)
+{
+    unsigned int radixSums = RADIX_BUCKETS * NumWorkGroups(maxParticles);
+    unsigned int nodeSums = NumWorkGroups(CompactParticleQuadTree::MAX_NODES);
+    return (radixSums > nodeSums) ? radixSums : nodeSums;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    How many work groups the node steps are dispatched with at the given depth.  A depth can
+    have at most 4^depth nodes, and never more than the whole node buffer.
+Parameters:
+    depth   Self-explanatory
+Returns:
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int QuadTreeBuildEmulator::NumNodeWorkGroupsAtDepth(unsigned int depth)
+{
+    unsigned int maxNodesAtDepth = CompactParticleQuadTree::MAX_NODES;
+    if ((2 * depth) < 32 && (1u << (2 * depth)) < maxNodesAtDepth)
+    {
+        maxNodesAtDepth = 1u << (2 * depth);
+    }
+
+    return NumWorkGroups(maxNodesAtDepth);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    PARTICLES_STEP_COUNT_ACTIVE.  Counts the work group's active particles into its block sum.
+Parameters:
+    workGroupIndex  Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void QuadTreeBuildEmulator::ParticlesCountActiveKernel(unsigned int workGroupIndex)
+{
+    unsigned int sActiveCount = 0;
+    for (unsigned int localIndex = 0; localIndex < WORK_GROUP_SIZE; localIndex++)
+    {
+        unsigned int particleIndex = (workGroupIndex * WORK_GROUP_SIZE) + localIndex;
+        if (particleIndex < _numParticles && ParticleSoA::IsActive(_pStateFlags[particleIndex]))
+        {
+            sActiveCount++;
+        }
+    }
+
+    // barrier, and then invocation 0 writes it out
+    _blockSums[workGroupIndex] = sActiveCount;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    PARTICLES_STEP_WRITE_KEYS.  The block sums have been scanned, so each work group knows
+    where its first active particle goes.  Each active particle goes after the active
+    particles before it in the work group, so the particles stay in index order.
+Parameters:
+    workGroupIndex  Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void QuadTreeBuildEmulator::ParticlesWriteKeysKernel(unsigned int workGroupIndex)
+{
+    if (workGroupIndex == 0)
+    {
+        // invocation 0 of work group 0; nothing else in this step reads it
+        _state._numActiveParticles = _state._scanTotal;
+    }
+
+    // the shader counts the active flags before it in shared memory; a running count gives
+    // the same answer
+    unsigned int activeBefore = 0;
+    for (unsigned int localIndex = 0; localIndex < WORK_GROUP_SIZE; localIndex++)
+    {
+        unsigned int particleIndex = (workGroupIndex * WORK_GROUP_SIZE) + localIndex;
+        if (particleIndex >= _numParticles || !ParticleSoA::IsActive(_pStateFlags[particleIndex]))
+        {
+            continue;
+        }
+
+        // the update shader constrains particles to the region, but a particle can still be a
+        // hair outside of it for a frame, so clamp it to the edge cells
+        glm::vec2 pos = _pPositions[particleIndex];
+        float column = (pos.x - _regionLeft) * _cellsPerWorldUnit;
+        float row = (_regionTop - pos.y) * _cellsPerWorldUnit;
+        column = (column < 0.0f) ? 0.0f : ((column > 65535.0f) ? 65535.0f : column);
+        row = (row < 0.0f) ? 0.0f : ((row > 65535.0f) ? 65535.0f : row);
+
+        unsigned int destination = _blockSums[workGroupIndex] + activeBefore;
+        _keys[0][destination] = SpreadBits16((unsigned int)column) |
+            (SpreadBits16((unsigned int)row) << 1);
+        _values[0][destination] = particleIndex;
+        activeBefore++;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The whole scan shader, which is always one work group.  Turns the first numSums block sums
+    into exclusive prefix sums in place, and puts their total in the build state.
+    (1) Each invocation adds up its own chunk of the sums.
+    (2) Invocation 0 scans the chunk totals.
+    (3) Each invocation scans its own chunk, starting from its chunk's scanned total.
+Parameters:
+    numSums     Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void QuadTreeBuildEmulator::ScanKernel(unsigned int numSums)
+{
+    unsigned int chunkSize = (numSums + WORK_GROUP_SIZE - 1) / WORK_GROUP_SIZE;
+    unsigned int sChunkSums[WORK_GROUP_SIZE];
+    for (unsigned int localIndex = 0; localIndex < WORK_GROUP_SIZE; localIndex++)
+    {
+        unsigned int chunkBegin = localIndex * chunkSize;
+        unsigned int chunkEnd = (chunkBegin + chunkSize < numSums) ? (chunkBegin + chunkSize) : numSums;
+        unsigned int chunkSum = 0;
+        for (unsigned int sumIndex = chunkBegin; sumIndex < chunkEnd; sumIndex++)
+        {
+            chunkSum += _blockSums[sumIndex];
+        }
+        sChunkSums[localIndex] = chunkSum;
+    }
+
+    unsigned int runningTotal = 0;
+    for (unsigned int localIndex = 0; localIndex < WORK_GROUP_SIZE; localIndex++)
+    {
+        unsigned int chunkSum = sChunkSums[localIndex];
+        sChunkSums[localIndex] = runningTotal;
+        runningTotal += chunkSum;
+    }
+    _state._scanTotal = runningTotal;
+
+    for (unsigned int localIndex = 0; localIndex < WORK_GROUP_SIZE; localIndex++)
+    {
+        unsigned int chunkBegin = localIndex * chunkSize;
+        unsigned int chunkEnd = (chunkBegin + chunkSize < numSums) ? (chunkBegin + chunkSize) : numSums;
+        unsigned int chunkTotal = sChunkSums[localIndex];
+        for (unsigned int sumIndex = chunkBegin; sumIndex < chunkEnd; sumIndex++)
+        {
+            unsigned int sum = _blockSums[sumIndex];
+            _blockSums[sumIndex] = chunkTotal;
+            chunkTotal += sum;
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    RADIX_SORT_STEP_COUNT.  Counts how many of the work group's keys have each digit.  The
+    counts are stored digit by digit (all work groups' counts for digit 0, then for digit 1,
+    and so on) so that the scan gives each (digit, work group) its place in the output.
+Parameters:
+    workGroupIndex  Self-explanatory
+    keyShift        Where the digit is in the key.
+    inputIndex      Which of the two key arrays is being sorted.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void QuadTreeBuildEmulator::RadixSortCountKernel(unsigned int workGroupIndex,
+    unsigned int keyShift, unsigned int inputIndex)
+{
+    unsigned int sDigitCounts[RADIX_BUCKETS] = { 0 };
+    for (unsigned int localIndex = 0; localIndex < WORK_GROUP_SIZE; localIndex++)
+    {
+        unsigned int keyIndex = (workGroupIndex * WORK_GROUP_SIZE) + localIndex;
+        if (keyIndex < _state._numActiveParticles)
+        {
+            sDigitCounts[(_keys[inputIndex][keyIndex] >> keyShift) & (RADIX_BUCKETS - 1)]++;
+        }
+    }
+
+    unsigned int numWorkGroups = NumWorkGroups(_maxParticles);
+    for (unsigned int digit = 0; digit < RADIX_BUCKETS; digit++)
+    {
+        _blockSums[(digit * numWorkGroups) + workGroupIndex] = sDigitCounts[digit];
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    RADIX_SORT_STEP_SCATTER.  Moves each key (and its value) to the other array, after every
+    key with a smaller digit and after the keys with the same digit that came before it.
+Parameters:
+    workGroupIndex  Self-explanatory
+    keyShift        Where the digit is in the key.
+    inputIndex      Which of the two key arrays is being sorted.  The output is the other one.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void QuadTreeBuildEmulator::RadixSortScatterKernel(unsigned int workGroupIndex,
+    unsigned int keyShift, unsigned int inputIndex)
+{
+    unsigned int outputIndex = 1 - inputIndex;
+    unsigned int numWorkGroups = NumWorkGroups(_maxParticles);
+
+    // same as the counts before each key's position in shared memory in the shader
+    unsigned int sameDigitBefore[RADIX_BUCKETS] = { 0 };
+    for (unsigned int localIndex = 0; localIndex < WORK_GROUP_SIZE; localIndex++)
+    {
+        unsigned int keyIndex = (workGroupIndex * WORK_GROUP_SIZE) + localIndex;
+        if (keyIndex >= _state._numActiveParticles)
+        {
+            continue;
+        }
+
+        unsigned int key = _keys[inputIndex][keyIndex];
+        unsigned int digit = (key >> keyShift) & (RADIX_BUCKETS - 1);
+        unsigned int destination = _blockSums[(digit * numWorkGroups) + workGroupIndex] +
+            sameDigitBefore[digit];
+        sameDigitBefore[digit]++;
+
+        _keys[outputIndex][destination] = key;
+        _values[outputIndex][destination] = _values[inputIndex][keyIndex];
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    NODES_STEP_SETUP_LEVEL.  One invocation.  At depth 0, writes the root, which has every
+    active particle.  After that, the nodes at this depth are the ones that the last depth's
+    splits emitted, which the last scan counted.  Splits past the end of the node buffer
+    weren't made (see NodesEmitChildrenKernel(...)).
+Parameters:
+    depth   Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void QuadTreeBuildEmulator::NodesSetupLevelKernel(unsigned int depth)
+{
+    if (depth == 0)
+    {
+        CompactQuadTreeNode root = {};
+        root._firstChildIndex = CompactQuadTreeNode::INVALID_INDEX;
+        root._parentIndex = CompactQuadTreeNode::INVALID_INDEX;
+        root._particleCount = _state._numActiveParticles;
+        _nodes[0] = root;
+
+        _state._levelBegin = 0;
+        _state._levelEnd = 1;
+        return;
+    }
+
+    unsigned int maxSplits = (CompactParticleQuadTree::MAX_NODES - _state._levelEnd) / 4;
+    unsigned int numSplits = (_state._scanTotal < maxSplits) ? _state._scanTotal : maxSplits;
+    _state._levelBegin = _state._levelEnd;
+    _state._levelEnd += 4 * numSplits;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The same "should this node be split?" as CompactParticleQuadTree's build, minus the check
+    for room, which needs the node's place among the splits.
+Parameters:
+    nodeIndex   Self-explanatory
+Returns:
+    True if the node is at the current depth and would be split if there is room.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+bool QuadTreeBuildEmulator::NodeWantsToSplit(unsigned int nodeIndex) const
+{
+    if (nodeIndex < _state._levelBegin || nodeIndex >= _state._levelEnd)
+    {
+        return false;
+    }
+
+    const CompactQuadTreeNode &node = _nodes[nodeIndex];
+    return node._particleCount > _maxParticlesPerLeaf &&
+        node.Depth() < CompactParticleQuadTree::MAX_NODE_DEPTH;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    NODES_STEP_COUNT_SPLITS.  Counts the work group's nodes that want to split into its block
+    sum.
+Parameters:
+    workGroupIndex  Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void QuadTreeBuildEmulator::NodesCountSplitsKernel(unsigned int workGroupIndex)
+{
+    unsigned int sSplitCount = 0;
+    for (unsigned int localIndex = 0; localIndex < WORK_GROUP_SIZE; localIndex++)
+    {
+        unsigned int nodeIndex = _state._levelBegin + (workGroupIndex * WORK_GROUP_SIZE) + localIndex;
+        if (NodeWantsToSplit(nodeIndex))
+        {
+            sSplitCount++;
+        }
+    }
+
+    _blockSums[workGroupIndex] = sSplitCount;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    NODES_STEP_EMIT_CHILDREN.  The k'th split at this depth (counting in node order) gets the
+    4 nodes after the 4 * k that the splits before it got, so the children are in the same
+    place that CompactParticleQuadTree's breadth-first build puts them.  If they wouldn't fit,
+    the node stays a leaf, as it does there.
+Parameters:
+    workGroupIndex  Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void QuadTreeBuildEmulator::NodesEmitChildrenKernel(unsigned int workGroupIndex)
+{
+    const unsigned int *keys = _keys[0].data();
+    unsigned int splitsBefore = 0;
+    for (unsigned int localIndex = 0; localIndex < WORK_GROUP_SIZE; localIndex++)
+    {
+        unsigned int nodeIndex = _state._levelBegin + (workGroupIndex * WORK_GROUP_SIZE) + localIndex;
+        if (!NodeWantsToSplit(nodeIndex))
+        {
+            continue;
+        }
+
+        unsigned int splitIndex = _blockSums[workGroupIndex] + splitsBefore;
+        splitsBefore++;
+        unsigned int firstChildIndex = _state._levelEnd + (4 * splitIndex);
+        if (firstChildIndex + 4 > CompactParticleQuadTree::MAX_NODES)
+        {
+            continue;
+        }
+
+        CompactQuadTreeNode &parent = _nodes[nodeIndex];
+        unsigned int depth = parent.Depth();
+        parent._firstChildIndex = firstChildIndex;
+        parent._depthAndFlags |= CompactQuadTreeNode::FLAG_IS_SUBDIVIDED;
+
+        // the children's 2 bits of the key; the root's children use the top 2
+        int childKeyShift = 30 - (2 * (int)depth);
+        unsigned int rangeEnd = parent._particleOffset + parent._particleCount;
+        unsigned int quadrantBegin = parent._particleOffset;
+        for (unsigned int quadrant = 0; quadrant < 4; quadrant++)
+        {
+            unsigned int quadrantEnd = (quadrant == 3) ? rangeEnd :
+                FirstMortonKeyInQuadrant(keys, quadrantBegin, rangeEnd, childKeyShift,
+                quadrant + 1);
+
+            // quadrant bit 0 is "right" and bit 1 is "bottom"
+            CompactQuadTreeNode child = {};
+            child._firstChildIndex = CompactQuadTreeNode::INVALID_INDEX;
+            child._parentIndex = nodeIndex;
+            child._depthAndFlags = depth + 1;
+            child._cell = CompactQuadTreeNode::PackCell(
+                (CompactQuadTreeNode::CellColumn(parent._cell) * 2) + (quadrant & 1),
+                (CompactQuadTreeNode::CellRow(parent._cell) * 2) + (quadrant >> 1));
+            child._particleOffset = quadrantBegin;
+            child._particleCount = quadrantEnd - quadrantBegin;
+            _nodes[firstChildIndex + quadrant] = child;
+
+            quadrantBegin = quadrantEnd;
+        }
+    }
+}
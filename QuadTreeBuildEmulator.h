@@ -0,0 +1,142 @@
+#pragma once
+
+#include <vector>
+#include "glm/vec2.hpp"
+#include "glm/vec4.hpp"
+
+#include "CompactQuadTreeNode.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The build's bookkeeping, which stays on the GPU so that no step has to wait for the CPU to
+    read a count back.  Must match the QuadTreeBuildBufferState block in the QuadTreeBuild*.comp
+    shaders.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+struct QuadTreeBuildState
+{
+    // the particle index pool's size
+    unsigned int _numActiveParticles;
+
+    // the sum of everything that the last scan went over
+    unsigned int _scanTotal;
+
+    // the nodes at the depth that is being split
+    unsigned int _levelBegin;
+    unsigned int _levelEnd;
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Builds a CompactParticleQuadTree's nodes and particle index pool on the CPU with the same
+    steps, in the same order, and with the same work groups as the QuadTreeBuild*.comp
+    shaders that ComputeControllerQuadTreeBuild dispatches.  Each "kernel" function here is
+    one work group of one shader step, with the work group's shared memory as local arrays and
+    a loop over the work group's invocations between each barrier.  The member vectors are
+    the shaders' storage blocks.
+
+    This is how the GPU build is checked without a GPU: the result must be exactly the same
+    nodes and the same pool as CompactParticleQuadTree's own build (see
+    CompactParticleQuadTree::SetEmulateGpuBuild(...)).  If a shader changes, the kernel here
+    must change with it.
+
+    The steps:
+    (1) Compact the active particles into the front of the key and value arrays, in index
+    order, with a Morton key each.  Each work group counts its active particles, a scan of
+    the counts says where each work group's particles go, and then each work group writes
+    them there.
+    (2) Radix sort the keys, and the particle indices with them, 4 bits at a time, starting
+    with the lowest.  Each pass is the same count-scan-scatter as (1), but with 16 counts per
+    work group, and each pass is stable, so the order is the same as RadixSortMortonKeys(...).
+    The sorted particle indices are the pool.
+    (3) Emit the nodes one depth at a time.  Each node at the current depth that has too many
+    particles is flagged, a scan of the flags gives each one the index of its four children,
+    and then the children's runs of the pool are found with a binary search on their 2 bits of
+    the key, as in CompactParticleQuadTree's build.  The number of nodes at the next depth
+    comes from the scan's total.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class QuadTreeBuildEmulator
+{
+public:
+    QuadTreeBuildEmulator(unsigned int maxParticles, const glm::vec4 &particleRegionCenter,
+        float particleRegionRadius);
+
+    void Build(const glm::vec2 *positions, const unsigned int *stateFlags,
+        unsigned int numParticles, unsigned int maxParticlesPerLeaf);
+
+    const CompactQuadTreeNode *Nodes() const;
+    unsigned int NumNodes() const;
+    const unsigned int *ParticleIndexPool() const;
+    unsigned int ParticleIndexPoolSize() const;
+
+    // same as the shaders' local_size_x
+    static const unsigned int WORK_GROUP_SIZE = 256;
+
+    // 4 bits of the key per radix sort pass, so 8 passes for a 32 bit key
+    static const unsigned int RADIX_BITS = 4;
+    static const unsigned int RADIX_BUCKETS = 1 << RADIX_BITS;
+    static const unsigned int RADIX_PASSES = 32 / RADIX_BITS;
+
+    // what each shader's uBuildStep uniform can be
+    enum PARTICLES_STEP
+    {
+        PARTICLES_STEP_COUNT_ACTIVE = 0,
+        PARTICLES_STEP_WRITE_KEYS
+    };
+    enum RADIX_SORT_STEP
+    {
+        RADIX_SORT_STEP_COUNT = 0,
+        RADIX_SORT_STEP_SCATTER
+    };
+    enum NODES_STEP
+    {
+        NODES_STEP_SETUP_LEVEL = 0,
+        NODES_STEP_COUNT_SPLITS,
+        NODES_STEP_EMIT_CHILDREN
+    };
+
+    static unsigned int NumWorkGroups(unsigned int numItems);
+    static unsigned int NumNodeWorkGroupsAtDepth(unsigned int depth);
+    static unsigned int MaxBlockSums(unsigned int maxParticles);
+
+private:
+    // QuadTreeBuildParticles.comp
+    void ParticlesCountActiveKernel(unsigned int workGroupIndex);
+    void ParticlesWriteKeysKernel(unsigned int workGroupIndex);
+
+    // QuadTreeBuildScan.comp
+    void ScanKernel(unsigned int numSums);
+
+    // QuadTreeBuildRadixSort.comp
+    void RadixSortCountKernel(unsigned int workGroupIndex, unsigned int keyShift,
+        unsigned int inputIndex);
+    void RadixSortScatterKernel(unsigned int workGroupIndex, unsigned int keyShift,
+        unsigned int inputIndex);
+
+    // QuadTreeBuildNodes.comp
+    void NodesSetupLevelKernel(unsigned int depth);
+    void NodesCountSplitsKernel(unsigned int workGroupIndex);
+    void NodesEmitChildrenKernel(unsigned int workGroupIndex);
+    bool NodeWantsToSplit(unsigned int nodeIndex) const;
+
+    // uniforms
+    unsigned int _maxParticles;
+    unsigned int _numParticles;
+    unsigned int _maxParticlesPerLeaf;
+    float _regionLeft;
+    float _regionTop;
+    float _cellsPerWorldUnit;
+
+    // the particles, as the particles step sees them
+    const glm::vec2 *_pPositions;
+    const unsigned int *_pStateFlags;
+
+    // storage blocks; the radix sort goes back and forth between the two key (and value)
+    // arrays and finishes in [0]
+    std::vector<unsigned int> _keys[2];
+    std::vector<unsigned int> _values[2];
+    std::vector<unsigned int> _blockSums;
+    std::vector<CompactQuadTreeNode> _nodes;
+    QuadTreeBuildState _state;
+};
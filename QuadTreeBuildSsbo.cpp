@@ -0,0 +1,172 @@
+#include "QuadTreeBuildSsbo.h"
+
+#include "QuadTreeBuildEmulator.h"
+#include "glload/include/glload/gl_4_4.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Calls the base class to give members initial values (zeros).
+
+    Allocates every section at its largest size.  Each section starts on a multiple of 
+    GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT so that it can be bound with 
+    glBindBufferRange(...), and each of the six storage blocks gets its own binding point.  
+    The sort starts from the key and value arrays at index 0 (see BindSortDirection(...)).
+Parameters:
+    maxParticles    The size of each key and value array.
+    maxBlockSums    See QuadTreeBuildEmulator::MaxBlockSums(...).
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+QuadTreeBuildSsbo::QuadTreeBuildSsbo(unsigned int maxParticles, unsigned int maxBlockSums) :
+    SsboBase(),  // generate buffers
+    _maxParticles(maxParticles),
+    _maxBlockSums(maxBlockSums),
+    _valuesInBindingPointIndex(0),
+    _keysOutBindingPointIndex(0),
+    _valuesOutBindingPointIndex(0),
+    _blockSumsBindingPointIndex(0),
+    _stateBindingPointIndex(0)
+{
+    // ignore _numVertices because this SSBO does not draw
+
+    GLint offsetAlignment = 0;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+    if (offsetAlignment < 1)
+    {
+        offsetAlignment = 1;
+    }
+
+    _sectionSizeBytes[SECTION_KEYS_0] = sizeof(unsigned int) * maxParticles;
+    _sectionSizeBytes[SECTION_KEYS_1] = sizeof(unsigned int) * maxParticles;
+    _sectionSizeBytes[SECTION_VALUES_0] = sizeof(unsigned int) * maxParticles;
+    _sectionSizeBytes[SECTION_VALUES_1] = sizeof(unsigned int) * maxParticles;
+    _sectionSizeBytes[SECTION_BLOCK_SUMS] = sizeof(unsigned int) * maxBlockSums;
+    _sectionSizeBytes[SECTION_STATE] = sizeof(QuadTreeBuildState);
+
+    GLuint bufferSizeBytes = 0;
+    for (unsigned int sectionIndex = 0; sectionIndex < SECTION_COUNT; sectionIndex++)
+    {
+        _sectionOffsetBytes[sectionIndex] = bufferSizeBytes;
+        GLuint sectionEnd = bufferSizeBytes + _sectionSizeBytes[sectionIndex];
+        bufferSizeBytes = ((sectionEnd + offsetAlignment - 1) / offsetAlignment) * offsetAlignment;
+    }
+
+    _valuesInBindingPointIndex = NewStorageBlockBindingPointIndex();
+    _keysOutBindingPointIndex = NewStorageBlockBindingPointIndex();
+    _valuesOutBindingPointIndex = NewStorageBlockBindingPointIndex();
+    _blockSumsBindingPointIndex = NewStorageBlockBindingPointIndex();
+    _stateBindingPointIndex = NewStorageBlockBindingPointIndex();
+
+    // Note: Only the shaders read and write it, hence "copy".  Every step writes what it 
+    // reads later in the same build, so there is nothing to fill it with.
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSizeBytes, 0, GL_DYNAMIC_COPY);
+
+    _bufferSizeBytes = bufferSizeBytes;
+
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, _blockSumsBindingPointIndex, _bufferId, 
+        _sectionOffsetBytes[SECTION_BLOCK_SUMS], _sectionSizeBytes[SECTION_BLOCK_SUMS]);
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, _stateBindingPointIndex, _bufferId, 
+        _sectionOffsetBytes[SECTION_STATE], _sectionSizeBytes[SECTION_STATE]);
+
+    // cleanup
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    BindSortDirection(0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Connects each of the shader's storage blocks to its binding point.  Blocks that the shader 
+    doesn't have (the compiler may remove unused ones) are skipped.  The sections were bound to 
+    the binding points in the constructor and BindSortDirection(...).
+
+    Note: It is ok to call this function for multiple compute shaders so that the same SSBO 
+    can be used in each shader.  No member variables are altered in this function.
+Parameters:
+    computeProgramId    Self-explanatory
+    bufferNameInShader  The prefix of the storage block names.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void QuadTreeBuildSsbo::ConfigureCompute(unsigned int computeProgramId, 
+    const std::string &bufferNameInShader)
+{
+    const char *blockSuffixes[] = 
+    {
+        "KeysIn", "ValuesIn", "KeysOut", "ValuesOut", "BlockSums", "State"
+    };
+    unsigned int bindingPointIndexes[] = 
+    {
+        _ssboBindingPointIndex, 
+        _valuesInBindingPointIndex, 
+        _keysOutBindingPointIndex, 
+        _valuesOutBindingPointIndex,
+        _blockSumsBindingPointIndex,
+        _stateBindingPointIndex
+    };
+
+    for (unsigned int blockIndex = 0; blockIndex < 6; blockIndex++)
+    {
+        std::string blockName = bufferNameInShader + blockSuffixes[blockIndex];
+        GLuint storageBlockIndex = glGetProgramResourceIndex(computeProgramId, GL_SHADER_STORAGE_BLOCK, blockName.c_str());
+        if (storageBlockIndex != GL_INVALID_INDEX)
+        {
+            glShaderStorageBlockBinding(computeProgramId, storageBlockIndex, bindingPointIndexes[blockIndex]);
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Like CompactQuadTreeSsbo, this SSBO does not draw.
+Parameters:
+    irrelevant
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void QuadTreeBuildSsbo::ConfigureRender(unsigned int, unsigned int)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Binds the key and value arrays at inputIndex to the "in" binding points and the other 
+    ones to the "out" binding points.
+Parameters:
+    inputIndex  0 or 1.  Anything else is treated as 1.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void QuadTreeBuildSsbo::BindSortDirection(unsigned int inputIndex)
+{
+    unsigned int keysIn = (inputIndex == 0) ? SECTION_KEYS_0 : SECTION_KEYS_1;
+    unsigned int keysOut = (inputIndex == 0) ? SECTION_KEYS_1 : SECTION_KEYS_0;
+    unsigned int valuesIn = (inputIndex == 0) ? SECTION_VALUES_0 : SECTION_VALUES_1;
+    unsigned int valuesOut = (inputIndex == 0) ? SECTION_VALUES_1 : SECTION_VALUES_0;
+
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, _ssboBindingPointIndex, _bufferId, 
+        _sectionOffsetBytes[keysIn], _sectionSizeBytes[keysIn]);
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, _valuesInBindingPointIndex, _bufferId, 
+        _sectionOffsetBytes[valuesIn], _sectionSizeBytes[valuesIn]);
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, _keysOutBindingPointIndex, _bufferId, 
+        _sectionOffsetBytes[keysOut], _sectionSizeBytes[keysOut]);
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, _valuesOutBindingPointIndex, _bufferId, 
+        _sectionOffsetBytes[valuesOut], _sectionSizeBytes[valuesOut]);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Where one of the particle index arrays starts in the buffer.  Once the build is done, the 
+    one at index 0 is the particle index pool.
+Parameters:
+    arrayIndex  0 or 1.  Anything else is treated as 1.
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int QuadTreeBuildSsbo::ValuesOffsetBytes(unsigned int arrayIndex) const
+{
+    return _sectionOffsetBytes[(arrayIndex == 0) ? SECTION_VALUES_0 : SECTION_VALUES_1];
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "SsboBase.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets up the Shader Storage Block Object for building a CompactParticleQuadTree on the GPU 
+    (see ComputeControllerQuadTreeBuild).  It holds everything that the QuadTreeBuild*.comp 
+    shaders need other than the particles and the nodes: two arrays of Morton keys, two arrays 
+    of particle indices (the radix sort goes back and forth between them), the work groups' 
+    block sums, and a QuadTreeBuildState.  Each is a section of the same buffer, like 
+    CompactQuadTreeSsbo's nodes and pool.
+
+    The storage blocks are bufferNameInShader + "KeysIn", "ValuesIn", "KeysOut", "ValuesOut", 
+    "BlockSums", and "State".  Which key and value arrays are "in" and which are "out" is set 
+    with BindSortDirection(...), and since binding points are shared by every program, that 
+    covers all of the build's shaders at once.
+
+    Nothing here is ever read or written by the CPU.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class QuadTreeBuildSsbo : public SsboBase
+{
+public:
+    QuadTreeBuildSsbo(unsigned int maxParticles, unsigned int maxBlockSums);
+    virtual ~QuadTreeBuildSsbo() override = default; // empty override of base destructor
+
+    void ConfigureCompute(unsigned int computeProgramId, const std::string &bufferNameInShader) override;
+    void ConfigureRender(unsigned int renderProgramId, unsigned int drawStyle) override;
+
+    void BindSortDirection(unsigned int inputIndex);
+    unsigned int ValuesOffsetBytes(unsigned int arrayIndex) const;
+
+private:
+    enum SECTION
+    {
+        SECTION_KEYS_0 = 0,
+        SECTION_KEYS_1,
+        SECTION_VALUES_0,
+        SECTION_VALUES_1,
+        SECTION_BLOCK_SUMS,
+        SECTION_STATE,
+        SECTION_COUNT
+    };
+
+    unsigned int _maxParticles;
+    unsigned int _maxBlockSums;
+    unsigned int _sectionOffsetBytes[SECTION_COUNT];
+    unsigned int _sectionSizeBytes[SECTION_COUNT];
+
+    // the base class' binding point is the keys "in"
+    unsigned int _valuesInBindingPointIndex;
+    unsigned int _keysOutBindingPointIndex;
+    unsigned int _valuesOutBindingPointIndex;
+    unsigned int _blockSumsBindingPointIndex;
+    unsigned int _stateBindingPointIndex;
+};
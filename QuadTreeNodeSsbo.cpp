@@ -11,18 +11,23 @@ Description:
 
     Allocates space for the SSBO and dumps the given collection of node data into it.
 Parameters:
-faceCollection  Self-explanatory
+nodeCollection  Self-explanatory
+numNodes        The size of the buffer, in nodes.  None of them are considered active until 
+                the first UploadNodes(...).
 Returns:    None
 Creator: John Cox, 1-16-2017
 -----------------------------------------------------------------------------------------------*/
 QuadTreeNodeSsbo::QuadTreeNodeSsbo(const ParticleQuadTreeNode *nodeCollection, int numNodes) :
-    SsboBase()  // generate buffers
+    SsboBase(),  // generate buffers
+    _orphanOnUpload(false),
+    _numActiveNodes(0)
 {
     // ignore _numVertices because this SSBO does not draw
 
+    // Note: The nodes are uploaded every frame, hence "dynamic".
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
     GLuint bufferSizeBytes = sizeof(ParticleQuadTreeNode) * numNodes;
-    glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSizeBytes, nodeCollection, GL_STATIC_DRAW);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSizeBytes, nodeCollection, GL_DYNAMIC_DRAW);
 
     _bufferSizeBytes = bufferSizeBytes;
 
@@ -71,3 +76,63 @@ Creator: John Cox, 1-16-2017
 void QuadTreeNodeSsbo::ConfigureRender(unsigned int, unsigned int)
 {
 }
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    If true, UploadNodes(...) gives the buffer new storage before writing to it ("orphaning" 
+    it) instead of writing over the storage that the previous frame's dispatches may still be 
+    reading.  The driver can then hand out fresh memory instead of waiting for them.  Whether 
+    that is faster depends on the driver, so it is off by default.
+Parameters:
+    orphanOnUpload  Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void QuadTreeNodeSsbo::SetOrphanOnUpload(bool orphanOnUpload)
+{
+    _orphanOnUpload = orphanOnUpload;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Copies the nodes [0, numActiveNodes) into the front of the buffer.  The nodes past that are 
+    left as they were, and the shaders must ignore them (see the "number of active nodes" 
+    uniform in ParticleCollisions.comp).
+
+    Note: ParticleQuadTree::NumActiveNodes() is the highest node in use, so every node that 
+    the tree refers to is in that range.
+Parameters:
+    allNodes        Self-explanatory
+    numActiveNodes  Clamped to the size of the buffer.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void QuadTreeNodeSsbo::UploadNodes(const ParticleQuadTreeNode *allNodes, 
+    unsigned int numActiveNodes)
+{
+    unsigned int maxNodes = _bufferSizeBytes / sizeof(ParticleQuadTreeNode);
+    _numActiveNodes = (numActiveNodes < maxNodes) ? numActiveNodes : maxNodes;
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+    if (_orphanOnUpload)
+    {
+        // same size and usage, so the binding points don't need to be set up again
+        glBufferData(GL_SHADER_STORAGE_BUFFER, _bufferSizeBytes, 0, GL_DYNAMIC_DRAW);
+    }
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, 
+        _numActiveNodes * sizeof(ParticleQuadTreeNode), allNodes);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of nodes in the last UploadNodes(...).
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int QuadTreeNodeSsbo::NumActiveNodes() const
+{
+    return _numActiveNodes;
+}
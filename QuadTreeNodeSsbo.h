@@ -8,6 +8,10 @@ struct ParticleQuadTreeNode;
 Description:
     Sets up the Shader Storage Block Object for quad tree nodes.  The polygon will be used in 
     the compute shader only.
+
+    Only the nodes that are in use are uploaded each frame (see UploadNodes(...)).  The shaders 
+    are told how many that is with a "number of active nodes" uniform and treat every node 
+    past that as empty, so the rest of the buffer is never cleared.
 Creator: John Cox, 1/16/2017
 -----------------------------------------------------------------------------------------------*/
 class QuadTreeNodeSsbo : public SsboBase
@@ -19,5 +23,12 @@ public:
     void ConfigureCompute(unsigned int computeProgramId, const std::string &bufferNameInShader) override;
     void ConfigureRender(unsigned int renderProgramId, unsigned int drawStyle) override;
 
+    void SetOrphanOnUpload(bool orphanOnUpload);
+    void UploadNodes(const ParticleQuadTreeNode *allNodes, unsigned int numActiveNodes);
+    unsigned int NumActiveNodes() const;
+
+private:
+    bool _orphanOnUpload;
+    unsigned int _numActiveNodes;
 };
 
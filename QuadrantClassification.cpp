@@ -0,0 +1,495 @@
+#include "QuadrantClassification.h"
+
+#include <atomic>
+
+// the vector paths are only for x64 (where SSE2 is always there); everything else gets the
+// scalar path
+#if defined(_M_X64) || defined(__x86_64__)
+#define QUADRANT_CLASSIFICATION_X64
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>     // for __cpuid(...) and _xgetbv(...)
+#endif
+#endif
+
+// gcc and clang won't emit AVX2 instructions outside of a function that asks for them, but
+// Visual Studio will emit them anywhere
+#if defined(__GNUC__)
+#define QUADRANT_CLASSIFICATION_AVX2_FUNCTION __attribute__((target("avx2")))
+#else
+#define QUADRANT_CLASSIFICATION_AVX2_FUNCTION
+#endif
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A helper for the scalar MortonKey(...).  Spreads the low 16 bits of a value out to the
+    even bits of the result.
+Parameters:
+    value   Only the low 16 bits are used.
+Returns:
+    See description.
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+static inline unsigned int SpreadBits16(unsigned int value)
+{
+    value &= 0x0000ffff;
+    value = (value | (value << 8)) & 0x00ff00ff;
+    value = (value | (value << 4)) & 0x0f0f0f0f;
+    value = (value | (value << 2)) & 0x33333333;
+    value = (value | (value << 1)) & 0x55555555;
+    return value;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Makes a 32bit Morton (Z-order) key out of a position.  The particle region is cut into a
+    65536x65536 grid, and the key interleaves the cell's column and row, counting the row
+    from the top.  Every 2 bits, starting from the top, say which quadrant the particle is in
+    at the next level down: 0 = top left, 1 = top right, 2 = bottom left, 3 = bottom right.
+    That is the same order as ClassifyQuadrants(...).
+
+    Note: A particle that is exactly on a node's vertical center line goes to the right and
+    one that is exactly on the horizontal center line goes to the bottom, just like
+    ClassifyQuadrants(...).  The only disagreement is for particles within float rounding
+    error of a center line.
+Parameters:
+    x                   In world space.
+    y                   In world space.
+    regionLeft          The left edge of the particle region.
+    regionTop           The top edge of the particle region.
+    cellsPerWorldUnit   65536 / the particle region's width.
+Returns:
+    See description.
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+static inline unsigned int MortonKey(float x, float y, float regionLeft, float regionTop,
+    float cellsPerWorldUnit)
+{
+    // the update shader constrains particles to the region, but a particle can still be a
+    // hair outside of it for a frame, so clamp it to the edge cells
+    float column = (x - regionLeft) * cellsPerWorldUnit;
+    float row = (regionTop - y) * cellsPerWorldUnit;
+    column = (column < 0.0f) ? 0.0f : ((column > 65535.0f) ? 65535.0f : column);
+    row = (row < 0.0f) ? 0.0f : ((row > 65535.0f) ? 65535.0f : row);
+
+    return SpreadBits16((unsigned int)column) | (SpreadBits16((unsigned int)row) << 1);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The scalar version of ClassifyQuadrants(...), which also handles the leftovers at the end
+    of the vector versions' arrays.
+Parameters:
+    See ClassifyQuadrants(...).
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+static void ClassifyQuadrantsScalar(const float *positionsX, const float *positionsY,
+    unsigned int count, float centerX, float centerY, unsigned char *quadrants)
+{
+    for (unsigned int index = 0; index < count; index++)
+    {
+        int isLeft = int(positionsX[index] < centerX);
+        int isTop = int(positionsY[index] > centerY);
+        quadrants[index] = (unsigned char)(((1 - isTop) * 2) + (1 - isLeft));
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The scalar version of ComputeMortonKeys(...), which also handles the leftovers at the end
+    of the vector versions' arrays.
+Parameters:
+    See ComputeMortonKeys(...).
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+static void ComputeMortonKeysScalar(const float *positionsX, const float *positionsY,
+    unsigned int count, float regionLeft, float regionTop, float cellsPerWorldUnit,
+    unsigned int *keys)
+{
+    for (unsigned int index = 0; index < count; index++)
+    {
+        keys[index] = MortonKey(positionsX[index], positionsY[index], regionLeft, regionTop,
+            cellsPerWorldUnit);
+    }
+}
+
+#if defined(QUADRANT_CLASSIFICATION_X64)
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Checks if the CPU has AVX2 and if the OS saves the 256bit registers on a context switch
+    (without the latter, the instructions are there but using them is a crash).
+Parameters: None
+Returns:
+    True if the AVX2 path can be used, otherwise false.
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+static bool CpuHasAvx2()
+{
+#if defined(_MSC_VER)
+    int cpuInfo[4] = { 0 };
+    __cpuid(cpuInfo, 0);
+    if (cpuInfo[0] < 7)
+    {
+        return false;
+    }
+
+    // ECX bit 27 is OSXSAVE and bit 28 is AVX
+    __cpuid(cpuInfo, 1);
+    bool osSavesYmm = (cpuInfo[2] & (1 << 27)) != 0;
+    bool hasAvx = (cpuInfo[2] & (1 << 28)) != 0;
+    if (!osSavesYmm || !hasAvx || (_xgetbv(0) & 0x6) != 0x6)
+    {
+        return false;
+    }
+
+    // leaf 7 EBX bit 5 is AVX2
+    __cpuidex(cpuInfo, 7, 0);
+    return (cpuInfo[1] & (1 << 5)) != 0;
+#else
+    // checks the OS support too
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The SSE2 version of ClassifyQuadrants(...).  4 particles at a time.
+Parameters:
+    See ClassifyQuadrants(...).
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+static void ClassifyQuadrantsSse2(const float *positionsX, const float *positionsY,
+    unsigned int count, float centerX, float centerY, unsigned char *quadrants)
+{
+    __m128 center4X = _mm_set1_ps(centerX);
+    __m128 center4Y = _mm_set1_ps(centerY);
+    unsigned int index = 0;
+    for (; index + 4 <= count; index += 4)
+    {
+        // right = !(x < center), bottom = !(y > center), one bit per particle
+        int isRightBits = _mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(positionsX + index), center4X));
+        int isBottomBits = _mm_movemask_ps(_mm_cmple_ps(_mm_loadu_ps(positionsY + index), center4Y));
+        for (int lane = 0; lane < 4; lane++)
+        {
+            quadrants[index + lane] =
+                (unsigned char)(((isBottomBits >> lane) & 1) * 2 + ((isRightBits >> lane) & 1));
+        }
+    }
+
+    ClassifyQuadrantsScalar(positionsX + index, positionsY + index, count - index, centerX,
+        centerY, quadrants + index);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The AVX2 version of ClassifyQuadrants(...).  8 particles at a time.
+
+    Note: Strictly, this only needs AVX, but there is no sense in having a third vector path
+    for CPUs from 2011.
+Parameters:
+    See ClassifyQuadrants(...).
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+QUADRANT_CLASSIFICATION_AVX2_FUNCTION
+static void ClassifyQuadrantsAvx2(const float *positionsX, const float *positionsY,
+    unsigned int count, float centerX, float centerY, unsigned char *quadrants)
+{
+    __m256 center8X = _mm256_set1_ps(centerX);
+    __m256 center8Y = _mm256_set1_ps(centerY);
+    unsigned int index = 0;
+    for (; index + 8 <= count; index += 8)
+    {
+        int isRightBits = _mm256_movemask_ps(
+            _mm256_cmp_ps(_mm256_loadu_ps(positionsX + index), center8X, _CMP_GE_OQ));
+        int isBottomBits = _mm256_movemask_ps(
+            _mm256_cmp_ps(_mm256_loadu_ps(positionsY + index), center8Y, _CMP_LE_OQ));
+        for (int lane = 0; lane < 8; lane++)
+        {
+            quadrants[index + lane] =
+                (unsigned char)(((isBottomBits >> lane) & 1) * 2 + ((isRightBits >> lane) & 1));
+        }
+    }
+
+    ClassifyQuadrantsScalar(positionsX + index, positionsY + index, count - index, centerX,
+        centerY, quadrants + index);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The SSE2 version of SpreadBits16(...).  4 values at a time.
+Parameters:
+    value   4 32bit values.  Only the low 16 bits of each are used.
+Returns:
+    See SpreadBits16(...).
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+static inline __m128i SpreadBits16Sse2(__m128i value)
+{
+    value = _mm_and_si128(value, _mm_set1_epi32(0x0000ffff));
+    value = _mm_and_si128(_mm_or_si128(value, _mm_slli_epi32(value, 8)), _mm_set1_epi32(0x00ff00ff));
+    value = _mm_and_si128(_mm_or_si128(value, _mm_slli_epi32(value, 4)), _mm_set1_epi32(0x0f0f0f0f));
+    value = _mm_and_si128(_mm_or_si128(value, _mm_slli_epi32(value, 2)), _mm_set1_epi32(0x33333333));
+    value = _mm_and_si128(_mm_or_si128(value, _mm_slli_epi32(value, 1)), _mm_set1_epi32(0x55555555));
+    return value;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The SSE2 version of ComputeMortonKeys(...).  4 particles at a time.
+Parameters:
+    See ComputeMortonKeys(...).
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+static void ComputeMortonKeysSse2(const float *positionsX, const float *positionsY,
+    unsigned int count, float regionLeft, float regionTop, float cellsPerWorldUnit,
+    unsigned int *keys)
+{
+    __m128 left4 = _mm_set1_ps(regionLeft);
+    __m128 top4 = _mm_set1_ps(regionTop);
+    __m128 cellsPerWorldUnit4 = _mm_set1_ps(cellsPerWorldUnit);
+    __m128 zero4 = _mm_setzero_ps();
+    __m128 lastCell4 = _mm_set1_ps(65535.0f);
+    unsigned int index = 0;
+    for (; index + 4 <= count; index += 4)
+    {
+        __m128 column = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(positionsX + index), left4), cellsPerWorldUnit4);
+        __m128 row = _mm_mul_ps(_mm_sub_ps(top4, _mm_loadu_ps(positionsY + index)), cellsPerWorldUnit4);
+        column = _mm_min_ps(_mm_max_ps(column, zero4), lastCell4);
+        row = _mm_min_ps(_mm_max_ps(row, zero4), lastCell4);
+
+        // truncates, like the scalar cast
+        __m128i key = _mm_or_si128(SpreadBits16Sse2(_mm_cvttps_epi32(column)),
+            _mm_slli_epi32(SpreadBits16Sse2(_mm_cvttps_epi32(row)), 1));
+        _mm_storeu_si128((__m128i *)(keys + index), key);
+    }
+
+    ComputeMortonKeysScalar(positionsX + index, positionsY + index, count - index, regionLeft,
+        regionTop, cellsPerWorldUnit, keys + index);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The AVX2 version of SpreadBits16(...).  8 values at a time.
+Parameters:
+    value   8 32bit values.  Only the low 16 bits of each are used.
+Returns:
+    See SpreadBits16(...).
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+QUADRANT_CLASSIFICATION_AVX2_FUNCTION
+static inline __m256i SpreadBits16Avx2(__m256i value)
+{
+    value = _mm256_and_si256(value, _mm256_set1_epi32(0x0000ffff));
+    value = _mm256_and_si256(_mm256_or_si256(value, _mm256_slli_epi32(value, 8)), _mm256_set1_epi32(0x00ff00ff));
+    value = _mm256_and_si256(_mm256_or_si256(value, _mm256_slli_epi32(value, 4)), _mm256_set1_epi32(0x0f0f0f0f));
+    value = _mm256_and_si256(_mm256_or_si256(value, _mm256_slli_epi32(value, 2)), _mm256_set1_epi32(0x33333333));
+    value = _mm256_and_si256(_mm256_or_si256(value, _mm256_slli_epi32(value, 1)), _mm256_set1_epi32(0x55555555));
+    return value;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The AVX2 version of ComputeMortonKeys(...).  8 particles at a time.
+Parameters:
+    See ComputeMortonKeys(...).
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+QUADRANT_CLASSIFICATION_AVX2_FUNCTION
+static void ComputeMortonKeysAvx2(const float *positionsX, const float *positionsY,
+    unsigned int count, float regionLeft, float regionTop, float cellsPerWorldUnit,
+    unsigned int *keys)
+{
+    __m256 left8 = _mm256_set1_ps(regionLeft);
+    __m256 top8 = _mm256_set1_ps(regionTop);
+    __m256 cellsPerWorldUnit8 = _mm256_set1_ps(cellsPerWorldUnit);
+    __m256 zero8 = _mm256_setzero_ps();
+    __m256 lastCell8 = _mm256_set1_ps(65535.0f);
+    unsigned int index = 0;
+    for (; index + 8 <= count; index += 8)
+    {
+        __m256 column = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(positionsX + index), left8), cellsPerWorldUnit8);
+        __m256 row = _mm256_mul_ps(_mm256_sub_ps(top8, _mm256_loadu_ps(positionsY + index)), cellsPerWorldUnit8);
+        column = _mm256_min_ps(_mm256_max_ps(column, zero8), lastCell8);
+        row = _mm256_min_ps(_mm256_max_ps(row, zero8), lastCell8);
+
+        __m256i key = _mm256_or_si256(SpreadBits16Avx2(_mm256_cvttps_epi32(column)),
+            _mm256_slli_epi32(SpreadBits16Avx2(_mm256_cvttps_epi32(row)), 1));
+        _mm256_storeu_si256((__m256i *)(keys + index), key);
+    }
+
+    ComputeMortonKeysScalar(positionsX + index, positionsY + index, count - index, regionLeft,
+        regionTop, cellsPerWorldUnit, keys + index);
+}
+
+#endif  // QUADRANT_CLASSIFICATION_X64
+
+// -1 until the first call picks one
+// Note: Atomic because trees on different threads (the frame scheduler's tree builder and 
+// the parallel build's workers) may be the first to ask.
+static std::atomic<int> gCurrentPath(-1);
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Asks the CPU which of the paths it can run and picks the fastest.
+Parameters: None
+Returns:
+    AVX2 if the CPU and OS support it, SSE2 on any other x64 CPU, and scalar otherwise.
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+QUADRANT_CLASSIFICATION_PATH BestQuadrantClassificationPath()
+{
+#if defined(QUADRANT_CLASSIFICATION_X64)
+    static const bool hasAvx2 = CpuHasAvx2();
+    return hasAvx2 ? QUADRANT_CLASSIFICATION_AVX2 : QUADRANT_CLASSIFICATION_SSE2;
+#else
+    return QUADRANT_CLASSIFICATION_SCALAR;
+#endif
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Tells which path ClassifyQuadrants(...) and ComputeMortonKeys(...) are using.  Picks the
+    best one if nothing has been picked yet.
+Parameters: None
+Returns:
+    See description.
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+QUADRANT_CLASSIFICATION_PATH CurrentQuadrantClassificationPath()
+{
+    int currentPath = gCurrentPath.load();
+    if (currentPath == -1)
+    {
+        // if another thread picked one (or SetQuadrantClassificationPath(...) was called) in 
+        // the meantime, that one stands and currentPath gets it
+        int bestPath = BestQuadrantClassificationPath();
+        if (gCurrentPath.compare_exchange_strong(currentPath, bestPath))
+        {
+            currentPath = bestPath;
+        }
+    }
+
+    return (QUADRANT_CLASSIFICATION_PATH)currentPath;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Overrides the automatic choice of path.  Meant for comparing the paths' speed and making
+    sure that they all agree.
+Parameters:
+    path    Self-explanatory.
+Returns:
+    True if the CPU can run that path, otherwise false (and nothing changes).
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+bool SetQuadrantClassificationPath(QUADRANT_CLASSIFICATION_PATH path)
+{
+    if (path > BestQuadrantClassificationPath())
+    {
+        return false;
+    }
+
+    gCurrentPath.store(path);
+    return true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    For printing.
+Parameters:
+    path    Self-explanatory.
+Returns:
+    "scalar", "SSE2", or "AVX2".
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+const char *QuadrantClassificationPathName(QUADRANT_CLASSIFICATION_PATH path)
+{
+    switch (path)
+    {
+    case QUADRANT_CLASSIFICATION_SSE2:
+        return "SSE2";
+    case QUADRANT_CLASSIFICATION_AVX2:
+        return "AVX2";
+    default:
+        return "scalar";
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Works out which quadrant of a node each position is in.  Uses the same rule as the rest
+    of the quad tree: less than the center's X is left, greater than the center's Y is top,
+    so a position exactly on a center line goes right or down.
+Parameters:
+    positionsX  X values in world space.
+    positionsY  Y values in world space.
+    count       How many positions.
+    centerX     The node's center.
+    centerY     The node's center.
+    quadrants   Gets count values: 0 = top left, 1 = top right, 2 = bottom left,
+                3 = bottom right (the order of ParticleQuadTree's starting nodes).
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void ClassifyQuadrants(const float *positionsX, const float *positionsY, unsigned int count,
+    float centerX, float centerY, unsigned char *quadrants)
+{
+    switch (CurrentQuadrantClassificationPath())
+    {
+#if defined(QUADRANT_CLASSIFICATION_X64)
+    case QUADRANT_CLASSIFICATION_AVX2:
+        ClassifyQuadrantsAvx2(positionsX, positionsY, count, centerX, centerY, quadrants);
+        break;
+    case QUADRANT_CLASSIFICATION_SSE2:
+        ClassifyQuadrantsSse2(positionsX, positionsY, count, centerX, centerY, quadrants);
+        break;
+#endif
+    default:
+        ClassifyQuadrantsScalar(positionsX, positionsY, count, centerX, centerY, quadrants);
+        break;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Makes the Morton key for each position (see MortonKey(...)).  The key is the quadrant
+    classification for every level of the tree at once.
+Parameters:
+    positionsX          X values in world space.
+    positionsY          Y values in world space.
+    count               How many positions.
+    regionLeft          The left edge of the particle region.
+    regionTop           The top edge of the particle region.
+    cellsPerWorldUnit   65536 / the particle region's width.
+    keys                Gets count keys.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void ComputeMortonKeys(const float *positionsX, const float *positionsY, unsigned int count,
+    float regionLeft, float regionTop, float cellsPerWorldUnit, unsigned int *keys)
+{
+    switch (CurrentQuadrantClassificationPath())
+    {
+#if defined(QUADRANT_CLASSIFICATION_X64)
+    case QUADRANT_CLASSIFICATION_AVX2:
+        ComputeMortonKeysAvx2(positionsX, positionsY, count, regionLeft, regionTop,
+            cellsPerWorldUnit, keys);
+        break;
+    case QUADRANT_CLASSIFICATION_SSE2:
+        ComputeMortonKeysSse2(positionsX, positionsY, count, regionLeft, regionTop,
+            cellsPerWorldUnit, keys);
+        break;
+#endif
+    default:
+        ComputeMortonKeysScalar(positionsX, positionsY, count, regionLeft, regionTop,
+            cellsPerWorldUnit, keys);
+        break;
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The quad tree builds spend most of their time asking "which side of this center is the
+    particle on?" for every particle.  These functions answer that question for a whole
+    array of positions at once, 8 at a time with AVX2 or 4 at a time with SSE2, and fall back
+    to plain C++ on CPUs (or compilers) that have neither.  The best path that the CPU
+    supports is picked the first time that one of them is called.
+
+    The positions are in separate x and y arrays (structure of arrays) rather than the
+    Particle structure's glm::vec4 because the vector instructions need 8 consecutive x values
+    in one load, and a Particle is 64 bytes.
+
+    Like RandomToast, these are plain functions because there is no state other than which
+    path is in use.
+
+    Note: Every path has to give the exact same answer as the others, and the same answer as
+    the scalar checks in ParticleQuadTree, or else particles would land in different nodes
+    depending on which CPU the program ran on.
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+
+enum QUADRANT_CLASSIFICATION_PATH
+{
+    QUADRANT_CLASSIFICATION_SCALAR = 0,
+    QUADRANT_CLASSIFICATION_SSE2,
+    QUADRANT_CLASSIFICATION_AVX2
+};
+
+QUADRANT_CLASSIFICATION_PATH BestQuadrantClassificationPath();
+QUADRANT_CLASSIFICATION_PATH CurrentQuadrantClassificationPath();
+bool SetQuadrantClassificationPath(QUADRANT_CLASSIFICATION_PATH path);
+const char *QuadrantClassificationPathName(QUADRANT_CLASSIFICATION_PATH path);
+
+void ClassifyQuadrants(const float *positionsX, const float *positionsY, unsigned int count,
+    float centerX, float centerY, unsigned char *quadrants);
+void ComputeMortonKeys(const float *positionsX, const float *positionsY, unsigned int count,
+    float regionLeft, float regionTop, float cellsPerWorldUnit, unsigned int *keys);
@@ -1,6 +1,24 @@
 #include "RandomToast.h"
+#include <atomic>
 #include <climits>
 
+#include "QuadrantClassification.h"     // for its CPU check
+
+// same as QuadrantClassification.cpp: the vector paths are only for x64, where SSE2 is always
+// there, and the AVX2 path is built into every x64 build but only used if the CPU has AVX2
+#if defined(_M_X64) || defined(__x86_64__)
+#define RANDOM_TOAST_X64
+#include <immintrin.h>
+#endif
+
+// gcc and clang won't emit AVX2 instructions outside of a function that asks for them, but
+// Visual Studio will emit them anywhere
+#if defined(__GNUC__)
+#define RANDOM_TOAST_AVX2_FUNCTION __attribute__((target("avx2")))
+#else
+#define RANDOM_TOAST_AVX2_FUNCTION
+#endif
+
 // initial values for xorshf96()
 static unsigned long x = 123456789, y = 362436069, z = 521288629;
 
@@ -101,3 +119,387 @@ glm::vec3 RandomColor()
     ret.z = RandomOnRange0to1();
     return ret;
 }
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The PCG hash: one step of a PCG random generator's state update followed by its output
+    permutation, used as a stateless hash.  Cheap on both the CPU and the GPU and, according
+    to Jarzynski and Olano, "Hash Functions for GPU Rendering" (JCGT, 2020), about the best
+    mix of speed and quality for a 32bit input.
+    http://www.jcgt.org/published/0009/03/02/
+
+    Note: Only 32bit unsigned integer math, which wraps the same way in C++ and GLSL, so the
+    shaders' version gives the same bits.
+Parameters:
+    value   Self-explanatory
+Returns:
+    A decently chaotic 32bit number.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int CounterRandomHash(unsigned int value)
+{
+    unsigned int state = (value * 747796405u) + 2891336453u;
+    unsigned int word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Hashes each part of the key into the last one's result, so a change to any of them
+    changes every bit, and then moves on to the key's next draw.
+Parameters:
+    key     The key for this number.  Its draw index is incremented.
+Returns:
+    A random 32bit number.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int CounterRandom(CounterRandomKey &key)
+{
+    unsigned int hash = CounterRandomHash(key._seed);
+    hash = CounterRandomHash(hash ^ key._frame);
+    hash = CounterRandomHash(hash ^ key._particleIndex);
+    hash = CounterRandomHash(hash ^ key._drawIndex);
+    key._drawIndex++;
+    return hash;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Like RandomOnRange0to1(), but from a CounterRandomKey.  Only the top 24 bits are used so
+    that the integer, and so the float, is exact, which keeps it identical to the shaders'.
+Parameters:
+    key     The key for this number.  Its draw index is incremented.
+Returns:
+    A random float on the range [0,+1).
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+float RandomOnRange0to1(CounterRandomKey &key)
+{
+    return (float)(CounterRandom(key) >> 8) * (1.0f / 16777216.0f);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Vigna's splitmix64.  Each call moves the state along by a constant and scrambles the
+    result, so consecutive states give unrelated outputs.  Used to turn a seed into xorshift
+    states, which must not start out all zeros.
+    http://xoroshiro.di.unimi.it/splitmix64.c
+Parameters:
+    state   Self-explanatory.  It is moved along by one.
+Returns:
+    A well-mixed 64bit number.
+Creator:    Sebastiano Vigna (2015), as found online.
+-----------------------------------------------------------------------------------------------*/
+static unsigned long long SplitMix64(unsigned long long &state)
+{
+    unsigned long long z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Turns the top 24 bits of a random 64bit number into a float.  24 bits fit in a float
+    exactly, so this is the same on every path.
+Parameters:
+    value   Self-explanatory
+Returns:
+    A float on the range [0,+1).
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static inline float TopBitsOnRange0to1(unsigned long long value)
+{
+    return (float)(unsigned int)(value >> 40) * (1.0f / 16777216.0f);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Seeds every lane.  Stream N's lanes take splitmix64 outputs 2 * NUM_LANES * N onwards,
+    two per lane, so streams with different indices start from different states.
+Parameters:
+    seed            Self-explanatory.  Any value is ok.
+    streamIndex     Which stream of this seed, such as the index of a worker thread.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+RandomStream::RandomStream(unsigned long long seed, unsigned int streamIndex)
+{
+    // skip to this stream's run by moving the state directly instead of calling it N times
+    unsigned long long splitMixState = seed + 
+        ((unsigned long long)streamIndex * 2 * NUM_LANES * 0x9E3779B97F4A7C15ull);
+    for (unsigned int lane = 0; lane < NUM_LANES; lane++)
+    {
+        _state0[lane] = SplitMix64(splitMixState);
+        _state1[lane] = SplitMix64(splitMixState);
+        if (_state0[lane] == 0 && _state1[lane] == 0)
+        {
+            _state0[lane] = 1;
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Vigna's xorshift128+ on lane 0 alone, for when only one number is needed.  The other lanes
+    are not moved, so this and Fill(...) can be used on the same stream, but the numbers 
+    depend on the order of the calls.
+    http://xoroshiro.di.unimi.it/xorshift128plus.c
+Parameters: None
+Returns:
+    A random 64bit number.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned long long RandomStream::Next()
+{
+    unsigned long long s1 = _state0[0];
+    const unsigned long long s0 = _state1[0];
+    const unsigned long long result = s0 + s1;
+    _state0[0] = s0;
+    s1 ^= s1 << 23;
+    _state1[0] = s1 ^ s0 ^ (s1 >> 18) ^ (s0 >> 5);
+    return result;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Like RandomOnRange0to1(), but from this stream.  See Next().
+Parameters: None
+Returns:
+    A random float on the range [0,+1).
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+float RandomStream::NextOnRange0to1()
+{
+    return TopBitsOnRange0to1(Next());
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Moves every lane along by one with the plain C++ version of Next().  Fill(...) uses the
+    vector paths instead when it can, and they must give the same results.
+Parameters:
+    results     One number per lane.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void RandomStream::Step(unsigned long long *results)
+{
+    for (unsigned int lane = 0; lane < NUM_LANES; lane++)
+    {
+        unsigned long long s1 = _state0[lane];
+        const unsigned long long s0 = _state1[lane];
+        results[lane] = s0 + s1;
+        _state0[lane] = s0;
+        s1 ^= s1 << 23;
+        _state1[lane] = s1 ^ s0 ^ (s1 >> 18) ^ (s0 >> 5);
+    }
+}
+
+#if defined(RANDOM_TOAST_X64)
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The SSE2 part of RandomStream::Fill(...).  Lanes 0 and 1 are in one register and lanes 2
+    and 3 in another.
+Parameters:
+    state0  The stream's _state0.  Moved along.
+    state1  The stream's _state1.  Moved along.
+    values  See RandomStream::Fill(...).
+    count   See RandomStream::Fill(...).
+Returns:
+    How many values were filled, which is count rounded down to a multiple of the lane count.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static unsigned int FillSse2(unsigned long long *state0, unsigned long long *state1,
+    float *values, unsigned int count)
+{
+    __m128i s0Low = _mm_loadu_si128((const __m128i *)state1);
+    __m128i s0High = _mm_loadu_si128((const __m128i *)(state1 + 2));
+    __m128i s1Low = _mm_loadu_si128((const __m128i *)state0);
+    __m128i s1High = _mm_loadu_si128((const __m128i *)(state0 + 2));
+    const __m128 toRange0to1 = _mm_set1_ps(1.0f / 16777216.0f);
+    unsigned int index = 0;
+    for (; index + RandomStream::NUM_LANES <= count; index += RandomStream::NUM_LANES)
+    {
+        __m128i resultLow = _mm_add_epi64(s0Low, s1Low);
+        __m128i resultHigh = _mm_add_epi64(s0High, s1High);
+        __m128i newState0Low = s0Low;
+        __m128i newState0High = s0High;
+        s1Low = _mm_xor_si128(s1Low, _mm_slli_epi64(s1Low, 23));
+        s1High = _mm_xor_si128(s1High, _mm_slli_epi64(s1High, 23));
+        s0Low = _mm_xor_si128(_mm_xor_si128(s1Low, s0Low),
+            _mm_xor_si128(_mm_srli_epi64(s1Low, 18), _mm_srli_epi64(s0Low, 5)));
+        s0High = _mm_xor_si128(_mm_xor_si128(s1High, s0High),
+            _mm_xor_si128(_mm_srli_epi64(s1High, 18), _mm_srli_epi64(s0High, 5)));
+        s1Low = newState0Low;
+        s1High = newState0High;
+
+        // the low half of each 64bit lane into the low 64 bits of each register, and then
+        // both registers' low 64 bits into one
+        __m128i topBitsLow = _mm_shuffle_epi32(_mm_srli_epi64(resultLow, 40), _MM_SHUFFLE(3, 1, 2, 0));
+        __m128i topBitsHigh = _mm_shuffle_epi32(_mm_srli_epi64(resultHigh, 40), _MM_SHUFFLE(3, 1, 2, 0));
+        __m128 floats = _mm_cvtepi32_ps(_mm_unpacklo_epi64(topBitsLow, topBitsHigh));
+        _mm_storeu_ps(values + index, _mm_mul_ps(floats, toRange0to1));
+    }
+    _mm_storeu_si128((__m128i *)state1, s0Low);
+    _mm_storeu_si128((__m128i *)(state1 + 2), s0High);
+    _mm_storeu_si128((__m128i *)state0, s1Low);
+    _mm_storeu_si128((__m128i *)(state0 + 2), s1High);
+
+    return index;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The AVX2 part of RandomStream::Fill(...).  All four lanes are in one register.
+Parameters:
+    See FillSse2(...).
+Returns:
+    See FillSse2(...).
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+RANDOM_TOAST_AVX2_FUNCTION
+static unsigned int FillAvx2(unsigned long long *state0, unsigned long long *state1,
+    float *values, unsigned int count)
+{
+    // Note: The top 24 bits are shifted down to the low half of each 64bit lane, and then the 
+    // low halves are gathered into the low 128 bits as 4 ints, which convert to floats 
+    // exactly.
+    __m256i s0 = _mm256_loadu_si256((const __m256i *)state1);
+    __m256i s1 = _mm256_loadu_si256((const __m256i *)state0);
+    const __m256i gatherLowHalves = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    const __m128 toRange0to1 = _mm_set1_ps(1.0f / 16777216.0f);
+    unsigned int index = 0;
+    for (; index + RandomStream::NUM_LANES <= count; index += RandomStream::NUM_LANES)
+    {
+        __m256i result = _mm256_add_epi64(s0, s1);
+        __m256i newState0 = s0;
+        s1 = _mm256_xor_si256(s1, _mm256_slli_epi64(s1, 23));
+        s0 = _mm256_xor_si256(_mm256_xor_si256(s1, s0),
+            _mm256_xor_si256(_mm256_srli_epi64(s1, 18), _mm256_srli_epi64(s0, 5)));
+        s1 = newState0;
+
+        __m256i topBits = _mm256_permutevar8x32_epi32(_mm256_srli_epi64(result, 40), gatherLowHalves);
+        __m128 floats = _mm_cvtepi32_ps(_mm256_castsi256_si128(topBits));
+        _mm_storeu_ps(values + index, _mm_mul_ps(floats, toRange0to1));
+    }
+    _mm256_storeu_si256((__m256i *)state1, s0);
+    _mm256_storeu_si256((__m256i *)state0, s1);
+
+    return index;
+}
+
+#endif  // RANDOM_TOAST_X64
+
+// -1 until the first Fill(...) picks one
+// Note: Atomic because the streams on different threads may be the first to ask.
+static std::atomic<int> gCurrentFillPath(-1);
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Asks the CPU which of Fill(...)'s paths it can run and picks the fastest.  The CPU check
+    is QuadrantClassification's, since its paths need the same instructions.
+Parameters: None
+Returns:
+    AVX2 if the CPU and OS support it, SSE2 on any other x64 CPU, and scalar otherwise.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+RANDOM_STREAM_FILL_PATH RandomStream::BestFillPath()
+{
+    switch (BestQuadrantClassificationPath())
+    {
+    case QUADRANT_CLASSIFICATION_AVX2:
+        return RANDOM_STREAM_FILL_AVX2;
+    case QUADRANT_CLASSIFICATION_SSE2:
+        return RANDOM_STREAM_FILL_SSE2;
+    default:
+        return RANDOM_STREAM_FILL_SCALAR;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Tells which path Fill(...) is using.  Picks the best one if nothing has been picked yet.
+Parameters: None
+Returns:
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+RANDOM_STREAM_FILL_PATH RandomStream::CurrentFillPath()
+{
+    int currentPath = gCurrentFillPath.load();
+    if (currentPath == -1)
+    {
+        // if another thread picked one (or SetFillPath(...) was called) in the meantime, that
+        // one stands and currentPath gets it
+        int bestPath = BestFillPath();
+        if (gCurrentFillPath.compare_exchange_strong(currentPath, bestPath))
+        {
+            currentPath = bestPath;
+        }
+    }
+
+    return (RANDOM_STREAM_FILL_PATH)currentPath;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Overrides the automatic choice of path for every stream.  Meant for making sure that the
+    paths all agree.
+Parameters:
+    path    Self-explanatory.
+Returns:
+    True if the CPU can run that path, otherwise false (and nothing changes).
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+bool RandomStream::SetFillPath(RANDOM_STREAM_FILL_PATH path)
+{
+    if (path > BestFillPath())
+    {
+        return false;
+    }
+
+    gCurrentFillPath.store(path);
+    return true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Fills an array with random floats on the range [0,+1).  Each step of the lanes makes
+    NUM_LANES of them, lane 0's first, so values[(step * NUM_LANES) + lane] is the lane's
+    number from that step.  If the count isn't a multiple of NUM_LANES, the last step's extra
+    numbers are thrown away.
+Parameters:
+    values  Must have room for count floats.
+    count   Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void RandomStream::Fill(float *values, unsigned int count)
+{
+    unsigned int index = 0;
+
+#if defined(RANDOM_TOAST_X64)
+    RANDOM_STREAM_FILL_PATH path = CurrentFillPath();
+    if (path == RANDOM_STREAM_FILL_AVX2)
+    {
+        index = FillAvx2(_state0, _state1, values, count);
+    }
+    else if (path == RANDOM_STREAM_FILL_SSE2)
+    {
+        index = FillSse2(_state0, _state1, values, count);
+    }
+#endif
+
+    // everything on the scalar path, and whatever is left over on the others
+    unsigned long long results[NUM_LANES];
+    while (index < count)
+    {
+        Step(results);
+        for (unsigned int lane = 0; lane < NUM_LANES && index < count; lane++, index++)
+        {
+            values[index] = TopBitsOnRange0to1(results[lane]);
+        }
+    }
+}
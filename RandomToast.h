@@ -23,3 +23,78 @@ float RandomOnRange0to1();
 unsigned long Random();
 long RandomPosAndNeg();
 glm::vec3 RandomColor();
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Everything that one random number from CounterRandom(...) depends on.  Unlike the
+    functions above, there is no hidden state, so the same key always gives the same number
+    on any thread, in any order, and on the GPU (see RandomOnRange0To1() in
+    particleReset.comp, which must stay identical).
+
+    Particle emission uses the simulation's seed, the number of the frame, and the index of
+    the particle being emitted, and each draw for that particle bumps _drawIndex.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+struct CounterRandomKey
+{
+    unsigned int _seed;
+    unsigned int _frame;
+    unsigned int _particleIndex;
+    unsigned int _drawIndex;
+};
+
+unsigned int CounterRandomHash(unsigned int value);
+unsigned int CounterRandom(CounterRandomKey &key);
+float RandomOnRange0to1(CounterRandomKey &key);
+
+// the ways that RandomStream::Fill(...) can step the lanes
+enum RANDOM_STREAM_FILL_PATH
+{
+    RANDOM_STREAM_FILL_SCALAR = 0,
+    RANDOM_STREAM_FILL_SSE2,
+    RANDOM_STREAM_FILL_AVX2
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The functions at the top of this file share one global generator, which is not safe to
+    use from more than one thread, and they make one number per call.  This is a generator
+    object instead, one per thread, that makes numbers in bulk with Fill(...).
+
+    It is four xorshift128+ generators ("lanes") side by side, so that one step of all four is
+    a handful of 64bit vector instructions: 4 at a time with AVX2, 2 at a time with SSE2, and
+    plain C++ on CPUs (or compilers) that have neither.  Like QuadrantClassification, the best
+    path that the CPU supports is picked the first time that Fill(...) is called, and every
+    path gives the same numbers in the same order.
+
+    Streams: Every (seed, stream index) pair is its own reproducible sequence, so each worker
+    thread can take the stream with its own index and not share anything with the others.  The
+    lanes are seeded with splitmix64, as the xorshift authors recommend, and each stream gets
+    its own run of splitmix64 outputs, so no two lanes of any two streams start out the same.
+
+    Note: xorshift128+ is fast and good enough for particles, but not for anything that needs
+    its lowest bits (they are weak), so the floats only use the top 24 bits.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class RandomStream
+{
+public:
+    RandomStream(unsigned long long seed, unsigned int streamIndex);
+
+    unsigned long long Next();
+    float NextOnRange0to1();
+    void Fill(float *values, unsigned int count);
+
+    static RANDOM_STREAM_FILL_PATH BestFillPath();
+    static RANDOM_STREAM_FILL_PATH CurrentFillPath();
+    static bool SetFillPath(RANDOM_STREAM_FILL_PATH path);
+
+    static const unsigned int NUM_LANES = 4;
+
+private:
+    void Step(unsigned long long *results);
+
+    // each lane's 128 bits of state
+    unsigned long long _state0[NUM_LANES];
+    unsigned long long _state1[NUM_LANES];
+};
@@ -0,0 +1,113 @@
+// random_toast_tests: Every path of RandomStream::Fill(...) that the CPU can run must give the
+// same numbers as the scalar path, which is Step() one lane step at a time.
+
+#include <vector>
+
+#include "RandomToast.h"
+#include "TestChecks.h"
+
+static const char *const gFillPathNames[] =
+{
+    "scalar", "SSE2", "AVX2"
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Fills with the path, in pieces whose sizes aren't all multiples of the lane count, so
+    that the vector loops' leftovers and the state that they write back are both used.  A
+    Next() in the middle checks that lane 0's state was written back where Next() expects it.
+Parameters:
+    path            Self-explanatory
+    seed            Self-explanatory
+    streamIndex     Self-explanatory
+Returns:
+    Every number from the fills and the Next(), as floats.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static std::vector<float> FillInPieces(RANDOM_STREAM_FILL_PATH path, unsigned long long seed,
+    unsigned int streamIndex)
+{
+    const unsigned int pieceSizes[] = { 1, 3, 4, 5, 7, 8, 0, 1000, 1003, 2 };
+
+    RandomStream::SetFillPath(path);
+    RandomStream random(seed, streamIndex);
+    std::vector<float> values;
+    for (size_t pieceIndex = 0; pieceIndex < sizeof(pieceSizes) / sizeof(pieceSizes[0]); pieceIndex++)
+    {
+        size_t start = values.size();
+        values.resize(start + pieceSizes[pieceIndex]);
+        random.Fill(values.data() + start, pieceSizes[pieceIndex]);
+        if (pieceIndex == 4)
+        {
+            values.push_back(random.NextOnRange0to1());
+        }
+    }
+
+    return values;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Compares each of the CPU's paths with the scalar path for a few seeds and streams, and
+    checks that the numbers are on [0,+1) and not all the same.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void TestFillPathsMatchScalar()
+{
+    const unsigned long long seeds[] = { 0, 1, 5, 0xFFFFFFFFFFFFFFFFull };
+    const unsigned int streamIndices[] = { 0, 1, 7 };
+
+    RANDOM_STREAM_FILL_PATH bestPath = RandomStream::BestFillPath();
+    printf("best RandomStream::Fill(...) path: %s\n", gFillPathNames[bestPath]);
+    for (size_t seedIndex = 0; seedIndex < sizeof(seeds) / sizeof(seeds[0]); seedIndex++)
+    {
+        for (size_t streamIndex = 0; streamIndex < sizeof(streamIndices) / sizeof(streamIndices[0]); streamIndex++)
+        {
+            unsigned long long seed = seeds[seedIndex];
+            unsigned int stream = streamIndices[streamIndex];
+            std::vector<float> scalarValues = FillInPieces(RANDOM_STREAM_FILL_SCALAR, seed, stream);
+
+            bool allInRange = true;
+            for (size_t valueIndex = 0; valueIndex < scalarValues.size(); valueIndex++)
+            {
+                float value = scalarValues[valueIndex];
+                allInRange = allInRange && (value >= 0.0f) && (value < 1.0f);
+            }
+            TEST_CHECK(allInRange, "seed %llu, stream %u", seed, stream);
+            TEST_CHECK(scalarValues[0] != scalarValues[1], "seed %llu, stream %u", seed, stream);
+
+            for (int path = RANDOM_STREAM_FILL_SSE2; path <= bestPath; path++)
+            {
+                std::vector<float> values = FillInPieces((RANDOM_STREAM_FILL_PATH)path, seed,
+                    stream);
+                size_t firstDifference = 0;
+                while (firstDifference < values.size() &&
+                    values[firstDifference] == scalarValues[firstDifference])
+                {
+                    firstDifference++;
+                }
+                TEST_CHECK(firstDifference == scalarValues.size(),
+                    "%s, seed %llu, stream %u: differs from scalar at value %u", gFillPathNames[path],
+                    seed, stream, (unsigned int)firstDifference);
+            }
+        }
+    }
+
+    // the paths that the CPU can't run are refused, and the current path doesn't change
+    TEST_CHECK(RandomStream::SetFillPath(bestPath), "%s", gFillPathNames[bestPath]);
+    if (bestPath < RANDOM_STREAM_FILL_AVX2)
+    {
+        TEST_CHECK(!RandomStream::SetFillPath(RANDOM_STREAM_FILL_AVX2), "%s",
+            gFillPathNames[bestPath]);
+        TEST_CHECK(RandomStream::CurrentFillPath() == bestPath, "%s", gFillPathNames[bestPath]);
+    }
+}
+
+int main()
+{
+    TestFillPathsMatchScalar();
+
+    return TestExitCode("random_toast_tests");
+}
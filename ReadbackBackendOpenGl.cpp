@@ -0,0 +1,125 @@
+#include "ReadbackBackendOpenGl.h"
+
+#include "glload/include/glload/gl_4_4.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Generates a buffer with immutable storage and maps all of it for reading.  The mapping is 
+    persistent, so it stays valid while the GPU copies into the buffer, and coherent, so that 
+    once a fence after the copy is signaled, the CPU sees the copy without any other calls.
+Parameters: 
+    sizeBytes   Self-explanatory.
+    mappedPtr   Receives the mapped pointer, or 0 if it couldn't be mapped.
+Returns:    
+    The buffer's ID, or 0 if the buffer could not be mapped.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int ReadbackBackendOpenGl::CreatePersistentReadBuffer(unsigned int sizeBytes, 
+    const void **mappedPtr)
+{
+    GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    GLuint bufferId = 0;
+    glGenBuffers(1, &bufferId);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, bufferId);
+    glBufferStorage(GL_COPY_WRITE_BUFFER, sizeBytes, 0, flags);
+    *mappedPtr = glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, sizeBytes, flags);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    if (*mappedPtr == 0)
+    {
+        glDeleteBuffers(1, &bufferId);
+        return 0;
+    }
+
+    return bufferId;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Unmaps and deletes a buffer from CreatePersistentReadBuffer(...).
+Parameters: 
+    bufferId    Self-explanatory.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ReadbackBackendOpenGl::DeletePersistentReadBuffer(unsigned int bufferId)
+{
+    glBindBuffer(GL_COPY_WRITE_BUFFER, bufferId);
+    glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glDeleteBuffers(1, &bufferId);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Queues a buffer-to-buffer copy on the GPU.  Nothing is transferred to system memory here; 
+    the destination is already mapped.
+
+    Note: The compute shaders wrote the source through a shader storage block, and 
+    glCopyBufferSubData(...) needs the buffer update barrier to see those writes.
+Parameters: 
+    sourceBufferId      Self-explanatory.
+    destinationBufferId Self-explanatory.
+    sizeBytes           How much to copy from the start of the source.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ReadbackBackendOpenGl::CopyBuffer(unsigned int sourceBufferId, 
+    unsigned int destinationBufferId, unsigned int sizeBytes)
+{
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glBindBuffer(GL_COPY_READ_BUFFER, sourceBufferId);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, destinationBufferId);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, sizeBytes);
+
+    // cleanup
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Self-explanatory.
+Parameters: None
+Returns:    
+    A GLsync, as an opaque pointer.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void *ReadbackBackendOpenGl::InsertFence()
+{
+    return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Waits for the fence, or just checks it if the timeout is 0.
+
+    Note: The flush makes sure that the fence actually gets to the GPU.  Without it, waiting on 
+    a fence that is still in the driver's command queue would wait out the whole timeout.
+Parameters: 
+    fence               From InsertFence().
+    timeoutNanoseconds  Self-explanatory.
+Returns:    
+    True if the fence was signaled before the timeout, otherwise false.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+bool ReadbackBackendOpenGl::WaitForFence(void *fence, unsigned long long timeoutNanoseconds)
+{
+    GLenum result = glClientWaitSync(static_cast<GLsync>(fence), GL_SYNC_FLUSH_COMMANDS_BIT, 
+        timeoutNanoseconds);
+    return (result == GL_ALREADY_SIGNALED) || (result == GL_CONDITION_SATISFIED);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Self-explanatory.
+Parameters: 
+    fence   From InsertFence().
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void ReadbackBackendOpenGl::DeleteFence(void *fence)
+{
+    glDeleteSync(static_cast<GLsync>(fence));
+}
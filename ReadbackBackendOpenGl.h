@@ -0,0 +1,22 @@
+#pragma once
+
+#include "IReadbackBackend.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The OpenGL implementation of IReadbackBackend.  Requires OpenGL 4.4 for 
+    glBufferStorage(...), and like the SSBOs, the OpenGL context must be started before any of 
+    these are called.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class ReadbackBackendOpenGl : public IReadbackBackend
+{
+public:
+    unsigned int CreatePersistentReadBuffer(unsigned int sizeBytes, const void **mappedPtr) override;
+    void DeletePersistentReadBuffer(unsigned int bufferId) override;
+    void CopyBuffer(unsigned int sourceBufferId, unsigned int destinationBufferId, 
+        unsigned int sizeBytes) override;
+    void *InsertFence() override;
+    bool WaitForFence(void *fence, unsigned long long timeoutNanoseconds) override;
+    void DeleteFence(void *fence) override;
+};
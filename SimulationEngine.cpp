@@ -0,0 +1,1259 @@
+#include "SimulationEngine.h"
+
+#include "RandomToast.h"
+#include "CompactParticleQuadTree.h"
+#include "ParticleUniformGrid.h"
+#include "glm/detail/func_geometric.hpp"     // for dot(...)
+#include "glm/detail/func_exponential.hpp"   // for inversesqrt(...)
+
+#include <algorithm>    // for std::copy(...)
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The CPU version of the shaders' QuickNormalize(...).  A convenience function so that I
+    don't have to type the vector name three times.
+Parameters:
+    v   The vec4 to be normalized.
+Returns:
+    A normalized copy of input v.
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+static inline glm::vec4 QuickNormalize(const glm::vec4 &v)
+{
+    return glm::inversesqrt(glm::dot(v, v)) * v;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The CPU version of the shaders' LinearMix(...).
+Parameters:
+    v1              The start of the linear blend.
+    v2              The end of the linear blend.
+    between0And1    Some fraction of the difference between v1 and v2.
+Returns:
+    A vec4 that is linearly blended according to between0And1.
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+static inline glm::vec4 LinearMix(const glm::vec4 &v1, const glm::vec4 &v2, float between0And1)
+{
+    return (v1 * (1.0f - between0And1)) + (v2 * between0And1);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The CPU version of particleReset.comp's RandomOnRangeNeg1ToPos1().
+Parameters:
+    randomKey   The emitted particle's key.  Each draw increments its draw index.
+Returns:
+    A semi-random float on the range [-1,+1].
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+static inline float RandomOnRangeNeg1ToPos1(CounterRandomKey &randomKey)
+{
+    if (RandomOnRange0to1(randomKey) < 0.5f)
+    {
+        return -1.0f * RandomOnRange0to1(randomKey);
+    }
+    else
+    {
+        return +1.0f * RandomOnRange0to1(randomKey);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives members initial values and allocates the particle collection and quad tree.  All
+    particles start inactive, just like the particle SSBO in main.cpp.
+Parameters:
+    numParticles            How many particles this simulation runs.
+    particleRegionCenter    The region of validity is a circle.  This is the center.
+    particleRegionRadius    Self-explanatory in light of the center.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+SimulationEngine::SimulationEngine(unsigned int numParticles,
+    const glm::vec4 &particleRegionCenter, float particleRegionRadius) :
+    _numParticles(numParticles),
+    _activeParticleCount(0),
+    _particleRegionCenter(particleRegionCenter),
+    _particleRegionRadius(particleRegionRadius),
+    _particleRegionRadiusSqr(particleRegionRadius * particleRegionRadius),
+    _allParticles(numParticles),
+    _activeParticleIndicesAreCurrent(false),
+    _useParticleFreeList(false),
+    _randomSeed(0),
+    _resetFrameNumber(0),
+    _pQuadTree(0),
+    _incrementalTreeUpdates(false),
+    _pSpatialIndex(0),
+    _pCollisionNodes(0),
+    _numCollisionNodes(0),
+    _pCollisionLeafIndices(0),
+    _pCollisionSpatialIndex(0),
+    _symmetricCollisions(false),
+    _deterministicCollisions(false),
+    _collisionWorkers(1),
+    _pCollisionTaskPool(0)
+{
+    _pQuadTree = new ParticleQuadTree(particleRegionCenter, particleRegionRadius, numParticles);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Cleans up the quad tree, the spatial index, and the collision threads.  Emitters are not 
+    deleted because they are not owned.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+SimulationEngine::~SimulationEngine()
+{
+    delete _pQuadTree;
+    delete _pSpatialIndex;
+    delete _pCollisionTaskPool;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Adds a point or bar emitter to internal storage.  See
+    ComputeControllerParticleReset::AddEmitter(...).
+Parameters:
+    pEmitter    A pointer to a "particle emitter" interface.
+Returns:
+    True if the emitter was added, otherwise false.
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+bool SimulationEngine::AddEmitter(const IParticleEmitter *pEmitter)
+{
+    return _emitterTable.AddEmitter(pEmitter);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Passes the thread count on to the quad tree.  See ParticleQuadTree::SetNumBuildThreads(...).
+Parameters:
+    numThreads  1 (the default) builds the tree on the calling thread.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::SetNumTreeBuildThreads(unsigned int numThreads)
+{
+    _pQuadTree->SetNumBuildThreads(numThreads);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Switches GenerateQuadTree() between a full rebuild every frame and
+    ParticleQuadTree::UpdateTree(...), which keeps the last frame's tree.
+Parameters:
+    useIncrementalUpdates   false (the default) rebuilds every frame.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::SetIncrementalTreeUpdates(bool useIncrementalUpdates)
+{
+    _incrementalTreeUpdates = useIncrementalUpdates;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Switches GenerateQuadTree() and CollideParticles(...) between ParticleQuadTree and one of 
+    the ISpatialIndex broadphases.  Incremental updates only apply to ParticleQuadTree.  The 
+    others are rebuilt from scratch every frame, but they have no per-leaf or per-cell 
+    particle cap, so no particle is left out of them.
+Parameters:
+    spatialIndexType    SPATIAL_INDEX_QUAD_TREE (the default) uses ParticleQuadTree.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::SetSpatialIndexType(SPATIAL_INDEX_TYPE spatialIndexType)
+{
+    delete _pSpatialIndex;
+    _pSpatialIndex = 0;
+
+    if (spatialIndexType == SPATIAL_INDEX_COMPACT_QUAD_TREE)
+    {
+        _pSpatialIndex = new CompactParticleQuadTree(_particleRegionCenter, _particleRegionRadius);
+    }
+    else if (spatialIndexType == SPATIAL_INDEX_UNIFORM_GRID)
+    {
+        _pSpatialIndex = new ParticleUniformGrid(_particleRegionCenter, _particleRegionRadius);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Switches CollideParticles(...) between the shaders' approach, where each particle works out 
+    only its own half of every collision (so every pair is worked out twice), and working out 
+    each pair once, from the particle with the lower index, and giving the other particle the 
+    equal and opposite force.  That halves the distance checks and the collision math.
+
+    The symmetric forces are gathered in a CollisionForceAccumulator and added to the 
+    particles at the end, so the particles are only read while the pairs are being worked out.
+
+    Note: A pair is only found if the lower-indexed particle's neighborhood has the other one 
+    in it.  The uniform grid's neighborhoods are symmetric (each is the 3x3 cells around the 
+    particle), so it finds the same collisions either way.  The quad trees' are not always 
+    (a big leaf only looks at the small leaves next to the particle), so with them, a pair 
+    that only one side found is now either counted for both or for neither.
+Parameters:
+    useSymmetricCollisions  false (the default) does what the shaders do.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::SetSymmetricCollisions(bool useSymmetricCollisions)
+{
+    _symmetricCollisions = useSymmetricCollisions;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Spreads CollideParticles(...) over several threads.  The particles are split, in the order 
+    that they are collided in, into tasks of COLLISION_TASK_PARTICLES each, and the tasks run 
+    on a WorkStealingTaskPool.  The order is the spatial index's (Morton order for the quad 
+    trees), so each task is a handful of neighboring leaves, and the emitters' crowded leaves, 
+    which cost far more than the rest, get stolen by whichever threads run out of work first.
+
+    One-sided collisions only ever change the particle that is being collided, and each 
+    particle is in exactly one task, so they give exactly the same result on any number of 
+    threads.  Symmetric collisions give each thread its own accumulator, but which thread 
+    gets which particle changes from frame to frame, and so does the order that the forces 
+    on a particle are added up in.  See SetDeterministicCollisions(...).
+Parameters:
+    numThreads  1 (the default) collides on the calling thread.  0 is treated as 1.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::SetNumCollisionThreads(unsigned int numThreads)
+{
+    numThreads = (numThreads > 0) ? numThreads : 1;
+
+    delete _pCollisionTaskPool;
+    _pCollisionTaskPool = 0;
+    if (numThreads > 1)
+    {
+        _pCollisionTaskPool = new WorkStealingTaskPool(numThreads);
+    }
+
+    // Note: Each worker's accumulator is allocated on the first symmetric frame that uses it.
+    _collisionWorkers.clear();
+    _collisionWorkers.resize(numThreads);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Makes symmetric collisions on more than one thread give exactly the same result, to the 
+    bit, as on one thread.  Instead of adding its forces up as it goes, each task records 
+    them, and once every task is done, the records are added up in task order, which is the 
+    order that one thread would have added them up in.
+
+    That last part runs on one thread, so this costs some of what the extra threads gained.  
+    It has no effect on one-sided collisions, which are always deterministic, or on one 
+    thread.
+Parameters:
+    useDeterministicCollisions  false (the default) lets the threads add up their own forces.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::SetDeterministicCollisions(bool useDeterministicCollisions)
+{
+    _deterministicCollisions = useDeterministicCollisions;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The CPU version of ComputeControllerParticleReset::SetUseParticleFreeList(...).  If true, 
+    UpdateParticles(...) pushes every particle that it deactivates onto a stack, and 
+    ResetParticles(...) pops the particles that it emits off of it instead of going through 
+    every particle.
+
+    Unlike on the GPU, this can be turned on at any time, because the stack is filled with 
+    whatever particles are inactive right then, in reverse so that the first pops come out in 
+    index order.  Later pops come out in the order that the particles died, so the particles 
+    that are picked, and so the results, are not the same as without it.
+Parameters:
+    useParticleFreeList     false (the default) looks for inactive particles every reset.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::SetUseParticleFreeList(bool useParticleFreeList)
+{
+    _useParticleFreeList = useParticleFreeList;
+    _freeParticleIndices.clear();
+    if (!useParticleFreeList)
+    {
+        return;
+    }
+
+    _freeParticleIndices.reserve(_numParticles);
+    for (unsigned int particleIndex = _numParticles; particleIndex > 0; particleIndex--)
+    {
+        if (_allParticles[particleIndex - 1]._isActive == 0)
+        {
+            _freeParticleIndices.push_back(particleIndex - 1);
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The CPU version of ComputeControllerParticleReset::SetRandomSeed(...).  Also starts the 
+    frame count over, so a simulation that is given the same seed, emitters, and frames as 
+    the GPU's spawns the same particles with the same random numbers.
+Parameters:
+    randomSeed  0 (the default) or anything else.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::SetRandomSeed(unsigned int randomSeed)
+{
+    _randomSeed = randomSeed;
+    _resetFrameNumber = 0;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Replaces every particle, for starting the simulation from a saved or made up state 
+    instead of from the emitters.  The active list and the free list (if it is in use) are 
+    made again from the new particles.
+Parameters:
+    particleCollection  NumParticles() particles.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::SetParticles(const Particle *particleCollection)
+{
+    std::copy(particleCollection, particleCollection + _numParticles, _allParticles.begin());
+    CompactActiveParticles();
+    _activeParticleCount = (unsigned int)_activeParticleIndices.size();
+    SetUseParticleFreeList(_useParticleFreeList);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs one whole frame in the same order as UpdateAllTheThings() in main.cpp.
+Parameters:
+    particlesPerEmitterPerFrame     See ResetParticles(...).
+    deltaTimeSec                    Self-explanatory.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::Update(unsigned int particlesPerEmitterPerFrame, float deltaTimeSec)
+{
+    ResetParticles(particlesPerEmitterPerFrame);
+    UpdateParticles(deltaTimeSec);
+    GenerateQuadTree();
+    CollideParticles(deltaTimeSec);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The CPU version of particleReset.comp.  One pass over the particle collection gives each
+    inactive particle the next number, and the first particlesPerEmitterPerFrame numbers go
+    to the first emitter in the table, the next particlesPerEmitterPerFrame to the second, and
+    so on.  That picks the same particles, in the same order, as a pass per emitter, point
+    emitters first and then bar emitters.  With the free list (see 
+    SetUseParticleFreeList(...)), the numbers are handed out to popped particles instead.
+
+    Each call is one frame of random numbers (see EmitParticle(...)).
+Parameters:
+    particlesPerEmitterPerFrame     Limits the number of particles that are reset per frame
+                                    so that they don't all spawn at once.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::ResetParticles(unsigned int particlesPerEmitterPerFrame)
+{
+    _activeParticleIndicesAreCurrent = false;
+    _resetFrameNumber++;
+
+    const ParticleEmitterData *emitters = _emitterTable.Emitters();
+    unsigned int maxParticlesEmitted = _emitterTable.NumEmitters() * particlesPerEmitterPerFrame;
+
+    if (_useParticleFreeList)
+    {
+        for (unsigned int resetParticleCounter = 0; 
+            resetParticleCounter < maxParticlesEmitted && !_freeParticleIndices.empty(); 
+            resetParticleCounter++)
+        {
+            const ParticleEmitterData &emitter = 
+                emitters[resetParticleCounter / particlesPerEmitterPerFrame];
+            EmitParticle(_freeParticleIndices.back(), emitter);
+            _freeParticleIndices.pop_back();
+        }
+        return;
+    }
+
+    unsigned int resetParticleCounter = 0;
+    for (unsigned int particleIndex = 0; 
+        particleIndex < _numParticles && resetParticleCounter < maxParticlesEmitted; 
+        particleIndex++)
+    {
+        if (_allParticles[particleIndex]._isActive == 0)
+        {
+            const ParticleEmitterData &emitter = 
+                emitters[resetParticleCounter / particlesPerEmitterPerFrame];
+            EmitParticle(particleIndex, emitter);
+            resetParticleCounter++;
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The CPU version of particleUpdate.comp.  Applies last frame's net force, moves the
+    particle, deactivates it if it left the particle region, and then clears the force and
+    collision count for this frame.
+
+    As with ComputeControllerActiveParticleCompaction, the active particles are listed first 
+    and only the list is gone over.
+Parameters:
+    deltaTimeSec    Self-explanatory
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::UpdateParticles(float deltaTimeSec)
+{
+    CompactActiveParticles();
+    _activeParticleCount = (unsigned int)_activeParticleIndices.size();
+    for (unsigned int activeCount = 0; activeCount < _activeParticleCount; activeCount++)
+    {
+        Particle &p = _allParticles[_activeParticleIndices[activeCount]];
+
+        glm::vec4 acceleration = p._netForceThisFrame / p._mass;
+        p._velocity += (acceleration * deltaTimeSec);
+        p._position += (p._velocity * deltaTimeSec);
+
+        // partial pythagorean theorem
+        float x = p._position.x - _particleRegionCenter.x;
+        float y = p._position.y - _particleRegionCenter.y;
+        float distToParticleSqr = (x * x) + (y * y);
+        if (distToParticleSqr > _particleRegionRadiusSqr)
+        {
+            p._isActive = 0;
+            if (_useParticleFreeList)
+            {
+                _freeParticleIndices.push_back(_activeParticleIndices[activeCount]);
+            }
+        }
+
+        p._netForceThisFrame = glm::vec4();
+        p._collisionCountThisFrame = 0;
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Rebuilds (or updates, see SetIncrementalTreeUpdates(...)) the quad tree from the current
+    particle positions.  This is the same thing that main.cpp does with the mapped particle
+    buffer.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::GenerateQuadTree()
+{
+    if (_pSpatialIndex != 0)
+    {
+        _pSpatialIndex->Build(_allParticles.data(), _numParticles);
+    }
+    else if (_incrementalTreeUpdates)
+    {
+        _pQuadTree->UpdateTree(_allParticles.data(), _numParticles);
+    }
+    else
+    {
+        _pQuadTree->ResetTree();
+        _pQuadTree->AddParticlestoTree(_allParticles.data(), _numParticles);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The CPU version of ParticleCollisions.comp.  Every active particle finds its leaf, gathers
+    the particles within collision range from that leaf and its neighbors, and then
+    accumulates the collision force from each of them.
+
+    Note: As in the shader, only the first particle of each pair is altered, and only its
+    force and collision count are altered, so the result does not depend on the order in which
+    the particles are handled.  Symmetric collisions (see SetSymmetricCollisions(...)) alter 
+    both, but only through an accumulator, so the same is true of them.
+Parameters:
+    deltaTimeSec    Self-explanatory
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::CollideParticles(float deltaTimeSec)
+{
+    if (_pSpatialIndex != 0)
+    {
+        CollideParticles(deltaTimeSec, _pSpatialIndex);
+        return;
+    }
+
+    _pCollisionNodes = _pQuadTree->QuadTreeBuffer();
+    _pCollisionSpatialIndex = 0;
+    _numCollisionNodes = _pQuadTree->NumActiveNodes();
+    _pCollisionLeafIndices = 0;
+
+    // walk the particles in the tree's Morton order if it has one so that particles in the
+    // same and neighboring nodes are handled one after another
+    CollideParticlesInOrder(deltaTimeSec, _pQuadTree->SortedParticleIndices(), 
+        _pQuadTree->NumSortedParticles());
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Like the other CollideParticles(...), but against quad tree nodes that were built somewhere 
+    else, such as by FrameScheduler's tree-builder thread.  This is the CPU equivalent of 
+    uploading a quad tree to the collision shader.
+Parameters:
+    deltaTimeSec    Self-explanatory
+    allNodes        A copy of a ParticleQuadTree's node buffer.
+    numNodes        How many nodes are in allNodes.  Nothing at or above this index is read.
+    particleLeafIndices     The leaf that the tree put each particle in (see 
+                    ParticleQuadTree::CopyParticleLeafIndices(...)), so that FindLeafNode(...) 
+                    doesn't have to walk the tree.  May be 0.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::CollideParticles(float deltaTimeSec, const ParticleQuadTreeNode *allNodes,
+    unsigned int numNodes, const unsigned int *particleLeafIndices)
+{
+    _pCollisionNodes = allNodes;
+    _pCollisionSpatialIndex = 0;
+    _numCollisionNodes = numNodes;
+    _pCollisionLeafIndices = particleLeafIndices;
+    CollideParticlesInOrder(deltaTimeSec, 0, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Like the other CollideParticles(...), but against an ISpatialIndex that was built 
+    somewhere else (or this engine's own, see SetSpatialIndexType(...)).  The particles are 
+    handled in pool order, which keeps particles that are close together one after another.
+
+    Note: The index must have been built from this engine's particles, over the same particle 
+    region.
+Parameters:
+    deltaTimeSec    Self-explanatory
+    pSpatialIndex   Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::CollideParticles(float deltaTimeSec, const ISpatialIndex *pSpatialIndex)
+{
+    _pCollisionNodes = 0;
+    _numCollisionNodes = 0;
+    _pCollisionLeafIndices = 0;
+    _pCollisionSpatialIndex = pSpatialIndex;
+    CollideParticlesInOrder(deltaTimeSec, pSpatialIndex->ParticleIndexPool(), 
+        pSpatialIndex->ParticleIndexPoolSize());
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The body of CollideParticles(...) once the nodes to collide against are known.
+Parameters:
+    deltaTimeSec            Self-explanatory
+    sortedParticleIndices   The order to handle the particles in.  May be 0.
+    numSortedParticles      If 0, particles are handled in index order, using the active 
+                            particle list if it is current.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::CollideParticlesInOrder(float deltaTimeSec, 
+    const int *sortedParticleIndices, unsigned int numSortedParticles)
+{
+    // see ComputeControllerParticleCollisions::Update(...) for why this is inverted up front
+    float inverseDeltaTimeSec = 1.0f / deltaTimeSec;
+
+    bool symmetric = _symmetricCollisions;
+    bool recordForces = symmetric && _deterministicCollisions && (_pCollisionTaskPool != 0);
+    if (symmetric)
+    {
+        // only worker 0's accumulator is needed if the forces are recorded
+        size_t numAccumulators = recordForces ? 1 : _collisionWorkers.size();
+        for (size_t workerIndex = 0; workerIndex < numAccumulators; workerIndex++)
+        {
+            CollisionForceAccumulator &accumulator = _collisionWorkers[workerIndex]._accumulator;
+            if (accumulator._netForces.empty())
+            {
+                accumulator._netForces.resize(_numParticles, glm::vec2(0.0f));
+                accumulator._collisionCounts.resize(_numParticles, 0);
+            }
+        }
+    }
+
+    // with no order of its own, go over the active particle list instead of every particle
+    // Note: The list is in index order, so this is the same order minus the inactive 
+    // particles.
+    if (numSortedParticles == 0 && _activeParticleIndicesAreCurrent && 
+        !_activeParticleIndices.empty())
+    {
+        sortedParticleIndices = _activeParticleIndices.data();
+        numSortedParticles = (unsigned int)_activeParticleIndices.size();
+    }
+
+    unsigned int numParticlesToCollide = (numSortedParticles > 0) ? numSortedParticles : _numParticles;
+    if (_pCollisionTaskPool == 0)
+    {
+        CollideParticlesInRange(sortedParticleIndices, numSortedParticles, 0, 
+            numParticlesToCollide, inverseDeltaTimeSec, symmetric, _collisionWorkers[0]);
+    }
+    else
+    {
+        unsigned int numTasks = 
+            (numParticlesToCollide + COLLISION_TASK_PARTICLES - 1) / COLLISION_TASK_PARTICLES;
+        if (recordForces && _collisionTaskRecords.size() < numTasks)
+        {
+            _collisionTaskRecords.resize(numTasks);
+        }
+
+        _pCollisionTaskPool->Run(numTasks, 
+            [&](unsigned int taskIndex, unsigned int workerIndex)
+        {
+            CollisionWorker &worker = _collisionWorkers[workerIndex];
+            worker._pTaskRecords = recordForces ? &_collisionTaskRecords[taskIndex] : 0;
+
+            unsigned int beginCount = taskIndex * COLLISION_TASK_PARTICLES;
+            unsigned int endCount = beginCount + COLLISION_TASK_PARTICLES;
+            endCount = (endCount < numParticlesToCollide) ? endCount : numParticlesToCollide;
+            CollideParticlesInRange(sortedParticleIndices, numSortedParticles, beginCount, 
+                endCount, inverseDeltaTimeSec, symmetric, worker);
+
+            worker._pTaskRecords = 0;
+        });
+
+        if (recordForces)
+        {
+            ReplayCollisionForceRecords(numTasks);
+        }
+    }
+
+    if (symmetric)
+    {
+        ReduceCollisionForces();
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Collides the particles in one stretch of the collision order.  The whole order when there 
+    is one collision thread, or one task's worth when there are more.
+Parameters:
+    sortedParticleIndices   The order to handle the particles in.  May be 0.
+    numSortedParticles      If 0, particles are handled in index order.
+    beginCount              The first place in the order to handle.
+    endCount                One past the last place in the order to handle.
+    inverseDeltaTimeSec     Self-explanatory.
+    symmetric               See SetSymmetricCollisions(...).
+    worker                  The collision thread's own scratch space and accumulator.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::CollideParticlesInRange(const int *sortedParticleIndices, 
+    unsigned int numSortedParticles, unsigned int beginCount, unsigned int endCount, 
+    float inverseDeltaTimeSec, bool symmetric, CollisionWorker &worker)
+{
+    for (unsigned int particleCount = beginCount; particleCount < endCount; particleCount++)
+    {
+        unsigned int particleIndex = (numSortedParticles > 0) ?
+            (unsigned int)sortedParticleIndices[particleCount] : particleCount;
+        if (_allParticles[particleIndex]._isActive == 0)
+        {
+            continue;
+        }
+
+        if (_pCollisionSpatialIndex != 0)
+        {
+            CollideParticleWithSpatialIndex(particleIndex, inverseDeltaTimeSec, symmetric, 
+                worker);
+            continue;
+        }
+
+        unsigned int leafNodeIndex = FindLeafNode(particleIndex);
+        PopulateCollidableParticlesArray(particleIndex, leafNodeIndex, worker);
+        for (unsigned int pCounter = 0; pCounter < worker._numCollidableParticles; pCounter++)
+        {
+            unsigned int p2Index = worker._collidableParticleArray[pCounter];
+            if (!symmetric)
+            {
+                ParticleCollisionP1WithP2(_allParticles[particleIndex], _allParticles[p2Index], 
+                    inverseDeltaTimeSec);
+            }
+            else if (p2Index > particleIndex)
+            {
+                ParticleCollisionSymmetric(particleIndex, p2Index, inverseDeltaTimeSec, worker);
+            }
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the size of the particle collection.
+Parameters: None
+Returns:
+    See description.
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int SimulationEngine::NumParticles() const
+{
+    return _numParticles;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of particles that were active on the last
+    UpdateParticles(...) call.  Mirrors ComputeControllerParticleUpdate::NumActiveParticles().
+Parameters: None
+Returns:
+    See description.
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int SimulationEngine::NumActiveParticles() const
+{
+    return _activeParticleCount;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Returns a pointer to the particle collection.  Useful for checking results or for
+    uploading them somewhere.
+Parameters: None
+Returns:
+    See description.
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+const Particle *SimulationEngine::ParticleBuffer() const
+{
+    return _allParticles.data();
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Returns a pointer to the quad tree that was populated on the last GenerateQuadTree() call.
+Parameters: None
+Returns:
+    See description.
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+const ParticleQuadTree *SimulationEngine::QuadTree() const
+{
+    return _pQuadTree;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Like QuadTree(), but for the ISpatialIndex that SetSpatialIndexType(...) picked.
+Parameters: None
+Returns:
+    See description.  0 if ParticleQuadTree is being used.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+const ISpatialIndex *SimulationEngine::SpatialIndex() const
+{
+    return _pSpatialIndex;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The CPU version of particleReset.comp's PointEmitterResetPos(...).  The math is kept
+    identical to the shader, quirks included, so that both versions emit the same cloud.
+Parameters:
+    emitter     The point emitter to spawn from.
+    randomKey   The particle's random key (see EmitParticle(...)).
+    p           The particle to reset.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::PointEmitterResetPos(const ParticleEmitterData &emitter, 
+    CounterRandomKey &randomKey, Particle &p) const
+{
+    glm::vec4 emitterCenter = emitter._p1;
+    float posX = RandomOnRangeNeg1ToPos1(randomKey);
+    float posY = RandomOnRangeNeg1ToPos1(randomKey);
+
+    // see the shader for why the w component is left out of the normalization
+    glm::vec4 outerPosLimit = 0.1f * QuickNormalize(glm::vec4(posX, posY, 0.0f, 0.0f));
+    glm::vec4 posVariance = LinearMix(emitterCenter, outerPosLimit, RandomOnRange0to1(randomKey));
+    p._position = emitterCenter + posVariance;
+
+    // velocity
+    float velX = RandomOnRangeNeg1ToPos1(randomKey);
+    float velY = RandomOnRangeNeg1ToPos1(randomKey);
+    glm::vec4 randomVelocityVector = QuickNormalize(glm::vec4(velX, velY, 0.0f, 0.0f));
+    float velocityMagnitude = emitter._minVelocity +
+        (RandomOnRange0to1(randomKey) * emitter._deltaVelocity);
+    p._velocity = randomVelocityVector * velocityMagnitude;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The CPU version of particleReset.comp's BarEmitterResetPos(...).
+Parameters:
+    emitter     The bar emitter to spawn from.
+    randomKey   The particle's random key (see EmitParticle(...)).
+    p           The particle to reset.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::BarEmitterResetPos(const ParticleEmitterData &emitter, 
+    CounterRandomKey &randomKey, Particle &p) const
+{
+    // position
+    glm::vec4 start = emitter._p1;
+    glm::vec4 startToEnd = emitter._p2 - start;
+    p._position = start + (RandomOnRange0to1(randomKey) * startToEnd);
+
+    // velocity
+    glm::vec4 velocityDir = QuickNormalize(emitter._emitDir);
+    float velocityMagnitude = emitter._minVelocity +
+        (RandomOnRange0to1(randomKey) * emitter._deltaVelocity);
+    p._velocity = velocityDir * velocityMagnitude;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The CPU version of ParticleCompactActive.comp.  Lists the indices of the active particles 
+    in index order.  The vector keeps its capacity from frame to frame.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::CompactActiveParticles()
+{
+    _activeParticleIndices.clear();
+    for (unsigned int particleIndex = 0; particleIndex < _numParticles; particleIndex++)
+    {
+        if (_allParticles[particleIndex]._isActive != 0)
+        {
+            _activeParticleIndices.push_back((int)particleIndex);
+        }
+    }
+    _activeParticleIndicesAreCurrent = true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Resets one inactive particle to an emitter and activates it.
+
+    Its random numbers are keyed by the seed, the frame, and the particle's index, like
+    particleReset.comp's, so they don't depend on the order that the particles are emitted
+    in, and no other particle's emission changes them.
+Parameters:
+    particleIndex   Self-explanatory
+    emitter         A point or bar emitter from the emitter table.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::EmitParticle(unsigned int particleIndex, 
+    const ParticleEmitterData &emitter)
+{
+    CounterRandomKey randomKey;
+    randomKey._seed = _randomSeed;
+    randomKey._frame = _resetFrameNumber;
+    randomKey._particleIndex = particleIndex;
+    randomKey._drawIndex = 0;
+
+    Particle &p = _allParticles[particleIndex];
+    if (emitter._isBarEmitter == 0)
+    {
+        PointEmitterResetPos(emitter, randomKey, p);
+    }
+    else
+    {
+        BarEmitterResetPos(emitter, randomKey, p);
+    }
+    p._isActive = 1;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The CPU version of ParticleCollisions.comp's FindLeafNode(...).  Starting with the initial
+    subdivision, dives down through subdivisions to find the deepest leaf that the particle
+    occupies.
+
+    If the tree came with the particles' leaf indices, the particle's own is used instead, 
+    but only if it is a leaf in this tree and the particle is still inside it.  With collision 
+    latency, the leaf indices are as old as the tree's snapshot, and a particle's slot may 
+    have been given to a new particle somewhere else since then (see the shader).
+Parameters:
+    particleIndex       Find where this particle is living.
+Returns:
+    See description.
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int SimulationEngine::FindLeafNode(unsigned int particleIndex) const
+{
+    const ParticleQuadTreeNode *allNodes = _pCollisionNodes;
+    const glm::vec4 &particlePos = _allParticles[particleIndex]._position;
+    if (_pCollisionLeafIndices != 0)
+    {
+        // Note: The same bounds as the walk below, so the particle's leaf is only used when 
+        // the walk would have found it anyway.
+        unsigned int leafNodeIndex = _pCollisionLeafIndices[particleIndex];
+        if (leafNodeIndex < _numCollisionNodes && allNodes[leafNodeIndex]._isSubdivided == 0)
+        {
+            const ParticleQuadTreeNode &leaf = allNodes[leafNodeIndex];
+            if (particlePos.x >= leaf._leftEdge && particlePos.x < leaf._rightEdge &&
+                particlePos.y > leaf._bottomEdge && particlePos.y <= leaf._topEdge)
+            {
+                return leafNodeIndex;
+            }
+        }
+    }
+
+
+    // initial subdivision is nodes 0 - 3 (top left, top right, bottom left, bottom right)
+    unsigned int isLeft = (unsigned int)(particlePos.x < _particleRegionCenter.x);
+    unsigned int isTop = (unsigned int)(particlePos.y > _particleRegionCenter.y);
+    unsigned int nodeIndex = ((1 - isTop) * 2) + (1 - isLeft);
+
+    while (allNodes[nodeIndex]._isSubdivided == 1)
+    {
+        const ParticleQuadTreeNode &node = allNodes[nodeIndex];
+        float nodeCenterX = (node._leftEdge + node._rightEdge) * 0.5f;
+        float nodeCenterY = (node._topEdge + node._bottomEdge) * 0.5f;
+
+        isLeft = (unsigned int)(particlePos.x < nodeCenterX);
+        unsigned int isRight = 1 - isLeft;
+        isTop = (unsigned int)(particlePos.y > nodeCenterY);
+        unsigned int isBottom = 1 - isTop;
+
+        // only one of these will be non-zero
+        nodeIndex =
+            (node._childNodeIndexTopLeft * (isLeft * isTop)) +
+            (node._childNodeIndexTopRight * (isRight * isTop)) +
+            (node._childNodeIndexBottomLeft * (isLeft * isBottom)) +
+            (node._childNodeIndexBottomRight * (isRight * isBottom));
+    }
+
+    return nodeIndex;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The CPU version of ParticleCollisions.comp's AddCollidableParticlesFromNode(...).  Runs
+    through the node's particles and adds any that are within collision range to the
+    collidable particle array.
+
+    Note: The shader unrolls this loop and filters without branching.  The CPU is good at
+    branching, so this is a plain loop.
+Parameters:
+    particleIndex   The particle that is being collided.
+    nodeIndex       The node whose particles are being checked.  May be -1 (no neighbor).
+    worker          Has the collidable particle array.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::AddCollidableParticlesFromNode(unsigned int particleIndex,
+    unsigned int nodeIndex, CollisionWorker &worker) const
+{
+    if (nodeIndex == (unsigned int)-1 || nodeIndex >= _numCollisionNodes)
+    {
+        return;
+    }
+
+    const ParticleQuadTreeNode &node = _pCollisionNodes[nodeIndex];
+    const Particle &p1 = _allParticles[particleIndex];
+    for (unsigned int containedCount = 0; containedCount < node._numCurrentParticles; containedCount++)
+    {
+        unsigned int p2Index = node._indicesForContainedParticles[containedCount];
+        if (p2Index == particleIndex || p2Index >= _numParticles)
+        {
+            // a particle colliding with itself would result in a nan line of contact
+            continue;
+        }
+
+        const Particle &p2 = _allParticles[p2Index];
+        glm::vec4 p1ToP2 = p2._position - p1._position;
+        float distanceBetweenSqr = glm::dot(p1ToP2, p1ToP2);
+        float minDistanceForCollision = p1._radiusOfInfluence + p2._radiusOfInfluence;
+        if (distanceBetweenSqr < (minDistanceForCollision * minDistanceForCollision))
+        {
+            worker._collidableParticleArray[worker._numCollidableParticles++] = p2Index;
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The CPU version of ParticleCollisions.comp's PopulateCollidableParticlesArray(...).
+    Gathers the collidable particles from the particle's "home" node and its 8 neighbors.
+Parameters:
+    particleIndex   The particle that is being collided.
+    nodeIndex       The particle's "home" node.
+    worker          Has the collidable particle array.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::PopulateCollidableParticlesArray(unsigned int particleIndex,
+    unsigned int nodeIndex, CollisionWorker &worker) const
+{
+    worker._numCollidableParticles = 0;
+    AddCollidableParticlesFromNode(particleIndex, nodeIndex, worker);
+
+    const ParticleQuadTreeNode &node = _pCollisionNodes[nodeIndex];
+    AddCollidableParticlesFromNode(particleIndex, node._neighborIndexLeft, worker);
+    AddCollidableParticlesFromNode(particleIndex, node._neighborIndexTopLeft, worker);
+    AddCollidableParticlesFromNode(particleIndex, node._neighborIndexTop, worker);
+    AddCollidableParticlesFromNode(particleIndex, node._neighborIndexTopRight, worker);
+    AddCollidableParticlesFromNode(particleIndex, node._neighborIndexRight, worker);
+    AddCollidableParticlesFromNode(particleIndex, node._neighborIndexBottomRight, worker);
+    AddCollidableParticlesFromNode(particleIndex, node._neighborIndexBottom, worker);
+    AddCollidableParticlesFromNode(particleIndex, node._neighborIndexBottomLeft, worker);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The CPU version of the ParticleCollisionsCompact.comp and ParticleCollisionsGrid.comp 
+    shaders.  Asks the spatial index for the runs of its particle index pool that are near 
+    the particle, and collides the particle with the particles in each of them.
+    
+    There is no collidable particle array because the runs are already in one array, and 
+    there is no limit on how many particles are in them.
+Parameters:
+    particleIndex           The particle that is being collided.
+    inverseDeltaTimeSec     Self-explanatory.
+    symmetric               See SetSymmetricCollisions(...).
+    worker                  Where symmetric collisions' forces go.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::CollideParticleWithSpatialIndex(unsigned int particleIndex,
+    float inverseDeltaTimeSec, bool symmetric, CollisionWorker &worker)
+{
+    const glm::vec4 &particlePos = _allParticles[particleIndex]._position;
+    unsigned int runOffsets[ISpatialIndex::MAX_CANDIDATE_RUNS];
+    unsigned int runCounts[ISpatialIndex::MAX_CANDIDATE_RUNS];
+    unsigned int numRuns = _pCollisionSpatialIndex->FindCandidateRuns(particlePos.x, 
+        particlePos.y, runOffsets, runCounts);
+    for (unsigned int runCount = 0; runCount < numRuns; runCount++)
+    {
+        CollideParticleWithPoolRange(particleIndex, runOffsets[runCount], runCounts[runCount], 
+            inverseDeltaTimeSec, symmetric, worker);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Collides a particle with every particle in a run of the particle index pool that is 
+    within collision range.  The same range check as AddCollidableParticlesFromNode(...).
+Parameters:
+    particleIndex           The particle that is being collided.
+    poolOffset              Where the run starts.
+    poolCount               How long the run is.  Clamped to the end of the pool.
+    inverseDeltaTimeSec     Self-explanatory.
+    symmetric               If true, only the particles with higher indices are checked, 
+                            and the collisions are symmetric.
+    worker                  Where symmetric collisions' forces go.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::CollideParticleWithPoolRange(unsigned int particleIndex, 
+    unsigned int poolOffset, unsigned int poolCount, float inverseDeltaTimeSec, 
+    bool symmetric, CollisionWorker &worker)
+{
+    const int *particleIndexPool = _pCollisionSpatialIndex->ParticleIndexPool();
+    unsigned int poolSize = _pCollisionSpatialIndex->ParticleIndexPoolSize();
+    if (poolOffset >= poolSize)
+    {
+        return;
+    }
+
+    unsigned int poolEnd = poolOffset + poolCount;
+    poolEnd = (poolEnd < poolSize) ? poolEnd : poolSize;
+
+    const Particle &p1 = _allParticles[particleIndex];
+    for (unsigned int poolIndex = poolOffset; poolIndex < poolEnd; poolIndex++)
+    {
+        unsigned int p2Index = (unsigned int)particleIndexPool[poolIndex];
+        if (p2Index == particleIndex || p2Index >= _numParticles)
+        {
+            // a particle colliding with itself would result in a nan line of contact
+            continue;
+        }
+        else if (symmetric && p2Index < particleIndex)
+        {
+            // that particle already did this pair
+            continue;
+        }
+
+        const Particle &p2 = _allParticles[p2Index];
+        glm::vec4 p1ToP2 = p2._position - p1._position;
+        float distanceBetweenSqr = glm::dot(p1ToP2, p1ToP2);
+        float minDistanceForCollision = p1._radiusOfInfluence + p2._radiusOfInfluence;
+        if (distanceBetweenSqr < (minDistanceForCollision * minDistanceForCollision))
+        {
+            if (!symmetric)
+            {
+                ParticleCollisionP1WithP2(_allParticles[particleIndex], _allParticles[p2Index], 
+                    inverseDeltaTimeSec);
+            }
+            else
+            {
+                ParticleCollisionSymmetric(particleIndex, p2Index, inverseDeltaTimeSec, worker);
+            }
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The CPU version of ParticleCollisions.comp's ParticleCollisionP1WithP2(...).  Calculates
+    the force of an elastic collision of p2 on p1.  Only p1 is changed.  See the shader for the
+    references on the math.
+
+    Note: Static so that it can be timed by itself (see ParticleMicrobenchmarks.cpp).  It 
+    doesn't need anything from the engine but the two particles.
+Parameters:
+    p1                      The particle to change.
+    p2                      The particle to check against.
+    inverseDeltaTimeSec     Self-explanatory.
+Returns:    None
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::ParticleCollisionP1WithP2(Particle &p1, const Particle &p2, 
+    float inverseDeltaTimeSec)
+{
+    glm::vec4 lineOfContact = p2._position - p1._position;
+    float distanceBetweenSqr = glm::dot(lineOfContact, lineOfContact);
+    glm::vec4 normalizedLineOfContact = glm::inversesqrt(distanceBetweenSqr) * lineOfContact;
+
+    float a1 = glm::dot(p1._velocity, lineOfContact);
+    float a2 = glm::dot(p2._velocity, lineOfContact);
+    float fraction = (2.0f * (a1 - a2)) / (p1._mass + p2._mass);
+    glm::vec4 p1VelocityPrime = p1._velocity - (fraction * p2._mass) * normalizedLineOfContact;
+
+    // delta momentum (impulse) = force * delta time
+    // therefore force = delta momentum / delta time
+    glm::vec4 p1InitialMomentum = p1._velocity * p1._mass;
+    glm::vec4 p1FinalMomentum = p1VelocityPrime * p1._mass;
+    glm::vec4 p1Force = (p1FinalMomentum - p1InitialMomentum) * inverseDeltaTimeSec;
+
+    p1._netForceThisFrame += p1Force;
+    p1._collisionCountThisFrame++;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Like ParticleCollisionP1WithP2(...), but for both particles at once.  p1's force is worked 
+    out the same way, and p2's is the opposite of it.  Working out p2's force on its own gives 
+    the same thing with the particles swapped (the line of contact flips, and so do both 
+    velocities' dot products with it, so the fraction is the same), apart from rounding.
+
+    Neither particle is changed.  The forces and the collision counts go into the worker's 
+    accumulator, or into the worker's task records if it has any (see 
+    SetDeterministicCollisions(...)).
+Parameters:
+    p1Index                 Index into the particle collection for one particle.
+    p2Index                 Index into the particle collection for the other.
+    inverseDeltaTimeSec     Self-explanatory.
+    worker                  Self-explanatory.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::ParticleCollisionSymmetric(unsigned int p1Index, unsigned int p2Index,
+    float inverseDeltaTimeSec, CollisionWorker &worker) const
+{
+    const Particle &p1 = _allParticles[p1Index];
+    const Particle &p2 = _allParticles[p2Index];
+
+    glm::vec4 lineOfContact = p2._position - p1._position;
+    float distanceBetweenSqr = glm::dot(lineOfContact, lineOfContact);
+    glm::vec4 normalizedLineOfContact = glm::inversesqrt(distanceBetweenSqr) * lineOfContact;
+
+    float a1 = glm::dot(p1._velocity, lineOfContact);
+    float a2 = glm::dot(p2._velocity, lineOfContact);
+    float fraction = (2.0f * (a1 - a2)) / (p1._mass + p2._mass);
+    glm::vec4 p1VelocityPrime = p1._velocity - (fraction * p2._mass) * normalizedLineOfContact;
+
+    glm::vec4 p1InitialMomentum = p1._velocity * p1._mass;
+    glm::vec4 p1FinalMomentum = p1VelocityPrime * p1._mass;
+    glm::vec4 p1Force = (p1FinalMomentum - p1InitialMomentum) * inverseDeltaTimeSec;
+    glm::vec2 p1Force2D(p1Force.x, p1Force.y);
+
+    if (worker._pTaskRecords != 0)
+    {
+        CollisionForceRecord record;
+        record._p1Index = p1Index;
+        record._p2Index = p2Index;
+        record._p1Force = p1Force2D;
+        worker._pTaskRecords->push_back(record);
+        return;
+    }
+
+    CollisionForceAccumulator &accumulator = worker._accumulator;
+    accumulator._netForces[p1Index] += p1Force2D;
+    accumulator._netForces[p2Index] -= p1Force2D;
+    accumulator._collisionCounts[p1Index]++;
+    accumulator._collisionCounts[p2Index]++;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Adds up every task's recorded forces in worker 0's accumulator, in task order and in the 
+    order that each task recorded them, which is exactly what ParticleCollisionSymmetric(...) 
+    would have done on one thread.  The records are cleared for the next frame.
+Parameters:
+    numTasks    How many tasks the last run had.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::ReplayCollisionForceRecords(unsigned int numTasks)
+{
+    CollisionForceAccumulator &accumulator = _collisionWorkers[0]._accumulator;
+    for (unsigned int taskIndex = 0; taskIndex < numTasks; taskIndex++)
+    {
+        std::vector<CollisionForceRecord> &taskRecords = _collisionTaskRecords[taskIndex];
+        for (size_t recordIndex = 0; recordIndex < taskRecords.size(); recordIndex++)
+        {
+            const CollisionForceRecord &record = taskRecords[recordIndex];
+            accumulator._netForces[record._p1Index] += record._p1Force;
+            accumulator._netForces[record._p2Index] -= record._p1Force;
+            accumulator._collisionCounts[record._p1Index]++;
+            accumulator._collisionCounts[record._p2Index]++;
+        }
+        taskRecords.clear();
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Adds every collision worker's forces and collision counts to the particles, in worker 
+    order, and clears the accumulators for the next frame.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void SimulationEngine::ReduceCollisionForces()
+{
+    for (unsigned int particleIndex = 0; particleIndex < _numParticles; particleIndex++)
+    {
+        Particle &p = _allParticles[particleIndex];
+        for (size_t workerIndex = 0; workerIndex < _collisionWorkers.size(); workerIndex++)
+        {
+            CollisionForceAccumulator &accumulator = _collisionWorkers[workerIndex]._accumulator;
+            if (accumulator._collisionCounts.empty())
+            {
+                // this worker has never had symmetric collisions
+                continue;
+            }
+
+            unsigned int collisionCount = accumulator._collisionCounts[particleIndex];
+            if (collisionCount == 0)
+            {
+                // no collisions means no force
+                continue;
+            }
+
+            glm::vec2 &netForce = accumulator._netForces[particleIndex];
+            p._netForceThisFrame += glm::vec4(netForce.x, netForce.y, 0.0f, 0.0f);
+            p._collisionCountThisFrame += (int)collisionCount;
+            netForce = glm::vec2(0.0f);
+            accumulator._collisionCounts[particleIndex] = 0;
+        }
+    }
+}
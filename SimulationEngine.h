@@ -0,0 +1,186 @@
+#pragma once
+
+#include "IParticleEmitter.h"
+#include "ParticleEmitterTable.h"
+#include "RandomToast.h"
+#include "ParticleQuadTree.h"
+#include "ISpatialIndex.h"
+#include "Particle.h"
+#include "WorkStealingTaskPool.h"
+#include "glm/vec2.hpp"
+#include "glm/vec4.hpp"
+#include <vector>
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A CPU-only version of the particle pipeline that the demo runs through the compute
+    controllers.  Every frame goes through the same stages as UpdateAllTheThings() in main.cpp:
+    (1) Reset inactive particles to the emitters (particleReset.comp).
+    (2) Integrate active particles and deactivate any that leave the region
+    (particleUpdate.comp).
+    (3) Populate the quad tree (ParticleQuadTree, which was already on the CPU).
+    (4) Calculate particle-particle collision forces (ParticleCollisions.comp).
+
+    No OpenGL context is required, so this can run on machines without a GPU and it serves as
+    the baseline that any CPU-side optimizations are compared against.  The stage functions
+    are ports of the compute shaders and should be kept in step with them.
+
+    Note: Like ComputeControllerParticleReset, this class does not own the emitters.
+Creator:    John Cox (10-16-2026)
+-----------------------------------------------------------------------------------------------*/
+class SimulationEngine
+{
+public:
+    SimulationEngine(unsigned int numParticles, const glm::vec4 &particleRegionCenter,
+        float particleRegionRadius);
+    ~SimulationEngine();
+
+    bool AddEmitter(const IParticleEmitter *pEmitter);
+    void SetNumTreeBuildThreads(unsigned int numThreads);
+    void SetIncrementalTreeUpdates(bool useIncrementalUpdates);
+    void SetSpatialIndexType(SPATIAL_INDEX_TYPE spatialIndexType);
+    void SetSymmetricCollisions(bool useSymmetricCollisions);
+    void SetNumCollisionThreads(unsigned int numThreads);
+    void SetDeterministicCollisions(bool useDeterministicCollisions);
+    void SetUseParticleFreeList(bool useParticleFreeList);
+    void SetRandomSeed(unsigned int randomSeed);
+    void SetParticles(const Particle *particleCollection);
+
+    void Update(unsigned int particlesPerEmitterPerFrame, float deltaTimeSec);
+    void ResetParticles(unsigned int particlesPerEmitterPerFrame);
+    void UpdateParticles(float deltaTimeSec);
+    void GenerateQuadTree();
+    void CollideParticles(float deltaTimeSec);
+    void CollideParticles(float deltaTimeSec, const ParticleQuadTreeNode *allNodes, 
+        unsigned int numNodes, const unsigned int *particleLeafIndices);
+    void CollideParticles(float deltaTimeSec, const ISpatialIndex *pSpatialIndex);
+
+    static void ParticleCollisionP1WithP2(Particle &p1, const Particle &p2, 
+        float inverseDeltaTimeSec);
+
+    unsigned int NumParticles() const;
+    unsigned int NumActiveParticles() const;
+    const Particle *ParticleBuffer() const;
+    const ParticleQuadTree *QuadTree() const;
+    const ISpatialIndex *SpatialIndex() const;
+
+private:
+    // copying would duplicate the ~7MB quad tree, and nothing needs it
+    SimulationEngine(const SimulationEngine &) = delete;
+    SimulationEngine &operator=(const SimulationEngine &) = delete;
+
+    void PointEmitterResetPos(const ParticleEmitterData &emitter, CounterRandomKey &randomKey,
+        Particle &p) const;
+    void BarEmitterResetPos(const ParticleEmitterData &emitter, CounterRandomKey &randomKey,
+        Particle &p) const;
+    void CompactActiveParticles();
+    void EmitParticle(unsigned int particleIndex, const ParticleEmitterData &emitter);
+
+    // the forces and collision counts from one batch of symmetric collisions, kept out of the 
+    // particles until ReduceCollisionForces() so that each batch only writes its own
+    struct CollisionForceAccumulator
+    {
+        std::vector<glm::vec2> _netForces;
+        std::vector<unsigned int> _collisionCounts;
+    };
+
+    // one symmetric collision's force on the lower-indexed particle, as it was worked out; see 
+    // SetDeterministicCollisions(...)
+    struct CollisionForceRecord
+    {
+        unsigned int _p1Index;
+        unsigned int _p2Index;
+        glm::vec2 _p1Force;
+    };
+
+    // the CPU equivalent of the collision shader's per-invocation array
+    // Note: 9 nodes (source node + 8 neighbors) * MAX_PARTICLES_PER_NODE.
+    static const unsigned int MAX_COLLIDABLE_PARTICLES = ParticleQuadTreeNode::MAX_PARTICLES_PER_NODE * 9;
+
+    // everything that one collision thread writes to, so that no two threads share any of it
+    struct CollisionWorker
+    {
+        CollisionWorker() : _numCollidableParticles(0), _pTaskRecords(0) {}
+
+        unsigned int _numCollidableParticles;
+        unsigned int _collidableParticleArray[MAX_COLLIDABLE_PARTICLES];
+        CollisionForceAccumulator _accumulator;
+
+        // if not 0, symmetric collisions are recorded here instead of being accumulated
+        std::vector<CollisionForceRecord> *_pTaskRecords;
+    };
+
+    // how many particles, in collision order, make up one task for the collision threads
+    static const unsigned int COLLISION_TASK_PARTICLES = 256;
+
+    void CollideParticlesInOrder(float deltaTimeSec, const int *sortedParticleIndices,
+        unsigned int numSortedParticles);
+    void CollideParticlesInRange(const int *sortedParticleIndices, 
+        unsigned int numSortedParticles, unsigned int beginCount, unsigned int endCount, 
+        float inverseDeltaTimeSec, bool symmetric, CollisionWorker &worker);
+    unsigned int FindLeafNode(unsigned int particleIndex) const;
+    void AddCollidableParticlesFromNode(unsigned int particleIndex, unsigned int nodeIndex,
+        CollisionWorker &worker) const;
+    void PopulateCollidableParticlesArray(unsigned int particleIndex, unsigned int nodeIndex,
+        CollisionWorker &worker) const;
+    void CollideParticleWithSpatialIndex(unsigned int particleIndex, float inverseDeltaTimeSec,
+        bool symmetric, CollisionWorker &worker);
+    void CollideParticleWithPoolRange(unsigned int particleIndex, unsigned int poolOffset, 
+        unsigned int poolCount, float inverseDeltaTimeSec, bool symmetric, 
+        CollisionWorker &worker);
+    void ParticleCollisionSymmetric(unsigned int p1Index, unsigned int p2Index,
+        float inverseDeltaTimeSec, CollisionWorker &worker) const;
+    void ReplayCollisionForceRecords(unsigned int numTasks);
+    void ReduceCollisionForces();
+
+    unsigned int _numParticles;
+    unsigned int _activeParticleCount;
+    glm::vec4 _particleRegionCenter;
+    float _particleRegionRadius;
+    float _particleRegionRadiusSqr;
+
+    std::vector<Particle> _allParticles;
+
+    // the CPU version of the list in ActiveParticleSsbo; see CompactActiveParticles()
+    // Note: ints because it takes the place of a tree's sorted particle indices when the 
+    // collisions have no order of their own.  It is only current from UpdateParticles(...) 
+    // until the next ResetParticles(...), which may activate particles that aren't in it.
+    std::vector<int> _activeParticleIndices;
+    bool _activeParticleIndicesAreCurrent;
+
+    // the CPU version of ParticleFreeListSsbo; see SetUseParticleFreeList(...)
+    bool _useParticleFreeList;
+    std::vector<unsigned int> _freeParticleIndices;
+
+    // the emission random numbers' key; see SetRandomSeed(...) and EmitParticle(...)
+    unsigned int _randomSeed;
+    unsigned int _resetFrameNumber;
+
+    // heap allocated because the node array inside it is far too big for the stack
+    ParticleQuadTree *_pQuadTree;
+    bool _incrementalTreeUpdates;
+
+    // 0 unless SetSpatialIndexType(...) picked something other than ParticleQuadTree
+    ISpatialIndex *_pSpatialIndex;
+
+    // what CollideParticles(...) is running against; only one of these is non-zero at a time
+    const ParticleQuadTreeNode *_pCollisionNodes;
+    unsigned int _numCollisionNodes;
+    const unsigned int *_pCollisionLeafIndices;
+    const ISpatialIndex *_pCollisionSpatialIndex;
+
+    // see SetSymmetricCollisions(...), SetNumCollisionThreads(...), and 
+    // SetDeterministicCollisions(...)
+    // Note: There is always at least one worker, and the task pool is 0 unless there is more 
+    // than one.  The task records are only used by deterministic symmetric collisions, one 
+    // vector per task, and they keep their capacity from frame to frame.
+    bool _symmetricCollisions;
+    bool _deterministicCollisions;
+    std::vector<CollisionWorker> _collisionWorkers;
+    WorkStealingTaskPool *_pCollisionTaskPool;
+    std::vector<std::vector<CollisionForceRecord> > _collisionTaskRecords;
+
+    // the same table as ComputeControllerParticleReset's so that both spawn particles in the 
+    // same order
+    ParticleEmitterTable _emitterTable;
+};
@@ -0,0 +1,360 @@
+// simulation_engine_tests: with SetDeterministicCollisions(true), symmetric collisions on many
+// threads must give exactly the same particles, to the bit, as on one thread, frame after
+// frame, with every spatial index.  Symmetric collisions must give the same forces as
+// one-sided ones, also when they are summed in the GPU's fixed point format.  Also, leaf
+// indices from an older snapshot must not send a particle to a leaf that it isn't in.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "glm/detail/func_geometric.hpp"     // for dot(...)
+
+#include "CollisionForceFixedPoint.h"
+#include "ParticleEmitterBar.h"
+#include "ParticleQuadTree.h"
+#include "SimulationEngine.h"
+#include "TestChecks.h"
+#include "TestParticles.h"
+
+// enough frames for the sprays to pile up in front of the bars; with nondeterministic
+// collisions on 8 threads, the particles already differ by the 5th frame
+static const unsigned int NUM_TEST_FRAMES = 60;
+static const unsigned int NUM_TEST_PARTICLES = 20000;
+static const unsigned int PARTICLES_PER_EMITTER_PER_FRAME = 40;
+static const float TEST_DELTA_TIME_SEC = 0.01f;
+
+static const char *gSpatialIndexNames[] =
+{
+    "quad tree", "compact quad tree", "uniform grid"
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs scenarios/two_bars.txt's emitters, in deterministic symmetric mode, and keeps a copy
+    of the particles after each frame.
+Parameters:
+    spatialIndexType    Self-explanatory
+    numThreads          For SetNumCollisionThreads(...).
+    frames              Gets every frame's particles, one after the other.
+    numCollisions       Gets the sum of every frame's particles' collision counts, so that the
+                        test can tell that there was something to be deterministic about.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void RunFrames(SPATIAL_INDEX_TYPE spatialIndexType, unsigned int numThreads,
+    std::vector<Particle> &frames, unsigned long long &numCollisions)
+{
+    SimulationEngine engine(NUM_TEST_PARTICLES, gParticleRegionCenter, gParticleRegionRadius);
+    engine.SetRandomSeed(1);
+    engine.SetSpatialIndexType(spatialIndexType);
+    engine.SetSymmetricCollisions(true);
+    engine.SetDeterministicCollisions(true);
+    engine.SetNumCollisionThreads(numThreads);
+
+    ParticleEmitterBar leftBar(glm::vec2(-0.5f, +0.5f), glm::vec2(-0.5f, 0.0f),
+        glm::vec2(+1.0f, 0.0f), 0.1f, 0.5f);
+    ParticleEmitterBar bottomBar(glm::vec2(-0.1f, -0.5f), glm::vec2(+0.2f, -0.5f),
+        glm::vec2(0.0f, +0.5f), 0.1f, 0.5f);
+    engine.AddEmitter(&leftBar);
+    engine.AddEmitter(&bottomBar);
+
+    frames.clear();
+    numCollisions = 0;
+    for (unsigned int frame = 0; frame < NUM_TEST_FRAMES; frame++)
+    {
+        engine.Update(PARTICLES_PER_EMITTER_PER_FRAME, TEST_DELTA_TIME_SEC);
+
+        const Particle *particles = engine.ParticleBuffer();
+        frames.insert(frames.end(), particles, particles + engine.NumParticles());
+        for (unsigned int particleIndex = 0; particleIndex < engine.NumParticles(); particleIndex++)
+        {
+            numCollisions += particles[particleIndex]._collisionCountThisFrame;
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    1 collision thread vs 8, with each spatial index.  Every frame's particles are compared,
+    so a difference is reported at the frame that it first shows up in.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void TestDeterministicCollisionsMatchAcrossThreads()
+{
+    SPATIAL_INDEX_TYPE spatialIndexTypes[] =
+    {
+        SPATIAL_INDEX_QUAD_TREE, SPATIAL_INDEX_COMPACT_QUAD_TREE, SPATIAL_INDEX_UNIFORM_GRID
+    };
+
+    for (int typeIndex = 0; typeIndex < 3; typeIndex++)
+    {
+        const char *indexName = gSpatialIndexNames[typeIndex];
+
+        std::vector<Particle> oneThreadFrames;
+        unsigned long long oneThreadCollisions = 0;
+        RunFrames(spatialIndexTypes[typeIndex], 1, oneThreadFrames, oneThreadCollisions);
+        TEST_CHECK(oneThreadCollisions > 0, "%s: no collisions", indexName);
+
+        std::vector<Particle> eightThreadFrames;
+        unsigned long long eightThreadCollisions = 0;
+        RunFrames(spatialIndexTypes[typeIndex], 8, eightThreadFrames, eightThreadCollisions);
+        TEST_CHECK(eightThreadCollisions == oneThreadCollisions, "%s: %llu collisions vs %llu",
+            indexName, eightThreadCollisions, oneThreadCollisions);
+
+        if (!TEST_CHECK(eightThreadFrames.size() == oneThreadFrames.size(), "%s", indexName))
+        {
+            continue;
+        }
+
+        for (unsigned int frame = 0; frame < NUM_TEST_FRAMES; frame++)
+        {
+            size_t frameBegin = (size_t)frame * NUM_TEST_PARTICLES;
+            if (!TEST_CHECK(memcmp(&oneThreadFrames[frameBegin], &eightThreadFrames[frameBegin],
+                NUM_TEST_PARTICLES * sizeof(Particle)) == 0, "%s: particles differ at frame %u",
+                indexName, frame))
+            {
+                // every frame after it will differ too
+                break;
+            }
+        }
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    With collision latency, the tree and its leaf indices are from an older snapshot of the
+    particles.  Some particles have since died and their slots have gone to new particles in
+    another part of the region, and they still have the old particles' leaf indices.  The
+    collisions must come out the same as if there were no leaf indices and every particle
+    walked the tree.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void TestStaleLeafIndicesAreNotUsed()
+{
+    const int numParticles = 4000;
+    std::vector<Particle> snapshotParticles = MakeParticles(TEST_DISTRIBUTION_CLUSTER,
+        numParticles);
+
+    // the node array is far too big for the stack
+    ParticleQuadTree *pTree = new ParticleQuadTree(gParticleRegionCenter,
+        gParticleRegionRadius, numParticles);
+    pTree->AddParticlestoTree(snapshotParticles.data(), numParticles);
+    std::vector<unsigned int> leafIndices(numParticles);
+    pTree->CopyParticleLeafIndices(leafIndices.data(), numParticles);
+
+    // every 5th slot is now a new particle on the other side of the region
+    std::vector<Particle> currentParticles = snapshotParticles;
+    for (int particleIndex = 0; particleIndex < numParticles; particleIndex += 5)
+    {
+        Particle &p = currentParticles[particleIndex];
+        p._position = glm::vec4(-p._position.x, -p._position.y, 0.0f, 1.0f);
+        p._isActive = 1;
+    }
+
+    SimulationEngine walkingEngine(numParticles, gParticleRegionCenter, gParticleRegionRadius);
+    walkingEngine.SetParticles(currentParticles.data());
+    walkingEngine.CollideParticles(TEST_DELTA_TIME_SEC, pTree->QuadTreeBuffer(),
+        pTree->NumActiveNodes(), 0);
+
+    SimulationEngine leafIndexEngine(numParticles, gParticleRegionCenter, gParticleRegionRadius);
+    leafIndexEngine.SetParticles(currentParticles.data());
+    leafIndexEngine.CollideParticles(TEST_DELTA_TIME_SEC, pTree->QuadTreeBuffer(),
+        pTree->NumActiveNodes(), leafIndices.data());
+    delete pTree;
+
+    unsigned long long numCollisions = 0;
+    for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    {
+        numCollisions += walkingEngine.ParticleBuffer()[particleIndex]._collisionCountThisFrame;
+    }
+    TEST_CHECK(numCollisions > 0, "no collisions");
+    TEST_CHECK(memcmp(walkingEngine.ParticleBuffer(), leafIndexEngine.ParticleBuffer(),
+        numParticles * sizeof(Particle)) == 0, "stale leaf indices changed the collisions");
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Collides the particles once on the uniform grid, one-sided or symmetric.
+Parameters:
+    particles           Self-explanatory
+    useSymmetric        For SetSymmetricCollisions(...).
+    collidedParticles   Gets the particles after the collisions.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void CollideOnGrid(const std::vector<Particle> &particles, bool useSymmetric,
+    std::vector<Particle> &collidedParticles)
+{
+    SimulationEngine engine((unsigned int)particles.size(), gParticleRegionCenter,
+        gParticleRegionRadius);
+    engine.SetSpatialIndexType(SPATIAL_INDEX_UNIFORM_GRID);
+    engine.SetSymmetricCollisions(useSymmetric);
+    engine.SetParticles(particles.data());
+    engine.GenerateQuadTree();
+    engine.CollideParticles(TEST_DELTA_TIME_SEC);
+    collidedParticles.assign(engine.ParticleBuffer(), engine.ParticleBuffer() + particles.size());
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    On the uniform grid, symmetric collisions (each pair worked out once, and the other
+    particle gets the opposite force) must give the same net forces and collision counts as
+    one-sided ones (each particle works out its own half).  The symmetric shader sums the
+    forces in CollisionForceFixedPoint's format, so that is checked too: every pair's halves
+    are added up in it and must come out the same, without wrapping around, even for a pile of
+    particles that each have hundreds of contacts.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+static void TestSymmetricForcesMatchOneSidedOnGrid()
+{
+    // spread out particles and a dense pile, all moving
+    const int numParticles = 20000;
+    const int numPiled = 600;
+    std::vector<Particle> particles = MakeParticles(TEST_DISTRIBUTION_UNIFORM, numParticles);
+    std::vector<Particle> piledParticles = MakeParticles(TEST_DISTRIBUTION_CLUSTER, numPiled);
+    RandomStream random(7, 0);
+    for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    {
+        Particle &p = particles[particleIndex];
+        if (particleIndex < numPiled)
+        {
+            p._position = piledParticles[particleIndex]._position;
+        }
+        p._velocity = glm::vec4(random.NextOnRange0to1() - 0.5f, random.NextOnRange0to1() - 0.5f,
+            0.0f, 0.0f);
+    }
+
+    std::vector<Particle> oneSidedParticles;
+    std::vector<Particle> symmetricParticles;
+    CollideOnGrid(particles, false, oneSidedParticles);
+    CollideOnGrid(particles, true, symmetricParticles);
+
+    // every pair within collision range, found by sweeping along x, with its halves summed
+    // in fixed point; the wide sums are to tell if the narrow ones wrapped around
+    std::vector<int> sortedIndices;
+    for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    {
+        if (particles[particleIndex]._isActive != 0)
+        {
+            sortedIndices.push_back(particleIndex);
+        }
+    }
+    std::sort(sortedIndices.begin(), sortedIndices.end(), [&](int a, int b)
+    {
+        return particles[a]._position.x < particles[b]._position.x;
+    });
+
+    std::vector<int> fixedPointForcesX(numParticles, 0);
+    std::vector<int> fixedPointForcesY(numParticles, 0);
+    std::vector<long long> wideForcesX(numParticles, 0);
+    std::vector<long long> wideForcesY(numParticles, 0);
+    std::vector<int> pairCounts(numParticles, 0);
+    for (size_t sortedIndex = 0; sortedIndex < sortedIndices.size(); sortedIndex++)
+    {
+        int p1Index = sortedIndices[sortedIndex];
+        for (size_t otherIndex = sortedIndex + 1; otherIndex < sortedIndices.size(); otherIndex++)
+        {
+            int p2Index = sortedIndices[otherIndex];
+            const Particle &p1 = particles[p1Index];
+            const Particle &p2 = particles[p2Index];
+            float minDistanceForCollision = p1._radiusOfInfluence + p2._radiusOfInfluence;
+            if (p2._position.x - p1._position.x >= minDistanceForCollision)
+            {
+                break;
+            }
+
+            glm::vec4 p1ToP2 = p2._position - p1._position;
+            if (glm::dot(p1ToP2, p1ToP2) >= (minDistanceForCollision * minDistanceForCollision))
+            {
+                continue;
+            }
+
+            // the lower index works the pair out, as in the symmetric shader
+            int lowIndex = std::min(p1Index, p2Index);
+            int highIndex = std::max(p1Index, p2Index);
+            Particle lowParticle = particles[lowIndex];
+            lowParticle._netForceThisFrame = glm::vec4(0.0f);
+            SimulationEngine::ParticleCollisionP1WithP2(lowParticle, particles[highIndex],
+                1.0f / TEST_DELTA_TIME_SEC);
+
+            int forceX = CollisionForceFixedPoint::FromForce(lowParticle._netForceThisFrame.x);
+            int forceY = CollisionForceFixedPoint::FromForce(lowParticle._netForceThisFrame.y);
+
+            // unsigned so that a wrap around is the same as on the GPU instead of undefined
+            fixedPointForcesX[lowIndex] = (int)((unsigned int)fixedPointForcesX[lowIndex] + (unsigned int)forceX);
+            fixedPointForcesY[lowIndex] = (int)((unsigned int)fixedPointForcesY[lowIndex] + (unsigned int)forceY);
+            fixedPointForcesX[highIndex] = (int)((unsigned int)fixedPointForcesX[highIndex] - (unsigned int)forceX);
+            fixedPointForcesY[highIndex] = (int)((unsigned int)fixedPointForcesY[highIndex] - (unsigned int)forceY);
+            wideForcesX[lowIndex] += forceX;
+            wideForcesY[lowIndex] += forceY;
+            wideForcesX[highIndex] -= forceX;
+            wideForcesY[highIndex] -= forceY;
+            pairCounts[lowIndex]++;
+            pairCounts[highIndex]++;
+        }
+    }
+
+    int maxPairCount = 0;
+    for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    {
+        const Particle &oneSided = oneSidedParticles[particleIndex];
+        const Particle &symmetric = symmetricParticles[particleIndex];
+        int collisionCount = oneSided._collisionCountThisFrame;
+        maxPairCount = std::max(maxPairCount, pairCounts[particleIndex]);
+
+        TEST_CHECK(symmetric._collisionCountThisFrame == collisionCount,
+            "particle %d: %d symmetric collisions vs %d", particleIndex,
+            symmetric._collisionCountThisFrame, collisionCount);
+        TEST_CHECK(pairCounts[particleIndex] == collisionCount,
+            "particle %d: %d pairs vs %d collisions", particleIndex, pairCounts[particleIndex],
+            collisionCount);
+
+        // float sums in a different order, and fixed point that is rounded once per pair
+        float floatTolerance = 1e-6f + (1e-5f * (float)collisionCount);
+        float fixedPointTolerance = floatTolerance +
+            ((float)collisionCount / (float)(1 << CollisionForceFixedPoint::SCALE_SHIFT));
+        TEST_CHECK(fabsf(symmetric._netForceThisFrame.x - oneSided._netForceThisFrame.x) <= floatTolerance &&
+            fabsf(symmetric._netForceThisFrame.y - oneSided._netForceThisFrame.y) <= floatTolerance,
+            "particle %d: symmetric force (%g, %g) vs (%g, %g)", particleIndex,
+            symmetric._netForceThisFrame.x, symmetric._netForceThisFrame.y,
+            oneSided._netForceThisFrame.x, oneSided._netForceThisFrame.y);
+
+        TEST_CHECK(wideForcesX[particleIndex] == fixedPointForcesX[particleIndex] &&
+            wideForcesY[particleIndex] == fixedPointForcesY[particleIndex],
+            "particle %d: the fixed point force wrapped around", particleIndex);
+        float fixedPointForceX = CollisionForceFixedPoint::ToForce(fixedPointForcesX[particleIndex]);
+        float fixedPointForceY = CollisionForceFixedPoint::ToForce(fixedPointForcesY[particleIndex]);
+        TEST_CHECK(fabsf(fixedPointForceX - oneSided._netForceThisFrame.x) <= fixedPointTolerance &&
+            fabsf(fixedPointForceY - oneSided._netForceThisFrame.y) <= fixedPointTolerance,
+            "particle %d: fixed point force (%g, %g) vs (%g, %g)", particleIndex,
+            fixedPointForceX, fixedPointForceY, oneSided._netForceThisFrame.x,
+            oneSided._netForceThisFrame.y);
+    }
+
+    // the pile must actually have been a pile
+    TEST_CHECK(maxPairCount >= 200, "at most %d contacts on a particle", maxPairCount);
+
+    // the clamp, and the room that it leaves
+    int maxAdd = CollisionForceFixedPoint::FromForce(1.0e9f);
+    TEST_CHECK(maxAdd == (CollisionForceFixedPoint::MAX_FORCE_PER_ADD << CollisionForceFixedPoint::SCALE_SHIFT),
+        "clamped to %d", maxAdd);
+    TEST_CHECK(CollisionForceFixedPoint::FromForce(-1.0e9f) == -maxAdd, "negative clamp");
+    TEST_CHECK((long long)maxAdd * 511 <= 0x7fffffffLL, "511 adds at the clamp overflow");
+}
+
+int main()
+{
+    TestDeterministicCollisionsMatchAcrossThreads();
+    TestSymmetricForcesMatchOneSidedOnGrid();
+    TestStaleLeafIndicesAreNotUsed();
+
+    return TestExitCode("simulation_engine_tests");
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A fixed-size queue for passing items from exactly one thread (the producer) to exactly one
+    other thread (the consumer) without a lock.  The producer only writes the tail and the
+    consumer only writes the head, so each side only has to publish its own index with a
+    release store and read the other's with an acquire load.
+
+    Neither side blocks.  TryPush(...) fails when the queue is full and TryPop(...) fails when it
+    is empty, and it is up to the caller to decide whether to spin, yield, or do something else.
+
+    Note: The head and the tail are on their own cache lines so that the two threads aren't
+    fighting over one line every time that either of them moves.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+template<typename T>
+class SpscQueue
+{
+public:
+    /*-------------------------------------------------------------------------------------------
+    Description:
+        Allocates room for capacity items.  One extra slot is allocated so that "full" and
+        "empty" can be told apart without a separate count.
+    Parameters:
+        capacity    The most items that can be in the queue at once.
+    Returns:    None
+    Creator:    John Cox (10-17-2026)
+    -------------------------------------------------------------------------------------------*/
+    SpscQueue(unsigned int capacity) :
+        _items(capacity + 1),
+        _head(0),
+        _tail(0)
+    {
+    }
+
+    /*-------------------------------------------------------------------------------------------
+    Description:
+        Producer only.  Copies the item to the back of the queue.
+    Parameters:
+        item    Self-explanatory.
+    Returns:
+        False if the queue was full, otherwise true.
+    Creator:    John Cox (10-17-2026)
+    -------------------------------------------------------------------------------------------*/
+    bool TryPush(const T &item)
+    {
+        unsigned int tail = _tail.load(std::memory_order_relaxed);
+        unsigned int nextTail = NextIndex(tail);
+        if (nextTail == _head.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        _items[tail] = item;
+        _tail.store(nextTail, std::memory_order_release);
+        return true;
+    }
+
+    /*-------------------------------------------------------------------------------------------
+    Description:
+        Consumer only.  Takes the item at the front of the queue.
+    Parameters:
+        item    Receives the item.  Untouched if the queue was empty.
+    Returns:
+        False if the queue was empty, otherwise true.
+    Creator:    John Cox (10-17-2026)
+    -------------------------------------------------------------------------------------------*/
+    bool TryPop(T &item)
+    {
+        unsigned int head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        item = _items[head];
+        _head.store(NextIndex(head), std::memory_order_release);
+        return true;
+    }
+
+private:
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    unsigned int NextIndex(unsigned int index) const
+    {
+        index++;
+        return (index == _items.size()) ? 0 : index;
+    }
+
+    std::vector<T> _items;
+    alignas(64) std::atomic<unsigned int> _head;
+    alignas(64) std::atomic<unsigned int> _tail;
+};
@@ -58,6 +58,20 @@ SsboBase::~SsboBase()
     glDeleteVertexArrays(1, &_vaoId);
 }
 
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Gives out another unique binding point index for derived classes that bind more than one 
+    storage block (see ParticleSsbo's structure of arrays layout).
+Parameters: None
+Returns:    
+    A binding point index that no other SSBO is using.
+Creator: John Cox, 10-17-2026
+-----------------------------------------------------------------------------------------------*/
+unsigned int SsboBase::NewStorageBlockBindingPointIndex()
+{
+    return GetNewStorageBlockBindingPointIndex();
+}
+
 /*-----------------------------------------------------------------------------------------------
 Description:
     A simple getter for the vertex array object ID.
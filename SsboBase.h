@@ -26,6 +26,8 @@ public:
     unsigned int BufferSizeBytes() const;
 
 protected:
+    static unsigned int NewStorageBlockBindingPointIndex();
+
     // can't be private because the derived classes need to set them or read them
 
     unsigned int _bufferSizeBytes;
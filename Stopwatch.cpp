@@ -1,123 +1,83 @@
 #include "Stopwatch.h"
 
-// this is a big header, but necessary to get access to LARGE_INTEGER
-// Note: We can't just include winnt.h, in which LARGE_INTEGER is defined, because there are some macros that this header file needs that are defined further up in the header hierarchy.  So just include Windows.h and be done with it.
-#define WIN32_LEAN_AND_MEAN
-#include <Windows.h>
-
-#include <stdio.h>
-
-// these are declared static here in order to avoid having to include Windows.h in the header
-static double gInverseCpuTimerFrequency;
-static LARGE_INTEGER gStartCounter;
-static LARGE_INTEGER gLastLapCounter;
-
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Converts a CPU cycle counter into fractions of a second.
-    counter     A LARGE_INTEGER (Windows-specific union of structs used for large or
-    high-precision integer work.
+    Converts the time between two clock readings into fractions of a second.
+Parameters:
+    start   The earlier reading.
+    end     The later reading.
 Returns:
-    A double indicating the fractions of a second corresponding to the argument counter.  This 
-    is not "time elapsed" yet but is rather totally depended upon the "counter" argument.
+    A double indicating the fractions of a second between the two readings.
 Creator:    John Cox (??-2015)
 -----------------------------------------------------------------------------------------------*/
-static inline double CounterToSeconds(const LARGE_INTEGER counter)
+static inline double SecondsBetween(const std::chrono::steady_clock::time_point &start,
+    const std::chrono::steady_clock::time_point &end)
 {
-    return ((double)counter.QuadPart * gInverseCpuTimerFrequency);
+    std::chrono::duration<double> elapsed = end - start;
+    return elapsed.count();
 }
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Sets up members to default values.
+    Starts the stopwatch, so a new one can be used right away.
 Parameters: None
 Returns:    None
 Creator:    John Cox (??-2015)
 -----------------------------------------------------------------------------------------------*/
-Stopwatch::Stopwatch() :
-    _haveInitialized(false)
+Stopwatch::Stopwatch()
 {
-    gStartCounter.QuadPart = 0;
-    gLastLapCounter.QuadPart = 0;
+    Start();
 }
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Reads the CPU's frequency.
-    Must be called prior to use.  
+    This used to read the CPU's frequency, but the steady clock doesn't need it.  Kept so
+    that the existing callers don't have to change.
 Parameters: None
 Returns:    None
 Creator:    John Cox (??-2015)
 -----------------------------------------------------------------------------------------------*/
 void Stopwatch::Init()
 {
-    // the "performance frequency" only changes on system reset, so it's ok to set it only 
-    // during initialization
-    // Note: It is technically possible for this query to return 0, but only on old versions of Windows.  According to the documentation, Windows XP or greater will never return 0. 
-    // http://msdn.microsoft.com/en-us/library/windows/desktop/ms644905(v=vs.85).aspx
-    LARGE_INTEGER cpuFreq;
-    QueryPerformanceFrequency(&cpuFreq);
-    gInverseCpuTimerFrequency = 1.0 / cpuFreq.QuadPart;
-    _haveInitialized = true;
 }
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Reads the CPU's clock counter and assumes it as the starting point for Lap() and TotalTime() 
-    method calls.
+    Reads the clock and assumes it as the starting point for Lap() and TotalTime() method
+    calls.
 Parameters: None
 Returns:    None
 Creator:    John Cox (??-2015)
 -----------------------------------------------------------------------------------------------*/
 void Stopwatch::Start()
 {
-    if (!_haveInitialized)
-    {
-        fprintf(stderr, "StopWatch has not been initialized.\n");
-    }
-
-    // give the counters their first values
-    // Note: "On systems that run Windows XP or later, the function will always succeed and will 
-    // thus never return zero."
-    // http://msdn.microsoft.com/en-us/library/windows/desktop/ms644904(v=vs.85).aspx
-    QueryPerformanceCounter(&gStartCounter);
-    gLastLapCounter.QuadPart = gStartCounter.QuadPart;
+    _startTime = std::chrono::steady_clock::now();
+    _lastLapTime = _startTime;
 }
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Reads the CPU's clock counter, compares it to the time set by Start() or the last call to 
-    Lap(), and returns the time since that call.
+    Reads the clock, compares it to the time set by Start() or the last call to Lap(), and
+    returns the time since that call.
 Parameters: None
-Returns:    
+Returns:
     Fractions of a seconds since the last call to Start() or Lap().  The fraction can be >1.
 Creator:    John Cox (??-2015)
 -----------------------------------------------------------------------------------------------*/
 double Stopwatch::Lap()
 {
-    if (!_haveInitialized)
-    {
-        fprintf(stderr, "StopWatch has not been initialized.\n");
-    }
-
-    // get the current time
-    LARGE_INTEGER now;
-    QueryPerformanceCounter(&now);
-
     // calculate delta time relative to previous frame
-    LARGE_INTEGER deltaLargeInt;
-    deltaLargeInt.QuadPart = now.QuadPart - gLastLapCounter.QuadPart;
-    double deltaTime = CounterToSeconds(deltaLargeInt);
-
-    gLastLapCounter.QuadPart = now.QuadPart;
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    double deltaTime = SecondsBetween(_lastLapTime, now);
+    _lastLapTime = now;
 
     return deltaTime;
 }
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Reads the CPU's clock counter, compares it to the time set by Start() or Reset(), and 
-    returns the fractions of a second since then.
+    Reads the clock, compares it to the time set by Start() or Reset(), and returns the
+    fractions of a second since then.
 Parameters: None
 Returns:
     Fractions of a seconds since the last call to Start() or Reset().  The fraction can be >1.
@@ -125,35 +85,18 @@ Creator:    John Cox (??-2015)
 -----------------------------------------------------------------------------------------------*/
 double Stopwatch::TotalTime()
 {
-    if (!_haveInitialized)
-    {
-        fprintf(stderr, "StopWatch has not been initialized.\n");
-    }
-
-    LARGE_INTEGER now;
-    QueryPerformanceCounter(&now);
-
-    LARGE_INTEGER deltaLargeInt;
-    deltaLargeInt.QuadPart = now.QuadPart - gStartCounter.QuadPart;
-    double deltaTime = CounterToSeconds(deltaLargeInt);
-    
-    return deltaTime;
+    return SecondsBetween(_startTime, std::chrono::steady_clock::now());
 }
 
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Reads the CPU's clock counter and resets the starting time.
+    Reads the clock and resets the starting time.
 Parameters: None
 Returns:    None
 Creator:    John Cox (??-2015)
 -----------------------------------------------------------------------------------------------*/
 void Stopwatch::Reset()
 {
-    if (!_haveInitialized)
-    {
-        fprintf(stderr, "StopWatch has not been initialized.\n");
-    }
-
     // reset the values by giving them new start values
     Start();
 }
@@ -1,14 +1,21 @@
 #pragma once
 
+#include <chrono>
+
 /*-----------------------------------------------------------------------------------------------
 Description:
-    Call Init() to have it read the CPU frequency, then Start() to have it register a starting 
+    Call Init() to have it read the CPU frequency, then Start() to have it register a starting
     time.  After that, Lap() will get you the number of seconds elapsed since Start() was called.
 
-    This class was ported in from my first game engine that I built while going through some 
-    tutorials on the topic.  I have no idea how old it is, but I think that it is from 2014 or 
-    2015, which is when I was still learning graphical programming and early stuff on game 
+    This class was ported in from my first game engine that I built while going through some
+    tutorials on the topic.  I have no idea how old it is, but I think that it is from 2014 or
+    2015, which is when I was still learning graphical programming and early stuff on game
     engines.
+
+    Note: It used to read Windows' QueryPerformanceCounter(...) into file-level globals, so
+    every Stopwatch shared one start time.  Now each one keeps its own times from
+    std::chrono::steady_clock, which is QueryPerformanceCounter(...) on Windows and
+    clock_gettime(CLOCK_MONOTONIC, ...) on Linux, and Init() has nothing left to do.
 Creator:    John Cox (??-2015)
 -----------------------------------------------------------------------------------------------*/
 class Stopwatch
@@ -23,6 +30,7 @@ public:
     double TotalTime();
     void Reset();
 private:
-    bool _haveInitialized;
+    std::chrono::steady_clock::time_point _startTime;
+    std::chrono::steady_clock::time_point _lastLapTime;
 };
 
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdarg>
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The tests' checks.  The test programs are plain programs so that they build anywhere that
+    particles_core does, without a test framework.  A check that fails prints where it was,
+    what was checked, and a printf(...) style message, and the test keeps going so that one
+    run shows every failure.  Each test program's main(...) returns TestExitCode().
+
+    Note: Only the first MAX_PRINTED_FAILURES failures are printed.  A broken build can fail
+    a check for every particle, and the first few say everything.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+#define TEST_CHECK(condition, ...) \
+    CheckTestCondition((condition), #condition, __FILE__, __LINE__, __VA_ARGS__)
+
+static const int MAX_PRINTED_FAILURES = 20;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The number of failed checks so far.  A function-local static so that the header can be
+    included by any test file.
+Parameters: None
+Returns:
+    A reference to the count.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+inline int &TestFailureCount()
+{
+    static int failureCount = 0;
+    return failureCount;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    What TEST_CHECK(...) calls.  Counts and prints the failure if the condition is false.
+Parameters:
+    condition       Self-explanatory
+    conditionText   The condition as it was written.
+    fileName        Where the check is.
+    lineNumber      Where the check is.
+    messageFormat   printf(...) style, followed by its arguments.
+Returns:
+    The condition, so that a test can stop when a check that everything after it depends on
+    fails.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+inline bool CheckTestCondition(bool condition, const char *conditionText, const char *fileName,
+    int lineNumber, const char *messageFormat, ...)
+{
+    if (condition)
+    {
+        return true;
+    }
+
+    int &failureCount = TestFailureCount();
+    failureCount++;
+    if (failureCount <= MAX_PRINTED_FAILURES)
+    {
+        fprintf(stderr, "%s(%d): check failed: %s\n    ", fileName, lineNumber, conditionText);
+        va_list arguments;
+        va_start(arguments, messageFormat);
+        vfprintf(stderr, messageFormat, arguments);
+        va_end(arguments);
+        fprintf(stderr, "\n");
+    }
+    else if (failureCount == MAX_PRINTED_FAILURES + 1)
+    {
+        fprintf(stderr, "(not printing any more failures)\n");
+    }
+
+    return false;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Prints how many checks failed, if any.
+Parameters:
+    testName    For the printout.
+Returns:
+    0 if every check passed, otherwise 1, for main(...) to return.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+inline int TestExitCode(const char *testName)
+{
+    int failureCount = TestFailureCount();
+    if (failureCount == 0)
+    {
+        printf("%s: all checks passed\n", testName);
+        return 0;
+    }
+
+    fprintf(stderr, "%s: %d checks failed\n", testName, failureCount);
+    return 1;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include "glm/vec4.hpp"
+
+#include "Particle.h"
+#include "RandomToast.h"
+
+// the same region as main.cpp's
+static const glm::vec4 gParticleRegionCenter(0.0f, 0.0f, 0.0f, 1.0f);
+static const float gParticleRegionRadius = 0.8f;
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Where the test particles are put.
+    UNIFORM         Evenly over the whole region.
+    CLUSTER         A 0.01 wide square around where main.cpp's bar emitters meet, so the tree
+                    goes deep and the Morton keys' rounding is about the size of a leaf.
+    GRID_LINES      On multiples of 1/64, which is where many nodes' center lines are, so
+                    every tie between quadrants is tested.
+    STACKED         A handful of points with many particles each, so no tree can split them
+                    up.  ParticleQuadTree leaves most of them out, and CompactParticleQuadTree
+                    bottoms out at MAX_NODE_DEPTH and keeps more than MaxParticlesPerLeaf()
+                    particles in a leaf.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+enum TEST_DISTRIBUTION
+{
+    TEST_DISTRIBUTION_UNIFORM = 0,
+    TEST_DISTRIBUTION_CLUSTER,
+    TEST_DISTRIBUTION_GRID_LINES,
+    TEST_DISTRIBUTION_STACKED,
+    TEST_DISTRIBUTION_COUNT
+};
+
+static const char *const gDistributionNames[TEST_DISTRIBUTION_COUNT] =
+{
+    "uniform", "cluster", "grid lines", "stacked"
+};
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Makes particles in the distribution.  Every 7th one is inactive so that the builds have
+    to skip some.  The same distribution and count always gives the same particles.
+Parameters:
+    distribution    Self-explanatory
+    numParticles    Self-explanatory
+Returns:
+    The particles.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+inline std::vector<Particle> MakeParticles(TEST_DISTRIBUTION distribution, int numParticles)
+{
+    RandomStream random(5, (unsigned int)distribution);
+    std::vector<Particle> particles(numParticles);
+    for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+    {
+        float x = (random.NextOnRange0to1() * 1.6f) - 0.8f;
+        float y = (random.NextOnRange0to1() * 1.6f) - 0.8f;
+        if (distribution == TEST_DISTRIBUTION_CLUSTER)
+        {
+            x = 0.05f + (0.00625f * x);
+            y = 0.25f + (0.00625f * y);
+        }
+        else if (distribution == TEST_DISTRIBUTION_GRID_LINES)
+        {
+            x = roundf(x * 64.0f) / 64.0f;
+            y = roundf(y * 64.0f) / 64.0f;
+        }
+        else if (distribution == TEST_DISTRIBUTION_STACKED)
+        {
+            x = roundf(x * 2.0f) / 4.0f;
+            y = roundf(y * 2.0f) / 4.0f;
+        }
+
+        Particle &p = particles[particleIndex];
+        p._position = glm::vec4(x, y, 0.0f, 1.0f);
+        p._isActive = ((particleIndex % 7) != 0) ? 1 : 0;
+    }
+
+    return particles;
+}
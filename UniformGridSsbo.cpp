@@ -0,0 +1,162 @@
+#include "UniformGridSsbo.h"
+
+#include "glload/include/glload/gl_4_4.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Calls the base class to give members initial values (zeros).
+
+    Allocates room for the most cells and particle indices that there could be.  There is one 
+    more cell offset than there are cells so that the last cell's end is in the buffer too.  
+    As in CompactQuadTreeSsbo, the pool section starts on a multiple of 
+    GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT and gets its own binding point.
+Parameters:
+    maxCells        The most cells that a grid uploaded to this buffer can have.
+    maxParticles    The size of the pool section, in particle indices.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+UniformGridSsbo::UniformGridSsbo(unsigned int maxCells, unsigned int maxParticles) :
+    SsboBase(),  // generate buffers
+    _orphanOnUpload(false),
+    _numActiveCells(0),
+    _maxCells(maxCells),
+    _maxParticles(maxParticles),
+    _particleIndicesOffsetBytes(0),
+    _particleIndicesBindingPointIndex(0)
+{
+    // ignore _numVertices because this SSBO does not draw
+
+    GLint offsetAlignment = 0;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+    if (offsetAlignment < 1)
+    {
+        offsetAlignment = 1;
+    }
+
+    GLuint cellOffsetsSizeBytes = sizeof(unsigned int) * (maxCells + 1);
+    _particleIndicesOffsetBytes = 
+        ((cellOffsetsSizeBytes + offsetAlignment - 1) / offsetAlignment) * offsetAlignment;
+    GLuint bufferSizeBytes = _particleIndicesOffsetBytes + (sizeof(int) * maxParticles);
+    _particleIndicesBindingPointIndex = NewStorageBlockBindingPointIndex();
+
+    // Note: The grid is uploaded every frame, hence "dynamic".
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSizeBytes, 0, GL_DYNAMIC_DRAW);
+
+    _bufferSizeBytes = bufferSizeBytes;
+
+    // cleanup
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Binds each section to its storage block.  Blocks that the shader doesn't have are 
+    skipped.
+
+    Note: It is ok to call this function for multiple compute shaders so that the same SSBO 
+    can be used in each shader.  No member variables are altered in this function.
+Parameters:
+    computeProgramId    Self-explanatory
+    bufferNameInShader  The prefix of the two storage block names.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void UniformGridSsbo::ConfigureCompute(unsigned int computeProgramId, 
+    const std::string &bufferNameInShader)
+{
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+
+    std::string blockName = bufferNameInShader + "CellOffsets";
+    GLuint storageBlockIndex = glGetProgramResourceIndex(computeProgramId, GL_SHADER_STORAGE_BLOCK, blockName.c_str());
+    if (storageBlockIndex != GL_INVALID_INDEX)
+    {
+        glShaderStorageBlockBinding(computeProgramId, storageBlockIndex, _ssboBindingPointIndex);
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, _ssboBindingPointIndex, _bufferId, 0, 
+            sizeof(unsigned int) * (_maxCells + 1));
+    }
+
+    blockName = bufferNameInShader + "ParticleIndices";
+    storageBlockIndex = glGetProgramResourceIndex(computeProgramId, GL_SHADER_STORAGE_BLOCK, blockName.c_str());
+    if (storageBlockIndex != GL_INVALID_INDEX)
+    {
+        glShaderStorageBlockBinding(computeProgramId, storageBlockIndex, _particleIndicesBindingPointIndex);
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, _particleIndicesBindingPointIndex, _bufferId, 
+            _particleIndicesOffsetBytes, sizeof(int) * _maxParticles);
+    }
+
+    // cleanup
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Like QuadTreeNodeSsbo, this SSBO does not draw.
+Parameters:
+    irrelevant
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void UniformGridSsbo::ConfigureRender(unsigned int, unsigned int)
+{
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    See QuadTreeNodeSsbo::SetOrphanOnUpload(...).
+Parameters:
+    orphanOnUpload  Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void UniformGridSsbo::SetOrphanOnUpload(bool orphanOnUpload)
+{
+    _orphanOnUpload = orphanOnUpload;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Copies the cell offsets (all numCells + 1 of them) and the used part of the particle 
+    index pool into the front of their sections.
+Parameters:
+    cellOffsets             numCells + 1 offsets into the pool, as in 
+                            ParticleUniformGrid::CellOffsets().
+    numCells                Clamped to the size of the cell offset section.
+    particleIndexPool       Self-explanatory
+    particleIndexPoolSize   Clamped to the size of the pool section.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void UniformGridSsbo::UploadGrid(const unsigned int *cellOffsets, unsigned int numCells,
+    const int *particleIndexPool, unsigned int particleIndexPoolSize)
+{
+    _numActiveCells = (numCells < _maxCells) ? numCells : _maxCells;
+    unsigned int numParticleIndices = 
+        (particleIndexPoolSize < _maxParticles) ? particleIndexPoolSize : _maxParticles;
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferId);
+    if (_orphanOnUpload)
+    {
+        // same size and usage, so the binding points don't need to be set up again
+        glBufferData(GL_SHADER_STORAGE_BUFFER, _bufferSizeBytes, 0, GL_DYNAMIC_DRAW);
+    }
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, 
+        (_numActiveCells + 1) * sizeof(unsigned int), cellOffsets);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, _particleIndicesOffsetBytes, 
+        numParticleIndices * sizeof(int), particleIndexPool);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of cells in the last UploadGrid(...).
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int UniformGridSsbo::NumActiveCells() const
+{
+    return _numActiveCells;
+}
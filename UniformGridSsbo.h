@@ -0,0 +1,38 @@
+#pragma once
+
+#include "SsboBase.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Sets up the Shader Storage Block Object for a ParticleUniformGrid.  Like 
+    CompactQuadTreeSsbo, it is two sections of the same buffer, each bound to its own storage 
+    block: the cell offsets (bufferNameInShader + "CellOffsets") and the particle index pool 
+    (bufferNameInShader + "ParticleIndices").
+
+    The grid's size doesn't change from frame to frame, so every cell offset is uploaded 
+    every time, but only the part of the pool that is in use is.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class UniformGridSsbo : public SsboBase
+{
+public:
+    UniformGridSsbo(unsigned int maxCells, unsigned int maxParticles);
+    virtual ~UniformGridSsbo() override = default; // empty override of base destructor
+
+    void ConfigureCompute(unsigned int computeProgramId, const std::string &bufferNameInShader) override;
+    void ConfigureRender(unsigned int renderProgramId, unsigned int drawStyle) override;
+
+    void SetOrphanOnUpload(bool orphanOnUpload);
+    void UploadGrid(const unsigned int *cellOffsets, unsigned int numCells, 
+        const int *particleIndexPool, unsigned int particleIndexPoolSize);
+    unsigned int NumActiveCells() const;
+
+private:
+    bool _orphanOnUpload;
+    unsigned int _numActiveCells;
+
+    unsigned int _maxCells;
+    unsigned int _maxParticles;
+    unsigned int _particleIndicesOffsetBytes;
+    unsigned int _particleIndicesBindingPointIndex;
+};
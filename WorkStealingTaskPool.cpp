@@ -0,0 +1,235 @@
+#include "WorkStealingTaskPool.h"
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Makes a queue for every worker and starts every worker thread but the caller's.  They go 
+    straight to sleep until the first Run(...).
+Parameters:
+    numWorkers  How many threads run the tasks, the caller included.  0 is treated as 1, and 
+                1 runs everything on the caller.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+WorkStealingTaskPool::WorkStealingTaskPool(unsigned int numWorkers) :
+    _numWorkers((numWorkers > 0) ? numWorkers : 1),
+    _queues((numWorkers > 0) ? numWorkers : 1),
+    _runNumber(0),
+    _numThreadsFinished(0),
+    _quit(false),
+    _pTaskFunction(0),
+    _numSteals(0)
+{
+    for (unsigned int workerIndex = 1; workerIndex < _numWorkers; workerIndex++)
+    {
+        _threads.push_back(std::thread(&WorkStealingTaskPool::WorkerThread, this, workerIndex));
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Wakes the worker threads up to quit and waits for them.
+Parameters: None
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+WorkStealingTaskPool::~WorkStealingTaskPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_runMutex);
+        _quit = true;
+    }
+    _runStarted.notify_all();
+
+    for (size_t threadCount = 0; threadCount < _threads.size(); threadCount++)
+    {
+        _threads[threadCount].join();
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Deals the tasks out, wakes the worker threads up, runs tasks on this thread until there 
+    are none left to run or steal, and then waits for the other threads to finish theirs.  
+    Every task runs exactly once, but which worker runs it, and when, changes from run to run.
+Parameters:
+    numTasks        Tasks 0 through numTasks - 1 are run.
+    taskFunction    Called with the task's index and the index of the worker that runs it.  
+                    Must be safe to call from several threads at once, as long as no two 
+                    calls share a worker index.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void WorkStealingTaskPool::Run(unsigned int numTasks, const TaskFunction &taskFunction)
+{
+    _numSteals = 0;
+    for (unsigned int workerIndex = 0; workerIndex < _numWorkers; workerIndex++)
+    {
+        unsigned int firstTask = (unsigned int)(((unsigned long long)numTasks * workerIndex) / _numWorkers);
+        unsigned int endTask = (unsigned int)(((unsigned long long)numTasks * (workerIndex + 1)) / _numWorkers);
+
+        std::lock_guard<std::mutex> lock(_queues[workerIndex]._mutex);
+        for (unsigned int taskIndex = firstTask; taskIndex < endTask; taskIndex++)
+        {
+            _queues[workerIndex]._taskIndices.push_back(taskIndex);
+        }
+    }
+
+    if (_numWorkers == 1)
+    {
+        _pTaskFunction = &taskFunction;
+        RunTasks(0);
+        _pTaskFunction = 0;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_runMutex);
+        _pTaskFunction = &taskFunction;
+        _numThreadsFinished = 0;
+        _runNumber++;
+    }
+    _runStarted.notify_all();
+
+    RunTasks(0);
+
+    std::unique_lock<std::mutex> lock(_runMutex);
+    _runFinished.wait(lock, [this]() { return _numThreadsFinished == _threads.size(); });
+    _pTaskFunction = 0;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    A simple getter for the number of workers, the calling thread included.
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int WorkStealingTaskPool::NumWorkers() const
+{
+    return _numWorkers;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    How many tasks in the last Run(...) were run by a worker other than the one that they 
+    were dealt to.  A few is normal.  A lot means that the tasks are too small or too uneven 
+    for the way that they are dealt out.
+Parameters: None
+Returns:    
+    See description.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+unsigned int WorkStealingTaskPool::NumStealsLastRun() const
+{
+    return _numSteals;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    The loop of every worker thread but the caller's.  Sleeps until a new run starts (or the 
+    pool is being destroyed), runs tasks until there are none left, and says that it's done.
+Parameters:
+    workerIndex     Which queue is this thread's own.
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void WorkStealingTaskPool::WorkerThread(unsigned int workerIndex)
+{
+    unsigned long long lastRunNumber = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_runMutex);
+            _runStarted.wait(lock, [this, lastRunNumber]() 
+            { 
+                return _quit || _runNumber != lastRunNumber; 
+            });
+            if (_quit)
+            {
+                return;
+            }
+            lastRunNumber = _runNumber;
+        }
+
+        RunTasks(workerIndex);
+
+        {
+            std::lock_guard<std::mutex> lock(_runMutex);
+            _numThreadsFinished++;
+        }
+        _runFinished.notify_one();
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs this worker's own tasks, and then other workers' tasks, until there are none left 
+    anywhere.  No task makes new tasks, so once every queue has been found empty, it stays 
+    that way until the next run.
+Parameters:
+    workerIndex     Self-explanatory
+Returns:    None
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+void WorkStealingTaskPool::RunTasks(unsigned int workerIndex)
+{
+    unsigned int taskIndex = 0;
+    while (PopOwnTask(workerIndex, taskIndex) || StealTask(workerIndex, taskIndex))
+    {
+        (*_pTaskFunction)(taskIndex, workerIndex);
+    }
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Takes the task at the front of the worker's own queue.
+Parameters:
+    workerIndex     Self-explanatory
+    taskIndex       Receives the task.  Untouched if the queue was empty.
+Returns:
+    False if the queue was empty, otherwise true.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+bool WorkStealingTaskPool::PopOwnTask(unsigned int workerIndex, unsigned int &taskIndex)
+{
+    WorkerQueue &queue = _queues[workerIndex];
+    std::lock_guard<std::mutex> lock(queue._mutex);
+    if (queue._taskIndices.empty())
+    {
+        return false;
+    }
+
+    taskIndex = queue._taskIndices.front();
+    queue._taskIndices.pop_front();
+    return true;
+}
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Takes the task at the back of the first other worker's queue that isn't empty, starting 
+    with the next worker after this one so that the thieves don't all pile onto worker 0.
+Parameters:
+    workerIndex     The thief.
+    taskIndex       Receives the task.  Untouched if every queue was empty.
+Returns:
+    False if every other queue was empty, otherwise true.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+bool WorkStealingTaskPool::StealTask(unsigned int workerIndex, unsigned int &taskIndex)
+{
+    for (unsigned int victimCount = 1; victimCount < _numWorkers; victimCount++)
+    {
+        WorkerQueue &queue = _queues[(workerIndex + victimCount) % _numWorkers];
+        std::lock_guard<std::mutex> lock(queue._mutex);
+        if (!queue._taskIndices.empty())
+        {
+            taskIndex = queue._taskIndices.back();
+            queue._taskIndices.pop_back();
+            _numSteals++;
+            return true;
+        }
+    }
+
+    return false;
+}
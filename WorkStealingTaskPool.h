@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*-----------------------------------------------------------------------------------------------
+Description:
+    Runs a function over a numbered set of tasks on a fixed set of worker threads, one of 
+    which is the thread that calls Run(...).  The other threads are started once and sleep 
+    between runs.
+
+    The tasks are dealt out up front, in order, one contiguous block per worker.  A worker 
+    takes its own tasks from the front of its queue, so neighboring tasks (which usually touch 
+    neighboring memory) run one after another.  When its queue is empty, it steals from the 
+    back of another worker's queue, which is the work that the other worker would have gotten 
+    to last.  Tasks that cost far more than others (such as the particles in the emitters' 
+    collision zone) then end up spread over every worker instead of holding one up.
+
+    Note: Each queue has its own lock.  The owner only holds it long enough to pop one task, 
+    and a thief only holds it long enough to take one, so the locks are rarely contended, and 
+    a lock-free deque would only pay off for tasks much smaller than the ones this is used for.
+Creator:    John Cox (10-17-2026)
+-----------------------------------------------------------------------------------------------*/
+class WorkStealingTaskPool
+{
+public:
+    WorkStealingTaskPool(unsigned int numWorkers);
+    ~WorkStealingTaskPool();
+
+    // taskFunction(taskIndex, workerIndex); worker 0 is the calling thread
+    typedef std::function<void(unsigned int, unsigned int)> TaskFunction;
+    void Run(unsigned int numTasks, const TaskFunction &taskFunction);
+
+    unsigned int NumWorkers() const;
+    unsigned int NumStealsLastRun() const;
+
+private:
+    WorkStealingTaskPool(const WorkStealingTaskPool &) = delete;
+    WorkStealingTaskPool &operator=(const WorkStealingTaskPool &) = delete;
+
+    // on its own cache lines so that one worker popping doesn't slow down the others
+    // Note: alignas(64) would not do it.  The queues are in a std::vector, and before C++17, 
+    // std::allocator doesn't have to honor more alignment than a max_align_t's (16 bytes on 
+    // x64).  The padding instead keeps one queue's members a whole 64 byte cache line away 
+    // from the next queue's, wherever the vector's memory starts.
+    struct WorkerQueue
+    {
+        std::mutex _mutex;
+        std::deque<unsigned int> _taskIndices;
+        char _padding[64];
+    };
+
+    void WorkerThread(unsigned int workerIndex);
+    void RunTasks(unsigned int workerIndex);
+    bool PopOwnTask(unsigned int workerIndex, unsigned int &taskIndex);
+    bool StealTask(unsigned int workerIndex, unsigned int &taskIndex);
+
+    unsigned int _numWorkers;
+    std::vector<WorkerQueue> _queues;
+    std::vector<std::thread> _threads;
+
+    // the threads wait for the run number to change, and Run(...) waits for all of them to 
+    // say that they are done with it
+    std::mutex _runMutex;
+    std::condition_variable _runStarted;
+    std::condition_variable _runFinished;
+    unsigned long long _runNumber;
+    unsigned int _numThreadsFinished;
+    bool _quit;
+    const TaskFunction *_pTaskFunction;
+
+    std::atomic<unsigned int> _numSteals;
+};
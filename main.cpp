@@ -42,14 +42,34 @@
 
 // for particles, where they live, and how to update them
 #include "glm/vec2.hpp"
+#include "ParticleEmitterPoint.h"
+#include "ParticleEmitterBar.h"
 #include "ParticleQuadTree.h"
+#include "CompactParticleQuadTree.h"
+#include "ParticleUniformGrid.h"
 #include "ParticleSsbo.h"
+#include "ParticleReadbackRing.h"
+#include "ReadbackBackendOpenGl.h"
+#include "GpuTimerBackendOpenGl.h"
 #include "PolygonSsbo.h"
 #include "QuadTreeNodeSsbo.h"
+#include "CompactQuadTreeSsbo.h"
+#include "UniformGridSsbo.h"
+#include "QuadTreeBuildSsbo.h"
+#include "CollisionForceSsbo.h"
+#include "ParticleLeafIndexSsbo.h"
+#include "ActiveParticleSsbo.h"
+#include "ParticleFreeListSsbo.h"
 #include "ComputeControllerGenerateQuadTreeGeometry.h"
 #include "ComputeControllerParticleReset.h"
 #include "ComputeControllerParticleUpdate.h"
 #include "ComputeControllerParticleCollisions.h"
+#include "ComputeControllerQuadTreeBuild.h"
+#include "ComputeControllerActiveParticleCompaction.h"
+#include "QuadTreeBuildEmulator.h"
+#include "FrameStagesOpenGl.h"
+#include "FrameScheduler.h"
+#include "FrameProfiler.h"
 
 // for moving the shapes around in window space
 #include "glm/gtc/matrix_transform.hpp"
@@ -71,7 +91,18 @@ ParticleSsbo *gpParticleBuffer = 0;
 PolygonSsbo *gpParticleBoundingRegionBuffer = 0;
 PolygonSsbo *gpQuadTreeGeometryBuffer = 0;
 QuadTreeNodeSsbo *gpQuadTreeBuffer = 0;
-ParticleQuadTree *gpQuadTree = 0;
+CompactQuadTreeSsbo *gpCompactQuadTreeBuffer = 0;
+UniformGridSsbo *gpUniformGridBuffer = 0;
+QuadTreeBuildSsbo *gpQuadTreeBuildBuffer = 0;
+CollisionForceSsbo *gpCollisionForceBuffer = 0;
+ParticleLeafIndexSsbo *gpParticleLeafIndexBuffer = 0;
+ActiveParticleSsbo *gpActiveParticleBuffer = 0;
+ParticleFreeListSsbo *gpParticleFreeListBuffer = 0;
+
+// the particles are read back for the CPU's tree build through a ring of buffers so that the 
+// CPU doesn't have to wait on the GPU (see ParticleReadbackRing and gFramesOfCollisionLatency)
+ReadbackBackendOpenGl gReadbackBackend;
+ParticleReadbackRing *gpParticleReadbackRing = 0;
 
 // in a bigger program, ??where would particle stuff be stored??
 IParticleEmitter *gpParticleEmitterBar1 = 0;
@@ -80,6 +111,76 @@ ComputeControllerParticleReset *gpParticleReseter = 0;
 ComputeControllerParticleUpdate *gpParticleUpdater = 0;
 ComputeControllerGenerateQuadTreeGeometry *gpQuadTreeGeometryGenerator = 0;
 ComputeControllerParticleCollisions *gpQuadTreeParticleCollider = 0;
+ComputeControllerQuadTreeBuild *gpQuadTreeBuilder = 0;
+ComputeControllerActiveParticleCompaction *gpActiveParticleCompactor = 0;
+
+// the quad tree is built on its own thread while the GPU runs (see FrameScheduler)
+// Note: The collisions use a tree that was built from particles that are max(1, 
+// gFramesOfCollisionLatency) frames old, because the latency is either the scheduler's or the 
+// readback ring's, never both.  With 1, the ring reads this frame's particles (waiting on the 
+// GPU's particle update), and the scheduler collides with the tree from the frame before while 
+// this frame's tree is built alongside the next frame's dispatches.  With 0, the ring gives 
+// the previous frame's particles without waiting, and that tree is built and collided with in 
+// the same frame, so the CPU and the GPU take turns.
+FrameStagesOpenGl *gpFrameStages = 0;
+FrameScheduler *gpFrameScheduler = 0;
+const unsigned int gFramesOfCollisionLatency = 1;
+
+// if true, the quad tree's buffer is given new storage before each upload instead of being 
+// written over while the previous frame's collisions may still be reading it
+// Note: Either way, only the nodes that are in use are uploaded.
+const bool gOrphanQuadTreeBufferOnUpload = false;
+
+// if true, the particles are stored as one array per member (see ParticleSoA) and the *SoA 
+// shaders are used
+// Note: The quad tree only needs the particles' positions and "is active" flags, and that is 
+// all that is mapped each frame in the structure of arrays layout (12 bytes per particle 
+// instead of 64).
+const bool gUseStructureOfArraysParticles = false;
+
+// what the scheduler builds for the collisions to look up neighbors in
+// - SPATIAL_INDEX_QUAD_TREE: ParticleQuadTree and ParticleCollisions*.comp
+// - SPATIAL_INDEX_COMPACT_QUAD_TREE: CompactParticleQuadTree (32-byte nodes and a shared 
+//  particle index pool, with no cap on particles per leaf) and ParticleCollisionsCompact*.comp
+// - SPATIAL_INDEX_UNIFORM_GRID: ParticleUniformGrid (cells as wide as a collision, sorted 
+//  with a counting sort) and ParticleCollisionsGrid*.comp
+// Note: The quad tree geometry shader only understands ParticleQuadTreeNodes.
+const SPATIAL_INDEX_TYPE gSpatialIndexType = SPATIAL_INDEX_QUAD_TREE;
+
+// if true (and the spatial index is the compact quad tree), the tree is built on the GPU from 
+// the particle buffer (see ComputeControllerQuadTreeBuild) and the particles are never read 
+// back, so there is no frame scheduler and no frame of latency
+// Note: The CPU doesn't know how many nodes the GPU made, so the node count shows 0.
+const bool gBuildCompactQuadTreeOnGpu = false;
+
+// if true (and the spatial index is the uniform grid), each colliding pair is worked out once 
+// instead of once from each side (see ParticleCollisionsGridSymmetric.comp)
+const bool gSymmetricCollisions = false;
+
+// if true (and the spatial index is ParticleQuadTree), the tree-builder thread also hands over 
+// the leaf that each particle went in, and the collision shader starts from that leaf instead 
+// of walking the tree from the root (see ParticleLeafIndexSsbo)
+const bool gUploadParticleLeafIndices = false;
+
+// if true, the indices of the active particles are written into a dense list after the reset 
+// shader, and the update shader, the collision shaders, and the particle draw only go over 
+// that list, with a dispatch and draw size that the GPU writes itself (see 
+// ComputeControllerActiveParticleCompaction)
+const bool gCompactActiveParticles = false;
+
+// if true, the update shader keeps a stack of the particles that it deactivates and the reset 
+// shader emits from it, so each emitter only dispatches as many invocations as it may emit 
+// instead of going through every particle (see ParticleFreeListSsbo)
+const bool gUseParticleFreeList = false;
+
+// if true, each stage of each frame is timed (see FrameProfiler), and the min, mean, 99th 
+// percentile, and max of the last few seconds of frames are printed once per second
+// Note: The compute controllers' dispatches are also timed on the GPU with timer queries, and 
+// those are the "gpu" stages.  The others are how long the CPU took, which for the GPU's 
+// stages is only how long it took to submit them.
+const bool gProfileFrames = false;
+FrameProfiler *gpFrameProfiler = 0;
+GpuTimerBackendOpenGl gGpuTimerBackend;
 
 
 
@@ -199,19 +300,74 @@ void Init()
     // for the particle compute shader stuff
     std::string computeShaderUpdateKey = "compute particle update";
     shaderStorageRef.NewShader(computeShaderUpdateKey);
-    shaderStorageRef.AddShaderFile(computeShaderUpdateKey, "ParticleUpdate.comp", GL_COMPUTE_SHADER);
+    shaderStorageRef.AddShaderFile(computeShaderUpdateKey, gUseStructureOfArraysParticles ? "ParticleUpdateSoA.comp" : "ParticleUpdate.comp", GL_COMPUTE_SHADER);
     shaderStorageRef.LinkShader(computeShaderUpdateKey);
 
     std::string computeShaderResetKey = "compute particle reset";
     shaderStorageRef.NewShader(computeShaderResetKey);
-    shaderStorageRef.AddShaderFile(computeShaderResetKey, "ParticleReset.comp", GL_COMPUTE_SHADER);
+    shaderStorageRef.AddShaderFile(computeShaderResetKey, gUseStructureOfArraysParticles ? "ParticleResetSoA.comp" : "ParticleReset.comp", GL_COMPUTE_SHADER);
     shaderStorageRef.LinkShader(computeShaderResetKey);
 
     std::string computeQuadTreeParticleColliderKey = "compute quad tree collider";
     shaderStorageRef.NewShader(computeQuadTreeParticleColliderKey);
-    shaderStorageRef.AddShaderFile(computeQuadTreeParticleColliderKey, "ParticleCollisions.comp", GL_COMPUTE_SHADER);
+    std::string collisionShaderFileName = "ParticleCollisions";
+    if (gSpatialIndexType == SPATIAL_INDEX_COMPACT_QUAD_TREE)
+    {
+        collisionShaderFileName = "ParticleCollisionsCompact";
+    }
+    else if (gSpatialIndexType == SPATIAL_INDEX_UNIFORM_GRID)
+    {
+        collisionShaderFileName = gSymmetricCollisions ? "ParticleCollisionsGridSymmetric" : "ParticleCollisionsGrid";
+    }
+    collisionShaderFileName += gUseStructureOfArraysParticles ? "SoA.comp" : ".comp";
+    shaderStorageRef.AddShaderFile(computeQuadTreeParticleColliderKey, collisionShaderFileName, GL_COMPUTE_SHADER);
     shaderStorageRef.LinkShader(computeQuadTreeParticleColliderKey);
 
+    // the symmetric collision shader leaves its forces for this one to add to the particles
+    bool resolveCollisionForces = 
+        gSymmetricCollisions && (gSpatialIndexType == SPATIAL_INDEX_UNIFORM_GRID);
+    std::string computeCollisionForceResolveKey = "compute collision force resolve";
+    if (resolveCollisionForces)
+    {
+        shaderStorageRef.NewShader(computeCollisionForceResolveKey);
+        shaderStorageRef.AddShaderFile(computeCollisionForceResolveKey, gUseStructureOfArraysParticles ? "ParticleCollisionsResolveSoA.comp" : "ParticleCollisionsResolve.comp", GL_COMPUTE_SHADER);
+        shaderStorageRef.LinkShader(computeCollisionForceResolveKey);
+    }
+
+    // the GPU quad tree build's shaders (see ComputeControllerQuadTreeBuild)
+    bool buildQuadTreeOnGpu = 
+        gBuildCompactQuadTreeOnGpu && (gSpatialIndexType == SPATIAL_INDEX_COMPACT_QUAD_TREE);
+    std::string computeQuadTreeBuildParticlesKey = "compute quad tree build particles";
+    std::string computeQuadTreeBuildScanKey = "compute quad tree build scan";
+    std::string computeQuadTreeBuildRadixSortKey = "compute quad tree build radix sort";
+    std::string computeQuadTreeBuildNodesKey = "compute quad tree build nodes";
+    if (buildQuadTreeOnGpu)
+    {
+        shaderStorageRef.NewShader(computeQuadTreeBuildParticlesKey);
+        shaderStorageRef.AddShaderFile(computeQuadTreeBuildParticlesKey, gUseStructureOfArraysParticles ? "QuadTreeBuildParticlesSoA.comp" : "QuadTreeBuildParticles.comp", GL_COMPUTE_SHADER);
+        shaderStorageRef.LinkShader(computeQuadTreeBuildParticlesKey);
+
+        shaderStorageRef.NewShader(computeQuadTreeBuildScanKey);
+        shaderStorageRef.AddShaderFile(computeQuadTreeBuildScanKey, "QuadTreeBuildScan.comp", GL_COMPUTE_SHADER);
+        shaderStorageRef.LinkShader(computeQuadTreeBuildScanKey);
+
+        shaderStorageRef.NewShader(computeQuadTreeBuildRadixSortKey);
+        shaderStorageRef.AddShaderFile(computeQuadTreeBuildRadixSortKey, "QuadTreeBuildRadixSort.comp", GL_COMPUTE_SHADER);
+        shaderStorageRef.LinkShader(computeQuadTreeBuildRadixSortKey);
+
+        shaderStorageRef.NewShader(computeQuadTreeBuildNodesKey);
+        shaderStorageRef.AddShaderFile(computeQuadTreeBuildNodesKey, "QuadTreeBuildNodes.comp", GL_COMPUTE_SHADER);
+        shaderStorageRef.LinkShader(computeQuadTreeBuildNodesKey);
+    }
+
+    std::string computeActiveParticleCompactionKey = "compute active particle compaction";
+    if (gCompactActiveParticles)
+    {
+        shaderStorageRef.NewShader(computeActiveParticleCompactionKey);
+        shaderStorageRef.AddShaderFile(computeActiveParticleCompactionKey, gUseStructureOfArraysParticles ? "ParticleCompactActiveSoA.comp" : "ParticleCompactActive.comp", GL_COMPUTE_SHADER);
+        shaderStorageRef.LinkShader(computeActiveParticleCompactionKey);
+    }
+
     std::string ComputeControllerGenerateQuadTreeGeometryKey = "compute quad tree generate geometry";
     shaderStorageRef.NewShader(ComputeControllerGenerateQuadTreeGeometryKey);
     shaderStorageRef.AddShaderFile(ComputeControllerGenerateQuadTreeGeometryKey, "GenerateQuadTreeGeometry.comp", GL_COMPUTE_SHADER);
@@ -223,7 +379,7 @@ void Init()
     // particle state, so it isn't the same as the geometry's render shader)
     std::string renderParticlesShaderKey = "render particles";
     shaderStorageRef.NewShader(renderParticlesShaderKey);
-    shaderStorageRef.AddShaderFile(renderParticlesShaderKey, "ParticleRender.vert", GL_VERTEX_SHADER);
+    shaderStorageRef.AddShaderFile(renderParticlesShaderKey, gUseStructureOfArraysParticles ? "ParticleRenderSoA.vert" : "ParticleRender.vert", GL_VERTEX_SHADER);
     shaderStorageRef.AddShaderFile(renderParticlesShaderKey, "ParticleRender.frag", GL_FRAGMENT_SHADER);
     shaderStorageRef.LinkShader(renderParticlesShaderKey);
 
@@ -252,18 +408,109 @@ void Init()
     gpParticleBoundingRegionBuffer->ConfigureRender(renderGeometryProgramId, GL_LINES);
 
     // set up the particle SSBO for computing and rendering
-    std::vector<Particle> allParticles(Particle::MAX_PARTICLES);
-    gpParticleBuffer = new ParticleSsbo(allParticles);
+    if (gUseStructureOfArraysParticles)
+    {
+        ParticleSoA allParticles(Particle::MAX_PARTICLES);
+        gpParticleBuffer = new ParticleSsbo(allParticles);
+    }
+    else
+    {
+        std::vector<Particle> allParticles(Particle::MAX_PARTICLES);
+        gpParticleBuffer = new ParticleSsbo(allParticles);
+    }
     gpParticleBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeShaderResetKey), "ParticleBuffer");
     gpParticleBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeShaderUpdateKey), "ParticleBuffer");
     gpParticleBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeParticleColliderKey), "ParticleBuffer");
     gpParticleBuffer->ConfigureRender(shaderStorageRef.GetShaderProgram(renderParticlesShaderKey), GL_POINTS);
 
+    // the free list starts with every particle in it, so it is made along with them
+    if (gUseParticleFreeList)
+    {
+        gpParticleFreeListBuffer = new ParticleFreeListSsbo(Particle::MAX_PARTICLES);
+        gpParticleFreeListBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeShaderResetKey), "ParticleFreeListBuffer");
+        gpParticleFreeListBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeShaderUpdateKey), "ParticleFreeListBuffer");
+    }
+
+    // only the part of the particle buffer that the quad tree needs is read back
+    // Note: The scheduler's latency already keeps the CPU from waiting on the tree, so the 
+    // ring only needs a frame of its own when the scheduler has none (see 
+    // gFramesOfCollisionLatency).
+    unsigned int framesOfReadbackLatency = (gFramesOfCollisionLatency > 0) ? 0 : 1;
+    gpParticleReadbackRing = new ParticleReadbackRing(&gReadbackBackend, 
+        gpParticleBuffer->BufferId(), gpParticleBuffer->TreeInputSizeBytes(), 3, 
+        framesOfReadbackLatency);
+
     // set up the quad tree for computation
-    gpQuadTree = new ParticleQuadTree(particleRegionCenter, particleRegionRadius);
-    gpQuadTreeBuffer = new QuadTreeNodeSsbo(gpQuadTree->QuadTreeBuffer(), ParticleQuadTree::MAX_NODES);
+    // Note: The tree itself belongs to the frame scheduler's tree-builder thread, and nothing 
+    // collides with the buffer until the scheduler uploads the first tree.
+    std::vector<ParticleQuadTreeNode> initialQuadTreeNodes(ParticleQuadTree::MAX_NODES);
+    gpQuadTreeBuffer = new QuadTreeNodeSsbo(initialQuadTreeNodes.data(), ParticleQuadTree::MAX_NODES);
+    gpQuadTreeBuffer->SetOrphanOnUpload(gOrphanQuadTreeBufferOnUpload);
     gpQuadTreeBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeParticleColliderKey), "QuadTreeNodeBuffer");
     gpQuadTreeBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(ComputeControllerGenerateQuadTreeGeometryKey), "QuadTreeNodeBuffer");
+    bool uploadParticleLeafIndices = 
+        gUploadParticleLeafIndices && (gSpatialIndexType == SPATIAL_INDEX_QUAD_TREE);
+    if (uploadParticleLeafIndices)
+    {
+        gpParticleLeafIndexBuffer = new ParticleLeafIndexSsbo(Particle::MAX_PARTICLES);
+        gpParticleLeafIndexBuffer->SetOrphanOnUpload(gOrphanQuadTreeBufferOnUpload);
+        gpParticleLeafIndexBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeParticleColliderKey), "ParticleLeafIndexBuffer");
+    }
+    unsigned int maxCollisionNodes = ParticleQuadTree::MAX_NODES;
+    unsigned int gridCellsPerSide = 0;
+    if (gSpatialIndexType == SPATIAL_INDEX_COMPACT_QUAD_TREE)
+    {
+        gpCompactQuadTreeBuffer = new CompactQuadTreeSsbo(CompactParticleQuadTree::MAX_NODES, Particle::MAX_PARTICLES);
+        gpCompactQuadTreeBuffer->SetOrphanOnUpload(gOrphanQuadTreeBufferOnUpload);
+        gpCompactQuadTreeBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeParticleColliderKey), "CompactQuadTreeBuffer");
+        maxCollisionNodes = CompactParticleQuadTree::MAX_NODES;
+
+        if (buildQuadTreeOnGpu)
+        {
+            gpCompactQuadTreeBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeBuildNodesKey), "CompactQuadTreeBuffer");
+            gpParticleBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeBuildParticlesKey), "ParticleBuffer");
+
+            gpQuadTreeBuildBuffer = new QuadTreeBuildSsbo(Particle::MAX_PARTICLES, 
+                QuadTreeBuildEmulator::MaxBlockSums(Particle::MAX_PARTICLES));
+            gpQuadTreeBuildBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeBuildParticlesKey), "QuadTreeBuildBuffer");
+            gpQuadTreeBuildBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeBuildScanKey), "QuadTreeBuildBuffer");
+            gpQuadTreeBuildBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeBuildRadixSortKey), "QuadTreeBuildBuffer");
+            gpQuadTreeBuildBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeBuildNodesKey), "QuadTreeBuildBuffer");
+        }
+    }
+    else if (gSpatialIndexType == SPATIAL_INDEX_UNIFORM_GRID)
+    {
+        // Note: This grid is never built.  It only says how big the scheduler's grids will be.
+        ParticleUniformGrid gridShape(particleRegionCenter, particleRegionRadius);
+        gpUniformGridBuffer = new UniformGridSsbo(gridShape.NumCells(), Particle::MAX_PARTICLES);
+        gpUniformGridBuffer->SetOrphanOnUpload(gOrphanQuadTreeBufferOnUpload);
+        gpUniformGridBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeParticleColliderKey), "UniformGridBuffer");
+        maxCollisionNodes = gridShape.NumCells();
+        gridCellsPerSide = gridShape.CellsPerSide();
+
+        if (resolveCollisionForces)
+        {
+            gpCollisionForceBuffer = new CollisionForceSsbo(Particle::MAX_PARTICLES);
+            gpCollisionForceBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeParticleColliderKey), "CollisionForceBuffer");
+            gpCollisionForceBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeCollisionForceResolveKey), "CollisionForceBuffer");
+            gpParticleBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeCollisionForceResolveKey), "ParticleBuffer");
+        }
+    }
+
+    // the active particle list goes to every shader that goes over it
+    if (gCompactActiveParticles)
+    {
+        gpParticleBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeActiveParticleCompactionKey), "ParticleBuffer");
+
+        gpActiveParticleBuffer = new ActiveParticleSsbo(Particle::MAX_PARTICLES);
+        gpActiveParticleBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeActiveParticleCompactionKey), "ActiveParticleBuffer");
+        gpActiveParticleBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeShaderUpdateKey), "ActiveParticleBuffer");
+        gpActiveParticleBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeQuadTreeParticleColliderKey), "ActiveParticleBuffer");
+        if (resolveCollisionForces)
+        {
+            gpActiveParticleBuffer->ConfigureCompute(shaderStorageRef.GetShaderProgram(computeCollisionForceResolveKey), "ActiveParticleBuffer");
+        }
+    }
 
     // set up the quad tree's nodes for rendering
     unsigned int allPolygonFaces = ParticleQuadTree::MAX_NODES * 4;
@@ -296,12 +543,74 @@ void Init()
     gpParticleReseter = new ComputeControllerParticleReset(Particle::MAX_PARTICLES, computeShaderResetKey);
     gpParticleReseter->AddEmitter(gpParticleEmitterBar1);
     gpParticleReseter->AddEmitter(gpParticleEmitterBar2);
+    gpParticleReseter->SetUseParticleFreeList(gUseParticleFreeList);
 
     gpParticleUpdater = new ComputeControllerParticleUpdate(Particle::MAX_PARTICLES, particleRegionCenter, particleRegionRadius, computeShaderUpdateKey);
+    gpParticleUpdater->SetUseParticleFreeList(gUseParticleFreeList);
 
     gpQuadTreeGeometryGenerator = new ComputeControllerGenerateQuadTreeGeometry(ParticleQuadTree::MAX_NODES, allPolygonFaces, ComputeControllerGenerateQuadTreeGeometryKey);
 
-    gpQuadTreeParticleCollider = new ComputeControllerParticleCollisions(Particle::MAX_PARTICLES, ParticleQuadTree::MAX_NODES, particleRegionCenter, computeQuadTreeParticleColliderKey);
+    gpQuadTreeParticleCollider = new ComputeControllerParticleCollisions(Particle::MAX_PARTICLES, maxCollisionNodes, particleRegionCenter, particleRegionRadius, computeQuadTreeParticleColliderKey);
+    gpQuadTreeParticleCollider->SetGridCellsPerSide(gridCellsPerSide);
+    if (resolveCollisionForces)
+    {
+        gpQuadTreeParticleCollider->SetForceResolveShader(computeCollisionForceResolveKey);
+    }
+
+    if (gCompactActiveParticles)
+    {
+        gpActiveParticleCompactor = new ComputeControllerActiveParticleCompaction(
+            Particle::MAX_PARTICLES, computeActiveParticleCompactionKey);
+        gpParticleUpdater->SetActiveParticleBuffer(gpActiveParticleBuffer);
+        gpQuadTreeParticleCollider->SetActiveParticleBuffer(gpActiveParticleBuffer);
+    }
+
+    // 10 particles per emitter per frame (see UpdateAllTheThings())
+    gpFrameStages = new FrameStagesOpenGl(gpParticleReseter, gpParticleUpdater, 
+        gpQuadTreeParticleCollider, gpActiveParticleCompactor, gpParticleBuffer, 
+        gpParticleReadbackRing, gpQuadTreeBuffer, gpCompactQuadTreeBuffer, gpUniformGridBuffer, 
+        gpParticleLeafIndexBuffer, Particle::MAX_PARTICLES, 10);
+    if (buildQuadTreeOnGpu)
+    {
+        gpQuadTreeBuilder = new ComputeControllerQuadTreeBuild(Particle::MAX_PARTICLES, 
+            particleRegionCenter, particleRegionRadius, 
+            ParticleQuadTreeNode::MAX_PARTICLES_PER_NODE, gpQuadTreeBuildBuffer, 
+            gpCompactQuadTreeBuffer, computeQuadTreeBuildParticlesKey, 
+            computeQuadTreeBuildScanKey, computeQuadTreeBuildRadixSortKey, 
+            computeQuadTreeBuildNodesKey);
+    }
+    else
+    {
+        gpFrameScheduler = new FrameScheduler(gpFrameStages, particleRegionCenter, 
+            particleRegionRadius, gFramesOfCollisionLatency, gSpatialIndexType);
+        gpFrameScheduler->SetUploadParticleLeafIndices(uploadParticleLeafIndices);
+    }
+
+    if (gProfileFrames)
+    {
+        gpFrameProfiler = new FrameProfiler();
+        if (gpFrameScheduler != 0)
+        {
+            gpFrameScheduler->SetProfiler(gpFrameProfiler);
+        }
+        else
+        {
+            gpFrameStages->SetProfiler(gpFrameProfiler);
+        }
+
+        gpParticleReseter->EnableGpuTiming(&gGpuTimerBackend, gpFrameProfiler);
+        gpParticleUpdater->EnableGpuTiming(&gGpuTimerBackend, gpFrameProfiler);
+        gpQuadTreeParticleCollider->EnableGpuTiming(&gGpuTimerBackend, gpFrameProfiler);
+        gpQuadTreeGeometryGenerator->EnableGpuTiming(&gGpuTimerBackend, gpFrameProfiler);
+        if (gpActiveParticleCompactor != 0)
+        {
+            gpActiveParticleCompactor->EnableGpuTiming(&gGpuTimerBackend, gpFrameProfiler);
+        }
+        if (gpQuadTreeBuilder != 0)
+        {
+            gpQuadTreeBuilder->EnableGpuTiming(&gGpuTimerBackend, gpFrameProfiler);
+        }
+    }
 
     // the timer will be used for framerate calculations
     gTimer.Init();
@@ -322,32 +631,38 @@ void UpdateAllTheThings()
     // just hard-code it for this demo
     float deltaTimeSec = 0.01f;
 
-    // reset inactive particles and update active particles (the MAGIC happens here)
+    // reset inactive particles and update active particles (the MAGIC happens here), hand 
+    // the particles to the tree-builder thread, and collide them with a finished tree
     // Note: 20 particles per emitter per frame * 8 emitters * 60 frames per second stabilizes 
     // (for this particle region and the emitters' min-max spawn velocities) at ~45,000 active 
     // particles in one moment.
     // Also Note: 50 easily maxes out the maximuum 100,000 total particles active at one time.
-    gpParticleReseter->ResetParticles(10);
-    gpParticleUpdater->Update(deltaTimeSec);
-
-    // grap updated particle data from the GPU
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, gpParticleBuffer->BufferId());
-    void *bufferPtr = glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_READ_ONLY);
-    Particle *particleObjPtr = static_cast<Particle *>(bufferPtr);
-
-    // populate the quad tree (the CPU is great for this job)
-    gpQuadTree->ResetTree();
-    gpQuadTree->AddParticlestoTree(particleObjPtr, Particle::MAX_PARTICLES);
-
-    glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
-
-    // and upload the resulting quad tree
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, gpQuadTreeBuffer->BufferId());
-    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, gpQuadTreeBuffer->BufferSizeBytes(), gpQuadTree->QuadTreeBuffer());
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    // Also Also Note: The particles are read through a ParticleReadbackRing, and between it 
+    // and the scheduler, the collisions are 1 frame behind (see gFramesOfCollisionLatency).
+    // Also Also Also Note: When the tree is built on the GPU, nothing is read back, and the 
+    // collisions use this frame's tree.
+    if (gpFrameProfiler != 0)
+    {
+        gpFrameProfiler->BeginFrame();
+    }
+    if (gpQuadTreeBuilder != 0)
+    {
+        gpFrameStages->UpdateParticles(deltaTimeSec);
+        {
+            FrameProfileZone treeBuildZone(gpFrameProfiler, PROFILER_STAGE_TREE_BUILD);
+            gpQuadTreeBuilder->BuildTree();
+        }
+        {
+            FrameProfileZone collideZone(gpFrameProfiler, PROFILER_STAGE_COLLIDE);
+            gpQuadTreeParticleCollider->Update(deltaTimeSec, CompactParticleQuadTree::MAX_NODES);
+        }
+    }
+    else
+    {
+        gpFrameScheduler->RunFrame(deltaTimeSec);
+    }
 
-    gpQuadTreeParticleCollider->Update(deltaTimeSec);
-    //gpQuadTreeGeometryGenerator->GenerateGeometry();
+    //gpQuadTreeGeometryGenerator->GenerateGeometry(gpQuadTreeBuffer->NumActiveNodes());
 
 
     // tell glut to call this display() function again on the next iteration of the main loop
@@ -375,6 +690,9 @@ Creator:    John Cox (2-13-2016)
 -----------------------------------------------------------------------------------------------*/
 void Display()
 {
+    // not a FrameProfileZone because the frame has to end before this function does
+    Stopwatch renderStopwatch;
+
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClearDepth(1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -398,8 +716,17 @@ void Display()
 
     // draw the particles
     glUseProgram(ShaderStorage::GetInstance().GetShaderProgram("render particles"));
+    // Note: The inactive particles are drawn invisibly anyway, so if there is a list of the 
+    // active ones, only those are drawn.
     glBindVertexArray(gpParticleBuffer->VaoId());
-    glDrawArrays(gpParticleBuffer->DrawStyle(), 0, gpParticleBuffer->NumVertices());
+    if (gpActiveParticleBuffer != 0)
+    {
+        gpActiveParticleBuffer->DrawIndirect(gpParticleBuffer->DrawStyle());
+    }
+    else
+    {
+        glDrawArrays(gpParticleBuffer->DrawStyle(), 0, gpParticleBuffer->NumVertices());
+    }
 
     // draw text on top of the rendered items
     glUseProgram(ShaderStorage::GetInstance().GetShaderProgram("freetype"));
@@ -421,8 +748,16 @@ void Display()
         frameRate = (double)elapsedFramesPerSecond / elapsedTime;
         elapsedFramesPerSecond = 0;
 
-        quadTreePopulationsPerSecond = (int)((gpQuadTree->NumNodePopulations()) / elapsedTime);
-        gpQuadTree->ResetNumNodePopulations();
+        if (gpFrameScheduler != 0)
+        {
+            quadTreePopulationsPerSecond = (int)((gpFrameScheduler->NumNodePopulations()) / elapsedTime);
+            gpFrameScheduler->ResetNumNodePopulations();
+        }
+
+        if (gpFrameProfiler != 0)
+        {
+            gpFrameProfiler->PrintSummary(stdout);
+        }
 
         elapsedTime -= 1.0f;
     }
@@ -447,7 +782,7 @@ void Display()
     gTextAtlases.GetAtlas(pointSize)->RenderText(str, numActiveParticlesXY, scaleXY, color);
 
     // now draw the number of active quad tree nodes
-    sprintf(str, "nodes: %d", gpQuadTree->NumActiveNodes());
+    sprintf(str, "nodes: %d", (gpFrameScheduler != 0) ? gpFrameScheduler->NumActiveNodes() : 0);
     float numActiveNodesXY[2] = { -0.99f, +0.5f };
     gTextAtlases.GetAtlas(pointSize)->RenderText(str, numActiveNodesXY, scaleXY, color);
 
@@ -490,6 +825,12 @@ void Display()
 
     // tell the GPU to swap out the displayed buffer with the one that was just rendered
     glutSwapBuffers();
+
+    if (gpFrameProfiler != 0)
+    {
+        gpFrameProfiler->AddStageTime(PROFILER_STAGE_RENDER, renderStopwatch.TotalTime() * 1000.0);
+        gpFrameProfiler->EndFrame();
+    }
 }
 
 /*-----------------------------------------------------------------------------------------------
@@ -581,15 +922,29 @@ Creator:    John Cox (2-13-2016)
 -----------------------------------------------------------------------------------------------*/
 void CleanupAll()
 {
+    // the scheduler's thread must stop before anything that the stages use goes away
+    delete gpFrameScheduler;
+    delete gpFrameStages;
+    delete gpParticleReadbackRing;
     delete gpParticleBuffer;
     delete gpParticleBoundingRegionBuffer;
     delete gpQuadTreeGeometryBuffer;
     delete gpQuadTreeBuffer;
+    delete gpCompactQuadTreeBuffer;
+    delete gpUniformGridBuffer;
+    delete gpQuadTreeBuildBuffer;
+    delete gpCollisionForceBuffer;
+    delete gpParticleLeafIndexBuffer;
+    delete gpActiveParticleBuffer;
+    delete gpParticleFreeListBuffer;
+    delete gpQuadTreeBuilder;
+    delete gpActiveParticleCompactor;
     delete gpParticleEmitterBar1;
     delete gpParticleEmitterBar2;
     delete gpParticleReseter;
     delete gpParticleUpdater;
     delete gpQuadTreeGeometryGenerator;
+    delete gpFrameProfiler;
 }
 
 /*-----------------------------------------------------------------------------------------------